@@ -0,0 +1,76 @@
+/** @file bench_channels.cpp
+ *  This file contains a table of eight channels and the shares which the
+ *  stream stage writes to, for the benchmarks which run the pipeline with
+ *  more channels than the tester has, and the readings they're given.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include "shares.h"
+#include "sample_pipeline.h"
+#include "signal_gen.h"
+#include "bench_channels.h"
+
+/// The channels: the tester's two, then six more on the other ADC inputs
+const channel_t CHANNELS[] =
+{
+    { "fine", 36, 0 },
+    { "coarse", 39, 1 },
+    { "ch2", 34, 2 },
+    { "ch3", 35, 3 },
+    { "ch4", 32, 4 },
+    { "ch5", 33, 5 },
+    { "ch6", 25, 6 },
+    { "ch7", 26, 7 }
+};
+const uint8_t CHANNEL_COUNT = BENCH_CHANNEL_COUNT;
+static_assert (sizeof (CHANNELS) / sizeof (CHANNELS[0]) == BENCH_CHANNEL_COUNT,
+               "BENCH_CHANNEL_COUNT must match the table");
+static_assert (BENCH_CHANNEL_COUNT <= PIPELINE_MAX_CHANNELS
+               && BENCH_CHANNEL_COUNT <= SIGNAL_MAX_CHANNELS,
+               "The pipeline and generator must carry every channel");
+
+/// Shares which the stream stage puts the latest voltages into
+Share<uint16_t> v_fine ("Fine");
+Share<uint16_t> v_coarse ("Coarse");
+
+
+/** @brief   Make every channel's readings, as the sampling task would read
+ *           them, with each channel converted after the one before.
+ *  @param   counts Where the readings go, a scan's channels together
+ *  @param   offsets Where each channel's time in the scan goes, in
+ *           microseconds; room for @c BENCH_CHANNEL_COUNT of them
+ *  @param   samples The number of readings of each channel
+ *  @param   period_ms The time between scans
+ */
+void bench_make_readings (std::vector<uint16_t>& counts, uint16_t* offsets,
+                          uint32_t samples, uint16_t period_ms)
+{
+    signal_config_t config;
+    signal_defaults (config);
+    config.channels = BENCH_CHANNEL_COUNT;
+    for (uint8_t channel = 2; channel < BENCH_CHANNEL_COUNT; channel++)
+    {
+        // Sensors between the fine and coarse ones in gain
+        config.channel[channel] = config.channel[channel & 1];
+        config.channel[channel].gain = 8.0f + 8.0f * channel;
+    }
+    SignalGenerator signal (config);
+    counts.resize ((size_t)samples * BENCH_CHANNEL_COUNT);
+    for (uint8_t channel = 0; channel < BENCH_CHANNEL_COUNT; channel++)
+    {
+        offsets[channel] = channel * BENCH_CONVERSION_US;
+    }
+    for (uint32_t scan = 0; scan < samples; scan++)
+    {
+        uint32_t time_us = scan * period_ms * 1000;
+        for (uint8_t channel = 0; channel < BENCH_CHANNEL_COUNT; channel++)
+        {
+            counts[scan * BENCH_CHANNEL_COUNT + channel]
+                = signal.read (channel, time_us + offsets[channel]);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+/** @file bench_channels.h
+ *  This file contains the table of eight channels which the benchmarks of
+ *  the pipeline at more than the tester's two channels are built with, in
+ *  place of @c host/host_channels.cpp, and a way to make readings for all
+ *  of them from the synthetic signal generator.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _BENCH_CHANNELS_H_
+#define _BENCH_CHANNELS_H_
+
+#include <stdint.h>
+#include <vector>
+#include "channels.h"
+
+/// Number of channels in the table, the fine and coarse sensors and six more
+const uint8_t BENCH_CHANNEL_COUNT = 8;
+
+/// Microseconds the simulated ADC takes for each conversion
+const uint32_t BENCH_CONVERSION_US = 10;
+
+void bench_make_readings (std::vector<uint16_t>& counts, uint16_t* offsets,
+                          uint32_t samples, uint16_t period_ms);
+
+#endif // _BENCH_CHANNELS_H_
@@ -0,0 +1,225 @@
+/** @file bench_server.cpp
+ *  This file contains the host benchmark's web server, which uses POSIX
+ *  sockets in place of the ESP32's WiFi stack.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "bench_server.h"
+#include "response_writer.h"
+#include "route_stats.h"
+
+/// Seconds a client may take to send its request before it's dropped
+const int BENCH_REQUEST_TIMEOUT_S = 2;
+
+/// Connections which may wait to be accepted, as many as a load test makes
+const int BENCH_BACKLOG = 64;
+
+
+/** @brief   Class which sends what is written to it over a socket.
+ */
+class SocketClient : public Print
+{
+protected:
+    int socket;                 ///< The connection
+
+public:
+    SocketClient (int socket) : socket (socket) { }
+
+    using Print::write;
+
+    /// Send one byte
+    size_t write (uint8_t byte)
+    {
+        return write (&byte, 1);
+    }
+
+    /// Send some bytes, waiting until they've all been taken
+    size_t write (const uint8_t* data, size_t count)
+    {
+        size_t sent = 0;
+        while (sent < count)
+        {
+            ssize_t taken = send (socket, data + sent, count - sent,
+                                  MSG_NOSIGNAL);
+            if (taken <= 0)
+            {
+                break;
+            }
+            sent += taken;
+        }
+        return sent;
+    }
+};
+
+
+/** @brief   Find the value of one argument in a query.
+ *  @details Values aren't decoded, as the bench's arguments are numbers.
+ *  @param   query The query, such as @c max=10&reset=1, or @c NULL
+ *  @param   name The argument's name
+ *  @param   value Room for the value, which is always ended with a zero
+ *  @param   size Bytes of room for the value
+ *  @returns @c true if the argument was there
+ */
+bool bench_query_arg (const char* query, const char* name, char* value,
+                      size_t size)
+{
+    size_t name_length = strlen (name);
+    while (query != NULL && *query)
+    {
+        const char* end = strchr (query, '&');
+        size_t length = end ? (size_t)(end - query) : strlen (query);
+        if (length > name_length && strncmp (query, name, name_length) == 0
+            && query[name_length] == '=')
+        {
+            size_t take = length - name_length - 1;
+            take = (take < size - 1) ? take : size - 1;
+            memcpy (value, query + name_length + 1, take);
+            value[take] = '\0';
+            return true;
+        }
+        query = end ? end + 1 : NULL;
+    }
+    return false;
+}
+
+
+/** @brief   Read a request's line and headers from a client.
+ *  @details The body, if any, isn't read, as no route here takes one.
+ *  @param   socket The connection
+ *  @param   request Room for the request, @c BENCH_REQUEST_SIZE bytes
+ *  @returns @c true if the headers ended before the room ran out
+ */
+static bool read_request (int socket, char* request)
+{
+    size_t length = 0;
+    while (length < BENCH_REQUEST_SIZE - 1)
+    {
+        ssize_t got = recv (socket, request + length,
+                            BENCH_REQUEST_SIZE - 1 - length, 0);
+        if (got <= 0)
+        {
+            return false;
+        }
+        length += got;
+        request[length] = '\0';
+        if (strstr (request, "\r\n\r\n") != NULL)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/** @brief   Answer one request.
+ *  @param   socket The connection
+ *  @param   routes The routes answered
+ *  @param   ids Each route's index in the histograms
+ *  @param   count Number of routes
+ *  @param   not_found Index in the histograms of unknown paths
+ */
+static void answer (int socket, const bench_route_t* routes,
+                    const uint8_t* ids, uint8_t count, uint8_t not_found)
+{
+    static char request[BENCH_REQUEST_SIZE];
+    if (!read_request (socket, request))
+    {
+        return;
+    }
+
+    // The path runs from after the method to the next space; the query
+    // follows a question mark
+    char* path = strchr (request, ' ');
+    char* end = path ? strchr (++path, ' ') : NULL;
+    if (end == NULL)
+    {
+        return;
+    }
+    *end = '\0';
+    char* query = strchr (path, '?');
+    if (query != NULL)
+    {
+        *query++ = '\0';
+    }
+
+    SocketClient client (socket);
+    uint32_t start = micros ();
+    for (uint8_t index = 0; index < count; index++)
+    {
+        if (strcmp (path, routes[index].path) == 0)
+        {
+            routes[index].handler (client, query);
+            stats_record (ids[index], micros () - start);
+            return;
+        }
+    }
+
+    char buffer[128];
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (404, "text/plain");
+    page.write ("Not found: ");
+    page.write (path);
+    page.end ();
+    stats_record (not_found, micros () - start);
+}
+
+
+/** @brief   Answer requests for the routes on a TCP port until the program
+ *           is stopped.
+ *  @param   port The port, on every address of this computer
+ *  @param   routes The routes answered
+ *  @param   count Number of routes
+ *  @returns @c false if the port couldn't be opened; otherwise it doesn't
+ *           return
+ */
+bool bench_serve (uint16_t port, const bench_route_t* routes, uint8_t count)
+{
+    uint8_t ids[STATS_MAX_ROUTES];
+    for (uint8_t index = 0; index < count; index++)
+    {
+        ids[index] = stats_route (routes[index].path);
+    }
+    uint8_t not_found = stats_route ("(not found)");
+
+    int listener = socket (AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    setsockopt (listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof (on));
+    sockaddr_in address = { };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl (INADDR_ANY);
+    address.sin_port = htons (port);
+    if (listener < 0
+        || bind (listener, (sockaddr*)&address, sizeof (address)) != 0
+        || listen (listener, BENCH_BACKLOG) != 0)
+    {
+        perror ("bench server");
+        return false;
+    }
+    fprintf (stderr, "serving on port %u\n", port);
+
+    for (;;)
+    {
+        int client = accept (listener, NULL, NULL);
+        if (client < 0)
+        {
+            continue;
+        }
+        timeval timeout = { BENCH_REQUEST_TIMEOUT_S, 0 };
+        setsockopt (client, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                    sizeof (timeout));
+        setsockopt (client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof (on));
+        answer (client, routes, ids, count, not_found);
+        shutdown (client, SHUT_WR);
+        close (client);
+    }
+}
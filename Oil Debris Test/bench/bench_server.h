@@ -0,0 +1,42 @@
+/** @file bench_server.h
+ *  This file contains a small web server for the host benchmark, so that
+ *  the tester's pages can be loaded by @c tools/http_load.py on a PC. Like
+ *  the ESP32's @c WebServer, it answers one request at a time in one
+ *  thread and closes each connection when the response has been sent.
+ *  Each route's handler writes its page through a @c ResponseWriter, and
+ *  the time it takes is counted in @c route_stats.h, so @c /stats gives the
+ *  same histograms the tester does.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _BENCH_SERVER_H_
+#define _BENCH_SERVER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>
+
+/// The longest request line and headers which are read
+const size_t BENCH_REQUEST_SIZE = 2048;
+
+
+/** @brief   One route the server answers.
+ */
+struct bench_route_t
+{
+    const char* path;           ///< The path, without the query
+    void (*handler) (Print& client, const char* query);    ///< Writes the page
+};
+
+
+// Find the value of one argument in a query such as "max=10&reset=1"
+bool bench_query_arg (const char* query, const char* name, char* value,
+                      size_t size);
+
+// Answer requests for the routes on a TCP port until the program is stopped
+bool bench_serve (uint16_t port, const bench_route_t* routes, uint8_t count);
+
+#endif // _BENCH_SERVER_H_
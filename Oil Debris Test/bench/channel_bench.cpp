@@ -0,0 +1,232 @@
+/** @file channel_bench.cpp
+ *  This file contains a benchmark of how the data path's time grows with
+ *  the number of sensor channels: the same pipeline and stages as
+ *  @c main.cpp are run on a PC with 2 to 8 channels, and the time to put a
+ *  block's readings and run the block through align, filter, detect, store
+ *  and stream is measured for each count of channels.
+ *
+ *  Each count of channels has a pipeline of its own, sized at compile time
+ *  as @c main.cpp sizes the tester's; the count asked for at run time picks
+ *  one. The readings come from the synthetic signal generator and are all
+ *  made before the clock starts, so only the data path is timed. The
+ *  channels are those of @c bench_channels.cpp, which takes the place of
+ *  @c host/host_channels.cpp.
+ *
+ *  The results are written as JSON, as those of @c replay_bench.cpp are:
+ *  for each count of channels, the spread of the microseconds each block
+ *  took and the mean nanoseconds for each reading of each channel, which
+ *  stays flat if the time grows linearly with the channels.
+ *
+ *  Usage, after @c pio @c run @c -e @c channel_bench:
+ *      .pio/build/channel_bench/program [--channels N] [--samples N]
+ *                                       [--out FILE]
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <Arduino.h>
+#include "sample_log.h"
+#include "sample_pipeline.h"
+#include "pipeline_stages.h"
+#include "voltage_history.h"
+#include "bench_channels.h"
+
+// The block size and settings are those of main.cpp
+const uint16_t SAMPLE_PERIOD_MS = 10;
+const uint16_t BLOCK_SIZE = 50;
+const uint16_t DETECT_THRESHOLD = 40;
+const uint8_t FILTER_SHIFT = 2;
+
+/// Fewest and most channels run
+const uint8_t BENCH_MIN_CHANNELS = 2;
+const uint8_t BENCH_MAX_CHANNELS = BENCH_CHANNEL_COUNT;
+
+/// Readings per channel run when none are asked for
+const uint32_t BENCH_DEFAULT_SAMPLES = 200000;
+
+/// Every channel's readings, a scan's channels together, and their times
+static std::vector<uint16_t> counts;
+static uint16_t offsets[BENCH_CHANNEL_COUNT];
+
+/// The chain of main.cpp
+typedef StageChain<stage_align, stage_filter, stage_detect, stage_store,
+                   stage_stream> bench_chain_t;
+
+
+/** @brief   Get the time in nanoseconds from a steady clock.
+ */
+static inline uint64_t now_ns (void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+
+/** @brief   Run the readings of the first few channels through a pipeline
+ *           of that many channels and write its times as a JSON object.
+ *  @tparam  COUNT The number of channels
+ *  @param   out Where the JSON goes
+ *  @param   samples The number of readings of each channel
+ *  @param   last Whether it's the last item, which takes no comma
+ */
+template <uint8_t COUNT>
+static void run_channels (FILE* out, uint32_t samples, bool last)
+{
+    // States of the stages, set up as in main.cpp
+    static align_state_t align_state = { SAMPLE_PERIOD_MS * 1000, false,
+                                         {} };
+    static filter_state_t filter_state = { FILTER_SHIFT, false, {} };
+    static detect_state_t detect_state = { DETECT_THRESHOLD,
+                                           SAMPLE_PERIOD_MS, {} };
+    static void* const STAGE_CONTEXTS[] =
+    {
+        &align_state, &filter_state, &detect_state, NULL, NULL
+    };
+    static StaticPipeline<COUNT, BLOCK_SIZE, bench_chain_t>
+        pipeline (STAGE_CONTEXTS);
+
+    uint32_t blocks = (samples + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<uint32_t> block_ns;
+    block_ns.reserve (blocks);
+    uint64_t total_ns = 0;
+    uint32_t done = 0;
+    for (uint32_t block = 0; block < blocks; block++)
+    {
+        uint64_t start = now_ns ();
+        for (uint16_t index = 0; index < BLOCK_SIZE && done < samples;
+             index++, done++)
+        {
+            pipeline.put (done * SAMPLE_PERIOD_MS,
+                          &counts[done * BENCH_CHANNEL_COUNT], offsets);
+        }
+        if (done == samples)
+        {
+            pipeline.flush ();
+        }
+        pipeline.process ();
+        uint32_t took = (uint32_t)(now_ns () - start);
+        block_ns.push_back (took);
+        total_ns += took;
+    }
+
+    std::sort (block_ns.begin (), block_ns.end ());
+    pipeline_stats_t stats = pipeline.stats ();
+    fprintf (out, "    {\"channels\": %u, \"blocks\": %u, "
+             "\"mean_us_per_block\": %.2f, \"p50_us_per_block\": %.2f, "
+             "\"p99_us_per_block\": %.2f, "
+             "\"ns_per_sample_channel\": %.1f, \"dropped\": %u}%s\n",
+             COUNT, blocks, total_ns / 1e3 / blocks,
+             block_ns[blocks / 2] / 1e3,
+             block_ns[(size_t)(blocks * 0.99)] / 1e3,
+             (double)total_ns / ((double)samples * COUNT),
+             stats.samples_dropped, last ? "" : ",");
+}
+
+
+/** @brief   Run a count of channels through its own pipeline.
+ *  @param   out Where the JSON goes
+ *  @param   channels The number of channels
+ *  @param   samples The number of readings of each channel
+ *  @param   last Whether it's the last item, which takes no comma
+ */
+static void run_count (FILE* out, uint8_t channels, uint32_t samples,
+                       bool last)
+{
+    switch (channels)
+    {
+        case 2: run_channels<2> (out, samples, last); break;
+        case 3: run_channels<3> (out, samples, last); break;
+        case 4: run_channels<4> (out, samples, last); break;
+        case 5: run_channels<5> (out, samples, last); break;
+        case 6: run_channels<6> (out, samples, last); break;
+        case 7: run_channels<7> (out, samples, last); break;
+        case 8: run_channels<8> (out, samples, last); break;
+    }
+}
+
+
+/** @brief   Show how the program is used.
+ */
+static void usage (void)
+{
+    fprintf (stderr, "usage: program [--channels 2-8] [--samples N] "
+             "[--out FILE.json]\n");
+}
+
+
+/** @brief   Time the data path with each count of channels and report on it.
+ */
+int main (int argc, char** argv)
+{
+    const char* output = NULL;
+    uint32_t samples = BENCH_DEFAULT_SAMPLES;
+    uint32_t first = BENCH_MIN_CHANNELS;
+    uint32_t final = BENCH_MAX_CHANNELS;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        bool more = arg + 1 < argc;
+        if (strcmp (argv[arg], "--channels") == 0 && more)
+        {
+            first = final = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--samples") == 0 && more)
+        {
+            samples = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--out") == 0 && more)
+        {
+            output = argv[++arg];
+        }
+        else
+        {
+            usage ();
+            return 2;
+        }
+    }
+    if (samples < BLOCK_SIZE || first < BENCH_MIN_CHANNELS
+        || final > BENCH_MAX_CHANNELS)
+    {
+        usage ();
+        return 2;
+    }
+
+    // Everything is made before the clock starts
+    bench_make_readings (counts, offsets, samples, SAMPLE_PERIOD_MS);
+    history_init ();
+    events_init ();
+    sample_log_init ();
+    if (!sample_log_mount ())
+    {
+        fprintf (stderr, "can't mount the log\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (output != NULL && (out = fopen (output, "w")) == NULL)
+    {
+        fprintf (stderr, "can't write %s\n", output);
+        return 1;
+    }
+    fprintf (out, "{\n  \"schema\": 1,\n  \"kind\": \"channel_bench\",\n");
+    fprintf (out, "  \"samples\": %u,\n  \"block_size\": %u,\n", samples,
+             BLOCK_SIZE);
+    fprintf (out, "  \"runs\": [\n");
+    for (uint32_t channels = first; channels <= final; channels++)
+    {
+        run_count (out, (uint8_t)channels, samples, channels == final);
+    }
+    fprintf (out, "  ]\n}\n");
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+    return 0;
+}
@@ -0,0 +1,404 @@
+/** @file codec_bench.cpp
+ *  This file contains a benchmark of the sample block codec on a PC: how
+ *  many megabytes of readings a second it encodes and decodes, and how
+ *  small it makes them, for readings like the tester's and for the worst
+ *  case. Each kind of readings is cut into blocks of the pipeline's size,
+ *  as the store stage cuts them, and every block is decoded again and
+ *  compared, so a run which gives a speed also shows the codec still works.
+ *
+ *  The kinds of readings are quiet noise of a few counts, as the sensors
+ *  give with no debris passing; the same noise with pulses now and then;
+ *  and readings swinging from zero to full scale every sample, whose 13-bit
+ *  deltas are the most the codec ever has to store.
+ *
+ *  Readings recorded from the tester can be given instead, either as a
+ *  CSV file written by @c tools/data_download.py or as the @c data.bin log
+ *  it downloads, whose blocks are decoded first. Each channel of a
+ *  recording is then encoded on its own, as the store stage encodes it.
+ *
+ *  The results are written as JSON, as those of @c replay_bench.cpp are.
+ *  Megabytes are of readings at two bytes each, before encoding.
+ *
+ *  Usage, after @c pio @c run @c -e @c codec_bench:
+ *      .pio/build/codec_bench/program [--samples N] [--block N]
+ *                                     [--input out.csv|data.bin]
+ *                                     [--out FILE]
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "sample_codec.h"
+#include "sample_log.h"
+#include "fixed_format.h"
+
+/// Readings of each kind encoded when no number is asked for
+const uint32_t CODEC_DEFAULT_SAMPLES = 10000000;
+
+/// Readings in each block when no size is asked for; that of main.cpp
+const uint16_t CODEC_DEFAULT_BLOCK = 50;
+
+/// Most readings in a block
+const uint16_t CODEC_MAX_BLOCK = 4096;
+
+/// Most channels read from a recording
+const uint8_t CODEC_MAX_CHANNELS = 8;
+
+/// Kinds of readings which are encoded
+enum codec_kind_t : uint8_t
+{
+    KIND_QUIET,                 ///< Noise of a few counts about mid-scale
+    KIND_PULSES,                ///< The same, with a pulse now and then
+    KIND_WORST,                 ///< Zero and full scale in turn
+    KIND_COUNT
+};
+
+/// Names of the kinds of readings, in the order of @c codec_kind_t
+static const char* const KIND_NAMES[] = { "quiet", "pulses", "worst_case" };
+
+/// Where the benchmark puts results, so the compiler can't leave out work
+static volatile uint32_t bench_sink;
+
+
+/** @brief   Get the time in nanoseconds from a steady clock.
+ */
+static inline uint64_t now_ns (void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+
+/** @brief   Make readings of one kind.
+ *  @param   readings Where the readings are put
+ *  @param   kind The kind of readings
+ */
+static void make_readings (std::vector<uint16_t>& readings, codec_kind_t kind)
+{
+    uint32_t seed = 2024 + kind;
+    for (size_t index = 0; index < readings.size (); index++)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint16_t noise = (uint16_t)((seed >> 16) % 9);
+        uint16_t reading = 2000 + noise;
+        if (kind == KIND_PULSES && index % 1000 < 20)
+        {
+            // A triangle 20 readings wide, 1500 counts high at its peak
+            uint16_t from_edge = (uint16_t)(index % 1000);
+            from_edge = (from_edge < 10) ? from_edge : 19 - from_edge;
+            reading += from_edge * 150;
+        }
+        else if (kind == KIND_WORST)
+        {
+            reading = (index & 1) ? 0x0FFF : 0;
+        }
+        readings[index] = reading;
+    }
+}
+
+
+/** @brief   Read a recording written by @c tools/data_download.py.
+ *  @details Each line holds a time and then each channel's voltage; lines
+ *           which don't start with a number are skipped, and an empty field
+ *           keeps the channel's last reading. Voltages are turned back into
+ *           counts with the full scale in @c fixed_format.h, as
+ *           @c replay_bench.cpp turns them.
+ *  @param   file The open file
+ *  @param   channels Where each channel's readings are put
+ */
+static void read_csv (FILE* file, std::vector<uint16_t>* channels)
+{
+    char line[256];
+    uint16_t last[CODEC_MAX_CHANNELS] = {};
+    while (fgets (line, sizeof (line), file))
+    {
+        char* field = line;
+        strtod (field, &field);
+        if (field == line)
+        {
+            continue;
+        }
+        for (uint8_t channel = 0; channel < CODEC_MAX_CHANNELS; channel++)
+        {
+            field = strchr (field, ',');
+            if (field == NULL)
+            {
+                break;
+            }
+            char* end;
+            double volts = strtod (++field, &end);
+            if (end != field && volts >= 0)
+            {
+                double counts = volts * 1000 * ADC_MAX_COUNTS / FULL_SCALE_MV;
+                last[channel] = (counts > ADC_MAX_COUNTS) ? ADC_MAX_COUNTS
+                                : (uint16_t)(counts + 0.5);
+            }
+            channels[channel].push_back (last[channel]);
+        }
+    }
+}
+
+
+/** @brief   Read the log downloaded from @c /data.bin and decode the
+ *           blocks of its samples records.
+ *  @details Bytes which aren't part of a whole record, as after a power
+ *           failure, are skipped by looking for the next record's start,
+ *           as @c tools/data_download.py skips them.
+ *  @param   file The open file
+ *  @param   channels Where each channel's readings are put
+ */
+static void read_log (FILE* file, std::vector<uint16_t>* channels)
+{
+    std::vector<uint8_t> data;
+    uint8_t chunk[16384];
+    size_t got;
+    while ((got = fread (chunk, 1, sizeof (chunk), file)) > 0)
+    {
+        data.insert (data.end (), chunk, chunk + got);
+    }
+
+    static uint16_t decoded[CODEC_MAX_BLOCK];
+    size_t offset = 0;
+    while (offset + LOG_RECORD_HEADER_SIZE <= data.size ())
+    {
+        const uint8_t* header = &data[offset];
+        size_t end = offset + LOG_RECORD_HEADER_SIZE
+                     + (header[2] | (header[3] << 8));
+        if (header[0] != LOG_RECORD_MAGIC || end > data.size ())
+        {
+            offset++;
+            continue;
+        }
+        size_t place = offset + LOG_RECORD_HEADER_SIZE;
+        while (header[1] == LOG_SAMPLES && place < end)
+        {
+            codec_block_info_t info;
+            size_t size = codec_decode_block (&data[place], end - place, info,
+                                              decoded, CODEC_MAX_BLOCK);
+            if (size == 0 || info.channel >= CODEC_MAX_CHANNELS)
+            {
+                break;
+            }
+            channels[info.channel].insert (channels[info.channel].end (),
+                                           decoded, decoded + info.count);
+            place += size;
+        }
+        offset = end;
+    }
+}
+
+
+/** @brief   Read a recording, as CSV if its name ends in @c .csv and as a
+ *           downloaded log otherwise.
+ *  @param   path The file's name
+ *  @param   channels Where each channel's readings are put
+ *  @returns @c true if the file could be read
+ */
+static bool read_recording (const char* path,
+                            std::vector<uint16_t>* channels)
+{
+    FILE* file = fopen (path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    size_t length = strlen (path);
+    if (length > 4 && strcmp (path + length - 4, ".csv") == 0)
+    {
+        read_csv (file, channels);
+    }
+    else
+    {
+        read_log (file, channels);
+    }
+    fclose (file);
+    return true;
+}
+
+
+/** @brief   Encode readings a block at a time, decode them again and write
+ *           the speeds and sizes as a JSON object.
+ *  @param   out Where the JSON goes
+ *  @param   name What the readings are called in the results
+ *  @param   readings The readings
+ *  @param   block The number of readings in each block
+ *  @param   last Whether it's the last item, which takes no comma
+ *  @returns @c true if every block came back as it went in
+ */
+static bool run_readings (FILE* out, const char* name,
+                          const std::vector<uint16_t>& readings,
+                          uint16_t block, bool last)
+{
+    uint32_t samples = readings.size ();
+    std::vector<uint16_t> decoded (samples);
+    uint32_t blocks = (samples + block - 1) / block;
+    std::vector<uint8_t> encoded (blocks * codec_max_encoded_size (block));
+
+    // Encode every block into one stream, as they'd be stored in the log
+    size_t used = 0;
+    uint32_t bitpacked = 0;
+    uint64_t start = now_ns ();
+    for (uint32_t first = 0; first < samples; first += block)
+    {
+        uint16_t count = (samples - first < block) ? samples - first : block;
+        size_t size = codec_encode_block (&readings[first], count, 0, first,
+                                          &encoded[used],
+                                          encoded.size () - used);
+        bitpacked += encoded[used + 1] == CODEC_BITPACK;
+        used += size;
+    }
+    uint64_t encode_ns = now_ns () - start;
+
+    size_t place = 0;
+    uint32_t first = 0;
+    bool whole = true;
+    start = now_ns ();
+    while (place < used && first < samples)
+    {
+        codec_block_info_t info;
+        uint16_t room = (samples - first < block) ? samples - first : block;
+        size_t size = codec_decode_block (&encoded[place], used - place, info,
+                                          &decoded[first], room);
+        if (size == 0)
+        {
+            whole = false;
+            break;
+        }
+        place += size;
+        first += info.count;
+    }
+    uint64_t decode_ns = now_ns () - start;
+    whole = whole && first == samples
+            && memcmp (readings.data (), decoded.data (),
+                       samples * sizeof (uint16_t)) == 0;
+    bench_sink = decoded[samples / 2];
+
+    double megabytes = samples * sizeof (uint16_t) / 1e6;
+    fprintf (out, "    {\"kind\": \"%s\", \"samples\": %u, \"blocks\": %u, "
+             "\"bitpacked_blocks\": %u, \"encoded_bytes\": %zu, "
+             "\"bits_per_sample\": %.3f, \"encode_mb_per_sec\": %.1f, "
+             "\"decode_mb_per_sec\": %.1f, \"round_trip\": %s}%s\n",
+             name, samples, blocks, bitpacked, used,
+             used * 8.0 / samples, megabytes / (encode_ns / 1e9),
+             megabytes / (decode_ns / 1e9), whole ? "true" : "false",
+             last ? "" : ",");
+    return whole;
+}
+
+
+/** @brief   Show how the program is used.
+ */
+static void usage (void)
+{
+    fprintf (stderr, "usage: program [--samples N] [--block N]\n"
+             "               [--input out.csv|data.bin] [--out FILE.json]\n");
+}
+
+
+/** @brief   Time the codec on each kind of readings, or on each channel of
+ *           a recording, and report on it.
+ */
+int main (int argc, char** argv)
+{
+    const char* input = NULL;
+    const char* output = NULL;
+    uint32_t samples = CODEC_DEFAULT_SAMPLES;
+    uint32_t block = CODEC_DEFAULT_BLOCK;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        bool more = arg + 1 < argc;
+        if (strcmp (argv[arg], "--samples") == 0 && more)
+        {
+            samples = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--block") == 0 && more)
+        {
+            block = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--input") == 0 && more)
+        {
+            input = argv[++arg];
+        }
+        else if (strcmp (argv[arg], "--out") == 0 && more)
+        {
+            output = argv[++arg];
+        }
+        else
+        {
+            usage ();
+            return 2;
+        }
+    }
+    if (samples == 0 || block == 0 || block > CODEC_MAX_BLOCK)
+    {
+        usage ();
+        return 2;
+    }
+
+    // A recording's channels take the place of the kinds of readings
+    std::vector<uint16_t> channels[CODEC_MAX_CHANNELS];
+    uint8_t count = 0;
+    if (input != NULL)
+    {
+        if (!read_recording (input, channels))
+        {
+            fprintf (stderr, "can't read %s\n", input);
+            return 1;
+        }
+        while (count < CODEC_MAX_CHANNELS && !channels[count].empty ())
+        {
+            count++;
+        }
+        if (count == 0)
+        {
+            fprintf (stderr, "no readings in %s\n", input);
+            return 1;
+        }
+    }
+
+    FILE* out = stdout;
+    if (output != NULL && (out = fopen (output, "w")) == NULL)
+    {
+        fprintf (stderr, "can't write %s\n", output);
+        return 1;
+    }
+    fprintf (out, "{\n  \"schema\": 1,\n  \"kind\": \"codec_bench\",\n");
+    fprintf (out, "  \"source\": \"%s\",\n", input ? input : "synthetic");
+    fprintf (out, "  \"block_size\": %u,\n", block);
+    fprintf (out, "  \"kinds\": [\n");
+    bool whole = true;
+    if (input != NULL)
+    {
+        for (uint8_t channel = 0; channel < count; channel++)
+        {
+            char name[24];
+            snprintf (name, sizeof (name), "channel_%u", channel);
+            whole = run_readings (out, name, channels[channel],
+                                  (uint16_t)block, channel == count - 1)
+                    && whole;
+        }
+    }
+    else
+    {
+        std::vector<uint16_t> readings (samples);
+        for (uint8_t kind = 0; kind < KIND_COUNT; kind++)
+        {
+            make_readings (readings, (codec_kind_t)kind);
+            whole = run_readings (out, KIND_NAMES[kind], readings,
+                                  (uint16_t)block, kind == KIND_COUNT - 1)
+                    && whole;
+        }
+    }
+    fprintf (out, "  ]\n}\n");
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+    return whole ? 0 : 1;
+}
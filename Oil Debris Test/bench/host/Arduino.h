@@ -0,0 +1,137 @@
+/** @file Arduino.h
+ *  This file stands in for the parts of the Arduino core and FreeRTOS which
+ *  the portable modules use, so that they can be built and run on a PC by
+ *  the host benchmark. The benchmark runs in one thread, so the mutexes and
+ *  critical sections do nothing, and the serial port only counts what is
+ *  written to it. Task delays move the simulated clock of @c esp_timer.h.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint32_t TickType_t;
+typedef void* SemaphoreHandle_t;
+typedef void* TaskHandle_t;
+
+#define portMAX_DELAY 0xFFFFFFFF
+
+/// Ticks are a millisecond each, as on the tester
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+/// A spinlock, which one thread never has to wait for
+struct portMUX_TYPE
+{
+    uint32_t owner;             ///< Unused
+};
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portMUX_INITIALIZE(mux) ((void)(mux))
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+/// Get the running task; the one thread stands for every task
+inline TaskHandle_t xTaskGetCurrentTaskHandle (void)
+{
+    return (TaskHandle_t)1;
+}
+
+/// Make a mutex, which one thread never has to wait for
+inline SemaphoreHandle_t xSemaphoreCreateMutex (void)
+{
+    return (SemaphoreHandle_t)1;
+}
+
+/// Take a mutex, at once
+inline int xSemaphoreTake (SemaphoreHandle_t mutex, TickType_t wait)
+{
+    return 1;
+}
+
+/// Give back a mutex
+inline int xSemaphoreGive (SemaphoreHandle_t mutex)
+{
+    return 1;
+}
+
+// Wait a number of ticks, on the simulated clock of esp_timer.h
+void vTaskDelay (TickType_t ticks);
+
+// Milliseconds and microseconds since the program started
+uint32_t millis (void);
+uint32_t micros (void);
+
+
+/** @brief   Class to which text and bytes are written, as in the Arduino
+ *           core.
+ */
+class Print
+{
+public:
+    virtual ~Print (void) { }
+
+    /// Write one byte, returning how many were taken
+    virtual size_t write (uint8_t byte) = 0;
+
+    /// Write some bytes, returning how many were taken
+    virtual size_t write (const uint8_t* data, size_t count)
+    {
+        size_t taken = 0;
+        while (count-- && write (*data++))
+        {
+            taken++;
+        }
+        return taken;
+    }
+
+    /// Write some characters, returning how many were taken
+    size_t write (const char* data, size_t count)
+    {
+        return write ((const uint8_t*)data, count);
+    }
+};
+
+
+/** @brief   Serial port which counts the bytes written to it and throws them
+ *           away, so that the benchmark's own output stays clean.
+ */
+class HardwareSerial : public Print
+{
+protected:
+    uint32_t bytes;             ///< Bytes written since the program started
+
+public:
+    HardwareSerial (void) : bytes (0) { }
+
+    using Print::write;
+
+    /// Count one byte
+    size_t write (uint8_t byte)
+    {
+        bytes++;
+        return 1;
+    }
+
+    /// Count some bytes
+    size_t write (const uint8_t* data, size_t count)
+    {
+        bytes += count;
+        return count;
+    }
+
+    /// Get the number of bytes written since the program started
+    uint32_t get_bytes (void) const { return bytes; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // _HOST_ARDUINO_H_
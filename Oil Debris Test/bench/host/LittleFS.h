@@ -0,0 +1,96 @@
+/** @file LittleFS.h
+ *  This file stands in for the LittleFS flash file system on a PC, so that
+ *  the flash log can be run by the host benchmark and the tests. The files
+ *  are kept in memory, in a few slots of fixed size, and are lost when the
+ *  program ends.
+ *
+ *  The things the log relies on behave as they do on the ESP32. Opening a
+ *  file takes memory from the heap, but reading and writing don't. What is
+ *  written to a file only becomes part of it when the file is flushed or
+ *  closed; until then, other readers of the file don't see it, and
+ *  @c power_cut() throws it away as a power failure would.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_LITTLEFS_H_
+#define _HOST_LITTLEFS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+
+/// Number of files there is room for
+const uint8_t HOST_FS_FILES = 8;
+
+/// Bytes of room in each file, a little over two full log files
+const size_t HOST_FS_FILE_BYTES = 1200 * 1024;
+
+/// The longest file name, counting its ending zero
+const uint8_t HOST_FS_NAME_SIZE = 32;
+
+
+/** @brief   Where an open file is and what has been written to it.
+ */
+struct host_handle_t
+{
+    uint8_t slot;               ///< Which slot holds the file
+    bool writing;               ///< Opened for writing rather than reading
+    size_t position;            ///< Where the next read starts
+    size_t end;                 ///< End of the file as this handle sees it
+    uint32_t mount;             ///< Mount the file was opened under
+};
+
+
+/** @brief   Class which stands for one open file, as in the ESP32's core.
+ *  @details Copies of a file share the one handle, as they do there.
+ */
+class File
+{
+protected:
+    std::shared_ptr<host_handle_t> handle;  ///< The handle, if open
+
+public:
+    File (void) { }
+    File (std::shared_ptr<host_handle_t> handle) : handle (handle) { }
+
+    size_t size (void) const;
+    bool seek (uint32_t position);
+    size_t read (uint8_t* buffer, size_t length);
+    size_t write (const uint8_t* data, size_t length);
+    void flush (void);
+    void close (void);
+
+    /// Find out whether the file is open
+    operator bool (void) const;
+};
+
+
+/** @brief   Class which stands in for the file system.
+ */
+class HostFS
+{
+public:
+    bool begin (bool format_on_fail = false);
+    void end (void);
+    bool format (void);
+    File open (const char* name, const char* mode = "r");
+    bool exists (const char* name);
+    bool remove (const char* name);
+    bool rename (const char* from, const char* to);
+
+    // Throw away what hasn't been flushed and close every file
+    void power_cut (void);
+
+    // Get the bytes which have been written to a file and flushed
+    size_t file_bytes (const char* name, const uint8_t** p_data = NULL);
+
+    // Put bytes at the end of a file, as if it had been damaged
+    bool append_raw (const char* name, const uint8_t* data, size_t length);
+};
+
+extern HostFS LittleFS;
+
+#endif // _HOST_LITTLEFS_H_
@@ -0,0 +1,29 @@
+/** @file esp_sleep.h
+ *  This file stands in for the ESP-IDF's light sleep on a PC. Sleeping
+ *  moves the simulated clock of @c esp_timer.h on to the timer wakeup, and
+ *  then on by the time the chip takes to wake up.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_ESP_SLEEP_H_
+#define _HOST_ESP_SLEEP_H_
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+
+// Set how long after the next sleep starts the timer wakes the chip
+esp_err_t esp_sleep_enable_timer_wakeup (uint64_t time_in_us);
+
+// Sleep until the timer wakes the chip
+esp_err_t esp_light_sleep_start (void);
+
+// Set how long the chip takes to wake up after the timer fires
+void host_sleep_latency (uint32_t us);
+
+#endif // _HOST_ESP_SLEEP_H_
@@ -0,0 +1,23 @@
+/** @file esp_timer.h
+ *  This file stands in for the ESP-IDF's microsecond timer on a PC. Its
+ *  clock is simulated rather than read from the PC: it moves only when the
+ *  program waits or sleeps, or says it has done some work, so that hours of
+ *  the low-power mode's schedule can be run in moments.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_ESP_TIMER_H_
+#define _HOST_ESP_TIMER_H_
+
+#include <stdint.h>
+
+// Get the simulated time in microseconds, which each reading moves on by one
+int64_t esp_timer_get_time (void);
+
+// Move the simulated clock on, as work which takes that long would
+void host_clock_advance (int64_t us);
+
+#endif // _HOST_ESP_TIMER_H_
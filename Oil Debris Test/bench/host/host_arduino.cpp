@@ -0,0 +1,36 @@
+/** @file host_arduino.cpp
+ *  This file contains the serial port and clocks which stand in for the
+ *  Arduino core's on a PC.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <chrono>
+#include "Arduino.h"
+
+/// The serial port, which counts what's written to it
+HardwareSerial Serial;
+
+/// When the program started, from which the clocks count
+static const std::chrono::steady_clock::time_point started
+    = std::chrono::steady_clock::now ();
+
+
+/** @brief   Get the time since the program started in milliseconds.
+ */
+uint32_t millis (void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::steady_clock::now () - started).count ();
+}
+
+
+/** @brief   Get the time since the program started in microseconds.
+ */
+uint32_t micros (void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>
+        (std::chrono::steady_clock::now () - started).count ();
+}
@@ -0,0 +1,28 @@
+/** @file host_channels.cpp
+ *  This file contains the tester's channel table and the shares which the
+ *  stream stage writes to, as they are in @c main.cpp, for the programs
+ *  which run the data path on a PC. A program which needs other channels
+ *  leaves this file out and has a table of its own.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include "shares.h"
+#include "host_channels.h"
+
+/// The channels, as in main.cpp
+const channel_t CHANNELS[] =
+{
+    { "fine", 36, 0 },
+    { "coarse", 39, 1 }
+};
+const uint8_t CHANNEL_COUNT = HOST_CHANNEL_COUNT;
+static_assert (sizeof (CHANNELS) / sizeof (CHANNELS[0]) == HOST_CHANNEL_COUNT,
+               "HOST_CHANNEL_COUNT must match the table");
+
+/// Shares which the stream stage puts the latest voltages into
+Share<uint16_t> v_fine ("Fine");
+Share<uint16_t> v_coarse ("Coarse");
@@ -0,0 +1,20 @@
+/** @file host_channels.h
+ *  This file contains the number of channels in the tester's table, as
+ *  @c host_channels.cpp has it, so that the programs which run on a PC can
+ *  size their pipelines with it at compile time as @c main.cpp does.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_CHANNELS_H_
+#define _HOST_CHANNELS_H_
+
+#include <stdint.h>
+#include "channels.h"
+
+/// Number of channels in the table, the fine and coarse sensors
+const uint8_t HOST_CHANNEL_COUNT = 2;
+
+#endif // _HOST_CHANNELS_H_
@@ -0,0 +1,75 @@
+/** @file host_clock.cpp
+ *  This file contains the simulated clock of the microsecond timer, the
+ *  task delay and light sleep which stand in for the ESP-IDF's on a PC.
+ *  Reading the clock takes a microsecond, so a loop which spins on it, as
+ *  the low-power mode does after waking early, gets to its time.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "Arduino.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+
+/// The simulated time in microseconds
+static int64_t clock_us = 0;
+
+/// How long after going to sleep the timer wakes the chip
+static uint64_t wakeup_us = 0;
+
+/// How long the chip takes to wake up once the timer fires
+static uint32_t latency_us = 0;
+
+
+/** @brief   Get the simulated time, moving it on by the microsecond the
+ *           reading takes.
+ */
+int64_t esp_timer_get_time (void)
+{
+    return clock_us++;
+}
+
+
+/** @brief   Move the simulated clock on.
+ *  @param   us How many microseconds to move it by
+ */
+void host_clock_advance (int64_t us)
+{
+    clock_us += us;
+}
+
+
+/** @brief   Wait a number of ticks, which are a millisecond each.
+ */
+void vTaskDelay (TickType_t ticks)
+{
+    clock_us += (int64_t)ticks * 1000;
+}
+
+
+/** @brief   Set how long after the next sleep starts the chip is woken.
+ */
+esp_err_t esp_sleep_enable_timer_wakeup (uint64_t time_in_us)
+{
+    wakeup_us = time_in_us;
+    return ESP_OK;
+}
+
+
+/** @brief   Sleep until the timer wakes the chip, and then until it's awake.
+ */
+esp_err_t esp_light_sleep_start (void)
+{
+    clock_us += (int64_t)(wakeup_us + latency_us);
+    return ESP_OK;
+}
+
+
+/** @brief   Set how long the chip takes to wake up after the timer fires.
+ */
+void host_sleep_latency (uint32_t us)
+{
+    latency_us = us;
+}
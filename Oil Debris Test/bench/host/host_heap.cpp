@@ -0,0 +1,67 @@
+/** @file host_heap.cpp
+ *  This file contains @c new and @c delete for a PC, which take their memory
+ *  from @c malloc(). The C++ library's own @c new calls a @c malloc() which
+ *  the linker's @c --wrap options can't reach, so without these the heap
+ *  guard in @c mem_pool.cpp wouldn't see what @c new takes, as it does on
+ *  the ESP32.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdlib.h>
+#include <new>
+
+
+/** @brief   Stand-in for @c new which takes its memory from @c malloc().
+ */
+void* operator new (size_t size)
+{
+    void* p_memory = malloc (size ? size : 1);
+    if (p_memory == NULL)
+    {
+        throw std::bad_alloc ();
+    }
+    return p_memory;
+}
+
+
+/** @brief   Stand-in for @c new[] which goes with the @c new above.
+ */
+void* operator new[] (size_t size)
+{
+    return operator new (size);
+}
+
+
+/** @brief   Stand-in for @c delete which goes with the @c new above.
+ */
+void operator delete (void* p_memory) noexcept
+{
+    free (p_memory);
+}
+
+
+/** @brief   Stand-in for sized @c delete which goes with the @c new above.
+ */
+void operator delete (void* p_memory, size_t size) noexcept
+{
+    free (p_memory);
+}
+
+
+/** @brief   Stand-in for @c delete[] which goes with the @c new above.
+ */
+void operator delete[] (void* p_memory) noexcept
+{
+    free (p_memory);
+}
+
+
+/** @brief   Stand-in for sized @c delete[] which goes with the @c new above.
+ */
+void operator delete[] (void* p_memory, size_t size) noexcept
+{
+    free (p_memory);
+}
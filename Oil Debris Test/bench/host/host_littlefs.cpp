@@ -0,0 +1,309 @@
+/** @file host_littlefs.cpp
+ *  This file contains the in-memory file system which stands in for
+ *  LittleFS on a PC.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include "LittleFS.h"
+
+/// The file system, as the ESP32's core names it
+HostFS LittleFS;
+
+/** @brief   What is kept about each file.
+ */
+struct host_file_t
+{
+    bool used;                          ///< The slot holds a file
+    char name[HOST_FS_NAME_SIZE];       ///< The file's name
+    size_t size;                        ///< Bytes flushed to the file
+};
+
+/// The files, and the bytes in each
+static host_file_t files[HOST_FS_FILES];
+static uint8_t contents[HOST_FS_FILES][HOST_FS_FILE_BYTES];
+
+/// Set while the file system is mounted
+static bool mounted = false;
+
+/// Counts power cuts; handles opened before the latest one are dead
+static uint32_t mount_count = 0;
+
+
+/** @brief   Find the slot which holds a file.
+ *  @returns The slot, or @c HOST_FS_FILES if there's no such file
+ */
+static uint8_t find (const char* name)
+{
+    uint8_t slot = 0;
+    while (slot < HOST_FS_FILES
+           && !(files[slot].used && strcmp (files[slot].name, name) == 0))
+    {
+        slot++;
+    }
+    return slot;
+}
+
+
+/** @brief   Make an empty file.
+ *  @returns Its slot, or @c HOST_FS_FILES if there's no room or the name
+ *           is too long
+ */
+static uint8_t create (const char* name)
+{
+    uint8_t slot = 0;
+    while (slot < HOST_FS_FILES && files[slot].used)
+    {
+        slot++;
+    }
+    if (slot == HOST_FS_FILES || strlen (name) >= HOST_FS_NAME_SIZE)
+    {
+        return HOST_FS_FILES;
+    }
+    files[slot].used = true;
+    strcpy (files[slot].name, name);
+    files[slot].size = 0;
+    return slot;
+}
+
+
+/** @brief   Get the file's size; a file open for writing includes what has
+ *           been written to it and not yet flushed.
+ */
+size_t File::size (void) const
+{
+    if (!*this)
+    {
+        return 0;
+    }
+    return handle->writing ? handle->end : files[handle->slot].size;
+}
+
+
+/** @brief   Move to a place in a file open for reading.
+ *  @returns @c true if the place is within the file
+ */
+bool File::seek (uint32_t position)
+{
+    if (!*this || position > size ())
+    {
+        return false;
+    }
+    handle->position = position;
+    return true;
+}
+
+
+/** @brief   Read bytes from where the last read ended.
+ *  @returns The number of bytes read
+ */
+size_t File::read (uint8_t* buffer, size_t length)
+{
+    if (!*this)
+    {
+        return 0;
+    }
+    size_t left = size () - handle->position;
+    length = (length < left) ? length : left;
+    memcpy (buffer, contents[handle->slot] + handle->position, length);
+    handle->position += length;
+    return length;
+}
+
+
+/** @brief   Write bytes to the end of a file open for writing.
+ *  @returns The number of bytes written, which is fewer than asked for if
+ *           the file is full
+ */
+size_t File::write (const uint8_t* data, size_t length)
+{
+    if (!*this || !handle->writing)
+    {
+        return 0;
+    }
+    size_t left = HOST_FS_FILE_BYTES - handle->end;
+    length = (length < left) ? length : left;
+    memcpy (contents[handle->slot] + handle->end, data, length);
+    handle->end += length;
+    return length;
+}
+
+
+/** @brief   Make what has been written part of the file.
+ */
+void File::flush (void)
+{
+    if (*this && handle->writing && files[handle->slot].used)
+    {
+        files[handle->slot].size = handle->end;
+    }
+}
+
+
+/** @brief   Flush and close the file; closing one which isn't open does
+ *           nothing.
+ */
+void File::close (void)
+{
+    flush ();
+    handle.reset ();
+}
+
+
+/** @brief   Find out whether the file is open, and wasn't closed by a power
+ *           cut.
+ */
+File::operator bool (void) const
+{
+    return handle && handle->mount == mount_count;
+}
+
+
+/** @brief   Mount the file system; it's always there to be mounted.
+ */
+bool HostFS::begin (bool format_on_fail)
+{
+    mounted = true;
+    return true;
+}
+
+
+/** @brief   Unmount the file system.
+ */
+void HostFS::end (void)
+{
+    mounted = false;
+}
+
+
+/** @brief   Remove every file.
+ */
+bool HostFS::format (void)
+{
+    memset (files, 0, sizeof (files));
+    mount_count++;
+    return true;
+}
+
+
+/** @brief   Open a file.
+ *  @details Mode @c "r" reads from the start, @c "a" writes after the end
+ *           and @c "w" writes over the whole file; the last two make the
+ *           file if it isn't there. The handle is taken from the heap.
+ *  @returns The file, which is false if it couldn't be opened
+ */
+File HostFS::open (const char* name, const char* mode)
+{
+    if (!mounted)
+    {
+        return File ();
+    }
+    uint8_t slot = find (name);
+    bool writing = (mode[0] == 'a' || mode[0] == 'w');
+    if (slot == HOST_FS_FILES && writing)
+    {
+        slot = create (name);
+    }
+    if (slot == HOST_FS_FILES)
+    {
+        return File ();
+    }
+
+    std::shared_ptr<host_handle_t> handle (new host_handle_t);
+    handle->slot = slot;
+    handle->writing = writing;
+    handle->position = 0;
+    handle->end = (mode[0] == 'w') ? 0 : files[slot].size;
+    handle->mount = mount_count;
+    return File (handle);
+}
+
+
+/** @brief   Find out whether a file is there.
+ */
+bool HostFS::exists (const char* name)
+{
+    return find (name) < HOST_FS_FILES;
+}
+
+
+/** @brief   Remove a file.
+ *  @returns @c true if it was there
+ */
+bool HostFS::remove (const char* name)
+{
+    uint8_t slot = find (name);
+    if (slot == HOST_FS_FILES)
+    {
+        return false;
+    }
+    files[slot].used = false;
+    return true;
+}
+
+
+/** @brief   Give a file a new name, replacing any file which has that name.
+ *  @returns @c true if the file was there
+ */
+bool HostFS::rename (const char* from, const char* to)
+{
+    uint8_t slot = find (from);
+    if (slot == HOST_FS_FILES || strlen (to) >= HOST_FS_NAME_SIZE)
+    {
+        return false;
+    }
+    remove (to);
+    strcpy (files[slot].name, to);
+    return true;
+}
+
+
+/** @brief   Throw away what hasn't been flushed and close every file, as a
+ *           power failure would; the file system must then be mounted
+ *           again.
+ */
+void HostFS::power_cut (void)
+{
+    mount_count++;
+    mounted = false;
+}
+
+
+/** @brief   Get the bytes which have been written to a file and flushed.
+ *  @param   name The file's name
+ *  @param   p_data Set to point to the bytes, if not @c NULL
+ *  @returns The number of bytes, or zero if there's no such file
+ */
+size_t HostFS::file_bytes (const char* name, const uint8_t** p_data)
+{
+    uint8_t slot = find (name);
+    if (slot == HOST_FS_FILES)
+    {
+        return 0;
+    }
+    if (p_data != NULL)
+    {
+        *p_data = contents[slot];
+    }
+    return files[slot].size;
+}
+
+
+/** @brief   Put bytes straight onto the end of a file, as if something other
+ *           than the log had written them or a write had been cut short.
+ *  @returns @c true if the file was there and had room
+ */
+bool HostFS::append_raw (const char* name, const uint8_t* data, size_t length)
+{
+    uint8_t slot = find (name);
+    if (slot == HOST_FS_FILES || files[slot].size + length > HOST_FS_FILE_BYTES)
+    {
+        return false;
+    }
+    memcpy (contents[slot] + files[slot].size, data, length);
+    files[slot].size += length;
+    return true;
+}
@@ -0,0 +1,13 @@
+/** @file taskqueue.h
+ *  This file stands in for the ME507 support library's queues on a PC. The
+ *  portable modules include it through @c shares.h but use no queues.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_TASKQUEUE_H_
+#define _HOST_TASKQUEUE_H_
+
+#endif // _HOST_TASKQUEUE_H_
@@ -0,0 +1,32 @@
+/** @file taskshare.h
+ *  This file stands in for the ME507 support library's shares on a PC,
+ *  where the host benchmark runs everything in one thread.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HOST_TASKSHARE_H_
+#define _HOST_TASKSHARE_H_
+
+/** @brief   A value which one task puts and others get.
+ */
+template <class DataType>
+class Share
+{
+protected:
+    DataType value;             ///< The latest value put
+
+public:
+    /// Create a share holding nothing in particular
+    Share (const char* name = "") : value () { }
+
+    /// Put a value into the share
+    void put (DataType data) { value = data; }
+
+    /// Get the latest value put into the share
+    DataType get (void) { return value; }
+};
+
+#endif // _HOST_TASKSHARE_H_
@@ -0,0 +1,220 @@
+/** @file pipeline_bench.cpp
+ *  This file contains a benchmark of a few instantiations of the
+ *  compile-time pipeline on a PC: the tester's two channels and blocks of
+ *  50 with the whole chain of @c main.cpp, without the store stage and with
+ *  the filter alone, and wider pipelines of four channels by 100 and eight
+ *  by the largest block. For each one it gives the bytes the pipeline takes
+ *  and the time to put a scan's readings and run them through the chain.
+ *
+ *  The bytes are those of the pipeline object, which holds both blocks'
+ *  readings and times; the stages' states are the same in every
+ *  instantiation. The code is mostly shared: @c put() and @c process() are
+ *  those of @c SamplePipeline, so each instantiation only adds its
+ *  @c run_chain(), into which its stages' calls are inlined. Its size is
+ *  shown by
+ *      nm -S -C --size-sort .pio/build/pipeline_bench/program | grep run_chain
+ *
+ *  The readings come from the synthetic signal generator, for the channels
+ *  of @c bench_channels.cpp, and are all made before the clock starts. The
+ *  results are written as JSON, as those of @c replay_bench.cpp are.
+ *
+ *  Usage, after @c pio @c run @c -e @c pipeline_bench:
+ *      .pio/build/pipeline_bench/program [--samples N] [--out FILE]
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <Arduino.h>
+#include "sample_log.h"
+#include "sample_pipeline.h"
+#include "pipeline_stages.h"
+#include "voltage_history.h"
+#include "bench_channels.h"
+
+// The settings are those of main.cpp
+const uint16_t SAMPLE_PERIOD_MS = 10;
+const uint16_t DETECT_THRESHOLD = 40;
+const uint8_t FILTER_SHIFT = 2;
+
+/// Readings per channel run when none are asked for
+const uint32_t BENCH_DEFAULT_SAMPLES = 200000;
+
+/// Every channel's readings, a scan's channels together, and their times
+static std::vector<uint16_t> counts;
+static uint16_t offsets[BENCH_CHANNEL_COUNT];
+
+/// States of the stages, set up afresh for each pipeline
+static align_state_t align_state;
+static filter_state_t filter_state;
+static detect_state_t detect_state;
+
+/// The chain of main.cpp, that chain without the store stage, and the
+/// filter alone
+typedef StageChain<stage_align, stage_filter, stage_detect, stage_store,
+                   stage_stream> full_chain_t;
+typedef StageChain<stage_align, stage_filter, stage_detect,
+                   stage_stream> no_store_chain_t;
+typedef StageChain<stage_filter> filter_chain_t;
+
+/// Contexts of the stages in each chain
+static void* const FULL_CONTEXTS[] =
+{
+    &align_state, &filter_state, &detect_state, NULL, NULL
+};
+static void* const NO_STORE_CONTEXTS[] =
+{
+    &align_state, &filter_state, &detect_state, NULL
+};
+static void* const FILTER_CONTEXTS[] = { &filter_state };
+
+/// Where the benchmark puts results, so the compiler can't leave out work
+static volatile uint32_t bench_sink;
+
+
+/** @brief   Get the time in nanoseconds from a steady clock.
+ */
+static inline uint64_t now_ns (void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+
+/** @brief   Set the stages' states as @c main.cpp sets them at start-up.
+ */
+static void reset_states (void)
+{
+    align_state = { SAMPLE_PERIOD_MS * 1000, false, {} };
+    filter_state = { FILTER_SHIFT, false, {} };
+    detect_state = { DETECT_THRESHOLD, SAMPLE_PERIOD_MS, {} };
+}
+
+
+/** @brief   Run the readings through one instantiation of the pipeline and
+ *           write its size and speed as a JSON object.
+ *  @tparam  COUNT The number of channels
+ *  @tparam  BLOCK The number of samples per channel in a block
+ *  @tparam  CHAIN The stages run on each block
+ *  @param   out Where the JSON goes
+ *  @param   name What the instantiation is called in the results
+ *  @param   contexts The stages' contexts, in the order of the chain
+ *  @param   samples The number of readings of each channel
+ *  @param   last Whether it's the last item, which takes no comma
+ */
+template <uint8_t COUNT, uint16_t BLOCK, typename CHAIN>
+static void run_pipeline (FILE* out, const char* name,
+                          void* const (&contexts)[CHAIN::COUNT],
+                          uint32_t samples, bool last)
+{
+    reset_states ();
+    static StaticPipeline<COUNT, BLOCK, CHAIN> pipeline (contexts);
+
+    uint64_t start = now_ns ();
+    for (uint32_t scan = 0; scan < samples; scan++)
+    {
+        pipeline.put (scan * SAMPLE_PERIOD_MS,
+                      &counts[scan * BENCH_CHANNEL_COUNT], offsets);
+        if ((scan + 1) % BLOCK == 0)
+        {
+            pipeline.process ();
+        }
+    }
+    pipeline.flush ();
+    pipeline.process ();
+    uint64_t took = now_ns () - start;
+
+    pipeline_stats_t stats = pipeline.stats ();
+    bench_sink = stats.blocks_processed;
+    fprintf (out, "    {\"pipeline\": \"%s\", \"channels\": %u, "
+             "\"block_size\": %u, \"stages\": %u, \"pipeline_bytes\": %zu, "
+             "\"ns_per_sample\": %.1f, \"blocks\": %u, \"dropped\": %u}%s\n",
+             name, COUNT, BLOCK, CHAIN::COUNT, sizeof (pipeline),
+             (double)took / samples, stats.blocks_processed,
+             stats.samples_dropped, last ? "" : ",");
+}
+
+
+/** @brief   Show how the program is used.
+ */
+static void usage (void)
+{
+    fprintf (stderr, "usage: program [--samples N] [--out FILE.json]\n");
+}
+
+
+/** @brief   Time each instantiation of the pipeline and report on it.
+ */
+int main (int argc, char** argv)
+{
+    const char* output = NULL;
+    uint32_t samples = BENCH_DEFAULT_SAMPLES;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        bool more = arg + 1 < argc;
+        if (strcmp (argv[arg], "--samples") == 0 && more)
+        {
+            samples = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--out") == 0 && more)
+        {
+            output = argv[++arg];
+        }
+        else
+        {
+            usage ();
+            return 2;
+        }
+    }
+    if (samples == 0)
+    {
+        usage ();
+        return 2;
+    }
+
+    // Everything is made before the clock starts
+    bench_make_readings (counts, offsets, samples, SAMPLE_PERIOD_MS);
+    history_init ();
+    events_init ();
+    sample_log_init ();
+    if (!sample_log_mount ())
+    {
+        fprintf (stderr, "can't mount the log\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (output != NULL && (out = fopen (output, "w")) == NULL)
+    {
+        fprintf (stderr, "can't write %s\n", output);
+        return 1;
+    }
+    fprintf (out, "{\n  \"schema\": 1,\n  \"kind\": \"pipeline_bench\",\n");
+    fprintf (out, "  \"samples\": %u,\n", samples);
+    fprintf (out, "  \"pipelines\": [\n");
+    run_pipeline<2, 50, full_chain_t> (out, "2x50 full chain",
+                                       FULL_CONTEXTS, samples, false);
+    run_pipeline<2, 50, no_store_chain_t> (out, "2x50 without store",
+                                           NO_STORE_CONTEXTS, samples,
+                                           false);
+    run_pipeline<2, 50, filter_chain_t> (out, "2x50 filter only",
+                                         FILTER_CONTEXTS, samples, false);
+    run_pipeline<4, 100, full_chain_t> (out, "4x100 full chain",
+                                        FULL_CONTEXTS, samples, false);
+    run_pipeline<8, PIPELINE_MAX_BLOCK, full_chain_t> (out,
+                                                       "8x256 full chain",
+                                                       FULL_CONTEXTS,
+                                                       samples, true);
+    fprintf (out, "  ]\n}\n");
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+    return 0;
+}
@@ -0,0 +1,991 @@
+/** @file replay_bench.cpp
+ *  This file contains a benchmark which runs the tester's whole data path
+ *  on a PC as fast as it will go: readings are taken by the same schedule,
+ *  pass through the same pipeline and stages, are stored as the same log
+ *  records and are rendered as the same @c /csv and @c /api/samples pages.
+ *  The readings come from a recording made by @c tools/data_download.py or
+ *  from the synthetic signal generator in @c signal_gen.h.
+ *
+ *  The results are written as JSON, so that runs can be kept and compared:
+ *  samples per second, the spread of the time each stage takes per block,
+ *  the number of heap allocations made while running, and counts and a
+ *  checksum of everything produced. Two runs over the same readings give
+ *  the same checksum unless the output has changed. The rows per second of
+ *  @c /csv and the bytes and time of each @c /api/samples response are
+ *  given too, and the fixed-point formatter is timed against @c snprintf()
+ *  on rows of voltages. The bits each row of the voltage history takes in
+ *  its Gorilla blocks show how well the readings replayed compress. With
+ *  the synthetic signal, the events found are compared with the
+ *  generator's labels to give the detector's precision and recall on each
+ *  channel.
+ *
+ *  Usage, after @c pio @c run @c -e @c native:
+ *      .pio/build/native/program [--input out.csv] [--samples N]
+ *                                [--render-every BLOCKS] [--out FILE]
+ *                                [--seed N] [--rate PER_S]
+ *                                [--sizes fixed|uniform|power]
+ *                                [--serve PORT]
+ *
+ *  With @c --serve, the pages are then served on a TCP port as the tester
+ *  serves them, with the history the replay left behind, so that
+ *  @c tools/http_load.py can measure the web server's side of the data
+ *  path; @c /stats gives each route's times.
+ *
+ *  The tester runs sampling and processing in two tasks; here they take
+ *  turns in one thread, a block at a time, so that no readings are dropped
+ *  and every stage's time is its own. The log is the tester's own, kept in
+ *  the in-memory file system of @c host/LittleFS.h; after each block the
+ *  new records are read back from it as a client of @c /sync would, which
+ *  is how the events found are counted. Heap use is counted by the heap
+ *  guard of @c mem_pool.h, leaving out what the benchmark itself uses; the
+ *  data path should only use the heap to open a new log file when one
+ *  fills.
+ *
+ *  The unit tests in @c test/ are built with the same files, less this one,
+ *  which is a program of its own.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <Arduino.h>
+#include "shares.h"
+#include "sample_log.h"
+#include "mem_pool.h"
+#include "sample_pipeline.h"
+#include "pipeline_stages.h"
+#include "sample_schedule.h"
+#include "voltage_history.h"
+#include "gorilla.h"
+#include "history_json.h"
+#include "json_writer.h"
+#include "fixed_format.h"
+#include "host_channels.h"
+#include "signal_gen.h"
+#include "route_stats.h"
+#include "bench_server.h"
+
+#ifndef PIO_UNIT_TESTING
+
+// The block size and settings are those of main.cpp; so are the channels,
+// which are in host/host_channels.cpp
+const uint16_t SAMPLE_PERIOD_MS = 10;
+const uint16_t BLOCK_SIZE = 50;
+const uint16_t DETECT_THRESHOLD = 40;
+const uint8_t FILTER_SHIFT = 2;
+const uint8_t CSV_ROWS = 20;
+const size_t RESPONSE_BUFFER_SIZE = RESPONSE_CHUNK_SIZE;
+
+/// Readings per channel replayed when none are asked for
+const uint32_t BENCH_DEFAULT_SAMPLES = 1000000;
+
+/// Blocks between renderings of the pages, as if a dashboard were polling
+const uint32_t BENCH_DEFAULT_RENDER_EVERY = 100;
+
+/// Microseconds the simulated ADC takes for each conversion
+const uint32_t BENCH_CONVERSION_US = 10;
+
+/// Rows of voltages formatted to time the number formatting
+const uint32_t BENCH_FORMAT_ROWS = 1000000;
+
+/// Samples by which a detected event may miss its particle's pulse, which
+/// allows for the filter's delay
+const uint16_t BENCH_MATCH_SAMPLES = 4;
+
+/// Names of the things timed, in the order of @c timed_t
+static const char* const TIMED_NAMES[] =
+{
+    "acquire", "align", "filter", "detect", "store", "stream",
+    "render_csv", "render_json"
+};
+
+/// Things timed; the stages are numbered as in the chain
+enum timed_t : uint8_t
+{
+    TIME_ACQUIRE, TIME_ALIGN, TIME_FILTER, TIME_DETECT, TIME_STORE,
+    TIME_STREAM, TIME_RENDER_CSV, TIME_RENDER_JSON, TIMED_COUNT
+};
+
+/// The time each thing took, in nanoseconds, once for each block
+static std::vector<uint32_t> times[TIMED_COUNT];
+
+/// Heap allocations which the benchmark itself made while running
+static uint32_t own_allocations = 0;
+
+/// Records read back from the log, their bytes, and their FNV-1a checksum
+static uint32_t log_records = 0;
+static uint64_t log_bytes = 0;
+static uint64_t log_checksum = 0xCBF29CE484222325ULL;
+
+/// Sequence number of the last record read back from the log
+static uint32_t log_last_seq = 0;
+
+/// Every particle the generator made, and every event the detector found
+static std::vector<signal_label_t> labels;
+static std::vector<debris_event_t> detections;
+
+/// The response buffer and room for a copy of the history, for the pages
+static char buffer[RESPONSE_BUFFER_SIZE];
+static uint8_t snapshot[2 * HISTORY_BLOCK_SIZE];
+
+/// Room for records read back from the log
+static std::vector<uint8_t> records;
+
+/// Where the benchmark puts results, so the compiler can't leave out work
+static volatile uint32_t bench_sink;
+
+
+/** @brief   Get the time in nanoseconds from a steady clock.
+ */
+static inline uint64_t now_ns (void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+
+/** @brief   Run one stage and note how long it took.
+ *  @tparam  STAGE The stage
+ *  @tparam  INDEX Where its times are kept in @c times
+ */
+template <pipeline_stage_t STAGE, uint8_t INDEX>
+void timed (sample_block_t& block, void* p_context)
+{
+    uint64_t start = now_ns ();
+    STAGE (block, p_context);
+    times[INDEX].push_back ((uint32_t)(now_ns () - start));
+}
+
+/// The chain of main.cpp, with each stage timed
+typedef StageChain<timed<stage_align, TIME_ALIGN>,
+                   timed<stage_filter, TIME_FILTER>,
+                   timed<stage_detect, TIME_DETECT>,
+                   timed<stage_store, TIME_STORE>,
+                   timed<stage_stream, TIME_STREAM> > bench_chain_t;
+
+/// States of the stages, set up as in main.cpp
+static align_state_t align_state = { SAMPLE_PERIOD_MS * 1000, false, {} };
+static filter_state_t filter_state = { FILTER_SHIFT, false, {} };
+static detect_state_t detect_state = { DETECT_THRESHOLD, SAMPLE_PERIOD_MS,
+                                       {} };
+
+/// Context of each stage, in the order of the chain
+static void* const STAGE_CONTEXTS[] =
+{
+    &align_state, &filter_state, &detect_state, NULL, NULL
+};
+
+/// The pipeline, which is large, so it isn't kept on the stack
+static StaticPipeline<HOST_CHANNEL_COUNT, BLOCK_SIZE, bench_chain_t>
+    pipeline (STAGE_CONTEXTS);
+
+
+/** @brief   Where the readings are replayed from.
+ */
+struct replay_t
+{
+    SignalGenerator* p_signal;      ///< The generator, if there's no file
+    std::vector<uint16_t> counts;   ///< Readings, a scan's channels together
+    uint32_t scans;                 ///< Scans in @c counts
+    uint32_t next;                  ///< Scan which is being read
+    uint32_t clock_us;              ///< Time of the simulated ADC
+};
+
+
+/** @brief   Read a recording written by @c tools/data_download.py.
+ *  @details Each line holds a time and then each channel's voltage; lines
+ *           which don't start with a number are skipped, and an empty field
+ *           keeps the channel's last reading. Voltages are turned back into
+ *           counts with the full scale in @c fixed_format.h.
+ *  @param   replay Where the readings are put
+ *  @param   path The file's name
+ *  @returns @c true if at least one reading was found
+ */
+static bool read_recording (replay_t& replay, const char* path)
+{
+    FILE* file = fopen (path, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char line[256];
+    uint16_t last[PIPELINE_MAX_CHANNELS] = {};
+    while (fgets (line, sizeof (line), file))
+    {
+        char* field = line;
+        strtod (field, &field);
+        if (field == line)
+        {
+            continue;
+        }
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            field = strchr (field, ',');
+            if (field == NULL)
+            {
+                break;
+            }
+            char* end;
+            double volts = strtod (++field, &end);
+            if (end != field && volts >= 0)
+            {
+                double counts = volts * 1000 * ADC_MAX_COUNTS / FULL_SCALE_MV;
+                last[channel] = (counts > ADC_MAX_COUNTS) ? ADC_MAX_COUNTS
+                                : (uint16_t)(counts + 0.5);
+            }
+            replay.counts.push_back (last[channel]);
+        }
+        while (replay.counts.size () % CHANNEL_COUNT)
+        {
+            replay.counts.push_back (0);
+        }
+    }
+    fclose (file);
+    replay.scans = replay.counts.size () / CHANNEL_COUNT;
+    return replay.scans > 0;
+}
+
+
+/** @brief   Give the schedule the next reading of a channel, as the ADC
+ *           would; the recording starts again when it runs out.
+ */
+static uint16_t replay_read (uint8_t channel, void* p_context)
+{
+    replay_t& replay = *(replay_t*)p_context;
+    replay.clock_us += BENCH_CONVERSION_US;
+    if (replay.p_signal != NULL)
+    {
+        return replay.p_signal->read (channel, replay.clock_us);
+    }
+    return replay.counts[replay.next * CHANNEL_COUNT + channel];
+}
+
+
+/// The replay being read, for @c replay_clock()
+static replay_t* p_clock_replay = NULL;
+
+
+/** @brief   Give the schedule the time of the simulated ADC.
+ */
+static uint32_t replay_clock (void)
+{
+    return p_clock_replay->clock_us;
+}
+
+
+/** @brief   Class which counts the bytes of a page and throws them away.
+ */
+class NullClient : public Print
+{
+public:
+    uint32_t bytes;             ///< Bytes written
+
+    NullClient (void) : bytes (0) { }
+
+    using Print::write;
+
+    /// Count one byte
+    size_t write (uint8_t byte)
+    {
+        bytes++;
+        return 1;
+    }
+
+    /// Count some bytes
+    size_t write (const uint8_t* data, size_t count)
+    {
+        bytes += count;
+        return count;
+    }
+};
+
+
+/** @brief   Render the @c /csv page as the web server does.
+ *  @param   client Where the page goes
+ *  @param   buffer The response buffer
+ */
+static void render_csv (Print& client, char* buffer)
+{
+    ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "text/plain");
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+    {
+        page.write (channel ? ", " : "");
+        page.write (CHANNELS[channel].name);
+        page.write (" Voltage");
+    }
+    page.write ("\n");
+    for (uint8_t index = 0; index < CSV_ROWS; index++)
+    {
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            page.write (channel ? "," : "");
+            page.write_fixed (channel_millivolts (channel), 3);
+        }
+        page.write ("\n");
+    }
+    page.end ();
+}
+
+
+/** @brief   Render the @c /api/samples page as the web server does.
+ *  @param   client Where the page goes
+ *  @param   buffer The response buffer
+ *  @param   snapshot Room for a copy of the voltage history
+ *  @param   max The most rows sent, the newest ones
+ */
+static void render_json (Print& client, char* buffer, uint8_t* snapshot,
+                         uint32_t max)
+{
+    ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+    size_t length = history_snapshot (snapshot, 2 * HISTORY_BLOCK_SIZE);
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("schema", JSON_SCHEMA_VERSION);
+    json.member_string ("kind", "samples");
+    json.member_uint ("uptime_ms", millis ());
+    history_write_json (json, snapshot, length, max);
+    json.end_object ();
+    page.end ();
+}
+
+
+/** @brief   Serve a page of links to the other routes.
+ */
+static void serve_root (Print& client, const char* query)
+{
+    ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "text/html");
+    page.write ("<html><body><h1>Replay bench</h1><ul>"
+                "<li><a href=\"/csv\">/csv</a></li>"
+                "<li><a href=\"/api/samples?max=100\">/api/samples</a></li>"
+                "<li><a href=\"/api/status\">/api/status</a></li>"
+                "<li><a href=\"/stats\">/stats</a></li>"
+                "</ul></body></html>\n");
+    page.end ();
+}
+
+
+/** @brief   Serve the @c /csv page.
+ */
+static void serve_csv (Print& client, const char* query)
+{
+    render_csv (client, buffer);
+}
+
+
+/** @brief   Serve the @c /api/samples page, with its optional @c max,
+ *           answering 400 as the tester does if it isn't a number of rows.
+ */
+static void serve_samples (Print& client, const char* query)
+{
+    char value[12];
+    uint32_t max = 0xFFFFFFFF;
+    if (bench_query_arg (query, "max", value, sizeof (value)))
+    {
+        char* end;
+        unsigned long number = strtoul (value, &end, 10);
+        if (end == value || *end != '\0' || *value == '-'
+            || number > 0xFFFFFFFFUL)
+        {
+            ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+            page.begin (400, "text/plain");
+            page.write ("max: not a number of rows");
+            page.end ();
+            return;
+        }
+        max = (uint32_t)number;
+    }
+    render_json (client, buffer, snapshot, max);
+}
+
+
+/** @brief   Serve a short status page, like the tester's @c /api/status.
+ */
+static void serve_status (Print& client, const char* query)
+{
+    ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("schema", JSON_SCHEMA_VERSION);
+    json.member_string ("kind", "status");
+    json.member_uint ("uptime_ms", millis ());
+    json.member_uint ("events", events_total ());
+    json.member_uint ("log_records", log_records);
+    json.end_object ();
+    page.end ();
+}
+
+
+/** @brief   Serve each route's times, as the tester's @c /stats does.
+ */
+static void serve_stats (Print& client, const char* query)
+{
+    char value[4];
+    ResponseWriter page (client, buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("schema", JSON_SCHEMA_VERSION);
+    json.member_string ("kind", "stats");
+    json.member_uint ("uptime_ms", millis ());
+    stats_write_json (json, bench_query_arg (query, "buckets", value,
+                                             sizeof (value))
+                            && strcmp (value, "1") == 0);
+    json.end_object ();
+    page.end ();
+
+    if (bench_query_arg (query, "reset", value, sizeof (value))
+        && strcmp (value, "1") == 0)
+    {
+        stats_reset ();
+    }
+}
+
+
+/// The routes served with @c --serve
+static const bench_route_t ROUTES[] =
+{
+    { "/", serve_root },
+    { "/csv", serve_csv },
+    { "/api/samples", serve_samples },
+    { "/api/status", serve_status },
+    { "/stats", serve_stats }
+};
+
+
+/** @brief   Write the spread of one thing's times as a JSON object.
+ *  @param   out Where the JSON goes
+ *  @param   index Which thing
+ *  @param   last Whether it's the last member, which takes no comma
+ */
+static void write_times (FILE* out, uint8_t index, bool last)
+{
+    std::vector<uint32_t>& list = times[index];
+    uint64_t total = 0;
+    for (size_t item = 0; item < list.size (); item++)
+    {
+        total += list[item];
+    }
+    std::sort (list.begin (), list.end ());
+    size_t count = list.size ();
+    const double PERCENTS[] = { 50, 90, 99, 99.9 };
+    const char* const NAMES[] = { "p50", "p90", "p99", "p999" };
+
+    fprintf (out, "    \"%s\": {\"count\": %zu, \"mean_ns\": %llu",
+             TIMED_NAMES[index], count,
+             (unsigned long long)(count ? total / count : 0));
+    for (uint8_t rank = 0; rank < 4; rank++)
+    {
+        size_t at = (size_t)(PERCENTS[rank] / 100 * count);
+        fprintf (out, ", \"%s_ns\": %u", NAMES[rank],
+                 count ? list[(at < count) ? at : count - 1] : 0);
+    }
+    fprintf (out, ", \"max_ns\": %u}%s\n", count ? list[count - 1] : 0,
+             last ? "" : ",");
+}
+
+
+/** @brief   Add up the times taken by one of the things timed.
+ *  @param   index Where its times are kept in @c times
+ *  @returns The total time in nanoseconds
+ */
+static uint64_t total_ns (uint8_t index)
+{
+    uint64_t total = 0;
+    for (size_t item = 0; item < times[index].size (); item++)
+    {
+        total += times[index][item];
+    }
+    return total;
+}
+
+
+/** @brief   Write how fast the pages were rendered: rows of @c /csv, made
+ *           with the fixed-point formatter, and bytes of @c /api/samples,
+ *           made with the JSON writer.
+ *  @param   out Where the JSON goes
+ *  @param   csv_bytes The bytes of every @c /csv page rendered
+ *  @param   json_bytes The bytes of every @c /api/samples page rendered
+ */
+static void write_rendering (FILE* out, uint32_t csv_bytes,
+                             uint32_t json_bytes)
+{
+    size_t pages = times[TIME_RENDER_CSV].size ();
+    double csv_seconds = total_ns (TIME_RENDER_CSV) / 1e9;
+    double json_seconds = total_ns (TIME_RENDER_JSON) / 1e9;
+    fprintf (out, "  \"rendering\": {\"pages\": %zu, "
+             "\"csv_rows_per_sec\": %.0f, \"csv_bytes_per_page\": %.0f, "
+             "\"json_bytes_per_response\": %.0f, "
+             "\"json_us_per_response\": %.1f, \"json_mb_per_sec\": %.1f},\n",
+             pages, csv_seconds > 0 ? pages * CSV_ROWS / csv_seconds : 0.0,
+             pages ? (double)csv_bytes / pages : 0.0,
+             pages ? (double)json_bytes / pages : 0.0,
+             pages ? json_seconds * 1e6 / pages : 0.0,
+             json_seconds > 0 ? json_bytes / 1e6 / json_seconds : 0.0);
+}
+
+
+/** @brief   Time the formatting of rows of voltages as @c /csv and the
+ *           serial line write them, with @c fmt_fixed() and, to compare,
+ *           with @c snprintf(), and write the rows per second of each.
+ *  @param   out Where the JSON goes
+ */
+static void write_formatting (FILE* out)
+{
+    char line[PIPELINE_MAX_CHANNELS * (FMT_MAX_CHARS + 1)];
+    uint32_t length = 0;
+    uint64_t start = now_ns ();
+    for (uint32_t row = 0; row < BENCH_FORMAT_ROWS; row++)
+    {
+        size_t used = 0;
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            uint32_t counts = (row + channel * 1000) & ADC_MAX_COUNTS;
+            if (channel != 0)
+            {
+                line[used++] = ',';
+            }
+            used += fmt_fixed (line + used, counts_to_millivolts (counts), 3);
+        }
+        line[used++] = '\n';
+        length += used;
+    }
+    uint64_t fixed_ns = now_ns () - start;
+
+    start = now_ns ();
+    for (uint32_t row = 0; row < BENCH_FORMAT_ROWS; row++)
+    {
+        size_t used = 0;
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            uint32_t counts = (row + channel * 1000) & ADC_MAX_COUNTS;
+            used += snprintf (line + used, sizeof (line) - used,
+                              channel ? ",%.3f" : "%.3f",
+                              counts_to_millivolts (counts) / 1000.0);
+        }
+        line[used++] = '\n';
+        length += used;
+    }
+    uint64_t printf_ns = now_ns () - start;
+    bench_sink = length;
+
+    fprintf (out, "  \"formatting\": {\"rows\": %u, "
+             "\"fixed_rows_per_sec\": %.0f, "
+             "\"snprintf_rows_per_sec\": %.0f},\n", BENCH_FORMAT_ROWS,
+             BENCH_FORMAT_ROWS / (fixed_ns / 1e9),
+             BENCH_FORMAT_ROWS / (printf_ns / 1e9));
+}
+
+
+/** @brief   Write how well the voltage history compressed the rows the
+ *           replay left in it: the Gorilla blocks are copied out as
+ *           @c /api/samples copies them and split apart, and their bits are
+ *           shared out over their rows, headers and all.
+ *  @param   out Where the JSON goes
+ */
+static void write_history (FILE* out)
+{
+    size_t length = history_snapshot (snapshot, sizeof (snapshot));
+    uint32_t blocks = 0;
+    uint32_t rows = 0;
+    uint8_t columns = 0;
+    size_t used = 0;
+    while (used < length)
+    {
+        GorillaDecoder block (snapshot + used, length - used);
+        if (!block.valid ())
+        {
+            break;
+        }
+        columns = block.column_count ();
+        blocks++;
+        rows += block.count ();
+        used += block.block_size ();
+    }
+    fprintf (out, "  \"history\": {\"blocks\": %u, \"rows\": %u, "
+             "\"bytes\": %zu, \"bits_per_row\": %.1f, "
+             "\"raw_bits_per_row\": %u},\n", blocks, rows, used,
+             rows ? used * 8.0 / rows : 0.0, 32 + 32 * columns);
+}
+
+
+/** @brief   Note an event found in a record read back from the log.
+ */
+static void note_event (const uint8_t* data, size_t length)
+{
+    if (length < 9)
+    {
+        return;
+    }
+    debris_event_t event;
+    event.time = data[0] | (data[1] << 8) | (data[2] << 16)
+                 | ((uint32_t)data[3] << 24);
+    event.peak = data[4] | (data[5] << 8);
+    event.duration = data[6] | (data[7] << 8);
+    event.channel = data[8];
+    detections.push_back (event);
+}
+
+
+/** @brief   Read back the records added to the log since the last call, as
+ *           a client of @c /sync would, and note the events among them.
+ *  @details The heap the reading uses is the benchmark's, not the data
+ *           path's, so it's left out of the count.
+ */
+static void take_records (void)
+{
+    uint32_t allocations = heap_guard_count ();
+    log_span_t span;
+    while (sample_log_find (log_last_seq, 64, span))
+    {
+        records.resize (span.end - span.start);
+        size_t got = 0;
+        while (got < records.size ())
+        {
+            size_t part = sample_log_read (span.start + got, &records[got],
+                                           records.size () - got,
+                                           span.generation);
+            if (part == 0)
+            {
+                break;
+            }
+            got += part;
+        }
+        if (got < records.size ())
+        {
+            continue;
+        }
+
+        for (size_t at = 0; at + LOG_RECORD_HEADER_SIZE <= got; )
+        {
+            const uint8_t* header = &records[at];
+            size_t length = header[2] | (header[3] << 8);
+            size_t record = LOG_RECORD_HEADER_SIZE + length;
+            for (size_t index = 0; index < record; index++)
+            {
+                log_checksum = (log_checksum ^ header[index])
+                               * 0x100000001B3ULL;
+            }
+            if (header[1] == LOG_EVENT)
+            {
+                note_event (header + LOG_RECORD_HEADER_SIZE, length);
+            }
+            log_records++;
+            log_bytes += record;
+            at += record;
+        }
+        log_last_seq = span.last_seq;
+    }
+    own_allocations += heap_guard_count () - allocations;
+}
+
+
+/** @brief   Take the labels of the particles the generator has made.
+ */
+static void take_labels (SignalGenerator& signal)
+{
+    uint32_t allocations = heap_guard_count ();
+    signal_label_t label;
+    while (signal.take_label (label))
+    {
+        labels.push_back (label);
+    }
+    own_allocations += heap_guard_count () - allocations;
+}
+
+
+/** @brief   Compare the events found on one channel with the labels, and
+ *           write how well they agree as a JSON object.
+ *  @details An event matches the first label not yet matched whose pulse
+ *           it falls within, give or take @c BENCH_MATCH_SAMPLES. A label is
+ *           counted as detectable if its pulse is higher than the detector's
+ *           threshold; precision is the share of events which match a
+ *           label, and recall the share of detectable labels matched.
+ *  @param   out Where the JSON goes
+ *  @param   channel The channel
+ *  @param   last Whether it's the last item, which takes no comma
+ */
+static void write_accuracy (FILE* out, uint8_t channel, bool last)
+{
+    std::vector<bool> matched (labels.size (), false);
+    uint32_t margin = BENCH_MATCH_SAMPLES * SAMPLE_PERIOD_MS;
+    uint32_t events = 0;
+    uint32_t true_events = 0;
+    size_t first = 0;
+    for (size_t index = 0; index < detections.size (); index++)
+    {
+        const debris_event_t& event = detections[index];
+        if (event.channel != channel)
+        {
+            continue;
+        }
+        events++;
+        while (first < labels.size ()
+               && labels[first].time_ms + labels[first].width_ms + margin
+                  < event.time)
+        {
+            first++;
+        }
+        for (size_t item = first; item < labels.size ()
+             && labels[item].time_ms <= event.time + margin; item++)
+        {
+            if (!matched[item] && labels[item].peak[channel])
+            {
+                matched[item] = true;
+                true_events++;
+                break;
+            }
+        }
+    }
+
+    uint32_t detectable = 0;
+    uint32_t found = 0;
+    for (size_t item = 0; item < labels.size (); item++)
+    {
+        if (labels[item].peak[channel] > DETECT_THRESHOLD)
+        {
+            detectable++;
+            found += matched[item];
+        }
+    }
+    fprintf (out, "    {\"channel\": \"%s\", \"labels\": %zu, "
+             "\"detectable\": %u, \"found\": %u, \"events\": %u, "
+             "\"true_events\": %u, \"precision\": %.4f, "
+             "\"recall\": %.4f}%s\n", CHANNELS[channel].name,
+             labels.size (), detectable, found, events, true_events,
+             events ? (double)true_events / events : 1.0,
+             detectable ? (double)found / detectable : 1.0, last ? "" : ",");
+}
+
+
+/** @brief   Show how the program is used.
+ */
+static void usage (void)
+{
+    fprintf (stderr,
+             "usage: program [--input FILE.csv] [--samples N]\n"
+             "               [--render-every BLOCKS] [--out FILE.json]\n"
+             "               [--seed N] [--rate PER_S]\n"
+             "               [--sizes fixed|uniform|power]\n"
+             "               [--serve PORT]\n");
+}
+
+
+/** @brief   Replay the readings through the data path and report on it.
+ */
+int main (int argc, char** argv)
+{
+    const char* input = NULL;
+    const char* output = NULL;
+    uint32_t samples = 0;
+    uint32_t render_every = BENCH_DEFAULT_RENDER_EVERY;
+    uint16_t port = 0;
+    signal_config_t config;
+    signal_defaults (config);
+    for (int arg = 1; arg < argc; arg++)
+    {
+        bool more = arg + 1 < argc;
+        if (strcmp (argv[arg], "--input") == 0 && more)
+        {
+            input = argv[++arg];
+        }
+        else if (strcmp (argv[arg], "--samples") == 0 && more)
+        {
+            samples = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--render-every") == 0 && more)
+        {
+            render_every = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--out") == 0 && more)
+        {
+            output = argv[++arg];
+        }
+        else if (strcmp (argv[arg], "--seed") == 0 && more)
+        {
+            config.seed = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--rate") == 0 && more)
+        {
+            config.rate = strtof (argv[++arg], NULL);
+        }
+        else if (strcmp (argv[arg], "--serve") == 0 && more)
+        {
+            port = strtoul (argv[++arg], NULL, 10);
+        }
+        else if (strcmp (argv[arg], "--sizes") == 0 && more)
+        {
+            const char* sizes = argv[++arg];
+            config.sizes = (strcmp (sizes, "fixed") == 0) ? SIZES_FIXED
+                           : (strcmp (sizes, "uniform") == 0) ? SIZES_UNIFORM
+                           : SIZES_POWER_LAW;
+        }
+        else
+        {
+            usage ();
+            return 2;
+        }
+    }
+
+    // Everything is made before the clock starts, so the heap isn't counted
+    replay_t replay = { };
+    static SignalGenerator signal (config);
+    if (input == NULL)
+    {
+        replay.p_signal = &signal;
+        replay.scans = samples ? samples : BENCH_DEFAULT_SAMPLES;
+    }
+    else if (!read_recording (replay, input))
+    {
+        fprintf (stderr, "no readings in %s\n", input);
+        return 1;
+    }
+    if (samples == 0)
+    {
+        samples = replay.scans;
+    }
+    p_clock_replay = &replay;
+
+    // Room for twice as many particles as expected, and three events each
+    size_t expected = (size_t)(config.rate * samples * SAMPLE_PERIOD_MS
+                               / 1000) * 2 + 64;
+    labels.reserve (replay.p_signal ? expected : 0);
+    detections.reserve (expected * CHANNEL_COUNT * 3);
+    records.reserve (64 * 1024);
+
+    uint32_t blocks = (samples + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint32_t renders = render_every ? blocks / render_every + 1 : 0;
+    for (uint8_t index = 0; index < TIMED_COUNT; index++)
+    {
+        times[index].reserve ((index < TIME_RENDER_CSV) ? blocks : renders);
+    }
+    history_init ();
+    events_init ();
+    sample_log_init ();
+    if (!sample_log_mount ())
+    {
+        fprintf (stderr, "can't mount the log\n");
+        return 1;
+    }
+    NullClient csv_client;
+    NullClient json_client;
+    SampleSchedule schedule (CHANNEL_COUNT, SCHEDULE_MIRRORED);
+
+    heap_guard_seal ();
+    uint32_t allocations = heap_guard_count ();
+    uint64_t busy_ns = 0;
+    uint32_t time = 0;
+    uint32_t done = 0;
+    for (uint32_t block = 0; block < blocks; block++)
+    {
+        // Take a block's worth of readings, then run the block through
+        uint64_t start = now_ns ();
+        for (uint16_t index = 0; index < BLOCK_SIZE && done < samples;
+             index++, done++)
+        {
+            uint16_t readings[PIPELINE_MAX_CHANNELS];
+            uint16_t offsets[PIPELINE_MAX_CHANNELS];
+            replay.clock_us = time * 1000;
+            schedule.scan (replay_read, replay_clock, &replay, readings,
+                           offsets);
+            pipeline.put (time, readings, offsets);
+            time += SAMPLE_PERIOD_MS;
+            replay.next = (replay.next + 1) % replay.scans;
+        }
+        uint64_t filled = now_ns ();
+        times[TIME_ACQUIRE].push_back ((uint32_t)(filled - start));
+        if (done == samples)
+        {
+            pipeline.flush ();
+        }
+        pipeline.process ();
+        busy_ns += now_ns () - start;
+        take_records ();
+        if (replay.p_signal != NULL)
+        {
+            take_labels (*replay.p_signal);
+        }
+
+        if (render_every && (block + 1) % render_every == 0)
+        {
+            uint64_t rendered = now_ns ();
+            render_csv (csv_client, buffer);
+            uint64_t csv_done = now_ns ();
+            render_json (json_client, buffer, snapshot, 0xFFFFFFFF);
+            times[TIME_RENDER_CSV].push_back ((uint32_t)(csv_done - rendered));
+            times[TIME_RENDER_JSON].push_back ((uint32_t)(now_ns ()
+                                                          - csv_done));
+        }
+    }
+    allocations = heap_guard_count () - allocations - own_allocations;
+
+    FILE* out = stdout;
+    if (output != NULL && (out = fopen (output, "w")) == NULL)
+    {
+        fprintf (stderr, "can't write %s\n", output);
+        return 1;
+    }
+    pipeline_stats_t stats = pipeline.stats ();
+    double seconds = busy_ns / 1e9;
+    fprintf (out, "{\n  \"schema\": 1,\n  \"kind\": \"replay_bench\",\n");
+    fprintf (out, "  \"source\": \"%s\",\n", input ? input : "synthetic");
+    fprintf (out, "  \"channels\": %u,\n  \"block_size\": %u,\n",
+             CHANNEL_COUNT, BLOCK_SIZE);
+    fprintf (out, "  \"samples\": %u,\n  \"seconds\": %.6f,\n", done, seconds);
+    fprintf (out, "  \"samples_per_sec\": %.0f,\n",
+             seconds > 0 ? done / seconds : 0.0);
+    fprintf (out, "  \"times\": {\n");
+    for (uint8_t index = 0; index < TIMED_COUNT; index++)
+    {
+        write_times (out, index, index == TIMED_COUNT - 1);
+    }
+    fprintf (out, "  },\n");
+    write_rendering (out, csv_client.bytes, json_client.bytes);
+    write_formatting (out);
+    write_history (out);
+    fprintf (out, "  \"allocations\": {\"count\": %u},\n", allocations);
+    fprintf (out, "  \"pipeline\": {\"samples_in\": %u, \"samples_dropped\":"
+             " %u, \"blocks_processed\": %u},\n", stats.samples_in,
+             stats.samples_dropped, stats.blocks_processed);
+    fprintf (out, "  \"output\": {\"events\": %u, \"log_records\": %u, "
+             "\"log_bytes\": %zu, \"log_checksum\": \"%016llx\", "
+             "\"serial_bytes\": %u, \"csv_bytes\": %u, \"json_bytes\": %u}",
+             events_total (), log_records, (size_t)log_bytes,
+             (unsigned long long)log_checksum, Serial.get_bytes (),
+             csv_client.bytes, json_client.bytes);
+    if (replay.p_signal != NULL)
+    {
+        fprintf (out, ",\n  \"accuracy\": [\n");
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            write_accuracy (out, channel, channel == CHANNEL_COUNT - 1);
+        }
+        fprintf (out, "  ]");
+    }
+    fprintf (out, "\n}\n");
+    if (out != stdout)
+    {
+        fclose (out);
+    }
+
+    if (port != 0)
+    {
+        fflush (stdout);
+        return bench_serve (port, ROUTES, sizeof (ROUTES) / sizeof (ROUTES[0]))
+               ? 0 : 1;
+    }
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,120 @@
+/** @file beacon.cpp
+ *  This file contains the UDP telemetry beacon. Each datagram is built in a
+ *  small array on the stack and handed to the WiFi stack in one piece.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "beacon.h"
+
+
+/** @brief   Store a 16-bit number in little-endian order.
+ */
+static inline void put_u16 (uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+
+/** @brief   Store a 32-bit number in little-endian order.
+ */
+static inline void put_u32 (uint8_t* p, uint32_t value)
+{
+    put_u16 (p, (uint16_t)value);
+    put_u16 (p + 2, (uint16_t)(value >> 16));
+}
+
+
+/** @brief   Put a beacon into its fixed-size wire form.
+ *  @param   beacon The beacon's contents
+ *  @param   out Where the @c BEACON_SIZE bytes go
+ */
+void beacon_pack (const beacon_t& beacon, uint8_t* out)
+{
+    out[0] = 'D';
+    out[1] = 'B';
+    out[2] = BEACON_VERSION;
+    out[3] = BEACON_SIZE;
+    memcpy (out + 4, beacon.mac, 6);
+    put_u16 (out + 10, beacon.period_ms);
+    put_u32 (out + 12, beacon.sequence);
+    put_u32 (out + 16, beacon.uptime_ms);
+    put_u16 (out + 20, beacon.rollup.blocks);
+    put_u16 (out + 22, beacon.rollup.fine_mean);
+    put_u16 (out + 24, beacon.rollup.fine_max);
+    put_u16 (out + 26, beacon.rollup.coarse_mean);
+    put_u16 (out + 28, beacon.rollup.coarse_max);
+    put_u16 (out + 30, (uint16_t)beacon.events);
+}
+
+
+/** @brief   Create a beacon which hasn't been started.
+ */
+TelemetryBeacon::TelemetryBeacon (void)
+    : port (0), beacon (), failures (0)
+{
+}
+
+
+/** @brief   Get the beacon ready to send.
+ *  @param   target Where datagrams go: a broadcast or multicast address
+ *  @param   port The UDP port to which they're sent
+ *  @param   period_ms The time between beacons, which is sent in each one
+ *           so listeners can tell how many they should have heard
+ */
+void TelemetryBeacon::begin (IPAddress target, uint16_t port,
+                             uint16_t period_ms)
+{
+    this->target = target;
+    this->port = port;
+    beacon.period_ms = period_ms;
+
+    uint64_t mac = ESP.getEfuseMac ();
+    for (uint8_t index = 0; index < 6; index++)
+    {
+        beacon.mac[index] = (uint8_t)(mac >> (8 * index));
+    }
+}
+
+
+/** @brief   Send one beacon with the readings since the last one.
+ *  @details The sequence number goes up even if the datagram couldn't be
+ *           sent, so listeners count it as lost.
+ *  @returns @c true if the datagram was handed to the network
+ */
+bool TelemetryBeacon::send (void)
+{
+    uint8_t packet[BEACON_SIZE];
+
+    beacon.uptime_ms = millis ();
+    rollup_take (beacon.rollup);
+    beacon.events = events_total ();
+    beacon_pack (beacon, packet);
+    beacon.sequence++;
+
+    bool ok = udp.beginPacket (target, port)
+              && udp.write (packet, BEACON_SIZE) == BEACON_SIZE
+              && udp.endPacket ();
+    if (!ok)
+    {
+        failures++;
+    }
+    return ok;
+}
+
+
+/** @brief   Pass over a beacon which can't be sent, as while the network is
+ *           down.
+ *  @details The readings since the last beacon are thrown away and the
+ *           sequence number goes up, so the next beacon covers only its own
+ *           period and listeners see the gap.
+ */
+void TelemetryBeacon::skip (void)
+{
+    rollup_take (beacon.rollup);
+    beacon.sequence++;
+    failures++;
+}
@@ -0,0 +1,90 @@
+/** @file beacon.h
+ *  This file contains a telemetry beacon which sends a small, fixed-size
+ *  UDP datagram at a steady rate with the tester's latest readings and
+ *  event count. A dashboard can listen for the beacons of a whole fleet of
+ *  testers without opening a connection to any of them.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _BEACON_H_
+#define _BEACON_H_
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "pipeline_stages.h"
+
+/// Number of bytes in every beacon datagram
+const size_t BEACON_SIZE = 32;
+
+/// Version of the beacon layout, changed whenever a field moves
+const uint8_t BEACON_VERSION = 1;
+
+
+/** @brief   The contents of one beacon.
+ *  @details On the wire, all fields are little-endian:
+ *
+ *           | Offset | Size | Field                                    |
+ *           |--------|------|------------------------------------------|
+ *           | 0      | 2    | magic, the letters "DB"                  |
+ *           | 2      | 1    | version, @c BEACON_VERSION               |
+ *           | 3      | 1    | size, @c BEACON_SIZE                     |
+ *           | 4      | 6    | MAC address of the tester                |
+ *           | 10     | 2    | period between beacons in ms             |
+ *           | 12     | 4    | sequence number, from 0 at each start    |
+ *           | 16     | 4    | uptime in ms                             |
+ *           | 20     | 2    | blocks summarized                        |
+ *           | 22     | 2    | fine mean in mV                          |
+ *           | 24     | 2    | fine peak in mV                          |
+ *           | 26     | 2    | coarse mean in mV                        |
+ *           | 28     | 2    | coarse peak in mV                        |
+ *           | 30     | 2    | debris events since start, low 16 bits   |
+ */
+struct beacon_t
+{
+    uint8_t mac[6];             ///< MAC address, which identifies the tester
+    uint16_t period_ms;         ///< Time between beacons in milliseconds
+    uint32_t sequence;          ///< Counts beacons sent since startup
+    uint32_t uptime_ms;         ///< Time since startup in milliseconds
+    rollup_t rollup;            ///< Readings since the last beacon
+    uint32_t events;            ///< Debris events detected since startup
+};
+
+// Put a beacon into its fixed-size wire form
+void beacon_pack (const beacon_t& beacon, uint8_t* out);
+
+
+/** @brief   Class which sends a telemetry beacon by UDP at a steady rate.
+ *  @details The beacon may go to the broadcast address of the network, as
+ *           @c 255.255.255.255, or to a multicast group such as
+ *           @c 239.255.0.1 which listeners join.
+ */
+class TelemetryBeacon
+{
+protected:
+    WiFiUDP udp;                ///< Socket the datagrams are sent from
+    IPAddress target;           ///< Where the datagrams go
+    uint16_t port;              ///< UDP port they go to
+    beacon_t beacon;            ///< The next beacon to send
+    uint32_t failures;          ///< Beacons skipped or not sent
+
+public:
+    TelemetryBeacon (void);
+
+    void begin (IPAddress target, uint16_t port, uint16_t period_ms);
+    bool send (void);
+    void skip (void);
+
+    /// Get the time between beacons in milliseconds
+    uint16_t get_period (void) const { return beacon.period_ms; }
+
+    /// Get the number of beacons which have come due, sent or not
+    uint32_t get_sent (void) const { return beacon.sequence; }
+
+    /// Get the number of beacons which were skipped or couldn't be sent
+    uint32_t get_failures (void) const { return failures; }
+};
+
+#endif // _BEACON_H_
@@ -0,0 +1,486 @@
+/** @file block_kernels.cpp
+ *  This file contains the versions of the block kernels, the check which
+ *  compares them and the benchmark which times them.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include "fixed_format.h"
+#include "block_kernels.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// Readings in the buffer which the check runs each kernel over; not a
+/// multiple of 4 or 8, so the ends of the unrolled loops are checked too
+const uint16_t KERNEL_CHECK_SAMPLES = 83;
+
+/// Where the benchmark puts results, so the compiler can't leave out work
+static volatile uint32_t bench_sink;
+
+
+/** @brief   Find the sum and range of some readings, one at a time.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   stats Set to the sum, smallest and largest reading
+ */
+static void plain_stats (const uint16_t* samples, uint16_t count,
+                         block_stats_t& stats)
+{
+    uint32_t total = 0;
+    uint16_t smallest = 0xFFFF;
+    uint16_t largest = 0;
+    for (uint16_t index = 0; index < count; index++)
+    {
+        total += samples[index];
+        smallest = (samples[index] < smallest) ? samples[index] : smallest;
+        largest = (samples[index] > largest) ? samples[index] : largest;
+    }
+    stats.sum = total;
+    stats.min = smallest;
+    stats.max = largest;
+}
+
+
+/** @brief   Convert ADC counts to millivolts, one at a time.
+ *  @param   counts The ADC readings
+ *  @param   millivolts Set to the voltages; may be the same as @c counts
+ *  @param   count The number of readings
+ */
+static void plain_scale (const uint16_t* counts, uint16_t* millivolts,
+                         uint16_t count)
+{
+    for (uint16_t index = 0; index < count; index++)
+    {
+        millivolts[index] = counts_to_millivolts (counts[index]);
+    }
+}
+
+
+/** @brief   Find the first reading above a limit, one at a time.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   limit The largest reading which isn't above the limit
+ *  @returns The index of the first reading above the limit, or @c count
+ */
+static uint16_t plain_above (const uint16_t* samples, uint16_t count,
+                             uint16_t limit)
+{
+    for (uint16_t index = 0; index < count; index++)
+    {
+        if (samples[index] > limit)
+        {
+            return index;
+        }
+    }
+    return count;
+}
+
+
+/** @brief   Run the first-order low-pass filter y += (x - y) / 2^shift over
+ *           some readings, in fixed point.
+ *  @details Each output depends on the one before, so no set does this
+ *           more than one reading at a time.
+ *  @param   samples The readings, which are replaced with filtered ones
+ *  @param   count The number of readings
+ *  @param   level The filter's state, shifted left by @c shift
+ *  @param   shift The filter's time constant as a power of two
+ */
+static void plain_filter (uint16_t* samples, uint16_t count, int32_t& level,
+                          uint8_t shift)
+{
+    int32_t state = level;
+    for (uint16_t index = 0; index < count; index++)
+    {
+        state += samples[index] - (state >> shift);
+        samples[index] = (uint16_t)(state >> shift);
+    }
+    level = state;
+}
+
+
+/** @brief   Find the sum and range of some readings, four at a time.
+ *  @details Two sets of running totals let the loads of one pair overlap
+ *           the arithmetic on the other.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   stats Set to the sum, smallest and largest reading
+ */
+static void unrolled_stats (const uint16_t* samples, uint16_t count,
+                            block_stats_t& stats)
+{
+    uint32_t total_a = 0;
+    uint32_t total_b = 0;
+    uint16_t smallest_a = 0xFFFF;
+    uint16_t smallest_b = 0xFFFF;
+    uint16_t largest_a = 0;
+    uint16_t largest_b = 0;
+    uint16_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        uint16_t first = samples[index];
+        uint16_t second = samples[index + 1];
+        uint16_t third = samples[index + 2];
+        uint16_t fourth = samples[index + 3];
+        total_a += first + third;
+        total_b += second + fourth;
+        smallest_a = (first < smallest_a) ? first : smallest_a;
+        smallest_b = (second < smallest_b) ? second : smallest_b;
+        largest_a = (first > largest_a) ? first : largest_a;
+        largest_b = (second > largest_b) ? second : largest_b;
+        smallest_a = (third < smallest_a) ? third : smallest_a;
+        smallest_b = (fourth < smallest_b) ? fourth : smallest_b;
+        largest_a = (third > largest_a) ? third : largest_a;
+        largest_b = (fourth > largest_b) ? fourth : largest_b;
+    }
+    block_stats_t rest;
+    plain_stats (samples + index, count - index, rest);
+    stats.sum = total_a + total_b + rest.sum;
+    smallest_a = (smallest_b < smallest_a) ? smallest_b : smallest_a;
+    stats.min = (rest.min < smallest_a) ? rest.min : smallest_a;
+    largest_a = (largest_b > largest_a) ? largest_b : largest_a;
+    stats.max = (rest.max > largest_a) ? rest.max : largest_a;
+}
+
+
+/** @brief   Find the first reading above a limit, four at a time.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   limit The largest reading which isn't above the limit
+ *  @returns The index of the first reading above the limit, or @c count
+ */
+static uint16_t unrolled_above (const uint16_t* samples, uint16_t count,
+                                uint16_t limit)
+{
+    uint16_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        if ((samples[index] > limit) | (samples[index + 1] > limit)
+            | (samples[index + 2] > limit) | (samples[index + 3] > limit))
+        {
+            return index + plain_above (samples + index, 4, limit);
+        }
+    }
+    return index + plain_above (samples + index, count - index, limit);
+}
+
+
+#ifdef __SSE2__
+/** @brief   Find the sum and range of some readings, eight at a time.
+ *  @details SSE2 compares only signed 16-bit numbers, so the readings are
+ *           flipped into that range by toggling their top bits.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   stats Set to the sum, smallest and largest reading
+ */
+static void sse2_stats (const uint16_t* samples, uint16_t count,
+                        block_stats_t& stats)
+{
+    const __m128i bias = _mm_set1_epi16 ((short)0x8000);
+    const __m128i zero = _mm_setzero_si128 ();
+    __m128i totals = zero;
+    __m128i smallest = _mm_set1_epi16 (0x7FFF);
+    __m128i largest = bias;
+    uint16_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m128i eight = _mm_loadu_si128 ((const __m128i*)(samples + index));
+        totals = _mm_add_epi32 (totals, _mm_unpacklo_epi16 (eight, zero));
+        totals = _mm_add_epi32 (totals, _mm_unpackhi_epi16 (eight, zero));
+        __m128i flipped = _mm_xor_si128 (eight, bias);
+        smallest = _mm_min_epi16 (smallest, flipped);
+        largest = _mm_max_epi16 (largest, flipped);
+    }
+
+    uint32_t lane_totals[4];
+    uint16_t lane_smallest[8];
+    uint16_t lane_largest[8];
+    _mm_storeu_si128 ((__m128i*)lane_totals, totals);
+    _mm_storeu_si128 ((__m128i*)lane_smallest, _mm_xor_si128 (smallest, bias));
+    _mm_storeu_si128 ((__m128i*)lane_largest, _mm_xor_si128 (largest, bias));
+
+    plain_stats (samples + index, count - index, stats);
+    for (uint8_t lane = 0; lane < 4; lane++)
+    {
+        stats.sum += lane_totals[lane];
+    }
+    for (uint8_t lane = 0; lane < 8; lane++)
+    {
+        stats.min = (lane_smallest[lane] < stats.min) ? lane_smallest[lane]
+                                                      : stats.min;
+        stats.max = (lane_largest[lane] > stats.max) ? lane_largest[lane]
+                                                     : stats.max;
+    }
+}
+
+
+/** @brief   Divide four 32-bit numbers below 2^29 by @c ADC_MAX_COUNTS.
+ *  @details The division is done as a multiplication by a scaled
+ *           reciprocal; the check shows it gives the same result as
+ *           @c counts_to_millivolts() for every reading.
+ */
+static inline __m128i sse2_divide (__m128i dividends)
+{
+    const __m128i reciprocal = _mm_set1_epi32 ((int)(((1ULL << 39)
+                                                      + ADC_MAX_COUNTS - 1)
+                                                     / ADC_MAX_COUNTS));
+    __m128i even = _mm_srli_epi64 (_mm_mul_epu32 (dividends, reciprocal), 39);
+    __m128i odd = _mm_srli_epi64 (_mm_mul_epu32 (_mm_srli_epi64 (dividends,
+                                                                 32),
+                                                 reciprocal), 39);
+    return _mm_or_si128 (even, _mm_slli_epi64 (odd, 32));
+}
+
+
+/** @brief   Convert ADC counts to millivolts, eight at a time.
+ *  @param   counts The ADC readings
+ *  @param   millivolts Set to the voltages; may be the same as @c counts
+ *  @param   count The number of readings
+ */
+static void sse2_scale (const uint16_t* counts, uint16_t* millivolts,
+                        uint16_t count)
+{
+    const __m128i full_scale = _mm_set1_epi16 ((short)FULL_SCALE_MV);
+    const __m128i half = _mm_set1_epi32 (ADC_MAX_COUNTS / 2);
+    uint16_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m128i eight = _mm_loadu_si128 ((const __m128i*)(counts + index));
+        __m128i low = _mm_mullo_epi16 (eight, full_scale);
+        __m128i high = _mm_mulhi_epu16 (eight, full_scale);
+        __m128i first = sse2_divide (_mm_add_epi32 (
+                                     _mm_unpacklo_epi16 (low, high), half));
+        __m128i second = sse2_divide (_mm_add_epi32 (
+                                      _mm_unpackhi_epi16 (low, high), half));
+
+        // Keep the low 16 bits, as the plain version does, so that packing
+        // with signed saturation leaves them as they are
+        first = _mm_srai_epi32 (_mm_slli_epi32 (first, 16), 16);
+        second = _mm_srai_epi32 (_mm_slli_epi32 (second, 16), 16);
+        _mm_storeu_si128 ((__m128i*)(millivolts + index),
+                          _mm_packs_epi32 (first, second));
+    }
+    plain_scale (counts + index, millivolts + index, count - index);
+}
+
+
+/** @brief   Find the first reading above a limit, eight at a time.
+ *  @param   samples The readings
+ *  @param   count The number of readings
+ *  @param   limit The largest reading which isn't above the limit
+ *  @returns The index of the first reading above the limit, or @c count
+ */
+static uint16_t sse2_above (const uint16_t* samples, uint16_t count,
+                            uint16_t limit)
+{
+    const __m128i bias = _mm_set1_epi16 ((short)0x8000);
+    const __m128i flipped_limit = _mm_set1_epi16 ((short)(limit ^ 0x8000));
+    uint16_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m128i eight = _mm_loadu_si128 ((const __m128i*)(samples + index));
+        int mask = _mm_movemask_epi8 (_mm_cmpgt_epi16 (
+                                      _mm_xor_si128 (eight, bias),
+                                      flipped_limit));
+        if (mask != 0)
+        {
+            return index + __builtin_ctz (mask) / 2;
+        }
+    }
+    return index + plain_above (samples + index, count - index, limit);
+}
+#endif // __SSE2__
+
+
+/// The sets of kernels built for this target, slowest first
+static const kernel_set_t kernel_sets[] =
+{
+    { "plain", plain_stats, plain_scale, plain_above, plain_filter },
+    { "unrolled", unrolled_stats, plain_scale, unrolled_above, plain_filter },
+#ifdef __SSE2__
+    { "sse2", sse2_stats, sse2_scale, sse2_above, plain_filter },
+#endif
+};
+
+/// Number of sets of kernels built for this target
+static const uint8_t KERNEL_SET_COUNT = sizeof (kernel_sets)
+                                        / sizeof (kernel_sets[0]);
+
+
+/** @brief   Get the fastest set of kernels built for this target.
+ */
+const kernel_set_t& kernels (void)
+{
+    return kernel_sets[KERNEL_SET_COUNT - 1];
+}
+
+
+/** @brief   Get one of the sets of kernels built for this target.
+ *  @param   index The number of the set, from zero for the plain one
+ *  @returns Pointer to the set, or @c NULL if there are no more
+ */
+const kernel_set_t* kernel_set_at (uint8_t index)
+{
+    return (index < KERNEL_SET_COUNT) ? &kernel_sets[index] : NULL;
+}
+
+
+/** @brief   Fill a buffer with readings for the check or the benchmark.
+ *  @param   samples The buffer
+ *  @param   count The number of readings
+ *  @param   pattern 0 for 12-bit noise, 1 for 16-bit noise, 2 for readings
+ *           which swing between the ends of the 16-bit range
+ */
+static void kernel_fill (uint16_t* samples, uint16_t count, uint8_t pattern)
+{
+    uint32_t seed = 12345 + pattern;
+    for (uint16_t index = 0; index < count; index++)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint16_t noise = (uint16_t)(seed >> 16);
+        if (pattern == 0)
+        {
+            samples[index] = noise & 0x0FFF;
+        }
+        else if (pattern == 1)
+        {
+            samples[index] = noise;
+        }
+        else
+        {
+            samples[index] = (index & 1) ? 0xFFFF - (noise & 3) : noise & 3;
+        }
+    }
+}
+
+
+/** @brief   Compare every set of kernels with the plain one.
+ *  @details Each kernel is run over each pattern of readings, starting at
+ *           the first and the second reading, for every length up to
+ *           @c KERNEL_CHECK_SAMPLES, so the odd ends and unaligned starts
+ *           of the faster loops are covered.
+ *  @returns The number of results which differ from the plain kernels'
+ */
+uint32_t kernels_check (void)
+{
+    static uint16_t samples[KERNEL_CHECK_SAMPLES + 1];
+    static uint16_t expected[KERNEL_CHECK_SAMPLES + 1];
+    static uint16_t result[KERNEL_CHECK_SAMPLES + 1];
+    const kernel_set_t& plain = kernel_sets[0];
+    uint32_t differences = 0;
+
+    for (uint8_t pattern = 0; pattern < 3; pattern++)
+    {
+        kernel_fill (samples, KERNEL_CHECK_SAMPLES + 1, pattern);
+        for (uint8_t set = 1; set < KERNEL_SET_COUNT; set++)
+        {
+            const kernel_set_t& other = kernel_sets[set];
+            for (uint8_t start = 0; start < 2; start++)
+            {
+                const uint16_t* first = samples + start;
+                for (uint16_t count = 0; count <= KERNEL_CHECK_SAMPLES;
+                     count++)
+                {
+                    block_stats_t want;
+                    block_stats_t got;
+                    plain.stats (first, count, want);
+                    other.stats (first, count, got);
+                    differences += (want.sum != got.sum)
+                                   + (want.min != got.min)
+                                   + (want.max != got.max);
+
+                    plain.scale (first, expected, count);
+                    other.scale (first, result, count);
+                    differences += memcmp (expected, result,
+                                           count * sizeof (uint16_t)) != 0;
+
+                    const uint16_t limits[] = { 0, 2047, want.max,
+                                                (uint16_t)(want.max - 1) };
+                    for (uint8_t limit = 0; limit < 4; limit++)
+                    {
+                        differences += plain.above (first, count,
+                                                    limits[limit])
+                                       != other.above (first, count,
+                                                       limits[limit]);
+                    }
+
+                    int32_t want_level = 1000 << 2;
+                    int32_t got_level = want_level;
+                    memcpy (expected, first, count * sizeof (uint16_t));
+                    memcpy (result, first, count * sizeof (uint16_t));
+                    plain.filter (expected, count, want_level, 2);
+                    other.filter (result, count, got_level, 2);
+                    differences += (want_level != got_level)
+                                   + (memcmp (expected, result,
+                                              count * sizeof (uint16_t)) != 0);
+                }
+            }
+        }
+    }
+    return differences;
+}
+
+
+/** @brief   Work out how long a kernel took per reading.
+ *  @param   cycles The cycles taken by all the rounds
+ *  @returns Hundredths of a cycle per reading
+ */
+static uint32_t per_reading (uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 100
+                      / ((uint32_t)KERNEL_BENCH_SAMPLES * KERNEL_BENCH_ROUNDS));
+}
+
+
+/** @brief   Time each kernel of a set over a buffer of 12-bit readings.
+ *  @details Each kernel is run @c KERNEL_BENCH_ROUNDS times over
+ *           @c KERNEL_BENCH_SAMPLES readings, which stay in the cache. The
+ *           filter runs last, as it changes the readings.
+ *  @param   set The set of kernels to time
+ *  @param   clock A function which reads a counter of CPU cycles
+ *  @param   timing Set to the time each kernel took
+ */
+void kernels_benchmark (const kernel_set_t& set, kernel_clock_t clock,
+                        kernel_timing_t& timing)
+{
+    static uint16_t samples[KERNEL_BENCH_SAMPLES];
+    static uint16_t millivolts[KERNEL_BENCH_SAMPLES];
+    kernel_fill (samples, KERNEL_BENCH_SAMPLES, 0);
+
+    block_stats_t stats;
+    uint32_t start = clock ();
+    for (uint16_t round = 0; round < KERNEL_BENCH_ROUNDS; round++)
+    {
+        set.stats (samples, KERNEL_BENCH_SAMPLES, stats);
+        bench_sink = stats.sum;
+    }
+    timing.stats = per_reading (clock () - start);
+
+    start = clock ();
+    for (uint16_t round = 0; round < KERNEL_BENCH_ROUNDS; round++)
+    {
+        set.scale (samples, millivolts, KERNEL_BENCH_SAMPLES);
+        bench_sink = millivolts[round];
+    }
+    timing.scale = per_reading (clock () - start);
+
+    // No 12-bit reading is above the limit, so every reading is looked at
+    start = clock ();
+    for (uint16_t round = 0; round < KERNEL_BENCH_ROUNDS; round++)
+    {
+        bench_sink = set.above (samples, KERNEL_BENCH_SAMPLES, ADC_MAX_COUNTS);
+    }
+    timing.above = per_reading (clock () - start);
+
+    int32_t level = 0;
+    start = clock ();
+    for (uint16_t round = 0; round < KERNEL_BENCH_ROUNDS; round++)
+    {
+        set.filter (samples, KERNEL_BENCH_SAMPLES, level, 2);
+    }
+    timing.filter = per_reading (clock () - start);
+    bench_sink = (uint32_t)level;
+}
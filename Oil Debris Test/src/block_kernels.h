@@ -0,0 +1,100 @@
+/** @file block_kernels.h
+ *  This file contains the small loops which the pipeline stages run over
+ *  each channel's readings: statistics, scaling to millivolts, finding the
+ *  first reading above a threshold, and the smoothing filter. Each kernel
+ *  comes in several versions, gathered into sets; the stages use the
+ *  fastest set built for the target, and the others are kept so that it
+ *  can be checked against the plain version and timed on the device.
+ *
+ *  The plain set is the reference. The unrolled set is written for the
+ *  ESP32's Xtensa core, which has no vector unit for 16-bit integers but
+ *  runs short unrolled loops without branch stalls. On a PC with SSE2 an
+ *  SSE2 set is added. Nothing here touches hardware; the benchmark is given
+ *  a cycle counter by the caller.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _BLOCK_KERNELS_H_
+#define _BLOCK_KERNELS_H_
+
+#include <stdint.h>
+
+/// Readings in the buffer which the benchmark runs each kernel over
+const uint16_t KERNEL_BENCH_SAMPLES = 256;
+
+/// Times the benchmark runs each kernel over its buffer
+const uint16_t KERNEL_BENCH_ROUNDS = 32;
+
+
+/** @brief   The sum and range of one channel's readings.
+ */
+struct block_stats_t
+{
+    uint32_t sum;               ///< Sum of the readings
+    uint16_t min;               ///< Smallest reading, or 0xFFFF if none
+    uint16_t max;               ///< Largest reading, or 0 if none
+};
+
+
+/// Type of a kernel which finds the sum and range of some readings
+typedef void (*stats_kernel_t) (const uint16_t* samples, uint16_t count,
+                                block_stats_t& stats);
+
+/// Type of a kernel which converts ADC counts to millivolts
+typedef void (*scale_kernel_t) (const uint16_t* counts, uint16_t* millivolts,
+                                uint16_t count);
+
+/// Type of a kernel which finds the first reading above a limit, returning
+/// @c count if there is none
+typedef uint16_t (*above_kernel_t) (const uint16_t* samples, uint16_t count,
+                                    uint16_t limit);
+
+/// Type of a kernel which runs the smoothing filter over some readings
+typedef void (*filter_kernel_t) (uint16_t* samples, uint16_t count,
+                                 int32_t& level, uint8_t shift);
+
+/// Type of a function which reads a counter of CPU cycles
+typedef uint32_t (*kernel_clock_t) (void);
+
+
+/** @brief   One version of each kernel.
+ */
+struct kernel_set_t
+{
+    const char* name;           ///< Name shown with the benchmark
+    stats_kernel_t stats;       ///< Sum and range
+    scale_kernel_t scale;       ///< Counts to millivolts
+    above_kernel_t above;       ///< First reading above a limit
+    filter_kernel_t filter;     ///< Smoothing filter
+};
+
+
+/** @brief   Time taken by each kernel of a set, in hundredths of a cycle per
+ *           reading.
+ */
+struct kernel_timing_t
+{
+    uint32_t stats;             ///< Sum and range
+    uint32_t scale;             ///< Counts to millivolts
+    uint32_t above;             ///< First reading above a limit
+    uint32_t filter;            ///< Smoothing filter
+};
+
+
+// The fastest set of kernels built for this target
+const kernel_set_t& kernels (void);
+
+// Get one of the sets of kernels built for this target, or NULL
+const kernel_set_t* kernel_set_at (uint8_t index);
+
+// Compare every set of kernels with the plain one and count the differences
+uint32_t kernels_check (void);
+
+// Time each kernel of a set
+void kernels_benchmark (const kernel_set_t& set, kernel_clock_t clock,
+                        kernel_timing_t& timing);
+
+#endif // _BLOCK_KERNELS_H_
@@ -0,0 +1,108 @@
+/** @file boot_timing.cpp
+ *  This file contains the record of startup phases. The phases of
+ *  @c setup() follow one another, each running from the end of the one
+ *  before; the first runs from the start of the program's timer, just
+ *  after the bootloader hands over, so time spent in the bootloader itself
+ *  isn't included. Tasks started during setup record their own phases, as
+ *  mounting the flash log, which overlap those of setup.
+ *
+ *  Each phase is written before the count goes up, so the diagnostics page
+ *  may read the record at any time.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "boot_timing.h"
+
+/// Names of the phases recorded
+static const char* phase_names[BOOT_MAX_PHASES];
+
+/// Times in microseconds at which the phases began
+static uint32_t phase_starts[BOOT_MAX_PHASES];
+
+/// Times in microseconds which the phases took
+static uint32_t phase_times[BOOT_MAX_PHASES];
+
+/// Number of phases recorded
+static volatile uint8_t phase_count = 0;
+
+/// Time at which the last phase of setup() ended
+static uint32_t setup_mark = 0;
+
+/// Guards the count when phases end in more than one task at once
+static portMUX_TYPE phase_mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** @brief   Mark the end of the current phase of @c setup() and give it a
+ *           name.
+ *  @details The next phase of setup begins now.
+ *  @param   name The phase's name, which must stay valid for good, as a
+ *           string literal does
+ */
+void boot_phase (const char* name)
+{
+    uint32_t start = setup_mark;
+    setup_mark = micros ();
+    boot_span (name, start);
+}
+
+
+/** @brief   Record a phase which some task began at a given time and has
+ *           just ended.
+ *  @details Phases past @c BOOT_MAX_PHASES are ignored.
+ *  @param   name The phase's name, which must stay valid for good
+ *  @param   start_us The value of @c micros() when the phase began
+ */
+void boot_span (const char* name, uint32_t start_us)
+{
+    uint32_t now = micros ();
+
+    portENTER_CRITICAL (&phase_mux);
+    if (phase_count < BOOT_MAX_PHASES)
+    {
+        phase_names[phase_count] = name;
+        phase_starts[phase_count] = start_us;
+        phase_times[phase_count] = now - start_us;
+        phase_count++;
+    }
+    portEXIT_CRITICAL (&phase_mux);
+}
+
+
+/** @brief   Get the number of phases recorded so far.
+ */
+uint8_t boot_phase_count (void)
+{
+    return phase_count;
+}
+
+
+/** @brief   Get the name of a phase.
+ *  @param   index Which phase, from zero in the order they ended
+ */
+const char* boot_phase_name (uint8_t index)
+{
+    return (index < phase_count) ? phase_names[index] : "";
+}
+
+
+/** @brief   Get the time after the program started at which a phase began.
+ *  @param   index Which phase, from zero in the order they ended
+ *  @returns The time in microseconds
+ */
+uint32_t boot_phase_start_us (uint8_t index)
+{
+    return (index < phase_count) ? phase_starts[index] : 0;
+}
+
+
+/** @brief   Get the time which a phase took.
+ *  @param   index Which phase, from zero in the order they ended
+ *  @returns The time in microseconds
+ */
+uint32_t boot_phase_us (uint8_t index)
+{
+    return (index < phase_count) ? phase_times[index] : 0;
+}
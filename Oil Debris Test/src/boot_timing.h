@@ -0,0 +1,39 @@
+/** @file boot_timing.h
+ *  This file contains a record of how long each phase of startup took, so
+ *  that one can see where the time between reset and the first sample, and
+ *  between reset and a working web server, goes.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _BOOT_TIMING_H_
+#define _BOOT_TIMING_H_
+
+#include <Arduino.h>
+
+/// The most startup phases which can be recorded
+const uint8_t BOOT_MAX_PHASES = 16;
+
+
+// Mark the end of the current phase of setup() and give it a name
+void boot_phase (const char* name);
+
+// Record a phase which some task began at a given time and has just ended
+void boot_span (const char* name, uint32_t start_us);
+
+// Get the number of phases recorded so far
+uint8_t boot_phase_count (void);
+
+// Get the name of a phase
+const char* boot_phase_name (uint8_t index);
+
+// Get the time in microseconds after the program started at which a phase
+// began
+uint32_t boot_phase_start_us (uint8_t index);
+
+// Get the time in microseconds which a phase took
+uint32_t boot_phase_us (uint8_t index);
+
+#endif // _BOOT_TIMING_H_
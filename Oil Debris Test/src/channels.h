@@ -0,0 +1,44 @@
+/** @file channels.h
+ *  This file contains the table of sensor channels which the tester reads.
+ *  The table itself is in main.cpp, next to the other settings; each
+ *  channel's readings go through the sample pipeline, the filter, the
+ *  detector and the flash log in the order they appear in it.
+ *
+ *  The first two channels are always the fine and coarse wear sensors,
+ *  because the telemetry beacon and the fine and coarse shares have room
+ *  for just those two.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _CHANNELS_H_
+#define _CHANNELS_H_
+
+#include <stdint.h>
+
+/// Index of the fine wear sensor in the channel table
+const uint8_t CHANNEL_FINE = 0;
+
+/// Index of the coarse wear sensor in the channel table
+const uint8_t CHANNEL_COARSE = 1;
+
+/// The longest channel name; names appear in the serial line and JSON
+const uint8_t CHANNEL_NAME_MAX = 12;
+
+
+/** @brief   One sensor channel.
+ */
+struct channel_t
+{
+    const char* name;           ///< Short name, such as @c "fine"
+    uint8_t pin;                ///< GPIO pin of the channel's ADC input
+    uint8_t spi_input;          ///< Input of the external ADC, if one is used
+};
+
+// The channel table and the number of channels in it
+extern const channel_t CHANNELS[];
+extern const uint8_t CHANNEL_COUNT;
+
+#endif // _CHANNELS_H_
@@ -0,0 +1,102 @@
+/** @file config_nvs.cpp
+ *  This file contains the code which reads and writes the tester's settings
+ *  in NVS through the Arduino @c Preferences library.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Preferences.h>
+#include "config_nvs.h"
+
+/// NVS namespace under which the settings are kept
+static const char* CONFIG_NAMESPACE = "config";
+
+
+/** @brief   Read the saved settings over the given ones.
+ *  @details A setting which was never saved, or whose saved value is no
+ *           longer allowed, keeps the value it had.
+ *  @param   config The settings, usually the defaults, which are changed
+ *  @returns The number of saved settings which were used
+ */
+uint8_t config_nvs_load (config_t& config)
+{
+    Preferences store;
+    if (!store.begin (CONFIG_NAMESPACE, true))
+    {
+        return 0;
+    }
+
+    uint8_t used = 0;
+    const config_item_t* p_item;
+    for (uint8_t index = 0; (p_item = config_item_at (index)) != NULL; index++)
+    {
+        if (!store.isKey (p_item->key))
+        {
+            continue;
+        }
+
+        config_result_t result;
+        if (p_item->type == CONFIG_UINT)
+        {
+            result = config_set_uint (config, *p_item,
+                                      store.getUInt (p_item->key));
+        }
+        else
+        {
+            char text[CONFIG_PASSWORD_MAX + 1];
+            store.getString (p_item->key, text, sizeof (text));
+            result = config_set_text (config, *p_item, text);
+        }
+        used += (result == CONFIG_OK);
+    }
+    store.end ();
+    return used;
+}
+
+
+/** @brief   Save every setting.
+ *  @details Only settings which differ from what's saved are written, so
+ *           the flash isn't worn by rewriting all of them each time.
+ *  @param   config The settings to save
+ *  @returns @c true if every setting was saved
+ */
+bool config_nvs_save (const config_t& config)
+{
+    Preferences store;
+    if (!store.begin (CONFIG_NAMESPACE, false))
+    {
+        return false;
+    }
+
+    bool saved = true;
+    const config_item_t* p_item;
+    for (uint8_t index = 0; (p_item = config_item_at (index)) != NULL; index++)
+    {
+        bool known = store.isKey (p_item->key);
+        if (p_item->type == CONFIG_UINT)
+        {
+            uint32_t value = config_get_uint (config, *p_item);
+            if (!known || store.getUInt (p_item->key) != value)
+            {
+                saved &= store.putUInt (p_item->key, value) > 0;
+            }
+        }
+        else
+        {
+            const char* text = config_get_text (config, *p_item);
+            char stored[CONFIG_PASSWORD_MAX + 1] = "";
+            if (known)
+            {
+                store.getString (p_item->key, stored, sizeof (stored));
+            }
+            if (!known || strcmp (stored, text) != 0)
+            {
+                saved &= store.putString (p_item->key, text) == strlen (text);
+            }
+        }
+    }
+    store.end ();
+    return saved;
+}
@@ -0,0 +1,24 @@
+/** @file config_nvs.h
+ *  This file contains the code which keeps the tester's settings in the
+ *  ESP32's non-volatile storage (NVS), so that changes made at @c /config
+ *  last through a restart. Each setting is kept under its own key, in the
+ *  @c config namespace; see @c config_store.h for the list.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _CONFIG_NVS_H_
+#define _CONFIG_NVS_H_
+
+#include <Arduino.h>
+#include "config_store.h"
+
+// Read the saved settings over the given ones; returns how many were used
+uint8_t config_nvs_load (config_t& config);
+
+// Save every setting
+bool config_nvs_save (const config_t& config);
+
+#endif // _CONFIG_NVS_H_
@@ -0,0 +1,262 @@
+/** @file config_store.cpp
+ *  This file contains the table of settings, the checks made on them and
+ *  the snapshots through which they are put into use.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include "config_store.h"
+
+/// Description of every setting; the keys are short enough for NVS
+static const config_item_t items[] =
+{
+    { "period_ms", CONFIG_UINT, false, sizeof (uint16_t),
+      offsetof (config_t, sample_period_ms), 1, 1000 },
+    { "threshold", CONFIG_UINT, false, sizeof (uint16_t),
+      offsetof (config_t, detect_threshold), 1, 4095 },
+    { "filter_shift", CONFIG_UINT, false, sizeof (uint8_t),
+      offsetof (config_t, filter_shift), 0, 8 },
+    { "ap_ssid", CONFIG_TEXT, false, CONFIG_SSID_MAX + 1,
+      offsetof (config_t, ap_ssid), 1, CONFIG_SSID_MAX },
+    { "ap_password", CONFIG_TEXT, true, CONFIG_PASSWORD_MAX + 1,
+      offsetof (config_t, ap_password), 8, CONFIG_PASSWORD_MAX }
+};
+
+/// Number of settings in the table
+static const uint8_t ITEM_COUNT = sizeof (items) / sizeof (items[0]);
+
+/// Snapshots, taken in turn; the one in use is never written
+static config_t snapshots[CONFIG_SNAPSHOTS];
+
+/// The snapshot in use
+static std::atomic<const config_t*> current (NULL);
+
+/// The snapshot the next change is written into
+static uint8_t next_snapshot = 0;
+
+/// Time of the last change, and whether one has been made
+static uint32_t last_change_ms = 0;
+static bool changed = false;
+
+
+/** @brief   Get the description of a setting.
+ *  @param   index The number of the setting, from zero
+ *  @returns Pointer to the description, or @c NULL if there are no more
+ */
+const config_item_t* config_item_at (uint8_t index)
+{
+    return (index < ITEM_COUNT) ? &items[index] : NULL;
+}
+
+
+/** @brief   Find the description of a setting by its name.
+ *  @param   key The setting's name
+ *  @returns Pointer to the description, or @c NULL if there's no such setting
+ */
+const config_item_t* config_find (const char* key)
+{
+    for (uint8_t index = 0; index < ITEM_COUNT; index++)
+    {
+        if (strcmp (items[index].key, key) == 0)
+        {
+            return &items[index];
+        }
+    }
+    return NULL;
+}
+
+
+/** @brief   Get the name of a result, for error messages.
+ *  @param   result The result of a change
+ */
+const char* config_result_name (config_result_t result)
+{
+    switch (result)
+    {
+        case CONFIG_OK:
+            return "ok";
+        case CONFIG_UNKNOWN:
+            return "no such setting";
+        case CONFIG_NOT_A_NUMBER:
+            return "not a number";
+        case CONFIG_OUT_OF_RANGE:
+            return "out of range";
+        default:
+            return "too soon after the last change";
+    }
+}
+
+
+/** @brief   Read a number setting from a snapshot.
+ *  @param   config The snapshot
+ *  @param   item The setting, which must be a number
+ */
+uint32_t config_get_uint (const config_t& config, const config_item_t& item)
+{
+    const uint8_t* place = (const uint8_t*)&config + item.offset;
+    if (item.size == sizeof (uint8_t))
+    {
+        return *place;
+    }
+    else if (item.size == sizeof (uint16_t))
+    {
+        uint16_t value;
+        memcpy (&value, place, sizeof (value));
+        return value;
+    }
+    uint32_t value;
+    memcpy (&value, place, sizeof (value));
+    return value;
+}
+
+
+/** @brief   Read a text setting from a snapshot.
+ *  @param   config The snapshot
+ *  @param   item The setting, which must be text
+ */
+const char* config_get_text (const config_t& config, const config_item_t& item)
+{
+    return (const char*)&config + item.offset;
+}
+
+
+/** @brief   Check a number and put it into a setting.
+ *  @param   config The settings to change
+ *  @param   item The setting, which must be a number
+ *  @param   value The new value
+ *  @returns @c CONFIG_OK, or @c CONFIG_OUT_OF_RANGE and no change
+ */
+config_result_t config_set_uint (config_t& config, const config_item_t& item,
+                                 uint32_t value)
+{
+    if (item.type != CONFIG_UINT)
+    {
+        return CONFIG_NOT_A_NUMBER;
+    }
+    if (value < item.min || value > item.max)
+    {
+        return CONFIG_OUT_OF_RANGE;
+    }
+
+    uint8_t* place = (uint8_t*)&config + item.offset;
+    if (item.size == sizeof (uint8_t))
+    {
+        *place = (uint8_t)value;
+    }
+    else if (item.size == sizeof (uint16_t))
+    {
+        uint16_t narrow = (uint16_t)value;
+        memcpy (place, &narrow, sizeof (narrow));
+    }
+    else
+    {
+        memcpy (place, &value, sizeof (value));
+    }
+    return CONFIG_OK;
+}
+
+
+/** @brief   Check some text and put it into a setting.
+ *  @param   config The settings to change
+ *  @param   item The setting, which must be text
+ *  @param   text The new text
+ *  @returns @c CONFIG_OK, or @c CONFIG_OUT_OF_RANGE and no change if the
+ *           text is too long or too short
+ */
+config_result_t config_set_text (config_t& config, const config_item_t& item,
+                                 const char* text)
+{
+    size_t length = strnlen (text, item.size);
+    if (item.type != CONFIG_TEXT || length < item.min || length > item.max
+        || length >= item.size)
+    {
+        return CONFIG_OUT_OF_RANGE;
+    }
+    memcpy ((char*)&config + item.offset, text, length + 1);
+    return CONFIG_OK;
+}
+
+
+/** @brief   Turn text into a setting of either kind, checking it.
+ *  @param   config The settings to change
+ *  @param   item The setting
+ *  @param   text The new value as text, such as from a web form
+ *  @returns @c CONFIG_OK if the setting was changed, or why it wasn't
+ */
+config_result_t config_parse (config_t& config, const config_item_t& item,
+                              const char* text)
+{
+    if (item.type == CONFIG_TEXT)
+    {
+        return config_set_text (config, item, text);
+    }
+
+    char* end;
+    unsigned long value = strtoul (text, &end, 10);
+    if (end == text || *end != '\0' || *text == '-')
+    {
+        return CONFIG_NOT_A_NUMBER;
+    }
+    if (value > 0xFFFFFFFFUL)
+    {
+        return CONFIG_OUT_OF_RANGE;
+    }
+    return config_set_uint (config, item, (uint32_t)value);
+}
+
+
+/** @brief   Make the first snapshot of the settings.
+ *  @details This must be called before any task reads the settings.
+ *  @param   initial The settings to start with
+ */
+void config_begin (const config_t& initial)
+{
+    snapshots[0] = initial;
+    snapshots[0].version = 0;
+    next_snapshot = 1;
+    current.store (&snapshots[0], std::memory_order_release);
+}
+
+
+/** @brief   Get the settings in use.
+ *  @details This only reads a pointer, so it never waits. The snapshot
+ *           doesn't change, but it should be read again on each pass of a
+ *           task's loop to see changes.
+ *  @returns The snapshot in use
+ */
+const config_t& config_now (void)
+{
+    return *current.load (std::memory_order_acquire);
+}
+
+
+/** @brief   Put changed settings into use.
+ *  @details The settings are copied into the next snapshot, which is then
+ *           made the one in use. This may only be called by one task.
+ *  @param   config The new settings, which should have been checked
+ *  @param   now_ms The time in milliseconds, to keep changes apart
+ *  @returns @c CONFIG_OK, or @c CONFIG_TOO_SOON if the last change was less
+ *           than @c CONFIG_MIN_CHANGE_MS ago
+ */
+config_result_t config_publish (const config_t& config, uint32_t now_ms)
+{
+    if (changed && now_ms - last_change_ms < CONFIG_MIN_CHANGE_MS)
+    {
+        return CONFIG_TOO_SOON;
+    }
+
+    config_t& snapshot = snapshots[next_snapshot];
+    snapshot = config;
+    snapshot.version = config_now ().version + 1;
+    current.store (&snapshot, std::memory_order_release);
+
+    next_snapshot = (next_snapshot + 1) % CONFIG_SNAPSHOTS;
+    last_change_ms = now_ms;
+    changed = true;
+    return CONFIG_OK;
+}
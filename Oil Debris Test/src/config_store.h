@@ -0,0 +1,125 @@
+/** @file config_store.h
+ *  This file contains the tester's settings which can be changed while it
+ *  runs: the sample period, the detector's threshold, the filter's time
+ *  constant and the name and password of its own access point. Each
+ *  setting is described in a table, which gives its name, type and range,
+ *  so that the web server, the NVS store and the checks all work from the
+ *  same list.
+ *
+ *  The settings in use are an unchanging snapshot. A change is made by
+ *  filling in a new snapshot and switching one pointer to it, so a task
+ *  which reads the settings never waits for one which changes them. Only
+ *  one task, the web server, may make changes. A snapshot is reused only
+ *  after @c CONFIG_SNAPSHOTS - 1 more changes, which can't happen in less
+ *  than a few seconds, so a task must not keep a reference to one for
+ *  longer than a loop. Nothing here touches hardware, so it runs on a PC.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _CONFIG_STORE_H_
+#define _CONFIG_STORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// The longest access point name WiFi allows
+const uint8_t CONFIG_SSID_MAX = 32;
+
+/// The longest access point password WiFi allows
+const uint8_t CONFIG_PASSWORD_MAX = 63;
+
+/// Number of snapshots which are taken in turn
+const uint8_t CONFIG_SNAPSHOTS = 4;
+
+/// Least time between changes in milliseconds, which keeps a snapshot from
+/// being reused while a task may still be reading it
+const uint32_t CONFIG_MIN_CHANGE_MS = 1000;
+
+
+/** @brief   One snapshot of the settings.
+ */
+struct config_t
+{
+    uint32_t version;                       ///< Changes made since boot
+    uint16_t sample_period_ms;              ///< Time between readings
+    uint16_t detect_threshold;              ///< Counts above baseline
+    uint8_t filter_shift;                   ///< Filter time constant, 2^n
+    char ap_ssid[CONFIG_SSID_MAX + 1];      ///< Access point's name
+    char ap_password[CONFIG_PASSWORD_MAX + 1];  ///< Access point's password
+};
+
+
+/// Kinds of setting
+enum config_type_t : uint8_t
+{
+    CONFIG_UINT,                ///< Unsigned number of 1, 2 or 4 bytes
+    CONFIG_TEXT                 ///< Text which ends with a zero byte
+};
+
+
+/** @brief   Description of one setting.
+ */
+struct config_item_t
+{
+    const char* key;            ///< Name in @c /config and in NVS, at most 15
+    config_type_t type;         ///< Kind of setting
+    bool secret;                ///< Not shown when the settings are read
+    uint8_t size;               ///< Bytes in its place in @c config_t
+    uint16_t offset;            ///< Where it is in @c config_t
+    uint32_t min;               ///< Smallest value, or fewest characters
+    uint32_t max;               ///< Largest value, or most characters
+};
+
+
+/// Results of changing a setting
+enum config_result_t : uint8_t
+{
+    CONFIG_OK,                  ///< The setting was changed
+    CONFIG_UNKNOWN,             ///< No setting has that name
+    CONFIG_NOT_A_NUMBER,        ///< A number was expected
+    CONFIG_OUT_OF_RANGE,        ///< The value or its length is out of range
+    CONFIG_TOO_SOON             ///< The last change was too recent
+};
+
+
+// Get the description of a setting, or NULL if there are no more
+const config_item_t* config_item_at (uint8_t index);
+
+// Find the description of a setting by its name, or NULL
+const config_item_t* config_find (const char* key);
+
+// Get the name of a result, for error messages
+const char* config_result_name (config_result_t result);
+
+// Read a number setting from a snapshot
+uint32_t config_get_uint (const config_t& config, const config_item_t& item);
+
+// Read a text setting from a snapshot
+const char* config_get_text (const config_t& config,
+                             const config_item_t& item);
+
+// Check a number and put it into a setting
+config_result_t config_set_uint (config_t& config, const config_item_t& item,
+                                 uint32_t value);
+
+// Check some text and put it into a setting
+config_result_t config_set_text (config_t& config, const config_item_t& item,
+                                 const char* text);
+
+// Turn text into a setting of either kind, checking it
+config_result_t config_parse (config_t& config, const config_item_t& item,
+                              const char* text);
+
+// Make the first snapshot, before any task reads the settings
+void config_begin (const config_t& initial);
+
+// Get the settings in use, without waiting
+const config_t& config_now (void);
+
+// Put changed settings into use
+config_result_t config_publish (const config_t& config, uint32_t now_ms);
+
+#endif // _CONFIG_STORE_H_
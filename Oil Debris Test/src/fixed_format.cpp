@@ -0,0 +1,128 @@
+/** @file fixed_format.cpp
+ *  This file contains number-to-text conversions which use a table of digit
+ *  pairs, so each division by 100 produces two characters at once. None of
+ *  them add a terminating null; they return the number of characters
+ *  written so the caller can keep appending.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include "fixed_format.h"
+
+/// The two-character text of every number from 00 to 99
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+
+/** @brief   Find the number of decimal digits in a number.
+ */
+static inline uint8_t digit_count (uint32_t value)
+{
+    uint8_t count = 1;
+    while (value >= 100)
+    {
+        value /= 100;
+        count += 2;
+    }
+    return (value >= 10) ? count + 1 : count;
+}
+
+
+/** @brief   Write the last @c count digits of a number, ending just before
+ *           @c end, two at a time.
+ */
+static inline void put_digits (char* end, uint32_t value, uint8_t count)
+{
+    while (count >= 2)
+    {
+        end -= 2;
+        memcpy (end, digit_pairs + 2 * (value % 100), 2);
+        value /= 100;
+        count -= 2;
+    }
+    if (count)
+    {
+        *--end = '0' + value % 10;
+    }
+}
+
+
+/** @brief   Write an unsigned number in decimal.
+ *  @param   out Where the text goes; it needs room for 10 characters
+ *  @param   value The number to write
+ *  @returns The number of characters written
+ */
+size_t fmt_uint (char* out, uint32_t value)
+{
+    uint8_t count = digit_count (value);
+    put_digits (out + count, value, count);
+    return count;
+}
+
+
+/** @brief   Write a signed number in decimal.
+ *  @param   out Where the text goes; it needs room for 11 characters
+ *  @param   value The number to write
+ *  @returns The number of characters written
+ */
+size_t fmt_int (char* out, int32_t value)
+{
+    if (value < 0)
+    {
+        *out = '-';
+        return 1 + fmt_uint (out + 1, 0 - (uint32_t)value);
+    }
+    return fmt_uint (out, (uint32_t)value);
+}
+
+
+/** @brief   Write a scaled integer with a fixed number of decimal places.
+ *  @details For example, 1234 millivolts with three decimals is written as
+ *           "1.234" and 5 millivolts as "0.005".
+ *  @param   out Where the text goes; it needs room for @c FMT_MAX_CHARS
+ *           characters
+ *  @param   value The number times 10^decimals
+ *  @param   decimals The number of digits after the decimal point, 0 to 9
+ *  @returns The number of characters written
+ */
+size_t fmt_fixed (char* out, int32_t value, uint8_t decimals)
+{
+    if (decimals == 0)
+    {
+        return fmt_int (out, value);
+    }
+
+    char* p = out;
+    uint32_t magnitude = (uint32_t)value;
+    if (value < 0)
+    {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    // Pad with zeros so there is at least one digit before the point
+    uint8_t count = digit_count (magnitude);
+    if (count <= decimals)
+    {
+        count = decimals + 1;
+    }
+
+    // Write the digits, then slide the fraction over to fit in the point
+    put_digits (p + count, magnitude, count);
+    memmove (p + count - decimals + 1, p + count - decimals, decimals);
+    p[count - decimals] = '.';
+
+    return (p - out) + count + 1;
+}
@@ -0,0 +1,47 @@
+/** @file fixed_format.h
+ *  This file contains fast number-to-text conversions which write straight
+ *  into a caller's buffer. Voltages are handled as whole millivolts and
+ *  shown with a fixed number of decimal places, so no floating point
+ *  formatting, and no heap memory, is needed.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _FIXED_FORMAT_H_
+#define _FIXED_FORMAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Room needed for any number written by these functions, with its sign
+const size_t FMT_MAX_CHARS = 12;
+
+/// Full-scale voltage of the wear sensor inputs in millivolts
+const uint32_t FULL_SCALE_MV = 5000;
+
+/// Largest reading from the 12-bit ADC
+const uint32_t ADC_MAX_COUNTS = 4095;
+
+
+/** @brief   Convert an ADC reading to millivolts, rounded to the nearest.
+ *  @param   counts The ADC reading, from 0 to @c ADC_MAX_COUNTS
+ *  @returns The voltage in millivolts
+ */
+inline uint16_t counts_to_millivolts (uint32_t counts)
+{
+    return (uint16_t)((counts * FULL_SCALE_MV + ADC_MAX_COUNTS / 2)
+                      / ADC_MAX_COUNTS);
+}
+
+// Write an unsigned number in decimal; returns the number of characters
+size_t fmt_uint (char* out, uint32_t value);
+
+// Write a signed number in decimal; returns the number of characters
+size_t fmt_int (char* out, int32_t value);
+
+// Write a scaled integer with a fixed number of decimal places
+size_t fmt_fixed (char* out, int32_t value, uint8_t decimals);
+
+#endif // _FIXED_FORMAT_H_
@@ -0,0 +1,443 @@
+/** @file gorilla.cpp
+ *  This file contains the delta-of-delta timestamp and XOR float compressor
+ *  described in Pelkonen et al., "Gorilla: A Fast, Scalable, In-Memory Time
+ *  Series Database," VLDB 2015, adapted to 32-bit floats and millisecond
+ *  timestamps.
+ *
+ *  The code uses no Arduino or FreeRTOS calls so that the decoder can also
+ *  be built on a PC.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include "gorilla.h"
+
+/// Marks a column whose previous XOR window has not been set yet
+const uint8_t NO_WINDOW = 0xFF;
+
+/// Largest number of bits one row's timestamp can take
+const size_t MAX_TIME_BITS = 4 + 32;
+
+/// Largest number of bits one value can take
+const size_t MAX_VALUE_BITS = 2 + 5 + 5 + 32;
+
+
+/** @brief   Get the bits of a float as an unsigned integer.
+ */
+static inline uint32_t float_bits (float value)
+{
+    uint32_t bits;
+    memcpy (&bits, &value, sizeof (bits));
+    return bits;
+}
+
+
+/** @brief   Make a float from its bits held in an unsigned integer.
+ */
+static inline float bits_float (uint32_t bits)
+{
+    float value;
+    memcpy (&value, &bits, sizeof (value));
+    return value;
+}
+
+
+/** @brief   Store a 32-bit number in little-endian order.
+ */
+static inline void put_u32 (uint8_t* p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+
+/** @brief   Store a 16-bit number in little-endian order.
+ */
+static inline void put_u16 (uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+
+/** @brief   Read a little-endian 32-bit number.
+ */
+static inline uint32_t get_u32 (const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+           | ((uint32_t)p[3] << 24);
+}
+
+
+/** @brief   Create an encoder which writes into the given buffer.
+ *  @param   buffer Pointer to memory which holds the compressed block
+ *  @param   capacity The size of the buffer in bytes, at most 65535
+ *  @param   columns The number of float values in each row, from 1 to
+ *           @c GORILLA_MAX_COLUMNS
+ */
+GorillaEncoder::GorillaEncoder (uint8_t* buffer, size_t capacity,
+                                uint8_t columns)
+    : buffer (buffer), capacity (capacity)
+{
+    if (columns > GORILLA_MAX_COLUMNS)
+    {
+        columns = GORILLA_MAX_COLUMNS;
+    }
+    this->columns = columns;
+    reset ();
+}
+
+
+/** @brief   Throw away all the rows in the block and start again.
+ */
+void GorillaEncoder::reset (void)
+{
+    rows = 0;
+    prev_time = 0;
+    prev_delta = 0;
+    bit_pos = GORILLA_HEADER_SIZE * 8;
+    if (capacity >= GORILLA_HEADER_SIZE)
+    {
+        memset (buffer, 0, GORILLA_HEADER_SIZE);
+        buffer[0] = GORILLA_MAGIC;
+        buffer[1] = columns;
+        put_u16 (buffer + 2, (uint16_t)GORILLA_HEADER_SIZE);
+    }
+}
+
+
+/** @brief   Write up to 32 bits into the block, most significant bit first.
+ *  @param   value The bits to be written, right justified
+ *  @param   count The number of bits to write
+ *  @returns @c true if the bits fit in the buffer
+ */
+bool GorillaEncoder::write_bits (uint32_t value, uint8_t count)
+{
+    if (bit_pos + count > capacity * 8)
+    {
+        return false;
+    }
+    while (count)
+    {
+        size_t byte = bit_pos / 8;
+        uint8_t used = bit_pos % 8;
+        if (used == 0)
+        {
+            buffer[byte] = 0;
+        }
+        uint8_t room = 8 - used;
+        uint8_t take = (count < room) ? count : room;
+        uint8_t chunk = (uint8_t)((value >> (count - take)) & ((1 << take) - 1));
+        buffer[byte] |= chunk << (room - take);
+        bit_pos += take;
+        count -= take;
+    }
+    return true;
+}
+
+
+/** @brief   Write the timestamp of a row as a delta of deltas.
+ *  @details A steady sample rate gives a delta of delta of zero, which takes
+ *           one bit. Jitter of a few ticks takes nine bits.
+ *  @param   time The timestamp of the row
+ *  @returns @c true if the bits fit in the buffer
+ */
+bool GorillaEncoder::write_time (uint32_t time)
+{
+    // The sums are done unsigned so a clock jump of over 2^31 ticks wraps
+    int32_t delta = (int32_t)(time - prev_time);
+    int32_t dod = (int32_t)((uint32_t)delta - (uint32_t)prev_delta);
+    prev_time = time;
+    prev_delta = delta;
+
+    if (dod == 0)
+    {
+        return write_bits (0b0, 1);
+    }
+    else if (dod >= -64 && dod <= 63)
+    {
+        return write_bits (0b10, 2) && write_bits ((uint32_t)dod & 0x7F, 7);
+    }
+    else if (dod >= -256 && dod <= 255)
+    {
+        return write_bits (0b110, 3) && write_bits ((uint32_t)dod & 0x1FF, 9);
+    }
+    else if (dod >= -2048 && dod <= 2047)
+    {
+        return write_bits (0b1110, 4) && write_bits ((uint32_t)dod & 0xFFF, 12);
+    }
+    return write_bits (0b1111, 4) && write_bits ((uint32_t)dod, 32);
+}
+
+
+/** @brief   Write one value as the XOR with the previous value in its column.
+ *  @details An unchanged value takes one bit. A value whose XOR fits in the
+ *           previous window of meaningful bits takes two bits plus the
+ *           window; otherwise a new window is described in ten more bits.
+ *  @param   column The column to which the value belongs
+ *  @param   value The value to be written
+ *  @returns @c true if the bits fit in the buffer
+ */
+bool GorillaEncoder::write_value (uint8_t column, float value)
+{
+    uint32_t bits = float_bits (value);
+    uint32_t xored = bits ^ prev_bits[column];
+    prev_bits[column] = bits;
+
+    if (xored == 0)
+    {
+        return write_bits (0b0, 1);
+    }
+
+    uint8_t lead = (uint8_t)__builtin_clz (xored);
+    uint8_t trail = (uint8_t)__builtin_ctz (xored);
+    if (prev_lead[column] != NO_WINDOW && lead >= prev_lead[column]
+        && trail >= prev_trail[column])
+    {
+        uint8_t length = 32 - prev_lead[column] - prev_trail[column];
+        return write_bits (0b10, 2)
+               && write_bits (xored >> prev_trail[column], length);
+    }
+
+    uint8_t length = 32 - lead - trail;
+    prev_lead[column] = lead;
+    prev_trail[column] = trail;
+    return write_bits (0b11, 2) && write_bits (lead, 5)
+           && write_bits (length - 1, 5) && write_bits (xored >> trail, length);
+}
+
+
+/** @brief   Add one row of values to the block.
+ *  @details The row is only added if it is sure to fit, so a block which has
+ *           filled up is still complete and can be decoded.
+ *  @param   time The timestamp of the row, usually in milliseconds
+ *  @param   values Pointer to an array holding one value for each column
+ *  @returns @c true if the row was added, @c false if the block is full
+ */
+bool GorillaEncoder::append (uint32_t time, const float* values)
+{
+    if (capacity < GORILLA_HEADER_SIZE || columns == 0
+        || bit_pos + MAX_TIME_BITS + MAX_VALUE_BITS * columns > capacity * 8)
+    {
+        return false;
+    }
+
+    if (rows == 0)
+    {
+        // The first row's time goes in the header and its values go verbatim
+        put_u32 (buffer + 8, time);
+        prev_time = time;
+        prev_delta = 0;
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            prev_bits[col] = float_bits (values[col]);
+            prev_lead[col] = NO_WINDOW;
+            prev_trail[col] = 0;
+            write_bits (prev_bits[col], 32);
+        }
+    }
+    else
+    {
+        write_time (time);
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            write_value (col, values[col]);
+        }
+    }
+
+    rows++;
+    put_u16 (buffer + 2, (uint16_t)size ());
+    put_u32 (buffer + 4, rows);
+    return true;
+}
+
+
+/** @brief   Create a decoder which reads the given block.
+ *  @details If @c length is more than the size recorded in the block's
+ *           header, only the recorded size is read, so @c block_size() can
+ *           find the start of a following block.
+ *  @param   buffer Pointer to a block made by @c GorillaEncoder
+ *  @param   length The number of bytes available at @c buffer
+ */
+GorillaDecoder::GorillaDecoder (const uint8_t* buffer, size_t length)
+    : buffer (buffer), length (length), bit_pos (GORILLA_HEADER_SIZE * 8),
+      columns (0), rows (0), row (0), prev_time (0), prev_delta (0)
+{
+    if (length >= GORILLA_HEADER_SIZE && buffer[0] == GORILLA_MAGIC
+        && buffer[1] > 0 && buffer[1] <= GORILLA_MAX_COLUMNS)
+    {
+        columns = buffer[1];
+        uint16_t used = (uint16_t)(buffer[2] | (buffer[3] << 8));
+        if (used >= GORILLA_HEADER_SIZE && used <= length)
+        {
+            this->length = used;
+        }
+        rows = get_u32 (buffer + 4);
+        prev_time = get_u32 (buffer + 8);
+    }
+}
+
+
+/** @brief   Read up to 32 bits from the block, most significant bit first.
+ *  @param   count The number of bits to read
+ *  @param   value Set to the bits read, right justified
+ *  @returns @c true if there were enough bits left in the block
+ */
+bool GorillaDecoder::read_bits (uint8_t count, uint32_t& value)
+{
+    if (bit_pos + count > length * 8)
+    {
+        return false;
+    }
+    value = 0;
+    while (count)
+    {
+        uint8_t used = bit_pos % 8;
+        uint8_t room = 8 - used;
+        uint8_t take = (count < room) ? count : room;
+        uint8_t chunk = (buffer[bit_pos / 8] >> (room - take))
+                        & ((1 << take) - 1);
+        value = (value << take) | chunk;
+        bit_pos += take;
+        count -= take;
+    }
+    return true;
+}
+
+
+/** @brief   Read a timestamp which was written by
+ *           @c GorillaEncoder::write_time().
+ */
+bool GorillaDecoder::read_time (uint32_t& time)
+{
+    static const uint8_t widths[] = { 7, 9, 12, 32 };
+    uint32_t bit;
+    uint8_t ones = 0;
+    while (ones < 4)
+    {
+        if (!read_bits (1, bit))
+        {
+            return false;
+        }
+        if (bit == 0)
+        {
+            break;
+        }
+        ones++;
+    }
+
+    int32_t dod = 0;
+    if (ones > 0)
+    {
+        uint8_t width = widths[ones - 1];
+        uint32_t raw;
+        if (!read_bits (width, raw))
+        {
+            return false;
+        }
+        // Sign extend from the field width
+        if (width < 32 && (raw & (1UL << (width - 1))))
+        {
+            raw |= ~((1UL << width) - 1);
+        }
+        dod = (int32_t)raw;
+    }
+
+    prev_delta = (int32_t)((uint32_t)prev_delta + (uint32_t)dod);
+    prev_time += prev_delta;
+    time = prev_time;
+    return true;
+}
+
+
+/** @brief   Read a value which was written by
+ *           @c GorillaEncoder::write_value().
+ */
+bool GorillaDecoder::read_value (uint8_t column, float& value)
+{
+    uint32_t control;
+    if (!read_bits (1, control))
+    {
+        return false;
+    }
+    if (control == 1)
+    {
+        if (!read_bits (1, control))
+        {
+            return false;
+        }
+        if (control == 1)
+        {
+            uint32_t lead, length;
+            if (!read_bits (5, lead) || !read_bits (5, length))
+            {
+                return false;
+            }
+            prev_lead[column] = (uint8_t)lead;
+            prev_trail[column] = (uint8_t)(32 - lead - (length + 1));
+        }
+        uint8_t length = 32 - prev_lead[column] - prev_trail[column];
+        uint32_t meaningful;
+        if (!read_bits (length, meaningful))
+        {
+            return false;
+        }
+        prev_bits[column] ^= meaningful << prev_trail[column];
+    }
+    value = bits_float (prev_bits[column]);
+    return true;
+}
+
+
+/** @brief   Read the next row from the block.
+ *  @param   time Set to the timestamp of the row
+ *  @param   values Pointer to an array into which one value for each column
+ *           is written
+ *  @returns @c true if a row was read, @c false at the end of the block or
+ *           if the block is damaged
+ */
+bool GorillaDecoder::next (uint32_t& time, float* values)
+{
+    if (row >= rows)
+    {
+        return false;
+    }
+
+    if (row == 0)
+    {
+        time = prev_time;
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            if (!read_bits (32, prev_bits[col]))
+            {
+                return false;
+            }
+            prev_lead[col] = NO_WINDOW;
+            prev_trail[col] = 0;
+            values[col] = bits_float (prev_bits[col]);
+        }
+    }
+    else
+    {
+        if (!read_time (time))
+        {
+            return false;
+        }
+        for (uint8_t col = 0; col < columns; col++)
+        {
+            if (!read_value (col, values[col]))
+            {
+                return false;
+            }
+        }
+    }
+
+    row++;
+    return true;
+}
+
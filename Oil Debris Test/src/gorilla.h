@@ -0,0 +1,122 @@
+/** @file gorilla.h
+ *  This file contains a time series compressor in the style of Facebook's
+ *  Gorilla database. Timestamps are stored as deltas of deltas and values
+ *  are stored as the XOR of each float with the previous one in its column,
+ *  so slowly changing signals sampled at a steady rate take only a few bits
+ *  per sample.
+ *
+ *  A block holds rows which each have one timestamp and one to
+ *  @c GORILLA_MAX_COLUMNS float values. The block is written into a buffer
+ *  supplied by the caller and can be sent as-is to a PC, where
+ *  @c GorillaDecoder or @c tools/gorilla_decode.py turns it back into rows.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _GORILLA_H_
+#define _GORILLA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// The largest number of float columns in one block
+const uint8_t GORILLA_MAX_COLUMNS = 8;
+
+/// Number of bytes in the header at the start of each block
+const size_t GORILLA_HEADER_SIZE = 12;
+
+/// Marker byte at the start of every block
+const uint8_t GORILLA_MAGIC = 'G';
+
+
+/** @brief   Class which compresses rows of timestamped floats into a buffer.
+ *  @details The header holds a marker byte, the column count, the size of the
+ *           block in bytes, the number of rows and the first timestamp, all
+ *           little-endian. Because the size is in the header, blocks can be
+ *           sent back to back and split apart again by the decoder. The bit
+ *           stream which follows holds the first row's values verbatim and
+ *           every later row as a delta-of-delta timestamp and one XOR-coded
+ *           value per column.
+ */
+class GorillaEncoder
+{
+protected:
+    uint8_t* buffer;                  ///< Memory into which the block goes
+    size_t capacity;                  ///< Size of @c buffer in bytes
+    size_t bit_pos;                   ///< Next bit to be written
+    uint8_t columns;                  ///< Number of values in each row
+    uint32_t rows;                    ///< Number of rows in the block
+    uint32_t prev_time;               ///< Timestamp of the previous row
+    int32_t prev_delta;               ///< Previous timestamp delta
+    uint32_t prev_bits[GORILLA_MAX_COLUMNS];    ///< Previous values as bits
+    uint8_t prev_lead[GORILLA_MAX_COLUMNS];     ///< Previous leading zeros
+    uint8_t prev_trail[GORILLA_MAX_COLUMNS];    ///< Previous trailing zeros
+
+    bool write_bits (uint32_t value, uint8_t count);
+    bool write_time (uint32_t time);
+    bool write_value (uint8_t column, float value);
+
+public:
+    GorillaEncoder (uint8_t* buffer, size_t capacity, uint8_t columns);
+
+    void reset (void);
+    bool append (uint32_t time, const float* values);
+
+    /// Get a pointer to the block, which is valid to @c size() bytes
+    const uint8_t* data (void) const { return buffer; }
+
+    /// Get the number of bytes of the buffer which the block uses so far
+    size_t size (void) const { return (bit_pos + 7) / 8; }
+
+    /// Get the number of rows which have been stored in the block
+    uint32_t count (void) const { return rows; }
+
+    /// Get the number of bits used so far, including the header
+    size_t bits (void) const { return bit_pos; }
+};
+
+
+/** @brief   Class which reads rows back out of a block made by
+ *           @c GorillaEncoder.
+ */
+class GorillaDecoder
+{
+protected:
+    const uint8_t* buffer;            ///< The block being decoded
+    size_t length;                    ///< Size of the block in bytes
+    size_t bit_pos;                   ///< Next bit to be read
+    uint8_t columns;                  ///< Number of values in each row
+    uint32_t rows;                    ///< Number of rows in the block
+    uint32_t row;                     ///< Number of rows read so far
+    uint32_t prev_time;               ///< Timestamp of the previous row
+    int32_t prev_delta;               ///< Previous timestamp delta
+    uint32_t prev_bits[GORILLA_MAX_COLUMNS];    ///< Previous values as bits
+    uint8_t prev_lead[GORILLA_MAX_COLUMNS];     ///< Previous leading zeros
+    uint8_t prev_trail[GORILLA_MAX_COLUMNS];    ///< Previous trailing zeros
+
+    bool read_bits (uint8_t count, uint32_t& value);
+    bool read_time (uint32_t& time);
+    bool read_value (uint8_t column, float& value);
+
+public:
+    GorillaDecoder (const uint8_t* buffer, size_t length);
+
+    /// Check whether the block had a sensible header
+    bool valid (void) const { return columns != 0; }
+
+    /// Get the number of values in each row
+    uint8_t column_count (void) const { return columns; }
+
+    /// Get the number of rows the block holds
+    uint32_t count (void) const { return rows; }
+
+    /// Get the number of bytes the block occupies, so that the start of a
+    /// block sent right after this one can be found
+    size_t block_size (void) const { return length; }
+
+    bool next (uint32_t& time, float* values);
+};
+
+#endif // _GORILLA_H_
@@ -0,0 +1,112 @@
+/** @file history_json.cpp
+ *  This file contains the function which turns a copy of the compressed
+ *  voltage history into the rows of JSON sent by @c /api/samples.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "gorilla.h"
+#include "channels.h"
+#include "history_json.h"
+
+
+/** @brief   Count the rows in a copy of the voltage history.
+ *  @param   snapshot The history, as copied by @c history_snapshot()
+ *  @param   length The number of bytes in the copy
+ *  @returns The number of rows in all its blocks
+ */
+uint32_t history_rows (const uint8_t* snapshot, size_t length)
+{
+    uint32_t total = 0;
+    for (size_t offset = 0; offset < length; )
+    {
+        GorillaDecoder block (snapshot + offset, length - offset);
+        if (!block.valid ())
+        {
+            break;
+        }
+        total += block.count ();
+        offset += block.block_size ();
+    }
+    return total;
+}
+
+
+/** @brief   Write the newest rows of a copy of the voltage history as JSON.
+ *  @details The rows are decoded one at a time as they're written, so no
+ *           more memory is needed however long the history is. The members
+ *           @c columns, @c count and @c rows are written into the object
+ *           which the caller has begun; each row is the time and then each
+ *           channel's voltage, as in @c [time_ms, fine_V, coarse_V]. The
+ *           columns are named after the channel table, and there are as
+ *           many as the history's blocks hold.
+ *  @param   json The writer, inside an object
+ *  @param   snapshot The history, as copied by @c history_snapshot()
+ *  @param   length The number of bytes in the copy
+ *  @param   max The most rows to write, the newest being kept
+ *  @returns The number of rows written
+ */
+uint32_t history_write_json (JsonWriter& json, const uint8_t* snapshot,
+                             size_t length, uint32_t max)
+{
+    // Count the rows so that only the newest ones need be sent
+    uint32_t total = history_rows (snapshot, length);
+    uint32_t wanted = (max < total) ? max : total;
+    uint32_t skip = total - wanted;
+
+    // The blocks all have a column for each channel in the table
+    GorillaDecoder first (snapshot, length);
+    uint8_t columns = first.valid () ? first.column_count () : CHANNEL_COUNT;
+    json.begin_array ("columns");
+    json.value_string ("time_ms");
+    for (uint8_t column = 0; column < columns; column++)
+    {
+        char name[CHANNEL_NAME_MAX + 8];
+        if (column < CHANNEL_COUNT)
+        {
+            snprintf (name, sizeof (name), "%.*s_V", CHANNEL_NAME_MAX,
+                      CHANNELS[column].name);
+        }
+        else
+        {
+            snprintf (name, sizeof (name), "ch%u_V", column);
+        }
+        json.value_string (name);
+    }
+    json.end_array ();
+    json.member_uint ("count", wanted);
+    json.begin_array ("rows");
+    for (size_t offset = 0; offset < length; )
+    {
+        GorillaDecoder block (snapshot + offset, length - offset);
+        if (!block.valid ())
+        {
+            break;
+        }
+        uint32_t time;
+        float volts[GORILLA_MAX_COLUMNS];
+        while (block.next (time, volts))
+        {
+            if (skip)
+            {
+                skip--;
+                continue;
+            }
+            json.begin_array ();
+            json.value_uint (time);
+            for (uint8_t column = 0; column < block.column_count ();
+                 column++)
+            {
+                json.value_fixed (lroundf (volts[column] * 1000), 3);
+            }
+            json.end_array ();
+        }
+        offset += block.block_size ();
+    }
+    json.end_array ();
+    return wanted;
+}
@@ -0,0 +1,26 @@
+/** @file history_json.h
+ *  This file contains the function which turns a copy of the compressed
+ *  voltage history into the rows of JSON sent by @c /api/samples. It is
+ *  kept apart from the web server so that the host benchmark renders the
+ *  history the same way the tester does.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _HISTORY_JSON_H_
+#define _HISTORY_JSON_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "json_writer.h"
+
+// Count the rows in a copy of the voltage history
+uint32_t history_rows (const uint8_t* snapshot, size_t length);
+
+// Write the newest rows of a copy of the voltage history as JSON members
+uint32_t history_write_json (JsonWriter& json, const uint8_t* snapshot,
+                             size_t length, uint32_t max);
+
+#endif // _HISTORY_JSON_H_
@@ -0,0 +1,234 @@
+/** @file json_writer.cpp
+ *  This file contains a streaming JSON writer which sends its text through a
+ *  @c ResponseWriter without building a document or any strings in memory.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "json_writer.h"
+
+
+/** @brief   Create a JSON writer which sends its text to a response.
+ *  @param   out The response, which should already have been started with
+ *           @c ResponseWriter::begin()
+ */
+JsonWriter::JsonWriter (ResponseWriter& out)
+    : out (out), depth (0)
+{
+    has_items[0] = false;
+}
+
+
+/** @brief   Write a comma if this isn't the first item at this level.
+ */
+void JsonWriter::separator (void)
+{
+    if (has_items[depth])
+    {
+        out.write (",", 1);
+    }
+    has_items[depth] = true;
+}
+
+
+/** @brief   Write the name of an object member and the colon after it.
+ */
+void JsonWriter::name (const char* key)
+{
+    separator ();
+    string (key);
+    out.write (":", 1);
+}
+
+
+/** @brief   Write text in quotes, escaping the characters JSON requires.
+ */
+void JsonWriter::string (const char* text)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out.write ("\"", 1);
+    const char* run = text;
+    for (; *text; text++)
+    {
+        unsigned char ch = (unsigned char)*text;
+        if (ch >= 0x20 && ch != '"' && ch != '\\')
+        {
+            continue;
+        }
+
+        // Send the plain characters before this one in a single write
+        out.write (run, text - run);
+        run = text + 1;
+        if (ch == '"' || ch == '\\')
+        {
+            char escape[2] = { '\\', (char)ch };
+            out.write (escape, 2);
+        }
+        else
+        {
+            char escape[6] = { '\\', 'u', '0', '0', hex[ch >> 4],
+                               hex[ch & 0x0F] };
+            out.write (escape, 6);
+        }
+    }
+    out.write (run, text - run);
+    out.write ("\"", 1);
+}
+
+
+/** @brief   Start an object which is an array item or the whole document.
+ */
+void JsonWriter::begin_object (void)
+{
+    if (depth > 0)
+    {
+        separator ();
+    }
+    out.write ("{", 1);
+    if (depth < JSON_MAX_DEPTH)
+    {
+        has_items[++depth] = false;
+    }
+}
+
+
+/** @brief   Start an object which is a member of the enclosing object.
+ *  @param   key The name of the member
+ */
+void JsonWriter::begin_object (const char* key)
+{
+    name (key);
+    out.write ("{", 1);
+    if (depth < JSON_MAX_DEPTH)
+    {
+        has_items[++depth] = false;
+    }
+}
+
+
+/** @brief   Finish the object most recently started.
+ */
+void JsonWriter::end_object (void)
+{
+    out.write ("}", 1);
+    if (depth > 0)
+    {
+        depth--;
+    }
+}
+
+
+/** @brief   Start an array which is an item in the enclosing array.
+ */
+void JsonWriter::begin_array (void)
+{
+    separator ();
+    out.write ("[", 1);
+    if (depth < JSON_MAX_DEPTH)
+    {
+        has_items[++depth] = false;
+    }
+}
+
+
+/** @brief   Start an array which is a member of the enclosing object.
+ *  @param   key The name of the member
+ */
+void JsonWriter::begin_array (const char* key)
+{
+    name (key);
+    out.write ("[", 1);
+    if (depth < JSON_MAX_DEPTH)
+    {
+        has_items[++depth] = false;
+    }
+}
+
+
+/** @brief   Finish the array most recently started.
+ */
+void JsonWriter::end_array (void)
+{
+    out.write ("]", 1);
+    if (depth > 0)
+    {
+        depth--;
+    }
+}
+
+
+/** @brief   Write an unsigned number as an array item.
+ */
+void JsonWriter::value_uint (uint32_t number)
+{
+    separator ();
+    out.write_uint (number);
+}
+
+
+/** @brief   Write a scaled integer with fixed decimal places as an array item.
+ */
+void JsonWriter::value_fixed (int32_t number, uint8_t decimals)
+{
+    separator ();
+    out.write_fixed (number, decimals);
+}
+
+
+/** @brief   Write a string as an array item.
+ */
+void JsonWriter::value_string (const char* text)
+{
+    separator ();
+    string (text);
+}
+
+
+/** @brief   Write an object member which holds an unsigned number.
+ */
+void JsonWriter::member_uint (const char* key, uint32_t number)
+{
+    name (key);
+    out.write_uint (number);
+}
+
+
+/** @brief   Write an object member which holds a signed number.
+ */
+void JsonWriter::member_int (const char* key, int32_t number)
+{
+    name (key);
+    out.write_int (number);
+}
+
+
+/** @brief   Write an object member which holds a scaled integer shown with a
+ *           fixed number of decimal places, such as millivolts as volts.
+ */
+void JsonWriter::member_fixed (const char* key, int32_t number,
+                               uint8_t decimals)
+{
+    name (key);
+    out.write_fixed (number, decimals);
+}
+
+
+/** @brief   Write an object member which holds a string.
+ */
+void JsonWriter::member_string (const char* key, const char* text)
+{
+    name (key);
+    string (text);
+}
+
+
+/** @brief   Write an object member which holds @c true or @c false.
+ */
+void JsonWriter::member_bool (const char* key, bool flag)
+{
+    name (key);
+    out.write (flag ? "true" : "false");
+}
@@ -0,0 +1,62 @@
+/** @file json_writer.h
+ *  This file contains a class which writes JSON text straight into a
+ *  @c ResponseWriter as it goes. No document is built in memory; the writer
+ *  only keeps track of how deeply objects and arrays are nested and whether
+ *  a comma is needed before the next item.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _JSON_WRITER_H_
+#define _JSON_WRITER_H_
+
+#include "response_writer.h"
+
+/// Version of the layout of the JSON sent by the @c /api endpoints; it is
+/// changed whenever a field is renamed, removed or changes its meaning
+const uint16_t JSON_SCHEMA_VERSION = 1;
+
+/// The deepest nesting of objects and arrays the writer can keep track of
+const uint8_t JSON_MAX_DEPTH = 8;
+
+
+/** @brief   Class which writes JSON text to a response as it's produced.
+ *  @details Members of objects are written with the @c member_...()
+ *           functions, which take the member's name; items in arrays are
+ *           written with the @c value_...() functions.
+ */
+class JsonWriter
+{
+protected:
+    ResponseWriter& out;                    ///< Where the text goes
+    uint8_t depth;                          ///< Current nesting depth
+    bool has_items[JSON_MAX_DEPTH + 1];     ///< A comma is needed next
+
+    void separator (void);
+    void name (const char* key);
+    void string (const char* text);
+
+public:
+    JsonWriter (ResponseWriter& out);
+
+    void begin_object (void);
+    void begin_object (const char* key);
+    void end_object (void);
+    void begin_array (void);
+    void begin_array (const char* key);
+    void end_array (void);
+
+    void value_uint (uint32_t number);
+    void value_fixed (int32_t number, uint8_t decimals);
+    void value_string (const char* text);
+
+    void member_uint (const char* key, uint32_t number);
+    void member_int (const char* key, int32_t number);
+    void member_fixed (const char* key, int32_t number, uint8_t decimals);
+    void member_string (const char* key, const char* text);
+    void member_bool (const char* key, bool flag);
+};
+
+#endif // _JSON_WRITER_H_
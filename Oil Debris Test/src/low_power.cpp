@@ -0,0 +1,294 @@
+/** @file low_power.cpp
+ *  This file contains the low-power mode's sleeping, radio schedule and
+ *  accounting. The sensor task calls @c power_wait_until() in place of a
+ *  task delay; light sleep stops every task, so the chip only sleeps when
+ *  the processing task has nothing to do and the radio is off. While the
+ *  radio is on, waits are ordinary task delays so the web server and WiFi
+ *  tasks can run.
+ *
+ *  Times come from @c esp_timer_get_time(), which keeps counting through
+ *  light sleep; the RTOS tick count doesn't, so it isn't used for timing.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <esp_sleep.h>
+#include "low_power.h"
+
+/// Microseconds in an hour
+static const int64_t HOUR_US = 3600LL * 1000000LL;
+
+/// Functions which turn the radio on and off
+static power_radio_t radio_on_fn = NULL;
+static power_radio_t radio_off_fn = NULL;
+
+/// Set while the schedule says the radio should be on
+static volatile bool radio_wanted = true;
+
+/// Set while the radio is on; setup() leaves it on for the first window
+static volatile bool radio_on = true;
+
+/// Time at which the radio schedule started
+static int64_t schedule_start = 0;
+
+/// Time at which the current hour began
+static int64_t hour_start = 0;
+
+/// Time up to which time has been counted
+static int64_t counted_to = 0;
+
+/// Times in microseconds for the hour so far
+static int64_t awake_us = 0;
+static int64_t asleep_us = 0;
+static int64_t radio_us = 0;
+static uint32_t sleeps = 0;
+
+/// Times for past hours, the newest at @c hours[newest_hour]
+static power_hour_t hours[POWER_HOURS_KEPT];
+static uint8_t newest_hour = 0;
+static uint8_t hours_kept = 0;
+
+/// Guards the times between the sensor task and the web server
+static portMUX_TYPE power_mux = portMUX_INITIALIZER_UNLOCKED;
+
+
+/** @brief   Count the time from the last count up to now as awake, moving
+ *           on to a new hour if this one is over.
+ *  @param   now The time in microseconds
+ *  @param   slept How much of the time was spent in light sleep
+ */
+static void tally (int64_t now, int64_t slept)
+{
+    int64_t span = now - counted_to;
+    counted_to = now;
+
+    portENTER_CRITICAL (&power_mux);
+    awake_us += span - slept;
+    asleep_us += slept;
+    if (radio_on)
+    {
+        radio_us += span;
+    }
+    if (slept > 0)
+    {
+        sleeps++;
+    }
+
+    if (now - hour_start >= HOUR_US)
+    {
+        newest_hour = (newest_hour + 1) % POWER_HOURS_KEPT;
+        power_hour_t& hour = hours[newest_hour];
+        hour.awake_ms = (uint32_t)(awake_us / 1000);
+        hour.asleep_ms = (uint32_t)(asleep_us / 1000);
+        hour.radio_ms = (uint32_t)(radio_us / 1000);
+        hour.sleeps = sleeps;
+        if (hours_kept < POWER_HOURS_KEPT)
+        {
+            hours_kept++;
+        }
+        awake_us = 0;
+        asleep_us = 0;
+        radio_us = 0;
+        sleeps = 0;
+        hour_start = now;
+    }
+    portEXIT_CRITICAL (&power_mux);
+}
+
+
+/** @brief   Start the low-power mode.
+ *  @details This should be called from setup() with the radio already on;
+ *           the first radio window starts now, so the tester can be reached
+ *           for a while after it's switched on.
+ *  @param   radio_on A function which turns the radio on
+ *  @param   radio_off A function which turns the radio off
+ */
+void power_begin (power_radio_t radio_on, power_radio_t radio_off)
+{
+    radio_on_fn = radio_on;
+    radio_off_fn = radio_off;
+
+    int64_t now = esp_timer_get_time ();
+    schedule_start = now;
+    hour_start = now;
+    counted_to = now;
+}
+
+
+/** @brief   Count time up to now and work out whether the chip may sleep.
+ *  @param   now The time in microseconds
+ *  @param   can_sleep The caller's word on whether the chip may sleep
+ *  @returns @c true if the radio is off and isn't wanted, and the caller
+ *           allows it
+ */
+static bool may_sleep (int64_t now, bool can_sleep)
+{
+    int64_t period = (int64_t)POWER_RADIO_PERIOD_S * 1000000LL;
+    int64_t window = (int64_t)POWER_RADIO_WINDOW_S * 1000000LL;
+    radio_wanted = (now - schedule_start) % period < window;
+    tally (now, 0);
+
+    return can_sleep && !radio_wanted && !radio_on;
+}
+
+
+/** @brief   Wait until a time, sleeping if nothing else needs the chip.
+ *  @details Light sleep is used if the radio is off, the caller says the
+ *           chip may sleep and the wait is long enough to be worth it.
+ *           The chip is woken @c POWER_WAKE_LEAD_US early and the rest is
+ *           spun away, so samples stay on time. Otherwise the wait is a
+ *           task delay, rounded up to a whole tick.
+ *  @param   wake_us The value of @c esp_timer_get_time() to wait for
+ *  @param   can_sleep @c false if other tasks have work to do, as when a
+ *           block is waiting to be processed
+ */
+void power_wait_until (int64_t wake_us, bool can_sleep)
+{
+    int64_t now = esp_timer_get_time ();
+    int64_t left = wake_us - now;
+
+    if (may_sleep (now, can_sleep) && left > (int64_t)POWER_MIN_SLEEP_US)
+    {
+        esp_sleep_enable_timer_wakeup (left - POWER_WAKE_LEAD_US);
+        esp_light_sleep_start ();
+        int64_t woke = esp_timer_get_time ();
+        tally (woke, woke - now);
+
+        while (esp_timer_get_time () < wake_us)
+        {
+        }
+    }
+    else if (left > 0)
+    {
+        vTaskDelay (pdMS_TO_TICKS ((uint32_t)((left + 999) / 1000)));
+    }
+}
+
+
+/** @brief   Sleep until another wakeup source fires, or a time at the latest.
+ *  @details This is for callers which have enabled a wakeup source of their
+ *           own, such as the ULP, and so don't know when they'll be woken.
+ *           The chip sleeps under the same conditions as in
+ *           @c power_wait_until(), but returns as soon as it wakes. When it
+ *           may not sleep the wait is a task delay of @c poll_ms instead.
+ *  @param   wake_us The latest value of @c esp_timer_get_time() to sleep to
+ *  @param   poll_ms How long to wait when the chip may not sleep
+ *  @param   can_sleep @c false if other tasks have work to do
+ */
+void power_wait_for_wakeup (int64_t wake_us, uint32_t poll_ms, bool can_sleep)
+{
+    int64_t now = esp_timer_get_time ();
+    int64_t left = wake_us - now;
+
+    if (may_sleep (now, can_sleep) && left > (int64_t)POWER_MIN_SLEEP_US)
+    {
+        esp_sleep_enable_timer_wakeup (left);
+        esp_light_sleep_start ();
+        int64_t woke = esp_timer_get_time ();
+        tally (woke, woke - now);
+    }
+    else
+    {
+        vTaskDelay (pdMS_TO_TICKS (poll_ms));
+    }
+}
+
+
+/** @brief   Turn the radio on or off when the schedule says to.
+ *  @details This is called every so often by a low-priority task. It gets
+ *           to run when a window opens because the chip stops sleeping as
+ *           soon as the radio is wanted.
+ */
+void power_run (void)
+{
+    if (radio_wanted && !radio_on)
+    {
+        if (radio_on_fn != NULL)
+        {
+            radio_on_fn ();
+        }
+        radio_on = true;
+    }
+    else if (!radio_wanted && radio_on)
+    {
+        if (radio_off_fn != NULL)
+        {
+            radio_off_fn ();
+        }
+        radio_on = false;
+    }
+}
+
+
+/** @brief   Find out whether the radio is on.
+ */
+bool power_radio_is_on (void)
+{
+    return radio_on;
+}
+
+
+/** @brief   Get the times spent in each state during an hour.
+ *  @param   hours_ago Zero for the hour so far, one for the last whole hour
+ *           and so on, up to @c POWER_HOURS_KEPT
+ *  @param   hour Set to the times in milliseconds
+ *  @returns @c true if that hour has been recorded
+ */
+bool power_get_hour (uint8_t hours_ago, power_hour_t& hour)
+{
+    bool found = true;
+
+    portENTER_CRITICAL (&power_mux);
+    if (hours_ago == 0)
+    {
+        hour.awake_ms = (uint32_t)(awake_us / 1000);
+        hour.asleep_ms = (uint32_t)(asleep_us / 1000);
+        hour.radio_ms = (uint32_t)(radio_us / 1000);
+        hour.sleeps = sleeps;
+    }
+    else if (hours_ago <= hours_kept)
+    {
+        hour = hours[(newest_hour + POWER_HOURS_KEPT + 1 - hours_ago)
+                     % POWER_HOURS_KEPT];
+    }
+    else
+    {
+        found = false;
+    }
+    portEXIT_CRITICAL (&power_mux);
+
+    return found;
+}
+
+
+/** @brief   Work out the average current from the times spent in each state.
+ *  @details Each state's current, from the @c POWER_..._UA constants, is
+ *           weighted by the time spent in it. The constants are typical
+ *           figures from the ESP32's data sheet; a board's own regulator
+ *           and sensors add to them, so they should be replaced with
+ *           measured values where the estimate matters.
+ *  @param   hour The times spent in each state
+ *  @param   budget Set to the estimate, which is all zeros if no time has
+ *           been counted
+ */
+void power_estimate (const power_hour_t& hour, power_budget_t& budget)
+{
+    uint64_t total = (uint64_t)hour.awake_ms + hour.asleep_ms;
+    if (total == 0)
+    {
+        budget = power_budget_t ();
+        return;
+    }
+
+    uint64_t charge = (uint64_t)hour.awake_ms * POWER_AWAKE_UA
+                      + (uint64_t)hour.asleep_ms * POWER_SLEEP_UA
+                      + (uint64_t)hour.radio_ms * POWER_RADIO_UA;
+    budget.awake_permille = (uint32_t)(hour.awake_ms * 1000ULL / total);
+    budget.radio_permille = (uint32_t)(hour.radio_ms * 1000ULL / total);
+    budget.average_ua = (uint32_t)(charge / total);
+    budget.mah_per_day = budget.average_ua * 24 / 1000;
+    budget.battery_hours = (budget.average_ua > 0)
+        ? (uint32_t)(POWER_BATTERY_MAH * 1000ULL / budget.average_ua) : 0;
+}
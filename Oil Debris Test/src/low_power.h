@@ -0,0 +1,97 @@
+/** @file low_power.h
+ *  This file contains a low-power mode for testers which run from a battery.
+ *  Between samples the whole chip goes into light sleep, woken by a timer in
+ *  time for the next sample; it stays awake only while a block is being
+ *  processed and stored. The radio is turned on for a short window on a
+ *  fixed schedule, so the readings can be fetched, and is off otherwise.
+ *  The time spent awake, asleep and with the radio on is measured each hour
+ *  and turned into an estimate of the average current.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _LOW_POWER_H_
+#define _LOW_POWER_H_
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+/// Time between the starts of the radio's windows, in seconds
+const uint32_t POWER_RADIO_PERIOD_S = 3600;
+
+/// How long the radio stays on in each window, in seconds; the first
+/// window opens at startup
+const uint32_t POWER_RADIO_WINDOW_S = 120;
+
+/// Shortest sleep worth going into; shorter waits are spent in a task delay
+const uint32_t POWER_MIN_SLEEP_US = 2000;
+
+/// How long before a sample the chip is woken, to cover the wakeup time
+const uint32_t POWER_WAKE_LEAD_US = 300;
+
+/// Current drawn with the CPUs running and the radio off, in microamps
+const uint32_t POWER_AWAKE_UA = 40000;
+
+/// Current drawn in light sleep, in microamps
+const uint32_t POWER_SLEEP_UA = 800;
+
+/// Extra current drawn while the radio is on, in microamps
+const uint32_t POWER_RADIO_UA = 80000;
+
+/// Capacity of the battery in milliamp-hours, for the battery life estimate
+const uint32_t POWER_BATTERY_MAH = 2000;
+
+/// Number of past hours whose awake time is kept
+const uint8_t POWER_HOURS_KEPT = 24;
+
+
+/** @brief   Time spent in each state during one hour, or part of one.
+ */
+struct power_hour_t
+{
+    uint32_t awake_ms;          ///< Time with the CPUs running
+    uint32_t asleep_ms;         ///< Time in light sleep
+    uint32_t radio_ms;          ///< Time with the radio on
+    uint32_t sleeps;            ///< Number of times the chip slept
+};
+
+
+/** @brief   Estimate of the current drawn, from the times measured.
+ */
+struct power_budget_t
+{
+    uint32_t awake_permille;    ///< Share of time awake, in thousandths
+    uint32_t radio_permille;    ///< Share of time with the radio on
+    uint32_t average_ua;        ///< Average current in microamps
+    uint32_t mah_per_day;       ///< Charge used per day in milliamp-hours
+    uint32_t battery_hours;     ///< Hours a full battery would last
+};
+
+/// Type of the functions which turn the radio on and off
+typedef void (*power_radio_t) (void);
+
+
+// Start the low-power mode with functions which switch the radio
+void power_begin (power_radio_t radio_on, power_radio_t radio_off);
+
+// Wait until a time, sleeping if nothing else needs the chip
+void power_wait_until (int64_t wake_us, bool can_sleep);
+
+// Sleep until a wakeup source the caller enabled fires, or a time at latest
+void power_wait_for_wakeup (int64_t wake_us, uint32_t poll_ms, bool can_sleep);
+
+// Turn the radio on or off when the schedule says to
+void power_run (void);
+
+// Find out whether the radio is on
+bool power_radio_is_on (void);
+
+// Get the times for the hour so far, or for an earlier hour
+bool power_get_hour (uint8_t hours_ago, power_hour_t& hour);
+
+// Work out the average current from the times in an hour
+void power_estimate (const power_hour_t& hour, power_budget_t& budget);
+
+#endif // _LOW_POWER_H_
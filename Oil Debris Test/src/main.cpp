@@ -31,18 +31,110 @@
 #include "taskshare.h"
 #include "taskqueue.h"
 #include "shares.h"
+#include "voltage_history.h"
+#include "sample_log.h"
+#include "sample_pipeline.h"
+#include "pipeline_stages.h"
+#include "block_kernels.h"
+#include "sample_schedule.h"
+#include "signal_gen.h"
+#include "channels.h"
+#include "config_store.h"
+#include "config_nvs.h"
+#include "mem_pool.h"
+#include "fixed_format.h"
+#include "response_writer.h"
+#include "json_writer.h"
+#include "history_json.h"
+#include "route_stats.h"
+#include "trace.h"
+#include "mqtt_publisher.h"
+#include "beacon.h"
+#include "wifi_link.h"
+#include "boot_timing.h"
+#include "low_power.h"
+#include "ulp_sampler.h"
+#include "spi_adc_bus.h"
 #include <WebServer.h>
 
 // Create integer variables for fine and course voltages.
 int fine, coarse;
 
-// Create share variables for voltages.
-Share<uint8_t> v_fine (0);
-Share<uint8_t> v_coarse (0);
+// Create share variables for voltages, in millivolts.
+Share<uint16_t> v_fine (0);
+Share<uint16_t> v_coarse (0);
 
-// define the input pins
-const int fine_wear = 36;
-const int coarse_wear = 39;
+/// The sensor channels, their input pins and their inputs on the external
+/// ADC if USE_SPI_ADC is defined. The fine and coarse wear
+/// sensors must come first; see channels.h. Up to PIPELINE_MAX_CHANNELS
+/// may be listed, such as sensors before and after a filter or on other
+/// gearboxes
+const channel_t CHANNELS[] =
+{
+  { "fine", 36, 0 },
+  { "coarse", 39, 1 }
+};
+const uint8_t CHANNEL_COUNT = sizeof (CHANNELS) / sizeof (CHANNELS[0]);
+
+// Time between readings in milliseconds at first, and readings per processed
+// block; 50 readings at 10 ms give the same half-second update rate as
+// before. The period can be changed at /config
+const uint16_t SAMPLE_PERIOD_MS = 10;
+const uint16_t BLOCK_SIZE = 50;
+
+// Counts above baseline at which a reading counts as a debris pulse, at
+// first, and the smoothing filter's time constant as a power of two
+const uint16_t DETECT_THRESHOLD = 40;
+const uint8_t FILTER_SHIFT = 2;
+
+// Records sent by /sync when the client doesn't say, and the most it may ask
+const uint16_t SYNC_DEFAULT_RECORDS = 256;
+const uint16_t SYNC_MAX_RECORDS = 2048;
+
+// Rows of the latest readings in the /csv page
+const uint8_t CSV_ROWS = 20;
+
+// Time between the web server's checks for requests in milliseconds
+const uint16_t WEB_POLL_MS = 500;
+
+// Stack size of each task in bytes
+const uint32_t SENSOR_STACK = 4000;
+const uint32_t PROCESS_STACK = 8192;
+const uint32_t WEB_STACK = 8192;
+const uint32_t WIFI_STACK = 4096;
+const uint32_t MQTT_STACK = 6144;
+const uint32_t POWER_STACK = 3072;
+const uint32_t BEACON_STACK = 3072;
+
+// Size of each buffer through which a response is written to the client
+const size_t RESPONSE_BUFFER_SIZE = RESPONSE_CHUNK_SIZE;
+
+/// Buffers for response writers; one per request being answered
+MemPool response_pool ("response", RESPONSE_BUFFER_SIZE, 2);
+
+/// Buffer into which the voltage history is copied for downloading
+MemPool download_pool ("download", 2 * HISTORY_BLOCK_SIZE, 1);
+
+// State kept between blocks by the align, filter and detector stages
+align_state_t align_state = { SAMPLE_PERIOD_MS * 1000, false, {} };
+filter_state_t filter_state = { FILTER_SHIFT, false, {} };
+detect_state_t detect_state = { DETECT_THRESHOLD, SAMPLE_PERIOD_MS, {} };
+
+/// The processing stages, in the order they run on each block; a stage
+/// left out here isn't built into the program
+typedef StageChain<stage_align, stage_filter, stage_detect, stage_store,
+                   stage_stream> processing_chain_t;
+
+/// What each stage is given with each block, in the order of the chain
+void* const STAGE_CONTEXTS[] =
+{
+  &align_state, &filter_state, &detect_state, NULL, NULL
+};
+
+/// The pipeline which carries blocks of readings from the sensor task to
+/// the processing task, with its blocks sized for the channel table
+StaticPipeline<CHANNEL_COUNT, BLOCK_SIZE, processing_chain_t>
+    pipeline (STAGE_CONTEXTS);
 
 // #define USE_LAN to have the ESP32 join an existing Local Area Network or 
 // #undef USE_LAN to have the ESP32 act as an access point, forming its own LAN
@@ -56,15 +148,149 @@ const int coarse_wear = 39;
 // If the ESP32 creates its own access point, put the credentials and network
 // parameters here; do not use any personally identifying or sensitive data
 #else
-const char* ssid = "debris_tester";   // SSID, network name seen on LAN lists
-const char* password = "password";   // ESP32 WiFi password (min. 8 characters)
-
 /* Put IP Address details */
 IPAddress local_ip (192, 168, 5, 1); // Address of ESP32 on its own network
 IPAddress gateway (192, 168, 5, 1);  // The ESP32 acts as its own gateway
 IPAddress subnet (255, 255, 255, 0); // Network mask; just leave this as is
 #endif
 
+/// Settings used until others are saved at /config, including the name and
+/// password of the access point the ESP32 makes when not on a LAN; the
+/// password must have at least 8 characters
+const config_t DEFAULT_CONFIG =
+{
+  0, SAMPLE_PERIOD_MS, DETECT_THRESHOLD, FILTER_SHIFT,
+  "debris_tester", "password"
+};
+
+#ifdef USE_LAN
+// The connection to the LAN, which is brought up and kept up in the
+// background by task_wifi()
+WifiLink wifi_link;
+
+// How often the WiFi task checks on the connection
+const uint32_t WIFI_POLL_MS = 100;
+
+// When on a LAN, @c mycerts.h should also give the MQTT broker's address,
+//   const char* mqtt_broker = "mqtt://192.168.1.10";
+// to which summaries of the log are published; see task_mqtt()
+MqttPublisher mqtt;
+
+// How often the MQTT task checks for records to publish
+const uint32_t MQTT_POLL_MS = 50;
+#endif
+
+// #define USE_BEACON to broadcast a small UDP datagram with the latest readings
+// at a steady rate, for dashboards which watch many testers at once, or
+// #undef USE_BEACON to leave it out; see task_beacon()
+#undef USE_BEACON
+
+#ifdef USE_BEACON
+TelemetryBeacon beacon;
+
+// Where beacons go: the broadcast address, or a multicast group like
+// 239.255.0.1 which the listeners join
+IPAddress beacon_target (255, 255, 255, 255);
+
+// UDP port to which beacons are sent; see tools/beacon_listen.py
+const uint16_t BEACON_PORT = 47210;
+
+// Time between beacons in milliseconds
+const uint16_t BEACON_PERIOD_MS = 1000;
+#endif
+
+// #define USE_LOW_POWER for testers which run from a battery: the chip sleeps
+// between samples and the radio is only on for a while each hour, or
+// #undef USE_LOW_POWER to keep everything on all the time; see low_power.h
+#undef USE_LOW_POWER
+
+#ifdef USE_LOW_POWER
+// How often the radio schedule is checked when not on a LAN
+const uint32_t POWER_POLL_MS = 100;
+#endif
+
+// #define USE_ULP to have the ULP coprocessor read the sensors into RTC
+// memory, so that with USE_LOW_POWER the CPUs sleep through many readings
+// at a time, or #undef USE_ULP to read them with analogRead(); see
+// ulp_sampler.h
+#undef USE_ULP
+
+#ifdef USE_ULP
+// How often the ULP's ring is emptied while the CPUs are awake; the ring
+// holds 2.5 seconds of readings
+const uint32_t ULP_POLL_MS = 100;
+
+/// Readings the ULP threw away because the ring was full
+uint32_t ulp_dropped = 0;
+
+/// Times a reading crossed a threshold and woke the CPUs
+uint32_t ulp_events = 0;
+
+/// The ULP's time between readings, which is set when it starts; a new
+/// period from /config takes effect after a restart
+uint16_t ulp_period_ms = SAMPLE_PERIOD_MS;
+#endif
+
+// #define USE_SPI_ADC to read the channels from an external SPI ADC, whose
+// inputs are given in the channel table, or #undef USE_SPI_ADC to use the
+// ESP32's own ADC; see spi_adc.h. It can't be used with USE_ULP, and with
+// USE_LOW_POWER the chip stays awake between samples
+#undef USE_SPI_ADC
+
+#if defined (USE_ULP) && defined (USE_SPI_ADC)
+#error "USE_ULP and USE_SPI_ADC can't both be defined"
+#endif
+
+#ifdef USE_SPI_ADC
+// The kind of external ADC, and the pins of the VSPI bus it's wired to
+const spi_adc_model_t SPI_ADC_MODEL = SPI_ADC_MCP3208;
+const spi_adc_pins_t SPI_ADC_PINS = { 18, 19, 23, 5 };
+
+// Scans converted back to back and averaged into each sample, which makes
+// the readings quieter; cut down to what fits in a batch
+const uint16_t SPI_ADC_SCANS = 8;
+
+/// The external ADC's driver
+SpiAdc spi_adc (SPI_ADC_MODEL);
+
+/// Two batches, so one converts while the other is decoded
+spi_adc_batch_t spi_batches[SPI_ADC_BATCHES_IN_FLIGHT];
+
+/** @brief   Sums of the readings in one batch of scans from the external ADC.
+ */
+struct spi_burst_t
+{
+  uint32_t sums[PIPELINE_MAX_CHANNELS];   ///< Sum of each channel's readings
+  uint16_t scans;                         ///< Number of scans summed
+};
+#endif
+
+// #define USE_SIMULATED to read the channels from the synthetic signal
+// generator instead of the ADC pins, with the truth about every particle
+// added to the flash log; see signal_gen.h. It takes the place of
+// analogRead(), so it can't be used with USE_ULP or USE_SPI_ADC
+#undef USE_SIMULATED
+
+#if defined (USE_SIMULATED) && (defined (USE_ULP) || defined (USE_SPI_ADC))
+#error "USE_SIMULATED can't be used with USE_ULP or USE_SPI_ADC"
+#endif
+
+#ifdef USE_SIMULATED
+/** @brief   Make the synthetic signal generator's settings.
+ *  @returns Settings like the tester's own sensors, for each channel
+ */
+signal_config_t simulated_config (void)
+{
+  signal_config_t config;
+  signal_defaults (config);
+  config.channels = CHANNEL_COUNT;
+  return config;
+}
+
+/// The synthetic signal generator, read in place of the ADC
+SignalGenerator signal_gen (simulated_config ());
+#endif
+
 /** @brief   The web server object for this project.
  *  @details This server is responsible for responding to HTTP requests from
  *           other computers, replying with useful information.
@@ -76,57 +302,154 @@ IPAddress subnet (255, 255, 255, 0); // Network mask; just leave this as is
 */
 WebServer server (80);
 
+/** @brief   Get a name for this tester which is different from every other.
+ *  @details The name is made from the last three bytes of the ESP32's MAC
+ *           address, as in @c debris-a1b2c3.
+ *  @returns The name, which stays the same while the program runs
+ */
+const char* device_name (void)
+{
+    static const char hex[] = "0123456789abcdef";
+    static char name[] = "debris-000000";
+
+    uint32_t mac = (uint32_t)(ESP.getEfuseMac () >> 24);
+    for (uint8_t index = 0; index < 6; index++)
+    {
+        // The MAC address is stored with its first byte lowest
+        uint8_t byte = (uint8_t)(mac >> (8 * (index / 2)));
+        name[7 + index] = hex[(index & 1) ? (byte & 0x0F) : (byte >> 4)];
+    }
+    return name;
+}
+
+
+#ifdef USE_LAN
+/** @brief   Report that the LAN connection has come up.
+ */
+void on_wifi_up (void)
+{
+    Serial << "WiFi connected at IP address " << WiFi.localIP () << endl;
+}
+
+
+/** @brief   Report that the LAN connection has been lost.
+ */
+void on_wifi_down (void)
+{
+    Serial << "WiFi connection lost; reconnecting" << endl;
+}
+#endif
+
+
 /** @brief   Get the WiFi running so we can serve some web pages.
+ *  @details On a LAN this only starts the connection, which comes up in the
+ *           background; nothing waits for it.
  */
 void setup_wifi (void)
 {
 #ifdef USE_LAN                           // If connecting to an existing LAN
-    Serial << "Connecting to " << ssid;
+    Serial << "Connecting to " << ssid << " in the background" << endl;
 
     // The SSID and password should be kept secret in @c mycerts.h.
     // This file should contain the two lines,
     //   const char* ssid = "YourWiFiNetworkName";
     //   const char* password = "YourWiFiPassword";
-    WiFi.begin (ssid, password);
+    wifi_link.begin (ssid, password, on_wifi_up, on_wifi_down);
 
-    while (WiFi.status() != WL_CONNECTED) 
+    // Start publishing to the MQTT broker; the client keeps trying to
+    // connect by itself, and anything logged meanwhile is sent when it can
+    if (!mqtt.begin (mqtt_broker, device_name ()))
     {
-        vTaskDelay (1000);
-        Serial.print (".");
+        Serial << "MQTT publisher couldn't be started" << endl;
     }
 
-    Serial << "connected at IP address " << WiFi.localIP () << endl;
-
 #else                                   // If the ESP32 makes its own LAN
     Serial << "Setting up WiFi access point...";
     WiFi.mode (WIFI_AP);
     WiFi.softAPConfig (local_ip, gateway, subnet);
-    WiFi.softAP (ssid, password);
+    WiFi.softAP (config_now ().ap_ssid, config_now ().ap_password);
     Serial << "done." << endl;
 #endif
 }
 
 
-/** @brief   Put a web page header into an HTML string. 
+#ifdef USE_LOW_POWER
+/** @brief   Turn the radio on when a low-power radio window opens.
+ */
+void radio_on (void)
+{
+#ifdef USE_LAN
+    wifi_link.resume ();
+#else
+    WiFi.mode (WIFI_AP);
+    WiFi.softAPConfig (local_ip, gateway, subnet);
+    WiFi.softAP (config_now ().ap_ssid, config_now ().ap_password);
+#endif
+}
+
+
+/** @brief   Turn the radio off when a low-power radio window closes.
+ */
+void radio_off (void)
+{
+#ifdef USE_LAN
+    wifi_link.suspend ();
+#else
+    WiFi.softAPdisconnect (true);
+#endif
+    WiFi.mode (WIFI_OFF);
+}
+#endif
+
+
+/** @brief   Put a web page header into a response. 
  *  @details This header may be modified if the developer wants some actual
  *           @a style for her or his web page. It is intended to be a common
  *           header (and stylle) for each of the pages served by this server.
- *  @param   a_string A reference to a string to which the header is added; the
- *           string must have been created in each function that calls this one
+ *  @param   page The response to which the header is written; it must have
+ *           been started in each function that calls this one
  *  @param   page_title The title of the page
 */
-void HTML_header (String& a_string, const char* page_title)
+void HTML_header (ResponseWriter& page, const char* page_title)
+{
+    page.write ("<!DOCTYPE html> <html>\n");
+    page.write ("<head><meta name=\"viewport\" content=\"width=device-width,");
+    page.write (" initial-scale=1.0, user-scalable=no\">\n<title> ");
+    page.write (page_title);
+    page.write ("</title>\n");
+    page.write ("<style>html { font-family: Helvetica; display: inline-block;");
+    page.write (" margin: 0px auto; text-align: center;}\n");
+    page.write ("body{margin-top: 50px;} h1 {color: #4444AA;margin: 50px auto 30px;}\n");
+    page.write ("p {font-size: 24px;color: #222222;margin-bottom: 10px;}\n");
+    page.write ("</style>\n</head>\n");
+}
+
+
+/** @brief   Take a buffer from the response pool for a response writer, or
+ *           reply that the server is busy if every buffer is in use.
+ *  @returns Pointer to the buffer, or @c NULL if none was free
+ */
+char* response_buffer (void)
 {
-    a_string += "<!DOCTYPE html> <html>\n";
-    a_string += "<head><meta name=\"viewport\" content=\"width=device-width,";
-    a_string += " initial-scale=1.0, user-scalable=no\">\n<title> ";
-    a_string += page_title;
-    a_string += "</title>\n";
-    a_string += "<style>html { font-family: Helvetica; display: inline-block;";
-    a_string += " margin: 0px auto; text-align: center;}\n";
-    a_string += "body{margin-top: 50px;} h1 {color: #4444AA;margin: 50px auto 30px;}\n";
-    a_string += "p {font-size: 24px;color: #222222;margin-bottom: 10px;}\n";
-    a_string += "</style>\n</head>\n";
+    char* buffer = (char*)response_pool.get ();
+    if (buffer == NULL)
+    {
+        server.send (503, "text/plain", "Busy");
+    }
+    return buffer;
+}
+
+
+/** @brief   Finish a response, close the connection as the response said we
+ *           would, and give the writer's buffer back to the pool.
+ *  @param   page The response to be finished
+ *  @param   buffer The buffer which came from @c response_buffer()
+ */
+void response_end (ResponseWriter& page, char* buffer)
+{
+    page.end ();
+    server.client ().stop ();
+    response_pool.put (buffer);
 }
 
 
@@ -141,15 +464,31 @@ void handle_DocumentRoot ()
 {
     Serial << "HTTP request from client #" << server.client () << endl;
 
-    String a_str;
-    HTML_header (a_str, "ESP32 Web Server Test");
-    a_str += "<body>\n<div id=\"webpage\">\n";
-    a_str += "<h1>Oil Debri Testing Page</h1>\n";
-    // a_str += "...or is it Main Test Page?\n";
-    a_str += "<p><p> <a href=\"/csv\">Debri Test Data</a>\n";
-    a_str += "</div>\n</body>\n</html>\n";
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    page.begin (200, "text/html");
+    HTML_header (page, "ESP32 Web Server Test");
+    page.write ("<body>\n<div id=\"webpage\">\n");
+    page.write ("<h1>Oil Debri Testing Page</h1>\n");
+    // page.write ("...or is it Main Test Page?\n");
+    page.write ("<p><p> <a href=\"/csv\">Debri Test Data</a>\n");
+    page.write ("<p><p> <a href=\"/data.bin\">Download Sample Log</a>\n");
+    page.write ("<p><p> <a href=\"/api/status\">Status (JSON)</a>\n");
+    page.write ("<p><p> <a href=\"/diag\">Diagnostics</a>\n");
+    page.write ("<p><p> <a href=\"/kernels\">Block kernel benchmark</a>\n");
+    page.write ("<p><p> <a href=\"/config\">Settings (JSON)</a>\n");
+    page.write ("<p><p> <a href=\"/stats\">Response times (JSON)</a>\n");
+#ifdef USE_TRACE
+    page.write ("<p><p> <a href=\"/trace\">Trace for Perfetto (JSON)</a>\n");
+#endif
+    page.write ("</div>\n</body>\n</html>\n");
 
-    server.send (200, "text/html", a_str); 
+    response_end (page, buffer); 
 }
 
 
@@ -158,7 +497,16 @@ void handle_DocumentRoot ()
  */
 void handle_NotFound (void)
 {
-    server.send (404, "text/plain", "Not found");
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    page.begin (404, "text/plain");
+    page.write ("Not found");
+    response_end (page, buffer);
 }
 
 
@@ -166,119 +514,1451 @@ void handle_NotFound (void)
  *  @details The data is taken every sent in a relatively efficient Comma
  *           Separated Variable (CSV) format which is easily read by Matlab(tm)
  *           and Python and spreadsheets.
+ *
+ *           If the request is @c /csv?format=gorilla, the whole compressed
+ *           voltage history is sent instead as binary Gorilla blocks, which
+ *           @c tools/gorilla_decode.py turns back into CSV on a PC.
  */
 void handle_Sensor (void)
 {
-    // The page will be composed in an Arduino String object, then sent.
-    // The first line will be column headers so we know what the data is
-    String IMU_str = "Fine Voltage, Coarse Voltage\n";
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    if (server.arg ("format") == "gorilla")
+    {
+        // Copy the history so the sensor task isn't held up while we send
+        uint8_t* snapshot = (uint8_t*)download_pool.get ();
+        if (snapshot == NULL)
+        {
+            page.begin (503, "text/plain");
+            page.write ("Busy");
+        }
+        else
+        {
+            size_t length = history_snapshot (snapshot,
+                                              2 * HISTORY_BLOCK_SIZE);
+            page.begin (200, "application/octet-stream", length);
+            page.write ((const char*)snapshot, length);
+            page.flush ();
+            download_pool.put (snapshot);
+        }
+        response_end (page, buffer);
+        return;
+    }
 
-    // Create some fake data and put it into a String object. We could just
-    // as easily have taken values from a data array, if such an array existed
-    for (uint8_t index = 0; index < 20; index++)
+    // The page is written straight to the client as it's composed. The
+    // first line will be column headers so we know what the data is
+    page.begin (200, "text/plain");
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
     {
-        IMU_str += String (v_fine.get());
-        IMU_str += ",";
-        IMU_str += String (v_coarse.get());
-        IMU_str += "\n";
+        page.write (channel ? ", " : "");
+        page.write (CHANNELS[channel].name);
+        page.write (" Voltage");
+    }
+    page.write ("\n");
+
+    // Put the data into the page. We could just as easily have taken values
+    // from a data array, if such an array existed
+    for (uint8_t index = 0; index < CSV_ROWS; index++)
+    {
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            page.write (channel ? "," : "");
+            page.write_fixed (channel_millivolts (channel), 3);
+        }
+        page.write ("\n");
     }
 
     // Send the CSV file as plain text so it can be easily saved as a file
-    server.send (404, "text/plain", IMU_str);
+    response_end (page, buffer);
 }
 
 
-/** @brief   Task which sets up and runs a web server.
- *  @details After setup, function @c handleClient() must be run periodically
- *           to check for page requests from web clients. One could run this
- *           task as the lowest priority task with a short or no delay, as there
- *           generally isn't much rush in replying to web queries.
- *  @param   p_params Pointer to unused parameters
+/** @brief   Send the stored sample log in its packed binary form.
+ *  @details The old and current log files are sent as one run of log
+ *           records, which @c tools/data_download.py saves and turns into
+ *           CSV. The length is given up front, and a @c Range header asks
+ *           for just part of the log, so a download which was cut off can
+ *           carry on where it stopped. The @c ETag is the log's generation;
+ *           if the log has been moved aside since, a request with a
+ *           matching @c If-Range gets the whole new log instead of a part
+ *           which no longer lines up.
  */
-void task_webserver (void* p_params)
+void handle_DataBin (void)
 {
-    // The server has been created statically when the program was started and
-    // is accessed as a global object because not only this function but also
-    // the page handling functions referenced below need access to the server
-    server.on ("/", handle_DocumentRoot);
-    server.on ("/csv", handle_Sensor);
-    server.onNotFound (handle_NotFound);
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
 
-    // Get the web server running
-    server.begin ();
-    Serial.println ("HTTP server started");
+    uint8_t* chunk = (uint8_t*)download_pool.get ();
+    if (chunk == NULL)
+    {
+        page.begin (503, "text/plain");
+        page.write ("Busy");
+        response_end (page, buffer);
+        return;
+    }
 
-    for (;;)
+    uint32_t generation = sample_log_generation ();
+    size_t total = sample_log_total ();
+
+    // The tag is the generation in quotes, as in "7"
+    char tag[FMT_MAX_CHARS + 2];
+    size_t tag_length = 0;
+    tag[tag_length++] = '"';
+    tag_length += fmt_uint (tag + tag_length, generation);
+    tag[tag_length++] = '"';
+    tag[tag_length] = '\0';
+
+    size_t first = 0;
+    size_t last = total - 1;
+    byte_range_t range = RANGE_NONE;
+    if (server.hasHeader ("Range"))
     {
-        // The web server must be periodically run to watch for page requests
-        server.handleClient ();
-        vTaskDelay (500);
+        // A range from some other generation would be the wrong bytes
+        if (!server.hasHeader ("If-Range")
+            || server.header ("If-Range") == tag)
+        {
+            range = parse_byte_range (server.header ("Range").c_str (), total,
+                                      first, last);
+        }
+    }
+
+    // Content-Range is "bytes first-last/total", or "bytes */total"
+    char content_range[3 * FMT_MAX_CHARS + 8];
+    memcpy (content_range, "bytes ", 6);
+    size_t length = 6;
+    if (range == RANGE_VALID)
+    {
+        length += fmt_uint (content_range + length, first);
+        content_range[length++] = '-';
+        length += fmt_uint (content_range + length, last);
+    }
+    else
+    {
+        content_range[length++] = '*';
+    }
+    content_range[length++] = '/';
+    length += fmt_uint (content_range + length, total);
+    content_range[length] = '\0';
+
+    if (range == RANGE_UNSATISFIABLE)
+    {
+        page.begin (416, "text/plain", 0);
+        page.header ("Content-Range", content_range);
+    }
+    else
+    {
+        size_t count = (total == 0) ? 0 : last - first + 1;
+        page.begin ((range == RANGE_VALID) ? 206 : 200,
+                    "application/octet-stream", count);
+        page.header ("Accept-Ranges", "bytes");
+        page.header ("ETag", tag);
+        if (range == RANGE_VALID)
+        {
+            page.header ("Content-Range", content_range);
+        }
+        page.header ("Content-Disposition",
+                     "attachment; filename=\"data.bin\"");
+
+        // Blocks are read from flash a download buffer at a time and go
+        // to the client without being copied again
+        size_t offset = first;
+        while (count > 0)
+        {
+            size_t wanted = (count < 2 * HISTORY_BLOCK_SIZE)
+                            ? count : 2 * HISTORY_BLOCK_SIZE;
+            size_t got = sample_log_read (offset, chunk, wanted, generation);
+            if (got == 0)
+            {
+                // The log was moved aside; the client will see a short
+                // reply and ask again, getting the new generation
+                break;
+            }
+            page.write ((const char*)chunk, got);
+            offset += got;
+            count -= got;
+        }
     }
+
+    download_pool.put (chunk);
+    response_end (page, buffer);
 }
 
-/** @brief   Task which implements code for GS condition sensor.
- *  @details This task reads the sensor.
+
+/** @brief   Send only the log records a client hasn't seen yet.
+ *  @details The request is @c /sync?after=N&max=M, where @c N is the
+ *           sequence number of the last record the client has (zero for
+ *           everything) and @c M limits how many records are sent. The body
+ *           is the records in their log form. The headers say where the
+ *           client is to carry on from and what the tester still holds:
+ *
+ *           - @c X-Sync-Cursor, the last sequence number sent, which is the
+ *             @c after of the next request
+ *           - @c X-Sync-Oldest, the oldest record still kept; if it's above
+ *             @c after + 1, the records between were lost to log rotation
+ *           - @c X-Sync-Next, the number the next record will get, so more
+ *             are waiting if it's above the cursor + 1
+ *
+ *           @c tools/sync_client.py polls this and checks the sequence.
  */
-void task_sensor (void* p_params)
-{  
-  for (;;)
-  {
-    // read the voltages from the input pins
-    float voltage1 = analogRead(fine_wear) * (5 / 4095.0);
-    float voltage2 = analogRead(coarse_wear) * (5 / 4095.0);
+void handle_Sync (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    uint32_t after = strtoul (server.arg ("after").c_str (), NULL, 10);
+    uint32_t max = SYNC_DEFAULT_RECORDS;
+    if (server.hasArg ("max"))
+    {
+        max = strtoul (server.arg ("max").c_str (), NULL, 10);
+        if (max == 0 || max > SYNC_MAX_RECORDS)
+        {
+            max = SYNC_MAX_RECORDS;
+        }
+    }
+
+    uint8_t* chunk = (uint8_t*)download_pool.get ();
+    if (chunk == NULL)
+    {
+        page.begin (503, "text/plain");
+        page.write ("Busy");
+        response_end (page, buffer);
+        return;
+    }
+
+    log_span_t span;
+    sample_log_find (after, max, span);
+
+    char number[FMT_MAX_CHARS];
+    page.begin (200, "application/octet-stream", span.end - span.start);
+    number[fmt_uint (number, span.last_seq)] = '\0';
+    page.header ("X-Sync-Cursor", number);
+    number[fmt_uint (number, span.oldest_seq)] = '\0';
+    page.header ("X-Sync-Oldest", number);
+    number[fmt_uint (number, span.next_seq)] = '\0';
+    page.header ("X-Sync-Next", number);
 
-    // write to the shares
-    v_fine.put(voltage1);
-    v_coarse.put(voltage2);
+    size_t offset = span.start;
+    while (offset < span.end)
+    {
+        size_t wanted = span.end - offset;
+        if (wanted > 2 * HISTORY_BLOCK_SIZE)
+        {
+            wanted = 2 * HISTORY_BLOCK_SIZE;
+        }
+        size_t got = sample_log_read (offset, chunk, wanted,
+                                      span.generation);
+        if (got == 0)
+        {
+            // The log was moved aside; the short reply makes the client
+            // ask again from the same cursor
+            break;
+        }
+        page.write ((const char*)chunk, got);
+        offset += got;
+    }
 
-    // calculate the sum of the voltages
-    float sum = voltage1 + voltage2;
+    download_pool.put (chunk);
+    response_end (page, buffer);
+}
 
-    // x-axis of serial plot???
-    //int analogValue = 0;
-    //analogValue = analogRead(0);
-    //Serial.println(analogValue);
 
-    // print the voltages and the sum to the serial monitor
-    Serial.print(" Fine Wear Voltage: ");
-    Serial.print(voltage1);
-    Serial.print("V");
+/** @brief   Show how the program's memory and sample pipeline are doing.
+ *  @details The arena and each pool show their use and high-water marks, so
+ *           one can tell whether they were sized well, and the heap figures
+ *           show whether anything is still using the heap after setup.
+ */
+void handle_Diagnostics (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "text/plain");
 
-    Serial.print(" Coarse Wear Voltage: ");
-    Serial.print(voltage2);
-    Serial.print("V");
+    page.write ("Uptime (ms): ");
+    page.write_uint (millis ());
 
-    Serial.print(" Sum: ");
-    Serial.print(sum);
-    Serial.println("V");
+    page.write ("\nBoot phase, start (us), duration (us)");
+    for (uint8_t index = 0; index < boot_phase_count (); index++)
+    {
+        page.write ("\n");
+        page.write (boot_phase_name (index));
+        page.write (", ");
+        page.write_uint (boot_phase_start_us (index));
+        page.write (", ");
+        page.write_uint (boot_phase_us (index));
+    }
+    page.write ("\nArena bytes used: ");
+    page.write_uint (arena_used ());
+    page.write (" of ");
+    page.write_uint (ARENA_SIZE);
 
-    // wait for a short period of time before reading the voltages again
-    vTaskDelay(500);
-  }
+    page.write ("\nPool, block bytes, blocks, in use, high water, failures");
+    MemPool* p_pool;
+    for (uint8_t index = 0; (p_pool = pool_at (index)) != NULL; index++)
+    {
+        page.write ("\n");
+        page.write (p_pool->get_name ());
+        page.write (", ");
+        page.write_uint (p_pool->get_block_size ());
+        page.write (", ");
+        page.write_uint (p_pool->get_num_blocks ());
+        page.write (", ");
+        page.write_uint (p_pool->get_used ());
+        page.write (", ");
+        page.write_uint (p_pool->get_high_water ());
+        page.write (", ");
+        page.write_uint (p_pool->get_failures ());
+    }
+
+    page.write ("\nFree heap: ");
+    page.write_uint (ESP.getFreeHeap ());
+    page.write ("\nLowest free heap: ");
+    page.write_uint (ESP.getMinFreeHeap ());
+    page.write ("\nHeap allocations after setup: ");
+    page.write_uint (heap_guard_count ());
+
+    pipeline_stats_t stats = pipeline.stats ();
+    page.write ("\nSamples in: ");
+    page.write_uint (stats.samples_in);
+    page.write ("\nSamples dropped: ");
+    page.write_uint (stats.samples_dropped);
+    page.write ("\nPipeline overflows: ");
+    page.write_uint (stats.overflows);
+    page.write ("\nBlocks processed: ");
+    page.write_uint (stats.blocks_processed);
+    page.write ("\nDebris events: ");
+    page.write_uint (events_total ());
+
+#ifdef USE_LAN
+    wifi_stats_t wifi_stats = wifi_link.get_stats ();
+    page.write ("\nWiFi: ");
+    page.write (wifi_link.state_name ());
+    page.write ("\nWiFi attempts, connects, disconnects: ");
+    page.write_uint (wifi_stats.attempts);
+    page.write (", ");
+    page.write_uint (wifi_stats.connects);
+    page.write (", ");
+    page.write_uint (wifi_stats.disconnects);
+    page.write ("\nWiFi first connected at (ms): ");
+    page.write_uint (wifi_stats.first_connect_ms);
+    page.write ("\nWiFi outage last, max, total (ms): ");
+    page.write_uint (wifi_stats.last_outage_ms);
+    page.write (", ");
+    page.write_uint (wifi_stats.max_outage_ms);
+    page.write (", ");
+    page.write_uint (wifi_stats.total_outage_ms);
+
+    mqtt_stats_t mqtt_stats = mqtt.get_stats ();
+    page.write ("\nMQTT connected: ");
+    page.write (mqtt.is_connected () ? "yes" : "no");
+    page.write ("\nMQTT connects: ");
+    page.write_uint (mqtt_stats.connects);
+    page.write ("\nMQTT messages published, acknowledged, resent: ");
+    page.write_uint (mqtt_stats.published);
+    page.write (", ");
+    page.write_uint (mqtt_stats.acked);
+    page.write (", ");
+    page.write_uint (mqtt_stats.resends);
+    page.write ("\nMQTT records sent, waiting, lost: ");
+    page.write_uint (mqtt_stats.records);
+    page.write (", ");
+    page.write_uint (mqtt_stats.backlog);
+    page.write (", ");
+    page.write_uint (mqtt_stats.lost);
+    page.write ("\nMQTT ack time last, max (ms): ");
+    page.write_uint (mqtt_stats.last_ack_ms);
+    page.write (", ");
+    page.write_uint (mqtt_stats.max_ack_ms);
+#endif
+#ifdef USE_LOW_POWER
+    page.write ("\nRadio: ");
+    page.write (power_radio_is_on () ? "on" : "off");
+    page.write ("\nHours ago, awake (ms), asleep (ms), radio (ms), sleeps, "
+                "awake (%), average (uA), battery life (h)");
+    power_hour_t hour;
+    for (uint8_t ago = 0; power_get_hour (ago, hour); ago++)
+    {
+        power_budget_t budget;
+        power_estimate (hour, budget);
+        char number[FMT_MAX_CHARS];
+        page.write ("\n");
+        page.write_uint (ago);
+        page.write (", ");
+        page.write_uint (hour.awake_ms);
+        page.write (", ");
+        page.write_uint (hour.asleep_ms);
+        page.write (", ");
+        page.write_uint (hour.radio_ms);
+        page.write (", ");
+        page.write_uint (hour.sleeps);
+        page.write (", ");
+        page.write (number, fmt_fixed (number, budget.awake_permille, 1));
+        page.write (", ");
+        page.write_uint (budget.average_ua);
+        page.write (", ");
+        page.write_uint (budget.battery_hours);
+    }
+#endif
+#ifdef USE_ULP
+    page.write ("\nULP readings waiting, dropped: ");
+    page.write_uint (ulp_sampler_ring ().available ());
+    page.write (", ");
+    page.write_uint (ulp_dropped);
+    page.write ("\nULP threshold wakeups: ");
+    page.write_uint (ulp_events);
+#endif
+#ifdef USE_SPI_ADC
+    page.write ("\nSPI ADC: ");
+    page.write (spi_adc_info (SPI_ADC_MODEL).name);
+    page.write ("\nSPI ADC scans, bad frames: ");
+    page.write_uint (spi_adc.get_scans ());
+    page.write (", ");
+    page.write_uint (spi_adc.get_bad_frames ());
+#endif
+#ifdef USE_SIMULATED
+    page.write ("\nSimulated particles, labels lost: ");
+    page.write_uint (signal_gen.get_particles ());
+    page.write (", ");
+    page.write_uint (signal_gen.get_labels_lost ());
+#endif
+#ifdef USE_BEACON
+    page.write ("\nBeacons due, not sent: ");
+    page.write_uint (beacon.get_sent ());
+    page.write (", ");
+    page.write_uint (beacon.get_failures ());
+#endif
+    page.write ("\n");
+
+    response_end (page, buffer);
+}
+
+
+/** @brief   Read the CPU's cycle counter, for the kernel benchmark.
+ */
+uint32_t cycle_count (void)
+{
+  return ESP.getCycleCount ();
 }
 
-void setup(void) {
-  Serial.begin(115200);
-  while (!Serial)
-    delay(10); // will pause Zero, Leonardo, etc until serial console opens
 
-    // configure the input pins as analog inputs
-    pinMode(fine_wear, INPUT);
-    pinMode(coarse_wear, INPUT);
+/** @brief   Check the block kernels and show how fast each set of them is.
+ *  @details Every set is compared with the plain one, then each kernel of
+ *           each set is timed; the pipeline uses the last set listed. This
+ *           takes a few milliseconds, so it's done only when asked for.
+ */
+void handle_Kernels (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+    page.begin (200, "text/plain");
 
-  // Begin the connection to the mpu
-  // mpu.begin(104);
-   
-  // Call function which gets the WiFi working
-  setup_wifi ();
-  delay(100);
+    page.write ("Differences from the plain kernels: ");
+    page.write_uint (kernels_check ());
+    page.write ("\nKernels used: ");
+    page.write (kernels ().name);
+    page.write ("\nCycles per reading: set, stats, scale, above, filter");
 
-  // Task which runs the web server. It runs at a low priority
-  xTaskCreate (task_webserver, "Web Server", 8192, NULL, 2, NULL);
+    const kernel_set_t* p_set;
+    for (uint8_t index = 0; (p_set = kernel_set_at (index)) != NULL; index++)
+    {
+        kernel_timing_t timing;
+        kernels_benchmark (*p_set, cycle_count, timing);
+        char number[FMT_MAX_CHARS];
+        page.write ("\n");
+        page.write (p_set->name);
+        page.write (", ");
+        page.write (number, fmt_fixed (number, timing.stats, 2));
+        page.write (", ");
+        page.write (number, fmt_fixed (number, timing.scale, 2));
+        page.write (", ");
+        page.write (number, fmt_fixed (number, timing.above, 2));
+        page.write (", ");
+        page.write (number, fmt_fixed (number, timing.filter, 2));
+    }
+    page.write ("\n");
 
-  // Task which reads from the IMU
-  xTaskCreate (task_sensor, "Sensor", 4000, NULL, 4, NULL);
+    response_end (page, buffer);
+}
+
+
+/** @brief   Start a JSON response with the members every @c /api reply has.
+ *  @param   json The writer for the response, which has just been begun
+ *  @param   kind The name of the kind of data in the reply
+ */
+void api_begin (JsonWriter& json, const char* kind)
+{
+    json.begin_object ();
+    json.member_uint ("schema", JSON_SCHEMA_VERSION);
+    json.member_string ("kind", kind);
+    json.member_uint ("uptime_ms", millis ());
+}
+
+
+/** @brief   Send the voltage history as JSON.
+ *  @details The compressed history is decoded row by row as it's sent, so
+ *           only the download buffer is needed however long the history is.
+ *           Each row is the time and then each channel's voltage, as in
+ *           @c [time_ms, fine_V, coarse_V]. The optional query
+ *           argument @c max limits the reply to that many of the newest rows;
+ *           if it isn't a whole number which fits 32 bits, the reply is 400.
+ */
+void handle_ApiSamples (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    // The row limit is checked as config_parse() checks numbers, so that a
+    // negative or junk limit isn't taken as some other number of rows
+    uint32_t max = 0xFFFFFFFF;
+    if (server.hasArg ("max"))
+    {
+        String arg = server.arg ("max");
+        const char* text = arg.c_str ();
+        char* end;
+        unsigned long value = strtoul (text, &end, 10);
+        if (end == text || *end != '\0' || *text == '-'
+            || value > 0xFFFFFFFFUL)
+        {
+            page.begin (400, "text/plain");
+            page.write ("max: not a number of rows");
+            response_end (page, buffer);
+            return;
+        }
+        max = (uint32_t)value;
+    }
+
+    uint8_t* snapshot = (uint8_t*)download_pool.get ();
+    if (snapshot == NULL)
+    {
+        page.begin (503, "text/plain");
+        page.write ("Busy");
+        response_end (page, buffer);
+        return;
+    }
+    size_t length = history_snapshot (snapshot, 2 * HISTORY_BLOCK_SIZE);
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "samples");
+    history_write_json (json, snapshot, length, max);
+    json.end_object ();
+
+    download_pool.put (snapshot);
+    response_end (page, buffer);
+}
+
+
+/** @brief   Send the most recent debris events as JSON.
+ */
+void handle_ApiEvents (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    debris_event_t events[EVENT_RING_SIZE];
+    uint8_t count = events_snapshot (events, EVENT_RING_SIZE);
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "events");
+    json.member_uint ("total", events_total ());
+    json.begin_array ("events");
+    for (uint8_t index = 0; index < count; index++)
+    {
+        json.begin_object ();
+        json.member_uint ("time_ms", events[index].time);
+        json.member_string ("channel",
+                            (events[index].channel < CHANNEL_COUNT)
+                            ? CHANNELS[events[index].channel].name : "");
+        json.member_uint ("peak_counts", events[index].peak);
+        json.member_uint ("samples", events[index].duration);
+        json.end_object ();
+    }
+    json.end_array ();
+    json.end_object ();
+
+    response_end (page, buffer);
+}
+
+
+/** @brief   Send the tester's latest readings and health counters as JSON.
+ */
+void handle_ApiStatus (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+    pipeline_stats_t stats = pipeline.stats ();
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "status");
+    json.member_fixed ("fine_V", v_fine.get (), 3);
+    json.member_fixed ("coarse_V", v_coarse.get (), 3);
+    json.begin_array ("channels");
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+    {
+        json.begin_object ();
+        json.member_string ("name", CHANNELS[channel].name);
+        json.member_fixed ("V", channel_millivolts (channel), 3);
+        json.end_object ();
+    }
+    json.end_array ();
+    json.member_uint ("sample_period_ms", config_now ().sample_period_ms);
+    json.member_uint ("block_size", pipeline.get_block_size ());
+    json.begin_object ("pipeline");
+    json.member_uint ("samples_in", stats.samples_in);
+    json.member_uint ("samples_dropped", stats.samples_dropped);
+    json.member_uint ("overflows", stats.overflows);
+    json.member_uint ("blocks_processed", stats.blocks_processed);
+    json.end_object ();
+    json.member_uint ("events_total", events_total ());
+    json.member_uint ("log_bytes", sample_log_size ());
+    json.member_uint ("free_heap", ESP.getFreeHeap ());
+    json.end_object ();
+
+    response_end (page, buffer);
+}
+
+
+/** @brief   Write the settings in use as JSON members; secret settings are
+ *           shown only as stars.
+ *  @param   json The writer, inside an object
+ */
+void write_config (JsonWriter& json)
+{
+    const config_t& config = config_now ();
+    json.member_uint ("version", config.version);
+    const config_item_t* item;
+    for (uint8_t index = 0; (item = config_item_at (index)) != NULL; index++)
+    {
+        if (item->secret)
+        {
+            json.member_string (item->key, "********");
+        }
+        else if (item->type == CONFIG_TEXT)
+        {
+            json.member_string (item->key, config_get_text (config, *item));
+        }
+        else
+        {
+            json.member_uint (item->key, config_get_uint (config, *item));
+        }
+    }
+}
+
+
+/** @brief   Send the settings in use as JSON.
+ */
+void handle_ConfigGet (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "config");
+    write_config (json);
+    json.end_object ();
+
+    response_end (page, buffer);
+}
+
+
+/** @brief   Change some settings, given as form fields such as
+ *           @c threshold=200, and save them in NVS.
+ *  @details Every field is checked before any is used, so a bad request
+ *           changes nothing. The new settings are then put to use at once;
+ *           a new access point name or password restarts the access point
+ *           after the reply has been sent.
+ */
+void handle_ConfigPost (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    config_t config = config_now ();
+    for (int index = 0; index < server.args (); index++)
+    {
+        // The web server puts a body it can't parse as a form in "plain"
+        String key = server.argName (index);
+        if (key == "plain")
+        {
+            continue;
+        }
+        const config_item_t* item = config_find (key.c_str ());
+        config_result_t result = (item == NULL) ? CONFIG_UNKNOWN
+            : config_parse (config, *item, server.arg (index).c_str ());
+        if (result != CONFIG_OK)
+        {
+            page.begin (400, "text/plain");
+            page.write (key.c_str ());
+            page.write (": ");
+            page.write (config_result_name (result));
+            response_end (page, buffer);
+            return;
+        }
+    }
+
+#ifndef USE_LAN
+    const config_t& old = config_now ();
+    bool new_ap = strcmp (config.ap_ssid, old.ap_ssid) != 0
+                  || strcmp (config.ap_password, old.ap_password) != 0;
+#endif
+    config_result_t result = config_publish (config, millis ());
+    if (result != CONFIG_OK)
+    {
+        page.begin (429, "text/plain");
+        page.write (config_result_name (result));
+        response_end (page, buffer);
+        return;
+    }
+    bool saved = config_nvs_save (config);
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "config");
+    write_config (json);
+    json.member_bool ("saved", saved);
+    json.end_object ();
+    response_end (page, buffer);
+
+#ifndef USE_LAN
+    if (new_ap)
+    {
+        WiFi.softAP (config.ap_ssid, config.ap_password);
+    }
+#endif
+}
+
+
+/** @brief   Send how long each route has taken to answer, as JSON.
+ *  @details Times are counted from when a handler starts to when it has
+ *           given the whole reply to the network, in microseconds. The
+ *           optional query argument @c buckets=1 adds each route's
+ *           histogram, and @c reset=1 starts the counts again after the
+ *           reply, as between the steps of a load test.
+ */
+void handle_Stats (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    api_begin (json, "stats");
+    stats_write_json (json, server.arg ("buckets") == "1");
+    json.end_object ();
+    response_end (page, buffer);
+
+    if (server.arg ("reset") == "1")
+    {
+        stats_reset ();
+    }
+}
+
+
+#ifdef USE_TRACE
+/** @brief   Get a task's name, for the trace.
+ *  @param   task The task's handle, as a number
+ */
+const char* trace_task_name (uint32_t task)
+{
+    return pcTaskGetName ((TaskHandle_t)(uintptr_t)task);
+}
+
+
+/** @brief   Send the newest traced spans as Chrome trace-event JSON.
+ *  @details The file can be opened in Perfetto or @c chrome://tracing to see
+ *           where the time goes in each task. Tracing stops while the spans
+ *           are sent, so they aren't overwritten; the optional query
+ *           argument @c clear=1 throws them away afterwards.
+ */
+void handle_Trace (void)
+{
+    char* buffer = response_buffer ();
+    if (buffer == NULL)
+    {
+        return;
+    }
+    ResponseWriter page (server.client (), buffer, RESPONSE_BUFFER_SIZE);
+
+    trace_ring.set_recording (false);
+    page.begin (200, "application/json");
+    page.header ("Content-Disposition", "attachment; filename=trace.json");
+    JsonWriter json (page);
+    api_begin (json, "trace");
+    trace_write_json (json, trace_ring, ESP.getCpuFreqMHz (),
+                      trace_task_name);
+    json.end_object ();
+    response_end (page, buffer);
+
+    if (server.arg ("clear") == "1")
+    {
+        trace_ring.clear ();
+    }
+    trace_ring.set_recording (true);
+}
+#endif
+
+
+/** @brief   Have the web server answer a route, timing each request.
+ *  @param   path The route's path
+ *  @param   method The request method it answers
+ *  @param   handler The function which answers it
+ *  @param   name The name it's shown by on @c /stats and in the trace
+ */
+void serve (const char* path, HTTPMethod method, void (*handler) (void),
+            const char* name)
+{
+    uint8_t route = stats_route (name);
+    server.on (path, method, [route, handler] ()
+    {
+        uint32_t start = micros ();
+        TRACE_BEGIN (request);
+        handler ();
+        TRACE_END (request, stats_route_name (route));
+        stats_record (route, micros () - start);
+    });
+}
+
+
+/** @brief   Have the web server answer a route by any method, timing each
+ *           request.
+ *  @param   path The route's path, which it's also shown by on @c /stats
+ *  @param   handler The function which answers it
+ */
+void serve (const char* path, void (*handler) (void))
+{
+    serve (path, HTTP_ANY, handler, path);
+}
+
+
+/** @brief   Task which sets up and runs a web server.
+ *  @details After setup, function @c handleClient() must be run periodically
+ *           to check for page requests from web clients. One could run this
+ *           task as the lowest priority task with a short or no delay, as there
+ *           generally isn't much rush in replying to web queries.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_webserver (void* p_params)
+{
+    // The server has been created statically when the program was started and
+    // is accessed as a global object because not only this function but also
+    // the page handling functions referenced below need access to the server
+    // Each route is timed, and the times are shown on /stats
+    serve ("/", handle_DocumentRoot);
+    serve ("/csv", handle_Sensor);
+    serve ("/diag", handle_Diagnostics);
+    serve ("/kernels", handle_Kernels);
+    serve ("/data.bin", handle_DataBin);
+    serve ("/sync", handle_Sync);
+    serve ("/api/samples", handle_ApiSamples);
+    serve ("/api/events", handle_ApiEvents);
+    serve ("/api/status", handle_ApiStatus);
+    serve ("/config", HTTP_GET, handle_ConfigGet, "GET /config");
+    serve ("/config", HTTP_POST, handle_ConfigPost, "POST /config");
+    serve ("/stats", handle_Stats);
+#ifdef USE_TRACE
+    serve ("/trace", handle_Trace);
+#endif
+    uint8_t not_found = stats_route ("(not found)");
+    server.onNotFound ([not_found] ()
+    {
+        uint32_t start = micros ();
+        TRACE_BEGIN (request);
+        handle_NotFound ();
+        TRACE_END (request, "(not found)");
+        stats_record (not_found, micros () - start);
+    });
+
+    // Downloads of the log need to see these request headers
+    const char* header_keys[] = { "Range", "If-Range" };
+    server.collectHeaders (header_keys, 2);
+
+    // Get the web server running
+    server.begin ();
+    Serial.println ("HTTP server started");
+
+    for (;;)
+    {
+        // The web server must be periodically run to watch for page requests
+        server.handleClient ();
+        vTaskDelay (pdMS_TO_TICKS (WEB_POLL_MS));
+    }
+}
+
+#ifdef USE_ULP
+/** @brief   Move the readings the ULP has taken into the sample pipeline.
+ *  @details The ULP doesn't record times, so they're worked out back from
+ *           now, one sample period apart; readings the ULP dropped are
+ *           taken to be the newest, as they are only dropped while the ring
+ *           is full. Draining stops once a block is ready, so the processing
+ *           task can take it before the other block fills; the rest wait
+ *           in the ring. The ULP's thresholds are then moved to follow the
+ *           detector's baselines, so that it wakes the CPUs for the same
+ *           pulses the detector looks for.
+ *  @param   ring The ULP's ring
+ *  @returns The number of readings put into the pipeline
+ */
+uint16_t drain_ulp_ring (UlpRing& ring)
+{
+  uint16_t dropped = ring.new_drops ();
+  uint16_t waiting = ring.available ();
+  uint32_t time = millis () - (uint32_t)(waiting + dropped) * ulp_period_ms;
+  ulp_dropped += dropped;
+  ulp_events += ring.new_events ();
+
+  // The ULP reads only the fine and coarse sensors; any other channels in
+  // the table read as zero
+  uint16_t count = 0;
+  uint16_t readings[PIPELINE_MAX_CHANNELS] = {};
+  while (count < waiting && ring.pop (readings[CHANNEL_FINE],
+                                      readings[CHANNEL_COARSE]))
+  {
+    time += ulp_period_ms;
+    pipeline.put (time, readings);
+    count++;
+    if (!pipeline.is_idle ())
+    {
+      break;
+    }
+  }
+
+  uint16_t thresholds[2];
+  for (uint8_t channel = 0; channel < 2; channel++)
+  {
+    const detect_channel_t& chan = detect_state.channels[channel];
+    thresholds[channel] = chan.primed
+        ? (uint16_t)((chan.baseline >> 8) + detect_state.threshold) : 0xFFFF;
+  }
+  ring.set_thresholds (thresholds[0], thresholds[1]);
+
+  return count;
+}
+#endif
+
+
+#ifdef USE_SPI_ADC
+/** @brief   Add the readings of one scan from the external ADC to the sums.
+ *  @param   readings One reading per channel
+ *  @param   p_context Pointer to the @c spi_burst_t being summed
+ */
+void add_spi_scan (const uint16_t* readings, void* p_context)
+{
+  spi_burst_t* p_burst = (spi_burst_t*)p_context;
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+  {
+    p_burst->sums[channel] += readings[channel];
+  }
+  p_burst->scans++;
+}
+#endif
+
+
+#if !defined (USE_ULP) && !defined (USE_SPI_ADC)
+/** @brief   Read one channel with the ESP32's own ADC, for the scheduler.
+ *  @param   channel The channel's index in the channel table
+ *  @param   p_context Not used
+ *  @returns The raw ADC count
+ */
+uint16_t read_channel (uint8_t channel, void* p_context)
+{
+  TRACE_SCOPE ("adc read");
+#ifdef USE_SIMULATED
+  return signal_gen.read (channel, micros ());
+#else
+  return analogRead (CHANNELS[channel].pin);
+#endif
+}
+
+
+/** @brief   Get the time in microseconds, for the scheduler.
+ */
+uint32_t read_clock (void)
+{
+  return micros ();
+}
+#endif
+
+
+/** @brief   Task which implements code for GS condition sensor.
+ *  @details This task reads the sensor at a steady rate and puts the readings
+ *           into the sample pipeline. It does nothing else, so that slow
+ *           processing can't make it miss readings; if processing falls
+ *           behind, the pipeline drops and counts readings instead.
+ *
+ *           With @c USE_ULP the ULP coprocessor does the reading, and this
+ *           task empties its ring into the pipeline whenever the ULP wakes
+ *           the CPUs or, while they're awake anyway, every @c ULP_POLL_MS.
+ *           With @c USE_SPI_ADC each sample is the average of a batch of
+ *           scans which the external ADC converted during the last period.
+ *           Otherwise the channels are read in a mirrored order, and the
+ *           time of each reading goes with it so the align stage can line
+ *           the channels up.
+ */
+void task_sensor (void* p_params)
+{  
+#ifdef USE_ULP
+  uint32_t ulp_start = micros ();
+  if (ulp_sampler_begin (ulp_period_ms * 1000))
+  {
+    boot_span ("start ULP", ulp_start);
+  }
+  else
+  {
+    boot_span ("ULP failed", ulp_start);
+  }
+  UlpRing& ring = ulp_sampler_ring ();
+  bool first = true;
+
+  for (;;)
+  {
+    TRACE_BEGIN (loop);
+    uint16_t drained = drain_ulp_ring (ring);
+    TRACE_END (loop, "sensor loop");
+    if (drained > 0 && first)
+    {
+      boot_span ("reset to first sample", 0);
+      first = false;
+    }
+
+    // Sleep until the ULP wakes the chip, with a timer in case it doesn't
+    // before the ring is full
+#ifdef USE_LOW_POWER
+    int64_t ring_full_us = (int64_t)ULP_RING_SAMPLES * ulp_period_ms * 1000;
+    power_wait_for_wakeup (esp_timer_get_time () + ring_full_us, ULP_POLL_MS,
+                           pipeline.is_idle ());
+#else
+    vTaskDelay (pdMS_TO_TICKS (ULP_POLL_MS));
+#endif
+  }
+#elif defined (USE_SPI_ADC)
+  uint32_t spi_start = micros ();
+  uint8_t inputs[PIPELINE_MAX_CHANNELS];
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+  {
+    inputs[channel] = CHANNELS[channel].spi_input;
+  }
+  if (spi_adc.set_inputs (inputs, CHANNEL_COUNT)
+      && spi_adc_bus_begin (SPI_ADC_PINS, SPI_ADC_MODEL))
+  {
+    boot_span ("start SPI ADC", spi_start);
+  }
+  else
+  {
+    boot_span ("SPI ADC failed", spi_start);
+  }
+
+  // The commands are the same every time, so the batches are filled once
+  uint16_t scans = (SPI_ADC_SCANS < spi_adc.max_scans ())
+                   ? SPI_ADC_SCANS : spi_adc.max_scans ();
+  spi_adc.prepare (spi_batches[0], scans);
+  spi_adc.prepare (spi_batches[1], scans);
+  uint8_t current = 0;
+  spi_adc_bus_start (spi_batches[current]);
+
+  // The channels of a scan are converted one frame apart
+  uint16_t offsets[PIPELINE_MAX_CHANNELS];
+  uint32_t frame_ns = 8000000000ULL * SPI_ADC_FRAME_BYTES
+                      / spi_adc_info (SPI_ADC_MODEL).clock_hz;
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+  {
+    offsets[channel] = (uint16_t)((channel * frame_ns + 500) / 1000);
+  }
+
+#ifdef USE_LOW_POWER
+  int64_t next_wake = esp_timer_get_time ();
+#else
+  TickType_t last_wake = xTaskGetTickCount ();
+#endif
+  bool first = true;
+
+  for (;;)
+  {
+    uint16_t period_ms = config_now ().sample_period_ms;
+#ifdef USE_LOW_POWER
+    next_wake += period_ms * 1000;
+    power_wait_until (next_wake, false);
+#else
+    vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (period_ms));
+#endif
+
+    // Collect the batch started a period ago and start the next at once,
+    // so that each batch converts while this task waits
+    TRACE_BEGIN (loop);
+    uint32_t time = millis () - period_ms;
+    bool done = spi_adc_bus_finish (spi_batches[current]);
+    spi_adc_bus_start (spi_batches[current ^ 1]);
+
+    spi_burst_t burst = {};
+    if (done && spi_adc.decode (spi_batches[current], add_spi_scan, &burst))
+    {
+      uint16_t readings[PIPELINE_MAX_CHANNELS];
+      for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+      {
+        readings[channel] = (uint16_t)((burst.sums[channel]
+                                        + burst.scans / 2) / burst.scans);
+      }
+      pipeline.put (time, readings, offsets);
+      if (first)
+      {
+        boot_span ("reset to first sample", 0);
+        first = false;
+      }
+    }
+    current ^= 1;
+    TRACE_END (loop, "sensor loop");
+  }
+#else
+#ifdef USE_LOW_POWER
+  int64_t next_wake = esp_timer_get_time ();
+#else
+  TickType_t last_wake = xTaskGetTickCount ();
+#endif
+  bool first = true;
+  SampleSchedule schedule (CHANNEL_COUNT, SCHEDULE_MIRRORED);
+
+  for (;;)
+  {
+    // read the raw ADC counts from the input pins, noting when each was read
+    TRACE_BEGIN (loop);
+    uint16_t readings[PIPELINE_MAX_CHANNELS];
+    uint16_t offsets[PIPELINE_MAX_CHANNELS];
+    uint32_t time = millis ();
+    schedule.scan (read_channel, read_clock, NULL, readings, offsets);
+
+    pipeline.put (time, readings, offsets);
+    if (first)
+    {
+      boot_span ("reset to first sample", 0);
+      first = false;
+    }
+    TRACE_END (loop, "sensor loop");
+
+    // wait until it's time to read the voltages again
+    uint16_t period_ms = config_now ().sample_period_ms;
+#ifdef USE_LOW_POWER
+    // The chip may sleep through the wait if no block is waiting to be
+    // processed; the tick count stops in sleep, so the timer is used
+    next_wake += period_ms * 1000;
+    power_wait_until (next_wake, pipeline.is_idle ());
+#else
+    vTaskDelayUntil (&last_wake, pdMS_TO_TICKS (period_ms));
+#endif
+  }
+#endif
+}
+
+
+/** @brief   Put a snapshot of the settings into the pipeline stages.
+ *  @details This is only called where the stages can't be running, before
+ *           the tasks start and between blocks in the processing task. The
+ *           filter starts again from the next reading if its time constant
+ *           changes, so that the old level isn't scaled wrongly.
+ *  @param   config The settings to use
+ */
+void apply_config (const config_t& config)
+{
+#ifdef USE_ULP
+  uint16_t period_ms = ulp_period_ms;
+#else
+  uint16_t period_ms = config.sample_period_ms;
+#endif
+  align_state.period_us = (uint32_t)period_ms * 1000;
+  detect_state.period_ms = period_ms;
+  detect_state.threshold = config.detect_threshold;
+  if (filter_state.shift != config.filter_shift)
+  {
+    filter_state.shift = config.filter_shift;
+    filter_state.primed = false;
+  }
+}
+
+
+/** @brief   Task which runs blocks of readings through the pipeline stages.
+ *  @details The stages filter the readings, look for debris pulses, store the
+ *           readings in the flash log and send a summary to the shares,
+ *           voltage history and serial monitor.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_process (void* p_params)
+{
+  // Mount the flash log here rather than in setup(), so that sampling can
+  // start at once; the sensor task fills the pipeline's blocks meanwhile
+  uint32_t mount_start = micros ();
+  if (sample_log_mount ())
+  {
+    boot_span ("mount flash log", mount_start);
+  }
+  else
+  {
+    boot_span ("flash log failed", mount_start);
+  }
+
+  uint32_t config_version = config_now ().version;
+  for (;;)
+  {
+    // Changed settings are put to use between blocks
+    const config_t& config = config_now ();
+    if (config.version != config_version)
+    {
+      apply_config (config);
+      config_version = config.version;
+    }
+
+#ifdef USE_SIMULATED
+    // Every simulated particle goes into the log beside the events, so a PC
+    // can check what the detector found against what was really there
+    signal_label_t label;
+    while (signal_gen.take_label (label))
+    {
+      uint8_t packed[9 + 2 * SIGNAL_MAX_CHANNELS];
+      sample_log_append (LOG_TRUTH, packed,
+                         signal_label_pack (label, CHANNEL_COUNT, packed));
+    }
+#endif
+
+    // When no block is ready, wait a tick for the sensor task to fill one;
+    // only blocks which were processed are traced
+    TRACE_BEGIN (block);
+    if (pipeline.process ())
+    {
+      TRACE_END (block, "process block");
+    }
+    else
+    {
+      vTaskDelay (1);
+    }
+  }
+}
+
+#ifdef USE_LAN
+/** @brief   Task which brings up the LAN connection and keeps it up.
+ *  @details Connecting and reconnecting never hold up anything else, so
+ *           sampling goes on whether or not the network is there.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_wifi (void* p_params)
+{
+  for (;;)
+  {
+#ifdef USE_LOW_POWER
+    // The radio is switched from this task, as the link must only be
+    // suspended and resumed where it's run
+    power_run ();
+#endif
+    wifi_link.run ();
+    vTaskDelay (pdMS_TO_TICKS (WIFI_POLL_MS));
+  }
+}
+
+
+/** @brief   Task which publishes summaries of the flash log to the MQTT
+ *           broker.
+ *  @details It runs at the lowest priority, since the broker can always
+ *           catch up from the log later.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_mqtt (void* p_params)
+{
+  for (;;)
+  {
+    mqtt.run ();
+    vTaskDelay (pdMS_TO_TICKS (MQTT_POLL_MS));
+  }
+}
+#endif
+
+#if defined (USE_LOW_POWER) && !defined (USE_LAN)
+/** @brief   Task which turns the access point on and off on the low-power
+ *           mode's schedule. On a LAN, the WiFi task does this instead.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_power (void* p_params)
+{
+  for (;;)
+  {
+    power_run ();
+    vTaskDelay (pdMS_TO_TICKS (POWER_POLL_MS));
+  }
+}
+#endif
+
+#ifdef USE_BEACON
+/** @brief   Task which sends the telemetry beacon at a steady rate.
+ *  @details Beacons are sent on a fixed schedule rather than a fixed delay
+ *           after each one, so listeners can count how many they missed.
+ *           While a LAN connection is down the beacon is skipped, but its
+ *           sequence number still goes up.
+ *  @param   p_params Pointer to unused parameters
+ */
+void task_beacon (void* p_params)
+{
+  beacon.begin (beacon_target, BEACON_PORT, BEACON_PERIOD_MS);
+
+  TickType_t wake_time = xTaskGetTickCount ();
+  for (;;)
+  {
+    vTaskDelayUntil (&wake_time, pdMS_TO_TICKS (BEACON_PERIOD_MS));
+#ifdef USE_LAN
+    if (!wifi_link.is_connected ())
+    {
+      beacon.skip ();
+      continue;
+    }
+#endif
+#ifdef USE_LOW_POWER
+    if (!power_radio_is_on ())
+    {
+      beacon.skip ();
+      continue;
+    }
+#endif
+    beacon.send ();
+  }
+}
+#endif
+
+/** @brief   Start everything up, sampling first.
+ *  @details Debris made while a machine starts is often the most telling, so
+ *           the sensor and processing tasks are started before the
+ *           network, with only what they need made ready first. The serial
+ *           port is one of those, since both tasks print to it as soon as
+ *           they run, which is at once, being above this task's priority.
+ *           The flash log, whose mounting can take seconds, is mounted by the
+ *           processing task itself while the sensor task fills its first
+ *           blocks. How long each phase takes is shown on @c /diag.
+ */
+void setup (void)
+{
+  boot_phase ("before setup");
+
+  // configure the input pins as analog inputs
+  for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+  {
+    pinMode (CHANNELS[channel].pin, INPUT);
+  }
+
+  // Begin the connection to the mpu
+  // mpu.begin(104);
+   
+  // Carve the buffer pools from the arena, then create the compressed
+  // voltage history, event ring and flash log before any task uses them
+  bool pools_ok = response_pool.begin () && download_pool.begin ();
+  history_init ();
+  events_init ();
+  sample_log_init ();
+
+  boot_phase ("buffers and pipeline");
+
+  // Settings saved by /config replace the defaults before anything uses them
+  config_t config = DEFAULT_CONFIG;
+  config_nvs_load (config);
+  config_begin (config);
+#ifdef USE_ULP
+  ulp_period_ms = config.sample_period_ms;
+#endif
+  apply_config (config_now ());
+  boot_phase ("settings");
+
+  // The serial port doesn't wait for a monitor to be opened, which on some
+  // boards would hold up everything after this until one is
+  Serial.begin (115200);
+  if (!pools_ok)
+  {
+    Serial << "Memory arena too small for the buffer pools" << endl;
+  }
+  boot_phase ("serial port");
+
+  // Start sampling before anything else, so that nothing the network does
+  // can delay it. The processing task runs below the sensor task so that
+  // reading the sensors always comes first
+  TaskHandle_t process_task;
+  xTaskCreate (task_process, "Process", PROCESS_STACK, NULL, 3, &process_task);
+
+  // Task which reads from the IMU
+  TaskHandle_t sensor_task;
+  xTaskCreate (task_sensor, "Sensor", SENSOR_STACK, NULL, 4, &sensor_task);
+  boot_phase ("start sampling");
+
+  // Call function which gets the WiFi working; it doesn't wait for the
+  // connection, which is kept up by its own task
+  setup_wifi ();
+#ifdef USE_LOW_POWER
+  power_begin (radio_on, radio_off);
+#endif
+  boot_phase ("start WiFi");
+
+  // Task which runs the web server. It runs at a low priority
+  xTaskCreate (task_webserver, "Web Server", WEB_STACK, NULL, 2, NULL);
+
+#ifdef USE_LAN
+  // Tasks which keep the LAN connection up and publish to the MQTT broker,
+  // below everything else
+  xTaskCreate (task_wifi, "WiFi", WIFI_STACK, NULL, 1, NULL);
+  xTaskCreate (task_mqtt, "MQTT", MQTT_STACK, NULL, 1, NULL);
+#endif
+
+#if defined (USE_LOW_POWER) && !defined (USE_LAN)
+  // Task which turns the access point on and off on schedule
+  xTaskCreate (task_power, "Power", POWER_STACK, NULL, 1, NULL);
+#endif
+
+#ifdef USE_BEACON
+  // Task which sends the telemetry beacon
+  xTaskCreate (task_beacon, "Beacon", BEACON_STACK, NULL, 1, NULL);
+#endif
 
+  // From here on, all buffers come from the arena; the sampling and
+  // processing tasks must never use the heap
+  heap_guard_watch (process_task);
+  heap_guard_watch (sensor_task);
+  heap_guard_seal ();
+  boot_phase ("start other tasks");
 }
 
 
@@ -0,0 +1,289 @@
+/** @file mem_pool.cpp
+ *  This file contains the static memory arena, the fixed-size block pools
+ *  which are carved from it, and the optional guard which catches use of the
+ *  heap after @c setup() has finished.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <atomic>
+#include "mem_pool.h"
+
+/// The arena itself, aligned so any kind of data can be put in it
+static uint8_t arena[ARENA_SIZE] __attribute__ ((aligned (8)));
+
+/// Number of bytes of the arena taken so far
+static size_t arena_next = 0;
+
+/// Set once setup is finished, after which the arena can't grow
+static bool arena_sealed = false;
+
+/// Pools which have been carved from the arena, for diagnostics
+static MemPool* pools[MAX_POOLS];
+
+/// Number of pools in @c pools
+static uint8_t num_pools = 0;
+
+
+/** @brief   Take memory from the arena.
+ *  @details Memory taken from the arena is never given back. This should
+ *           only be called from @c setup() and the init functions it calls.
+ *  @param   size The number of bytes wanted
+ *  @returns Pointer to 8-byte aligned memory, or @c NULL if the arena is
+ *           full or has been sealed
+ */
+void* arena_alloc (size_t size)
+{
+    size = (size + 7) & ~(size_t)7;
+    if (arena_sealed || arena_next + size > ARENA_SIZE)
+    {
+        return NULL;
+    }
+    void* p_memory = arena + arena_next;
+    arena_next += size;
+    return p_memory;
+}
+
+
+/** @brief   Get the number of bytes taken from the arena so far.
+ */
+size_t arena_used (void)
+{
+    return arena_next;
+}
+
+
+/** @brief   Get a pool by its index, for diagnostics.
+ *  @param   index The number of the pool, starting at zero
+ *  @returns Pointer to the pool, or @c NULL if there is no such pool
+ */
+MemPool* pool_at (uint8_t index)
+{
+    return (index < num_pools) ? pools[index] : NULL;
+}
+
+
+/** @brief   Create a pool; no memory is taken until @c begin() is called.
+ *  @param   name A short name for the pool, shown in diagnostics
+ *  @param   block_size The size of each block in bytes
+ *  @param   num_blocks The number of blocks in the pool
+ */
+MemPool::MemPool (const char* name, size_t block_size, uint16_t num_blocks)
+    : name (name), num_blocks (num_blocks), used (0), high_water (0),
+      failures (0), free_list (NULL)
+{
+    // Each free block must be able to hold the pointer to the next one
+    if (block_size < sizeof (void*))
+    {
+        block_size = sizeof (void*);
+    }
+    this->block_size = (block_size + 7) & ~(size_t)7;
+    portMUX_INITIALIZE (&mux);
+}
+
+
+/** @brief   Carve the pool's blocks from the arena.
+ *  @returns @c true if there was room in the arena for every block
+ */
+bool MemPool::begin (void)
+{
+    uint8_t* p_memory = (uint8_t*)arena_alloc (block_size * num_blocks);
+    if (p_memory == NULL || num_pools >= MAX_POOLS)
+    {
+        return false;
+    }
+    for (uint16_t index = 0; index < num_blocks; index++)
+    {
+        put (p_memory + index * block_size);
+    }
+    used = 0;
+    pools[num_pools++] = this;
+    return true;
+}
+
+
+/** @brief   Take a block from the pool.
+ *  @returns Pointer to the block, or @c NULL if every block is in use
+ */
+void* MemPool::get (void)
+{
+    portENTER_CRITICAL (&mux);
+    void* p_block = free_list;
+    if (p_block)
+    {
+        free_list = *(void**)p_block;
+        used++;
+        if (used > high_water)
+        {
+            high_water = used;
+        }
+    }
+    else
+    {
+        failures++;
+    }
+    portEXIT_CRITICAL (&mux);
+
+    return p_block;
+}
+
+
+/** @brief   Give a block back to the pool.
+ *  @param   p_block Pointer to a block which came from this pool's @c get()
+ */
+void MemPool::put (void* p_block)
+{
+    if (p_block == NULL)
+    {
+        return;
+    }
+    portENTER_CRITICAL (&mux);
+    *(void**)p_block = free_list;
+    free_list = p_block;
+    used--;
+    portEXIT_CRITICAL (&mux);
+}
+
+
+#ifdef NO_HEAP_AFTER_SETUP
+
+/// The largest number of tasks in which heap use is fatal
+const uint8_t MAX_WATCHED = 4;
+
+/// Set at the end of setup, after which heap use is counted
+static volatile bool heap_sealed = false;
+
+/// Number of heap allocations made since sealing, by any task
+static std::atomic<uint32_t> heap_count (0);
+
+/// Tasks in which heap use after sealing stops the program
+static TaskHandle_t watched[MAX_WATCHED];
+
+/// Number of tasks in @c watched
+static uint8_t num_watched = 0;
+
+/// Task which may use the heap for now even if it's watched, if any
+static volatile TaskHandle_t allowed_task = NULL;
+
+// The real allocators, reached through the linker's --wrap option
+extern "C" void* __real_malloc (size_t size);
+extern "C" void* __real_calloc (size_t count, size_t size);
+extern "C" void* __real_realloc (void* p_memory, size_t size);
+
+
+/** @brief   Count an allocation and stop if it came from a watched task.
+ *  @details Nothing may be printed here, as printing can itself allocate, so
+ *           the panic's backtrace is what shows the offending call.
+ */
+static void heap_check (void)
+{
+    if (!heap_sealed)
+    {
+        return;
+    }
+    heap_count.fetch_add (1, std::memory_order_relaxed);
+    TaskHandle_t task = xTaskGetCurrentTaskHandle ();
+    if (task == allowed_task)
+    {
+        return;
+    }
+    for (uint8_t index = 0; index < num_watched; index++)
+    {
+        if (watched[index] == task)
+        {
+            abort ();
+        }
+    }
+}
+
+
+/** @brief   Stand-in for @c malloc() which checks when it's being called.
+ */
+extern "C" void* __wrap_malloc (size_t size)
+{
+    heap_check ();
+    return __real_malloc (size);
+}
+
+
+/** @brief   Stand-in for @c calloc() which checks when it's being called.
+ */
+extern "C" void* __wrap_calloc (size_t count, size_t size)
+{
+    heap_check ();
+    return __real_calloc (count, size);
+}
+
+
+/** @brief   Stand-in for @c realloc() which checks when it's being called.
+ */
+extern "C" void* __wrap_realloc (void* p_memory, size_t size)
+{
+    heap_check ();
+    return __real_realloc (p_memory, size);
+}
+
+#endif // NO_HEAP_AFTER_SETUP
+
+
+/** @brief   Mark the end of setup.
+ *  @details After this the arena can't grow, and if the program was built
+ *           with @c NO_HEAP_AFTER_SETUP, heap allocations are counted.
+ */
+void heap_guard_seal (void)
+{
+    arena_sealed = true;
+#ifdef NO_HEAP_AFTER_SETUP
+    heap_sealed = true;
+#endif
+}
+
+
+/** @brief   Make heap use by a task a fatal error once setup is finished.
+ *  @details This is meant for the sampling and processing tasks, which must
+ *           run for weeks. The web server's library allocates memory for each
+ *           request, so its allocations are only counted.
+ *  @param   task The handle of the task to be watched
+ */
+void heap_guard_watch (TaskHandle_t task)
+{
+#ifdef NO_HEAP_AFTER_SETUP
+    if (num_watched < MAX_WATCHED)
+    {
+        watched[num_watched++] = task;
+    }
+#endif
+}
+
+
+/** @brief   Let the calling task use the heap for a while even if it's
+ *           watched, or stop letting it.
+ *  @details This is for things a watched task does rarely and whose use
+ *           of the heap is bounded, such as opening a file; the allocations
+ *           are still counted. Only one task at a time may be let off, so
+ *           callers should hold a mutex around the whole of it, as the
+ *           flash log does.
+ *  @param   allowed @c true to let the task use the heap, @c false to stop
+ */
+void heap_guard_allow (bool allowed)
+{
+#ifdef NO_HEAP_AFTER_SETUP
+    allowed_task = allowed ? xTaskGetCurrentTaskHandle () : NULL;
+#endif
+}
+
+
+/** @brief   Get the number of heap allocations made since setup finished.
+ *  @returns The count, or zero if the program wasn't built with
+ *           @c NO_HEAP_AFTER_SETUP
+ */
+uint32_t heap_guard_count (void)
+{
+#ifdef NO_HEAP_AFTER_SETUP
+    return heap_count.load (std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
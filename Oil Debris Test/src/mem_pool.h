@@ -0,0 +1,99 @@
+/** @file mem_pool.h
+ *  This file contains a static memory arena and fixed-size block pools for
+ *  the buffers the program uses while running. All the memory is set aside
+ *  in @c setup(), so that running for weeks can't fragment the heap.
+ *
+ *  If the program is built with @c NO_HEAP_AFTER_SETUP defined, calls to
+ *  @c malloc() after @c heap_guard_seal() are counted, and a call made from a
+ *  task marked with @c heap_guard_watch() stops the program with a panic so
+ *  the backtrace shows where it came from. The linker must also be given
+ *  @c --wrap options for the allocation functions; see @c platformio.ini.
+ *
+ *  A watched task may still use the heap for something rare and bounded
+ *  between @c heap_guard_allow(true) and @c heap_guard_allow(false); the
+ *  processing task does this to mount the flash log and to open a new log
+ *  file when the old one is full. Such allocations are still counted.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _MEM_POOL_H_
+#define _MEM_POOL_H_
+
+#include <Arduino.h>
+
+/// Size in bytes of the arena from which all pools and buffers are carved
+const size_t ARENA_SIZE = 48 * 1024;
+
+/// The largest number of pools which can exist at once
+const uint8_t MAX_POOLS = 6;
+
+
+/** @brief   Class which hands out and takes back blocks of one size.
+ *  @details The blocks are carved from the arena by @c begin(), which must be
+ *           called in @c setup(). Free blocks are kept in a linked list which
+ *           is threaded through the blocks themselves.
+ */
+class MemPool
+{
+protected:
+    const char* name;               ///< Name shown in diagnostics
+    size_t block_size;              ///< Size of each block in bytes
+    uint16_t num_blocks;            ///< Number of blocks in the pool
+    uint16_t used;                  ///< Blocks handed out right now
+    uint16_t high_water;            ///< Most blocks ever handed out at once
+    uint32_t failures;              ///< Requests made when no block was free
+    void* free_list;                ///< First free block
+    portMUX_TYPE mux;               ///< Guards the free list between tasks
+
+public:
+    MemPool (const char* name, size_t block_size, uint16_t num_blocks);
+
+    bool begin (void);
+    void* get (void);
+    void put (void* p_block);
+
+    /// Get the name shown in diagnostics
+    const char* get_name (void) const { return name; }
+
+    /// Get the size of each block in bytes
+    size_t get_block_size (void) const { return block_size; }
+
+    /// Get the number of blocks in the pool
+    uint16_t get_num_blocks (void) const { return num_blocks; }
+
+    /// Get the number of blocks handed out right now
+    uint16_t get_used (void) const { return used; }
+
+    /// Get the largest number of blocks ever handed out at once
+    uint16_t get_high_water (void) const { return high_water; }
+
+    /// Get the number of requests made when no block was free
+    uint32_t get_failures (void) const { return failures; }
+};
+
+
+// Take memory from the arena; only allowed before the arena is sealed
+void* arena_alloc (size_t size);
+
+// Get the number of bytes taken from the arena so far
+size_t arena_used (void);
+
+// Get a pool by its index, for diagnostics
+MemPool* pool_at (uint8_t index);
+
+// Mark the end of setup, after which the heap shouldn't be used
+void heap_guard_seal (void);
+
+// Make heap use by the given task a fatal error once sealed
+void heap_guard_watch (TaskHandle_t task);
+
+// Let the calling task use the heap even if it's watched, or stop it
+void heap_guard_allow (bool allowed);
+
+// Get the number of heap allocations made since sealing
+uint32_t heap_guard_count (void);
+
+#endif // _MEM_POOL_H_
@@ -0,0 +1,487 @@
+/** @file mqtt_publisher.cpp
+ *  This file contains a publisher which sends summaries of the flash log to
+ *  an MQTT broker through the ESP-IDF MQTT client, which comes with the
+ *  ESP32 Arduino core. Records are read from the log a batch at a time,
+ *  each block of samples is cut down to its mean and peak, and the batch is
+ *  published with QoS 1. The position in the log only moves on when the
+ *  broker acknowledges the message.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <LittleFS.h>
+#include "fixed_format.h"
+#include "json_writer.h"
+#include "mem_pool.h"
+#include "sample_codec.h"
+#include "sample_pipeline.h"
+#include "channels.h"
+#include "mqtt_publisher.h"
+
+/// Room kept in the payload for one more row, with a mean and a peak of up
+/// to four digits for every channel, and the closing brackets
+const size_t MQTT_ROW_ROOM = 32 + 10 * PIPELINE_MAX_CHANNELS;
+
+
+/** @brief   A debris event from the log, held until the blocks are written.
+ */
+struct mqtt_event_row_t
+{
+    uint32_t seq;               ///< Sequence number of the event's record
+    uint32_t time;              ///< Time at which the pulse began in ms
+    uint16_t peak;              ///< Highest reading above baseline in counts
+    uint16_t duration;          ///< Number of samples the pulse lasted
+    uint8_t channel;            ///< Index of the channel in the table
+};
+
+
+/** @brief   Copy text to the end of a message being built.
+ */
+static inline void put_text (char* out, size_t& length, const char* text)
+{
+    size_t count = strlen (text);
+    memcpy (out + length, text, count);
+    length += count;
+}
+
+
+/** @brief   Write a number, then a comma, at the end of a message.
+ */
+static inline void put_item (char* out, size_t& length, uint32_t number)
+{
+    length += fmt_uint (out + length, number);
+    out[length++] = ',';
+}
+
+
+/** @brief   Read a little-endian 16-bit number.
+ */
+static inline uint16_t get_u16 (const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+/** @brief   Read a little-endian 32-bit number.
+ */
+static inline uint32_t get_u32 (const uint8_t* p)
+{
+    return (uint32_t)get_u16 (p) | ((uint32_t)get_u16 (p + 2) << 16);
+}
+
+
+/** @brief   Decode one codec block and find the mean and largest reading.
+ *  @param   in Pointer to the encoded block
+ *  @param   in_size The number of bytes available at @c in
+ *  @param   info Set to the block's header
+ *  @param   mean Set to the mean reading in millivolts
+ *  @param   peak Set to the largest reading in millivolts
+ *  @returns The number of bytes the block took, or zero if it's damaged
+ */
+static size_t summarize_block (const uint8_t* in, size_t in_size,
+                               codec_block_info_t& info, uint16_t& mean,
+                               uint16_t& peak)
+{
+    uint16_t samples[PIPELINE_MAX_BLOCK];
+    size_t used = codec_decode_block (in, in_size, info, samples,
+                                      PIPELINE_MAX_BLOCK);
+    if (used == 0)
+    {
+        return 0;
+    }
+
+    uint32_t total = 0;
+    uint16_t largest = 0;
+    for (uint16_t index = 0; index < info.count; index++)
+    {
+        total += samples[index];
+        if (samples[index] > largest)
+        {
+            largest = samples[index];
+        }
+    }
+    mean = counts_to_millivolts ((total + info.count / 2) / info.count);
+    peak = counts_to_millivolts (largest);
+    return used;
+}
+
+
+/** @brief   Create a publisher which isn't yet connected to anything.
+ */
+MqttPublisher::MqttPublisher (void)
+    : client (NULL), device (""), payload (NULL), records (NULL),
+      connected (false), acked_id (-1), msg_id (-1), in_flight (false),
+      waiting (false), cursor_loaded (false), cursor (0), batch_last (0), saved_cursor (0),
+      sent_at (0), saved_at (0), waiting_since (0), stats ()
+{
+    topic[0] = '\0';
+}
+
+
+/** @brief   Set up the MQTT client and start it connecting to the broker.
+ *  @details This must be called during setup, as the buffers come from the
+ *           arena and the MQTT client allocates its own memory from the
+ *           heap. The client keeps reconnecting by itself whenever the
+ *           connection drops. The flash log needn't be mounted yet; the
+ *           saved position is read once it is.
+ *  @param   broker_uri Where the broker is, as in @c mqtt://192.168.1.10
+ *  @param   device_name Name of this tester, used in the topic and messages
+ *  @returns @c true if the client was started
+ */
+bool MqttPublisher::begin (const char* broker_uri, const char* device_name)
+{
+    device = device_name;
+    size_t length = 0;
+    put_text (topic, length, "debris/");
+    put_text (topic, length, device_name);
+    put_text (topic, length, "/telemetry");
+    topic[length] = '\0';
+
+    payload = (char*)arena_alloc (MQTT_PAYLOAD_SIZE);
+    records = (uint8_t*)arena_alloc (MQTT_READ_SIZE);
+    if (payload == NULL || records == NULL)
+    {
+        return false;
+    }
+
+    esp_mqtt_client_config_t config = {};
+    config.uri = broker_uri;
+    config.client_id = device_name;
+    config.buffer_size = 512;
+    config.out_buffer_size = MQTT_PAYLOAD_SIZE + 128;
+    client = esp_mqtt_client_init (&config);
+    if (client == NULL)
+    {
+        return false;
+    }
+    esp_mqtt_client_register_event (client, MQTT_EVENT_ANY, on_event, this);
+    return esp_mqtt_client_start (client) == 0;
+}
+
+
+/** @brief   Keep track of the connection and acknowledgements.
+ *  @details This runs in the MQTT client's own task, so it only sets flags
+ *           which @c run() looks at.
+ */
+void MqttPublisher::on_event (void* p_args, esp_event_base_t base,
+                              int32_t event_id, void* p_data)
+{
+    MqttPublisher* p_this = (MqttPublisher*)p_args;
+    esp_mqtt_event_handle_t event = (esp_mqtt_event_handle_t)p_data;
+
+    switch (event_id)
+    {
+        case MQTT_EVENT_CONNECTED:
+            p_this->stats.connects++;
+            p_this->connected = true;
+            break;
+        case MQTT_EVENT_DISCONNECTED:
+            p_this->connected = false;
+            break;
+        case MQTT_EVENT_PUBLISHED:
+            p_this->acked_id = event->msg_id;
+            break;
+        default:
+            break;
+    }
+}
+
+
+/** @brief   Read the position of the last acknowledged record from flash.
+ *  @details The first time the publisher runs there's no saved position,
+ *           so it starts with the records logged since startup rather than
+ *           sending the whole log.
+ */
+void MqttPublisher::load_cursor (void)
+{
+    cursor = sample_log_mount_seq () - 1;
+    File file = LittleFS.open (MQTT_CURSOR_FILE, "r");
+    if (file)
+    {
+        file.read ((uint8_t*)&cursor, sizeof (cursor));
+        file.close ();
+    }
+    saved_cursor = cursor;
+    cursor_loaded = true;
+}
+
+
+/** @brief   Save the position of the last acknowledged record in flash.
+ */
+void MqttPublisher::save_cursor (void)
+{
+    File file = LittleFS.open (MQTT_CURSOR_FILE, "w");
+    if (file)
+    {
+        file.write ((const uint8_t*)&cursor, sizeof (cursor));
+        file.close ();
+        saved_cursor = cursor;
+    }
+}
+
+
+/** @brief   Build a message from the records in part of the log.
+ *  @details Records are read a buffer at a time. The message stops early
+ *           if the payload buffer would overflow; the rest go in the next.
+ *  @param   span Where the records are, from @c sample_log_find()
+ *  @param   last_seq Set to the sequence number of the last record used
+ *  @returns The length of the message, or zero if the records couldn't be
+ *           read, as happens if the log was moved aside meanwhile
+ */
+size_t MqttPublisher::build (const log_span_t& span, uint32_t& last_seq)
+{
+    mqtt_event_row_t events[MQTT_BATCH_RECORDS];
+    uint16_t event_count = 0;
+    uint32_t newest = 0;
+    uint32_t first_seq = 0;
+    last_seq = 0;
+
+    size_t length = 0;
+    put_text (payload, length, "{\"schema\":");
+    put_item (payload, length, JSON_SCHEMA_VERSION);
+    put_text (payload, length, "\"device\":\"");
+    put_text (payload, length, device);
+    put_text (payload, length, "\",\"channels\":[");
+    for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+    {
+        put_text (payload, length, channel ? ",\"" : "\"");
+        size_t name_length = strnlen (CHANNELS[channel].name,
+                                      CHANNEL_NAME_MAX);
+        memcpy (payload + length, CHANNELS[channel].name, name_length);
+        length += name_length;
+        payload[length++] = '"';
+    }
+    put_text (payload, length, "],\"blocks\":[");
+    size_t blocks_start = length;
+
+    size_t offset = span.start;
+    bool full = false;
+    while (offset < span.end && !full)
+    {
+        size_t wanted = span.end - offset;
+        if (wanted > MQTT_READ_SIZE)
+        {
+            wanted = MQTT_READ_SIZE;
+        }
+        size_t got = sample_log_read (offset, records, wanted,
+                                      span.generation);
+        if (got < LOG_RECORD_HEADER_SIZE)
+        {
+            return 0;
+        }
+
+        // Use each whole record in the buffer; a record cut off at the end
+        // is read again from its start
+        size_t pos = 0;
+        while (pos + LOG_RECORD_HEADER_SIZE <= got)
+        {
+            const uint8_t* p_record = records + pos;
+            size_t size = get_u16 (p_record + 2);
+            if (pos + LOG_RECORD_HEADER_SIZE + size > got)
+            {
+                break;
+            }
+            if (length + MQTT_ROW_ROOM * (event_count + 2)
+                > MQTT_PAYLOAD_SIZE)
+            {
+                full = true;
+                break;
+            }
+
+            uint32_t seq = get_u32 (p_record + 4);
+            const uint8_t* p_data = p_record + LOG_RECORD_HEADER_SIZE;
+            if (p_record[1] == LOG_SAMPLES)
+            {
+                // A mean and a peak for each channel's block, in order
+                codec_block_info_t info;
+                uint16_t mean, peak;
+                size_t used;
+                size_t at = 0;
+                uint8_t channels = 0;
+                while (at < size && channels < PIPELINE_MAX_CHANNELS
+                       && (used = summarize_block (p_data + at, size - at,
+                                                   info, mean, peak)) > 0)
+                {
+                    if (channels++ == 0)
+                    {
+                        payload[length++] = '[';
+                        put_item (payload, length, seq);
+                        put_item (payload, length, info.timestamp);
+                        newest = info.timestamp;
+                    }
+                    put_item (payload, length, mean);
+                    put_item (payload, length, peak);
+                    at += used;
+                }
+                if (channels > 0)
+                {
+                    // Replace the comma after the last peak
+                    length--;
+                    put_text (payload, length, "],");
+                }
+            }
+            else if (p_record[1] == LOG_EVENT && size >= 9)
+            {
+                mqtt_event_row_t& row = events[event_count++];
+                row.seq = seq;
+                row.time = get_u32 (p_data);
+                row.peak = get_u16 (p_data + 4);
+                row.duration = get_u16 (p_data + 6);
+                row.channel = p_data[8];
+                newest = row.time;
+            }
+
+            if (first_seq == 0)
+            {
+                first_seq = seq;
+            }
+            last_seq = seq;
+            pos += LOG_RECORD_HEADER_SIZE + size;
+        }
+        if (pos == 0 && !full)
+        {
+            // A record bigger than the read buffer; this can't be sent
+            return 0;
+        }
+        offset += pos;
+    }
+    if (last_seq == 0)
+    {
+        return 0;
+    }
+
+    // Replace the comma after the last block with the closing bracket
+    if (length > blocks_start)
+    {
+        length--;
+    }
+    put_text (payload, length, "],\"events\":[");
+    for (uint16_t index = 0; index < event_count; index++)
+    {
+        payload[length++] = '[';
+        put_item (payload, length, events[index].seq);
+        put_item (payload, length, events[index].time);
+        put_item (payload, length, events[index].channel);
+        put_item (payload, length, events[index].peak);
+        length += fmt_uint (payload + length, events[index].duration);
+        put_text (payload, length, (index + 1 < event_count) ? "]," : "]");
+    }
+
+    put_text (payload, length, "],\"first\":");
+    put_item (payload, length, first_seq);
+    put_text (payload, length, "\"last\":");
+    put_item (payload, length, last_seq);
+    put_text (payload, length, "\"lost\":");
+    put_item (payload, length, stats.lost);
+    put_text (payload, length, "\"age_ms\":");
+    length += fmt_uint (payload + length, millis () - newest);
+    put_text (payload, length, "}");
+
+    return length;
+}
+
+
+/** @brief   Publish the next batch of records if it's time to.
+ *  @details This is called every few tens of milliseconds by the MQTT task.
+ *           A batch goes out when it's full or when its oldest record has
+ *           waited @c MQTT_MAX_DELAY_MS, but never sooner than
+ *           @c MQTT_MIN_INTERVAL_MS after the last one. While catching up
+ *           on a backlog, that bounds the rate to one full batch per
+ *           interval, which leaves the WiFi free for the web server.
+ */
+void MqttPublisher::run (void)
+{
+    if (client == NULL || !sample_log_ready ())
+    {
+        return;
+    }
+    if (!cursor_loaded)
+    {
+        load_cursor ();
+    }
+    uint32_t now = millis ();
+
+    if (in_flight)
+    {
+        if (acked_id == msg_id)
+        {
+            in_flight = false;
+            stats.records += batch_last - cursor;
+            cursor = batch_last;
+            stats.acked++;
+            stats.last_ack_ms = now - sent_at;
+            if (stats.last_ack_ms > stats.max_ack_ms)
+            {
+                stats.max_ack_ms = stats.last_ack_ms;
+            }
+        }
+        else if (!connected || now - sent_at > MQTT_ACK_TIMEOUT_MS)
+        {
+            // Send the same records again once the broker is back
+            in_flight = false;
+            stats.resends++;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    if (cursor != saved_cursor && now - saved_at >= MQTT_CURSOR_SAVE_MS)
+    {
+        save_cursor ();
+        saved_at = now;
+    }
+
+    if (!connected || now - sent_at < MQTT_MIN_INTERVAL_MS)
+    {
+        return;
+    }
+
+    log_span_t span;
+    if (!sample_log_find (cursor, MQTT_BATCH_RECORDS, span))
+    {
+        waiting = false;
+        stats.backlog = 0;
+        return;
+    }
+    stats.backlog = span.next_seq - 1 - cursor;
+    if (!waiting)
+    {
+        waiting = true;
+        waiting_since = now;
+    }
+    if (span.count < MQTT_BATCH_RECORDS
+        && now - waiting_since < MQTT_MAX_DELAY_MS)
+    {
+        return;
+    }
+
+    // Records which were rotated out of the log before they could be sent
+    if (span.oldest_seq > cursor + 1)
+    {
+        stats.lost += span.oldest_seq - cursor - 1;
+        cursor = span.oldest_seq - 1;
+    }
+
+    uint32_t last_seq;
+    size_t length = build (span, last_seq);
+    if (length == 0)
+    {
+        return;
+    }
+
+    acked_id = -1;
+    int id = esp_mqtt_client_publish (client, topic, payload, length, 1, 0);
+    sent_at = now;
+    if (id >= 0)
+    {
+        msg_id = id;
+        batch_last = last_seq;
+        in_flight = true;
+        waiting = false;
+        stats.published++;
+    }
+}
@@ -0,0 +1,123 @@
+/** @file mqtt_publisher.h
+ *  This file contains a class which pushes summaries of the stored sample
+ *  blocks, and the debris events, to an MQTT broker. The flash log is the
+ *  publisher's outbox: it keeps the sequence number of the last record the
+ *  broker acknowledged, so anything logged while the broker can't be
+ *  reached is simply sent later, at a bounded rate.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _MQTT_PUBLISHER_H_
+#define _MQTT_PUBLISHER_H_
+
+#include <Arduino.h>
+#include "mqtt_client.h"
+#include "sample_log.h"
+
+/// Name of the file which holds the last record the broker acknowledged
+#define MQTT_CURSOR_FILE "/mqtt.cur"
+
+/// The most log records summarized in one message
+const uint16_t MQTT_BATCH_RECORDS = 40;
+
+/// Longest a new record waits for a batch to fill before it's sent anyway
+const uint32_t MQTT_MAX_DELAY_MS = 2000;
+
+/// Shortest time between messages, which bounds how fast a backlog drains
+const uint32_t MQTT_MIN_INTERVAL_MS = 250;
+
+/// Time after which a message the broker hasn't acknowledged is sent again
+const uint32_t MQTT_ACK_TIMEOUT_MS = 10000;
+
+/// How often the acknowledged position is saved in flash
+const uint32_t MQTT_CURSOR_SAVE_MS = 30000;
+
+/// Size of the buffer in which a message is built
+const size_t MQTT_PAYLOAD_SIZE = 4096;
+
+/// Size of the buffer into which log records are read
+const size_t MQTT_READ_SIZE = 1024;
+
+
+/** @brief   Counts kept by the publisher, shown on the diagnostics page.
+ */
+struct mqtt_stats_t
+{
+    uint32_t connects;          ///< Times the broker connection came up
+    uint32_t published;         ///< Messages handed to the MQTT client
+    uint32_t acked;             ///< Messages the broker acknowledged
+    uint32_t resends;           ///< Batches sent again for lack of an ack
+    uint32_t records;           ///< Log records acknowledged
+    uint32_t lost;              ///< Records rotated out of the log unsent
+    uint32_t backlog;           ///< Records waiting when last checked
+    uint32_t last_ack_ms;       ///< Time from publishing to the last ack
+    uint32_t max_ack_ms;        ///< Longest time from publishing to an ack
+};
+
+
+/** @brief   Class which publishes batches of log records to an MQTT broker
+ *           with QoS 1.
+ *  @details Messages go to @c debris/<device>/telemetry as JSON:
+ *
+ *           @code
+ *           {"schema":1,"device":"debris-a1b2c3","first":101,"last":140,
+ *            "lost":0,"age_ms":380,"channels":["fine","coarse"],
+ *            "blocks":[[seq,time_ms,fine_mean_mV,fine_max_mV,
+ *                       coarse_mean_mV,coarse_max_mV],...],
+ *            "events":[[seq,time_ms,channel,peak_counts,samples],...]}
+ *           @endcode
+ *
+ *           Each block row has a mean and a peak for every channel stored
+ *           in the record, in the order of @c channels, which is the
+ *           channel table's; an event's channel is an index into it.
+ *
+ *           One message is in flight at a time; the next is built only
+ *           after the broker has acknowledged the last. After a restart or
+ *           a lost acknowledgement, a few records may be sent twice, so
+ *           subscribers should drop repeated sequence numbers.
+ */
+class MqttPublisher
+{
+protected:
+    esp_mqtt_client_handle_t client;    ///< The ESP-IDF MQTT client
+    char topic[48];                     ///< Topic messages go to
+    const char* device;                 ///< Name of this tester
+    char* payload;                      ///< Where a message is built
+    uint8_t* records;                   ///< Where log records are read
+    volatile bool connected;            ///< The broker is connected
+    volatile int acked_id;              ///< Message the broker last acked
+    int msg_id;                         ///< Message waiting for its ack
+    bool in_flight;                     ///< A message is waiting for an ack
+    bool waiting;                       ///< New records are waiting to go
+    bool cursor_loaded;                 ///< Cursor has been read from flash
+    uint32_t cursor;                    ///< Last record the broker has
+    uint32_t batch_last;                ///< Last record in the message
+    uint32_t saved_cursor;              ///< Cursor as last saved in flash
+    uint32_t sent_at;                   ///< When the message was published
+    uint32_t saved_at;                  ///< When the cursor was last saved
+    uint32_t waiting_since;             ///< When new records were first seen
+    mqtt_stats_t stats;                 ///< Counts for diagnostics
+
+    static void on_event (void* p_args, esp_event_base_t base,
+                          int32_t event_id, void* p_data);
+    size_t build (const log_span_t& span, uint32_t& last_seq);
+    void load_cursor (void);
+    void save_cursor (void);
+
+public:
+    MqttPublisher (void);
+
+    bool begin (const char* broker_uri, const char* device_name);
+    void run (void);
+
+    /// Find out whether the broker is connected
+    bool is_connected (void) const { return connected; }
+
+    /// Get a copy of the publisher's counts
+    mqtt_stats_t get_stats (void) const { return stats; }
+};
+
+#endif // _MQTT_PUBLISHER_H_
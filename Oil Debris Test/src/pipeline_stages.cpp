@@ -0,0 +1,486 @@
+/** @file pipeline_stages.cpp
+ *  This file contains the stages which the debris tester's sample pipeline
+ *  runs on each block of readings, in the processing task.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include "shares.h"
+#include "sample_codec.h"
+#include "sample_log.h"
+#include "voltage_history.h"
+#include "fixed_format.h"
+#include "channels.h"
+#include "block_kernels.h"
+#include "pipeline_stages.h"
+#include "trace.h"
+
+/// Ring of the most recent debris events
+static debris_event_t event_ring[EVENT_RING_SIZE];
+
+/// Number of events detected since boot; the newest is at this minus one
+static uint32_t event_count = 0;
+
+/// Mutex which keeps the web server from copying a half-written event
+static SemaphoreHandle_t event_mutex = NULL;
+
+/// Sums and peaks of the blocks streamed since the rollup was last taken
+static uint32_t rollup_blocks = 0;
+static uint32_t rollup_fine_sum = 0;
+static uint32_t rollup_coarse_sum = 0;
+static uint16_t rollup_fine_max = 0;
+static uint16_t rollup_coarse_max = 0;
+
+/// Guards the rollup between the processing task and whoever takes it
+static portMUX_TYPE rollup_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/// Each channel's mean reading in the last block streamed, in millivolts
+static volatile uint16_t latest_mv[PIPELINE_MAX_CHANNELS];
+
+
+/** @brief   Create the mutex which protects the event ring.
+ */
+void events_init (void)
+{
+    event_mutex = xSemaphoreCreateMutex ();
+}
+
+
+/** @brief   Copy the most recent debris events.
+ *  @param   events Pointer to an array into which events are copied, oldest
+ *           first
+ *  @param   max The size of the array
+ *  @returns The number of events copied
+ */
+uint8_t events_snapshot (debris_event_t* events, uint8_t max)
+{
+    xSemaphoreTake (event_mutex, portMAX_DELAY);
+    uint32_t available = (event_count < EVENT_RING_SIZE) ? event_count
+                                                         : EVENT_RING_SIZE;
+    uint8_t copies = (available < max) ? available : max;
+    for (uint8_t index = 0; index < copies; index++)
+    {
+        events[index] = event_ring[(event_count - copies + index)
+                                   % EVENT_RING_SIZE];
+    }
+    xSemaphoreGive (event_mutex);
+
+    return copies;
+}
+
+
+/** @brief   Get the number of debris events detected since boot.
+ */
+uint32_t events_total (void)
+{
+    return event_count;
+}
+
+
+/** @brief   Get the summary of the blocks streamed since the last call, and
+ *           start a new one.
+ *  @param   rollup Set to the means and peaks, which are all zero if no
+ *           blocks were streamed
+ */
+void rollup_take (rollup_t& rollup)
+{
+    portENTER_CRITICAL (&rollup_mux);
+    uint32_t blocks = rollup_blocks;
+    uint32_t fine_sum = rollup_fine_sum;
+    uint32_t coarse_sum = rollup_coarse_sum;
+    rollup.fine_max = rollup_fine_max;
+    rollup.coarse_max = rollup_coarse_max;
+    rollup_blocks = 0;
+    rollup_fine_sum = 0;
+    rollup_coarse_sum = 0;
+    rollup_fine_max = 0;
+    rollup_coarse_max = 0;
+    portEXIT_CRITICAL (&rollup_mux);
+
+    rollup.blocks = (blocks < 0xFFFF) ? blocks : 0xFFFF;
+    rollup.fine_mean = blocks ? (fine_sum + blocks / 2) / blocks : 0;
+    rollup.coarse_mean = blocks ? (coarse_sum + blocks / 2) / blocks : 0;
+}
+
+
+/** @brief   Get a channel's mean reading in the last block streamed.
+ *  @param   channel The channel's index in the channel table
+ *  @returns The reading in millivolts, or zero if there's no such channel
+ */
+uint16_t channel_millivolts (uint8_t channel)
+{
+    return (channel < PIPELINE_MAX_CHANNELS) ? latest_mv[channel] : 0;
+}
+
+
+/** @brief   Put a finished event into the ring, replacing the oldest one,
+ *           and add it to the flash log.
+ *  @details In the log an event is 9 little-endian bytes: time (4), peak
+ *           (2), duration (2) and channel (1).
+ */
+static void event_record (const debris_event_t& event)
+{
+    xSemaphoreTake (event_mutex, portMAX_DELAY);
+    event_ring[event_count % EVENT_RING_SIZE] = event;
+    event_count++;
+    xSemaphoreGive (event_mutex);
+
+    uint8_t packed[9] =
+    {
+        (uint8_t)event.time, (uint8_t)(event.time >> 8),
+        (uint8_t)(event.time >> 16), (uint8_t)(event.time >> 24),
+        (uint8_t)event.peak, (uint8_t)(event.peak >> 8),
+        (uint8_t)event.duration, (uint8_t)(event.duration >> 8),
+        event.channel
+    };
+    sample_log_append (LOG_EVENT, packed, sizeof (packed));
+}
+
+
+/** @brief   Copy text to the end of a line being composed.
+ *  @param   line The line; the caller makes sure there is room
+ *  @param   length The number of characters in the line, which is updated
+ *  @param   text The text to be copied
+ */
+static inline void append_text (char* line, size_t& length, const char* text)
+{
+    size_t count = strlen (text);
+    memcpy (line + length, text, count);
+    length += count;
+}
+
+
+/** @brief   Move each reading back to the start of its scan, so that every
+ *           channel's readings are for the same moments.
+ *  @details The channels of a scan are converted one after another; see
+ *           @c sample_schedule.h. Each reading is replaced by the point at
+ *           the start of its scan on the straight line from the channel's
+ *           reading before, so nothing needs to wait for the next block.
+ *           Readings without offsets are left as they are.
+ *  @param   block The block whose readings are replaced with aligned ones
+ *  @param   p_context Pointer to an @c align_state_t
+ */
+void stage_align (sample_block_t& block, void* p_context)
+{
+    align_state_t* p_state = (align_state_t*)p_context;
+    int32_t period = (int32_t)p_state->period_us;
+    if (period == 0 || block.count == 0)
+    {
+        return;
+    }
+
+    if (!p_state->primed)
+    {
+        for (uint8_t channel = 0; channel < block.channels; channel++)
+        {
+            p_state->last[channel] = block.samples[channel][0];
+        }
+        p_state->primed = true;
+    }
+
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        uint16_t* samples = block.samples[channel];
+        const uint16_t* offsets = block.offsets[channel];
+        int32_t previous = p_state->last[channel];
+        for (uint16_t index = 0; index < block.count; index++)
+        {
+            // Fraction of a period by which the reading was late, in
+            // 65536ths, so the rest is integer arithmetic
+            int32_t offset = (offsets[index] < period) ? offsets[index]
+                                                       : period;
+            int32_t weight = (offset << 16) / period;
+            int32_t reading = samples[index];
+            samples[index] = (uint16_t)(reading - (((reading - previous)
+                                                    * weight + 0x8000) >> 16));
+            previous = reading;
+        }
+        p_state->last[channel] = (uint16_t)previous;
+    }
+}
+
+
+/** @brief   Smooth the readings in a block with a first-order low-pass filter.
+ *  @details The filter is y += (x - y) / 2^shift, done in fixed point. Its
+ *           state carries over from one block to the next.
+ *  @param   block The block whose readings are replaced with filtered ones
+ *  @param   p_context Pointer to a @c filter_state_t
+ */
+void stage_filter (sample_block_t& block, void* p_context)
+{
+    filter_state_t* p_state = (filter_state_t*)p_context;
+    uint8_t shift = p_state->shift;
+
+    if (!p_state->primed && block.count > 0)
+    {
+        for (uint8_t channel = 0; channel < block.channels; channel++)
+        {
+            p_state->levels[channel] = (int32_t)block.samples[channel][0]
+                                       << shift;
+        }
+        p_state->primed = true;
+    }
+
+    // Each reading depends on the one before, so the readings are taken in
+    // order; keeping a channel's in one array keeps them in one cache line
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        kernels ().filter (block.samples[channel], block.count,
+                           p_state->levels[channel], shift);
+    }
+}
+
+
+/** @brief   Run the debris detector over the readings from one sensor.
+ *  @details A pulse starts when a reading rises @c threshold counts above
+ *           the baseline and ends when it falls back below half of that. The
+ *           baseline follows the signal slowly, except during a pulse.
+ *
+ *           Between pulses the baseline can't fall below the lower of where
+ *           it is and the block's smallest reading, less one for rounding,
+ *           so no reading at or below that plus @c threshold can start a
+ *           pulse. Those readings only move the baseline, and the threshold
+ *           kernel skips to the next one which might start a pulse.
+ */
+static void detect_channel (detect_channel_t& chan, const uint16_t* samples,
+                            uint16_t count, uint32_t start_time,
+                            uint16_t period_ms, uint16_t threshold,
+                            uint8_t channel)
+{
+    if (!chan.primed && count > 0)
+    {
+        chan.baseline = (int32_t)samples[0] << 8;
+        chan.primed = true;
+    }
+
+    block_stats_t stats;
+    kernels ().stats (samples, count, stats);
+
+    for (uint16_t index = 0; index < count; index++)
+    {
+        if (!chan.in_pulse)
+        {
+            int32_t lowest = chan.baseline >> 8;
+            lowest = (stats.min - 1 < lowest) ? stats.min - 1 : lowest;
+            int32_t limit = lowest + threshold;
+            uint16_t quiet = 0;
+            if (limit >= 0xFFFF)
+            {
+                quiet = count - index;
+            }
+            else if (limit >= 0)
+            {
+                quiet = kernels ().above (samples + index, count - index,
+                                          (uint16_t)limit);
+            }
+            for (; quiet > 0; quiet--, index++)
+            {
+                chan.baseline += (((int32_t)samples[index] << 8)
+                                  - chan.baseline) >> 6;
+            }
+            if (index == count)
+            {
+                break;
+            }
+        }
+
+        int32_t level = samples[index] - (chan.baseline >> 8);
+        if (!chan.in_pulse)
+        {
+            if (level > threshold)
+            {
+                chan.in_pulse = true;
+                chan.event.time = start_time + (uint32_t)index * period_ms;
+                chan.event.peak = (uint16_t)level;
+                chan.event.duration = 1;
+                chan.event.channel = channel;
+            }
+            else
+            {
+                chan.baseline += (((int32_t)samples[index] << 8)
+                                  - chan.baseline) >> 6;
+            }
+        }
+        else if (level > threshold / 2)
+        {
+            if (level > chan.event.peak)
+            {
+                chan.event.peak = (uint16_t)level;
+            }
+            chan.event.duration++;
+        }
+        else
+        {
+            chan.in_pulse = false;
+            event_record (chan.event);
+        }
+    }
+}
+
+
+/** @brief   Look for debris pulses in a block and record them as events.
+ *  @param   block The block to be examined
+ *  @param   p_context Pointer to a @c detect_state_t
+ */
+void stage_detect (sample_block_t& block, void* p_context)
+{
+    detect_state_t* p_state = (detect_state_t*)p_context;
+
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        detect_channel (p_state->channels[channel], block.samples[channel],
+                        block.count, block.start_time, p_state->period_ms,
+                        p_state->threshold, channel);
+    }
+}
+
+
+/** @brief   Add the names of a block's channels to the flash log.
+ *  @details The names go in channel order, each ended by a zero byte, so a
+ *           download can label its columns without knowing the table.
+ *  @param   channels The number of channels in the blocks stored
+ *  @returns @c true if the record was written
+ */
+static bool store_channel_names (uint8_t channels)
+{
+    static uint8_t names[PIPELINE_MAX_CHANNELS * (CHANNEL_NAME_MAX + 1)];
+
+    size_t length = 0;
+    for (uint8_t channel = 0; channel < channels; channel++)
+    {
+        size_t name_length = strnlen (CHANNELS[channel].name,
+                                      CHANNEL_NAME_MAX);
+        memcpy (names + length, CHANNELS[channel].name, name_length);
+        length += name_length;
+        names[length++] = '\0';
+    }
+    return sample_log_append (LOG_CHANNELS, names, length);
+}
+
+
+/** @brief   Compress a block and add it to the flash log.
+ *  @details Each channel's readings are encoded as a separate codec block,
+ *           in channel order, and the blocks are written to the log
+ *           together as one record. The channels' names are written first
+ *           after each mount and each time the log file is moved aside, so
+ *           that every file holds them.
+ *  @param   block The block to be stored
+ *  @param   p_context Not used
+ */
+void stage_store (sample_block_t& block, void* p_context)
+{
+    // The mount and file whose records the names were last written among
+    static uint32_t named_mount = 0;
+    static uint32_t named_generation = 0;
+    if ((sample_log_mount_seq () != named_mount
+         || sample_log_generation () != named_generation)
+        && store_channel_names (block.channels))
+    {
+        named_mount = sample_log_mount_seq ();
+        named_generation = sample_log_generation ();
+    }
+
+    // Room for a worst-case block per channel; see codec_max_encoded_size()
+    static uint8_t encoded[PIPELINE_MAX_CHANNELS
+                           * (CODEC_HEADER_SIZE
+                              + (PIPELINE_MAX_BLOCK * 13 + 7) / 8)];
+
+    size_t length = 0;
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        length += codec_encode_block (block.samples[channel], block.count,
+                                      channel, block.start_time,
+                                      encoded + length,
+                                      sizeof (encoded) - length);
+    }
+    sample_log_append (LOG_SAMPLES, encoded, length);
+}
+
+
+/** @brief   Send a summary of a block to the shares, the voltage history and
+ *           the serial port.
+ *  @details The block's average readings are used, so the serial monitor and
+ *           web page update once per block however fast sampling runs. The
+ *           shares hold millivolts, and the serial line is written with the
+ *           fixed-point formatter into one buffer and sent in one call. The
+ *           fine and coarse means and peaks are also added to the rollup for
+ *           the beacon.
+ *  @param   block The block to be summarized
+ *  @param   p_context Not used
+ */
+void stage_stream (sample_block_t& block, void* p_context)
+{
+    uint16_t mean_mv[PIPELINE_MAX_CHANNELS];
+    uint16_t peak_mv[PIPELINE_MAX_CHANNELS];
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        block_stats_t stats;
+        kernels ().stats (block.samples[channel], block.count, stats);
+        mean_mv[channel] = (uint16_t)((stats.sum + block.count / 2)
+                                      / block.count);
+        peak_mv[channel] = stats.max;
+    }
+    kernels ().scale (mean_mv, mean_mv, block.channels);
+    kernels ().scale (peak_mv, peak_mv, block.channels);
+
+    uint32_t sum_mv = 0;
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        latest_mv[channel] = mean_mv[channel];
+        sum_mv += mean_mv[channel];
+    }
+    uint16_t fine_mv = mean_mv[CHANNEL_FINE];
+    uint16_t coarse_mv = mean_mv[CHANNEL_COARSE];
+
+    // write to the shares
+    v_fine.put (fine_mv);
+    v_coarse.put (coarse_mv);
+
+    // add to the rollup which the telemetry beacon sends
+    portENTER_CRITICAL (&rollup_mux);
+    rollup_blocks++;
+    rollup_fine_sum += fine_mv;
+    rollup_coarse_sum += coarse_mv;
+    if (peak_mv[CHANNEL_FINE] > rollup_fine_max)
+    {
+        rollup_fine_max = peak_mv[CHANNEL_FINE];
+    }
+    if (peak_mv[CHANNEL_COARSE] > rollup_coarse_max)
+    {
+        rollup_coarse_max = peak_mv[CHANNEL_COARSE];
+    }
+    portEXIT_CRITICAL (&rollup_mux);
+
+    // keep a compressed copy of the readings for download; a channel of the
+    // table which this pipeline doesn't carry is kept as zero
+    float volts[PIPELINE_MAX_CHANNELS] = {};
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        volts[channel] = mean_mv[channel] / 1000.0f;
+    }
+    history_append (block.start_time, volts);
+
+    // print the voltages and the sum to the serial monitor
+    char line[PIPELINE_MAX_CHANNELS * (CHANNEL_NAME_MAX + 11) + 24];
+    size_t length = 0;
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        const char* name = CHANNELS[channel].name;
+        size_t name_length = strnlen (name, CHANNEL_NAME_MAX);
+        append_text (line, length, " ");
+        memcpy (line + length, name, name_length);
+        length += name_length;
+        append_text (line, length, ": ");
+        length += fmt_fixed (line + length, mean_mv[channel], 3);
+        append_text (line, length, "V");
+    }
+    append_text (line, length, " Sum: ");
+    length += fmt_fixed (line + length, sum_mv, 3);
+    append_text (line, length, "V\r\n");
+    TRACE_BEGIN (serial);
+    Serial.write (line, length);
+    TRACE_END (serial, "serial write");
+}
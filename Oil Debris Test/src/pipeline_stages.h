@@ -0,0 +1,117 @@
+/** @file pipeline_stages.h
+ *  This file contains the stages which the debris tester's sample pipeline
+ *  runs on each block: alignment of the channels in time, a smoothing
+ *  filter, a threshold detector for debris
+ *  particles, storage in the flash log and streaming to the shares, the
+ *  voltage history and the serial port.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _PIPELINE_STAGES_H_
+#define _PIPELINE_STAGES_H_
+
+#include <stdint.h>
+#include "sample_pipeline.h"
+
+/// Number of debris events kept for the web server to show
+const uint8_t EVENT_RING_SIZE = 64;
+
+
+/** @brief   A debris particle seen as a pulse on one of the sensors.
+ */
+struct debris_event_t
+{
+    uint32_t time;              ///< Time at which the pulse began in ms
+    uint16_t peak;              ///< Highest reading above baseline in counts
+    uint16_t duration;          ///< Number of samples the pulse lasted
+    uint8_t channel;            ///< Index of the sensor in the channel table
+};
+
+
+/** @brief   Data kept between blocks by the align stage.
+ */
+struct align_state_t
+{
+    uint32_t period_us;         ///< Time between scans in microseconds
+    bool primed;                ///< The last readings have been set
+    uint16_t last[PIPELINE_MAX_CHANNELS];   ///< Each channel's last reading
+};
+
+
+/** @brief   Data kept between blocks by the smoothing filter.
+ */
+struct filter_state_t
+{
+    uint8_t shift;              ///< Smoothing factor is 1 / 2^shift
+    bool primed;                ///< The filter has seen its first sample
+    int32_t levels[PIPELINE_MAX_CHANNELS];  ///< Filtered readings times 2^shift
+};
+
+
+/** @brief   Data kept between blocks by the debris detector for one sensor.
+ */
+struct detect_channel_t
+{
+    int32_t baseline;           ///< Slowly tracked baseline times 2^8
+    bool primed;                ///< The baseline has been set
+    bool in_pulse;              ///< A pulse is in progress
+    debris_event_t event;       ///< The pulse in progress
+};
+
+
+/** @brief   Data kept between blocks by the debris detector.
+ */
+struct detect_state_t
+{
+    uint16_t threshold;         ///< Counts above baseline which start a pulse
+    uint16_t period_ms;         ///< Time between samples in milliseconds
+    detect_channel_t channels[PIPELINE_MAX_CHANNELS];   ///< Each sensor's state
+};
+
+
+/** @brief   Summary of the blocks streamed since it was last taken.
+ */
+struct rollup_t
+{
+    uint16_t blocks;            ///< Number of blocks summarized
+    uint16_t fine_mean;         ///< Mean fine reading in millivolts
+    uint16_t fine_max;          ///< Largest fine reading in millivolts
+    uint16_t coarse_mean;       ///< Mean coarse reading in millivolts
+    uint16_t coarse_max;        ///< Largest coarse reading in millivolts
+};
+
+
+// Create the mutex which protects the event ring
+void events_init (void);
+
+// Copy up to @c max of the most recent events, oldest first
+uint8_t events_snapshot (debris_event_t* events, uint8_t max);
+
+// Get the number of events detected since boot
+uint32_t events_total (void);
+
+// Get the summary of the blocks streamed since the last call and start anew
+void rollup_take (rollup_t& rollup);
+
+// Get a channel's mean reading in the last block streamed, in millivolts
+uint16_t channel_millivolts (uint8_t channel);
+
+// Move each reading back to the start of its scan, to line up the channels
+void stage_align (sample_block_t& block, void* p_context);
+
+// Smooth the readings in a block with a first-order low-pass filter
+void stage_filter (sample_block_t& block, void* p_context);
+
+// Look for debris pulses in a block and record them as events
+void stage_detect (sample_block_t& block, void* p_context);
+
+// Compress a block and add it to the flash log
+void stage_store (sample_block_t& block, void* p_context);
+
+// Send a summary of a block to the shares, history and serial port
+void stage_stream (sample_block_t& block, void* p_context);
+
+#endif // _PIPELINE_STAGES_H_
@@ -0,0 +1,335 @@
+/** @file response_writer.cpp
+ *  This file contains a class which writes HTTP responses directly to the
+ *  web client's connection in TCP-sized pieces.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "fixed_format.h"
+#include "response_writer.h"
+
+
+/** @brief   Get the standard reason phrase for an HTTP status code.
+ */
+static const char* status_text (int code)
+{
+    switch (code)
+    {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 416: return "Range Not Satisfiable";
+        case 429: return "Too Many Requests";
+        case 503: return "Service Unavailable";
+        default:  return "";
+    }
+}
+
+
+/** @brief   Create a writer which sends to the given client.
+ *  @param   client The connection to the web client, usually
+ *           @c server.client()
+ *  @param   buffer Memory in which data waits to be sent, such as a block
+ *           from the response pool
+ *  @param   size The size of the buffer in bytes; only up to
+ *           @c RESPONSE_CHUNK_SIZE of it is used
+ */
+ResponseWriter::ResponseWriter (Print& client, char* buffer, size_t size)
+    : client (client), buffer (buffer), length (0), in_body (false),
+      failed (false), bytes_sent (0), bytes_copied (0), flushes (0)
+{
+    this->size = (size < RESPONSE_CHUNK_SIZE) ? size : RESPONSE_CHUNK_SIZE;
+}
+
+
+/** @brief   Write the status line and the headers every response has.
+ *  @param   code The HTTP status code, such as 200
+ *  @param   content_type The MIME type of the body
+ *  @param   content_length The length of the body in bytes, or
+ *           @c RESPONSE_LENGTH_UNKNOWN if the body ends when the connection
+ *           is closed
+ */
+void ResponseWriter::begin (int code, const char* content_type,
+                            size_t content_length)
+{
+    put_text ("HTTP/1.1 ");
+    put_uint (code);
+    put_text (" ");
+    put_text (status_text (code));
+    put_text ("\r\n");
+    header ("Content-Type", content_type);
+    if (content_length != RESPONSE_LENGTH_UNKNOWN)
+    {
+        put_text ("Content-Length: ");
+        put_uint (content_length);
+        put_text ("\r\n");
+    }
+    header ("Connection", "close");
+}
+
+
+/** @brief   Write one more header; this must come before the body.
+ *  @param   name The name of the header
+ *  @param   value The value of the header
+ */
+void ResponseWriter::header (const char* name, const char* value)
+{
+    put_text (name);
+    put_text (": ");
+    put_text (value);
+    put_text ("\r\n");
+}
+
+
+/** @brief   Write the blank line which ends the headers, if not done yet.
+ */
+void ResponseWriter::end_headers (void)
+{
+    if (!in_body)
+    {
+        in_body = true;
+        put ("\r\n", 2);
+    }
+}
+
+
+/** @brief   Copy data into the buffer, sending the buffer each time it fills.
+ *  @param   data Pointer to the data
+ *  @param   count The number of bytes to copy
+ */
+void ResponseWriter::put (const char* data, size_t count)
+{
+    while (count)
+    {
+        size_t room = size - length;
+        size_t take = (count < room) ? count : room;
+        memcpy (buffer + length, data, take);
+        length += take;
+        bytes_copied += take;
+        data += take;
+        count -= take;
+        if (length == size)
+        {
+            flush ();
+        }
+    }
+}
+
+
+/** @brief   Copy text into the buffer.
+ *  @param   text The null-terminated text to copy
+ */
+void ResponseWriter::put_text (const char* text)
+{
+    put (text, strlen (text));
+}
+
+
+/** @brief   Copy an unsigned number in decimal into the buffer.
+ *  @param   number The number to copy
+ */
+void ResponseWriter::put_uint (uint32_t number)
+{
+    char digits[FMT_MAX_CHARS];
+    put (digits, fmt_uint (digits, number));
+}
+
+
+/** @brief   Hand data to the client and keep count of what it took.
+ *  @param   data Pointer to the data
+ *  @param   count The number of bytes to send
+ */
+void ResponseWriter::send (const char* data, size_t count)
+{
+    size_t taken = client.write ((const uint8_t*)data, count);
+    bytes_sent += taken;
+    flushes++;
+    if (taken != count)
+    {
+        failed = true;
+    }
+}
+
+
+/** @brief   Write data to the body of the response.
+ *  @details When the data is long enough to fill a whole chunk or more, only
+ *           enough is copied to top up the buffer, and the rest of the full
+ *           chunks are sent straight from the caller's memory.
+ *  @param   data Pointer to the data
+ *  @param   count The number of bytes to write
+ */
+void ResponseWriter::write (const char* data, size_t count)
+{
+    end_headers ();
+    if (length > 0 && length + count >= 2 * size)
+    {
+        size_t fill = size - length;
+        put (data, fill);
+        data += fill;
+        count -= fill;
+    }
+    if (length == 0 && count >= size)
+    {
+        size_t direct = count - count % size;
+        send (data, direct);
+        data += direct;
+        count -= direct;
+    }
+    put (data, count);
+}
+
+
+/** @brief   Write a string of text to the body of the response.
+ *  @param   text The null-terminated text to write
+ */
+void ResponseWriter::write (const char* text)
+{
+    write (text, strlen (text));
+}
+
+
+/** @brief   Write an unsigned number in decimal to the body of the response.
+ *  @param   number The number to write
+ */
+void ResponseWriter::write_uint (uint32_t number)
+{
+    end_headers ();
+    put_uint (number);
+}
+
+
+/** @brief   Write a signed number in decimal to the body of the response.
+ *  @param   number The number to write
+ */
+void ResponseWriter::write_int (int32_t number)
+{
+    char digits[FMT_MAX_CHARS];
+    end_headers ();
+    put (digits, fmt_int (digits, number));
+}
+
+
+/** @brief   Write a scaled integer with a fixed number of decimal places to
+ *           the body of the response, such as millivolts shown as volts.
+ *  @param   number The number times 10^decimals
+ *  @param   decimals The number of digits after the decimal point
+ */
+void ResponseWriter::write_fixed (int32_t number, uint8_t decimals)
+{
+    char digits[FMT_MAX_CHARS];
+    end_headers ();
+    put (digits, fmt_fixed (digits, number, decimals));
+}
+
+
+/** @brief   Send whatever is waiting in the buffer to the client.
+ */
+void ResponseWriter::flush (void)
+{
+    if (length)
+    {
+        send (buffer, length);
+        length = 0;
+    }
+}
+
+
+/** @brief   Finish the response by sending whatever is left in the buffer.
+ *  @details The caller should then close the connection, as the response
+ *           says it will be closed.
+ *  @returns @c true if the client took every byte it was given
+ */
+bool ResponseWriter::end (void)
+{
+    end_headers ();
+    flush ();
+    return !failed;
+}
+
+
+/** @brief   Read a decimal number from text, moving past its digits.
+ *  @returns @c false if there were no digits or the number is too large
+ */
+static bool read_number (const char*& text, size_t& number)
+{
+    const char* start = text;
+    number = 0;
+    while (*text >= '0' && *text <= '9')
+    {
+        size_t digit = *text++ - '0';
+        if (number > ((size_t)-1 - digit) / 10)
+        {
+            return false;
+        }
+        number = number * 10 + digit;
+    }
+    return text != start;
+}
+
+
+/** @brief   Read a single byte range from the value of an HTTP @c Range
+ *           header.
+ *  @details The forms @c bytes=10-99, @c bytes=10- and @c bytes=-50 (the last
+ *           50 bytes) are understood. A header which can't be understood,
+ *           including one which asks for several ranges at once, is ignored
+ *           as HTTP allows, so the whole resource is sent.
+ *  @param   text The header's value, or @c NULL if there was no header
+ *  @param   total The size of the whole resource in bytes
+ *  @param   first Set to the offset of the first byte asked for
+ *  @param   last Set to the offset of the last byte asked for, which is
+ *           trimmed to the end of the resource
+ *  @returns Whether a range was given and whether it can be sent
+ */
+byte_range_t parse_byte_range (const char* text, size_t total,
+                               size_t& first, size_t& last)
+{
+    if (text == NULL || strncmp (text, "bytes=", 6) != 0)
+    {
+        return RANGE_NONE;
+    }
+    text += 6;
+
+    size_t start = 0;
+    size_t end = 0;
+    if (*text == '-')
+    {
+        // A suffix: the last so many bytes
+        text++;
+        if (!read_number (text, end) || *text != '\0')
+        {
+            return RANGE_NONE;
+        }
+        if (end == 0 || total == 0)
+        {
+            return RANGE_UNSATISFIABLE;
+        }
+        first = (end < total) ? total - end : 0;
+        last = total - 1;
+        return RANGE_VALID;
+    }
+
+    if (!read_number (text, start) || *text++ != '-')
+    {
+        return RANGE_NONE;
+    }
+    if (*text == '\0')
+    {
+        end = total - 1;
+    }
+    else if (!read_number (text, end) || *text != '\0' || end < start)
+    {
+        return RANGE_NONE;
+    }
+
+    if (start >= total)
+    {
+        return RANGE_UNSATISFIABLE;
+    }
+    first = start;
+    last = (end < total) ? end : total - 1;
+    return RANGE_VALID;
+}
@@ -0,0 +1,88 @@
+/** @file response_writer.h
+ *  This file contains a class which writes an HTTP response straight to the
+ *  web client's TCP connection. Text and numbers are gathered in one small
+ *  buffer which is sent whenever it holds a full TCP segment, so a page of
+ *  any length can be sent without first being built up in memory.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _RESPONSE_WRITER_H_
+#define _RESPONSE_WRITER_H_
+
+#include <Arduino.h>
+
+/// The most data sent in one piece, which fits one Ethernet/WiFi segment
+const size_t RESPONSE_CHUNK_SIZE = 1460;
+
+/// Content length given when the length of a response isn't known ahead
+const size_t RESPONSE_LENGTH_UNKNOWN = (size_t)-1;
+
+/// What a request's @c Range header asks for; see @c parse_byte_range()
+enum byte_range_t : uint8_t
+{
+    RANGE_NONE,             ///< The whole resource (no usable Range header)
+    RANGE_VALID,            ///< The part from @c first to @c last
+    RANGE_UNSATISFIABLE     ///< A part which lies wholly past the end
+};
+
+// Read a single "bytes=first-last" range from an HTTP Range header
+byte_range_t parse_byte_range (const char* text, size_t total,
+                               size_t& first, size_t& last);
+
+
+/** @brief   Class which writes an HTTP response to a client in TCP-sized
+ *           pieces from a reusable buffer.
+ *  @details The status line and headers are written by @c begin() and
+ *           @c header(); the body follows. Every response says the
+ *           connection will be closed, so that a body whose length isn't
+ *           known ahead ends when the caller closes the connection.
+ *           Writes which are at least a full chunk long go straight to the
+ *           client without being copied.
+ */
+class ResponseWriter
+{
+protected:
+    Print& client;                  ///< Connection to the web client
+    char* buffer;                   ///< Where data waits to be sent
+    size_t size;                    ///< Usable size of @c buffer
+    size_t length;                  ///< Bytes waiting in @c buffer
+    bool in_body;                   ///< Headers have all been written
+    bool failed;                    ///< The client didn't take some data
+    uint32_t bytes_sent;            ///< Bytes handed to the client so far
+    uint32_t bytes_copied;          ///< Bytes copied into @c buffer so far
+    uint16_t flushes;               ///< Number of writes to the client
+
+    void end_headers (void);
+    void put (const char* data, size_t count);
+    void put_text (const char* text);
+    void put_uint (uint32_t number);
+    void send (const char* data, size_t count);
+
+public:
+    ResponseWriter (Print& client, char* buffer, size_t size);
+
+    void begin (int code, const char* content_type,
+                size_t content_length = RESPONSE_LENGTH_UNKNOWN);
+    void header (const char* name, const char* value);
+    void write (const char* data, size_t count);
+    void write (const char* text);
+    void write_uint (uint32_t number);
+    void write_int (int32_t number);
+    void write_fixed (int32_t number, uint8_t decimals);
+    void flush (void);
+    bool end (void);
+
+    /// Get the number of bytes handed to the client so far
+    uint32_t get_bytes_sent (void) const { return bytes_sent; }
+
+    /// Get the number of bytes which had to be copied into the buffer
+    uint32_t get_bytes_copied (void) const { return bytes_copied; }
+
+    /// Get the number of separate writes made to the client
+    uint16_t get_flushes (void) const { return flushes; }
+};
+
+#endif // _RESPONSE_WRITER_H_
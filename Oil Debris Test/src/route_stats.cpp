@@ -0,0 +1,230 @@
+/** @file route_stats.cpp
+ *  This file contains histograms of how long the web server takes to
+ *  answer each route.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include "route_stats.h"
+
+/// Names of the routes, in the order they were added
+static const char* route_names[STATS_MAX_ROUTES];
+
+/// Times of each route
+static LatencyHistogram route_times[STATS_MAX_ROUTES];
+
+/// Number of routes added
+static uint8_t num_routes = 0;
+
+
+/** @brief   Create an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram (void)
+{
+    reset ();
+}
+
+
+/** @brief   Find the bucket a time belongs in.
+ *  @details Times below @c STATS_EXACT_US are their own bucket. Above that
+ *           the bucket is given by the position of the leading one and the
+ *           @c STATS_SUB_BITS bits below it.
+ *  @param   time_us The time in microseconds
+ *  @returns The bucket's index
+ */
+uint16_t LatencyHistogram::bucket_of (uint32_t time_us)
+{
+    if (time_us < STATS_EXACT_US)
+    {
+        return time_us;
+    }
+    if (time_us > STATS_MAX_US)
+    {
+        return STATS_BUCKETS - 1;
+    }
+    uint8_t top = 31 - __builtin_clz (time_us);
+    uint8_t shift = top - STATS_SUB_BITS;
+    uint32_t sub = (time_us >> shift) & ((1 << STATS_SUB_BITS) - 1);
+    return STATS_EXACT_US + (shift - 1) * (1 << STATS_SUB_BITS) + sub;
+}
+
+
+/** @brief   Find the longest time which goes in a bucket.
+ *  @param   bucket The bucket's index
+ *  @returns The time in microseconds
+ */
+uint32_t LatencyHistogram::bucket_top (uint16_t bucket)
+{
+    if (bucket < STATS_EXACT_US)
+    {
+        return bucket;
+    }
+    uint16_t above = bucket - STATS_EXACT_US;
+    uint8_t shift = above / (1 << STATS_SUB_BITS) + 1;
+    uint32_t sub = above % (1 << STATS_SUB_BITS);
+    uint32_t first = ((1UL << STATS_SUB_BITS) + sub) << shift;
+    return first + (1UL << shift) - 1;
+}
+
+
+/** @brief   Count one time.
+ *  @param   time_us The time in microseconds
+ */
+void LatencyHistogram::record (uint32_t time_us)
+{
+    counts[bucket_of (time_us)]++;
+    total++;
+    sum_us += time_us;
+    if (time_us < min_us)
+    {
+        min_us = time_us;
+    }
+    if (time_us > max_us)
+    {
+        max_us = time_us;
+    }
+}
+
+
+/** @brief   Forget every time counted.
+ */
+void LatencyHistogram::reset (void)
+{
+    memset (counts, 0, sizeof (counts));
+    total = 0;
+    sum_us = 0;
+    min_us = 0xFFFFFFFF;
+    max_us = 0;
+}
+
+
+/** @brief   Find the time which a given share of the times were no longer
+ *           than.
+ *  @param   percent The share, from 0 to 100
+ *  @returns The top of the bucket holding that time, but no more than the
+ *           longest time counted, or zero if none have been
+ */
+uint32_t LatencyHistogram::percentile (float percent) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+    uint32_t wanted = (uint32_t)(percent / 100.0f * total + 0.5f);
+    wanted = (wanted < 1) ? 1 : (wanted > total) ? total : wanted;
+    uint32_t seen = 0;
+    for (uint16_t bucket = 0; bucket < STATS_BUCKETS; bucket++)
+    {
+        seen += counts[bucket];
+        if (seen >= wanted)
+        {
+            uint32_t top = bucket_top (bucket);
+            return (top < max_us) ? top : max_us;
+        }
+    }
+    return max_us;
+}
+
+
+/** @brief   Add a route whose times are kept.
+ *  @param   name The route's name, such as @c "/csv", which must last as
+ *           long as the program
+ *  @returns The route's index, or @c STATS_NO_ROUTE if there are already
+ *           @c STATS_MAX_ROUTES
+ */
+uint8_t stats_route (const char* name)
+{
+    if (num_routes == STATS_MAX_ROUTES)
+    {
+        return STATS_NO_ROUTE;
+    }
+    route_names[num_routes] = name;
+    return num_routes++;
+}
+
+
+/** @brief   Get the name a route was added with.
+ *  @param   route The route's index from @c stats_route()
+ *  @returns The name, or @c "(unknown)" if there's no such route
+ */
+const char* stats_route_name (uint8_t route)
+{
+    return (route < num_routes) ? route_names[route] : "(unknown)";
+}
+
+
+/** @brief   Count the time one request for a route took.
+ *  @param   route The route's index from @c stats_route()
+ *  @param   time_us The time in microseconds
+ */
+void stats_record (uint8_t route, uint32_t time_us)
+{
+    if (route < num_routes)
+    {
+        route_times[route].record (time_us);
+    }
+}
+
+
+/** @brief   Forget every time counted for every route.
+ */
+void stats_reset (void)
+{
+    for (uint8_t route = 0; route < num_routes; route++)
+    {
+        route_times[route].reset ();
+    }
+}
+
+
+/** @brief   Write every route's times as JSON.
+ *  @details A @c routes array is written into the object the caller has
+ *           begun, with the count, mean, shortest, longest and percentiles
+ *           of each route in microseconds. Routes not yet asked for are
+ *           left out.
+ *  @param   json The writer, inside an object
+ *  @param   buckets Whether to add each route's non-empty buckets as pairs
+ *           of [top_us, count], so that histograms can be merged
+ */
+void stats_write_json (JsonWriter& json, bool buckets)
+{
+    json.begin_array ("routes");
+    for (uint8_t route = 0; route < num_routes; route++)
+    {
+        const LatencyHistogram& times = route_times[route];
+        if (times.count () == 0)
+        {
+            continue;
+        }
+        json.begin_object ();
+        json.member_string ("route", route_names[route]);
+        json.member_uint ("count", times.count ());
+        json.member_uint ("mean_us", times.mean ());
+        json.member_uint ("min_us", times.shortest ());
+        json.member_uint ("p50_us", times.percentile (50));
+        json.member_uint ("p90_us", times.percentile (90));
+        json.member_uint ("p99_us", times.percentile (99));
+        json.member_uint ("p999_us", times.percentile (99.9f));
+        json.member_uint ("max_us", times.longest ());
+        if (buckets)
+        {
+            json.begin_array ("buckets");
+            for (uint16_t bucket = 0; bucket < STATS_BUCKETS; bucket++)
+            {
+                if (times.bucket_count (bucket))
+                {
+                    json.begin_array ();
+                    json.value_uint (LatencyHistogram::bucket_top (bucket));
+                    json.value_uint (times.bucket_count (bucket));
+                    json.end_array ();
+                }
+            }
+            json.end_array ();
+        }
+        json.end_object ();
+    }
+    json.end_array ();
+}
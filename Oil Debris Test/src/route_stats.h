@@ -0,0 +1,103 @@
+/** @file route_stats.h
+ *  This file contains histograms of how long the web server takes to
+ *  answer each route, which are sent as JSON by @c /stats. The buckets are
+ *  laid out as in an HDR histogram: exact up to 16 microseconds, then eight
+ *  buckets for each power of two, so every time is kept to within 1/8 of
+ *  itself from microseconds up to @c STATS_MAX_US, in under a kilobyte per
+ *  route.
+ *
+ *  The histograms are only touched by the task which runs the web server,
+ *  as the handlers and @c /stats all run there, so there are no locks.
+ *  Nothing here touches hardware, so the host benchmark's server uses the
+ *  same code.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _ROUTE_STATS_H_
+#define _ROUTE_STATS_H_
+
+#include <stdint.h>
+#include "json_writer.h"
+
+/// Bits of each time kept below its leading one; 8 buckets per octave
+const uint8_t STATS_SUB_BITS = 3;
+
+/// Longest time told apart, as a power of two microseconds (16.7 s);
+/// longer times go in the last bucket
+const uint8_t STATS_MAX_BITS = 24;
+
+/// Times up to this many microseconds each have a bucket of their own
+const uint32_t STATS_EXACT_US = 2 << STATS_SUB_BITS;
+
+/// Number of buckets in each histogram
+const uint16_t STATS_BUCKETS = STATS_EXACT_US
+    + (STATS_MAX_BITS - STATS_SUB_BITS - 1) * (1 << STATS_SUB_BITS);
+
+/// The longest time a bucket of its own is kept for
+const uint32_t STATS_MAX_US = (1UL << STATS_MAX_BITS) - 1;
+
+/// The most routes whose times are kept
+const uint8_t STATS_MAX_ROUTES = 16;
+
+/// Index returned for a route which couldn't be added
+const uint8_t STATS_NO_ROUTE = 0xFF;
+
+
+/** @brief   Class which counts times in buckets of nearly equal relative
+ *           width, so that percentiles can be found to within 1/8.
+ */
+class LatencyHistogram
+{
+protected:
+    uint32_t counts[STATS_BUCKETS];     ///< Times in each bucket
+    uint32_t total;                     ///< Times counted
+    uint64_t sum_us;                    ///< Sum of the times
+    uint32_t min_us;                    ///< Shortest time
+    uint32_t max_us;                    ///< Longest time
+
+public:
+    LatencyHistogram (void);
+
+    void record (uint32_t time_us);
+    void reset (void);
+    uint32_t percentile (float percent) const;
+
+    /// Get the number of times counted
+    uint32_t count (void) const { return total; }
+
+    /// Get the mean time in microseconds
+    uint32_t mean (void) const { return total ? sum_us / total : 0; }
+
+    /// Get the shortest time in microseconds
+    uint32_t shortest (void) const { return total ? min_us : 0; }
+
+    /// Get the longest time in microseconds
+    uint32_t longest (void) const { return max_us; }
+
+    /// Get the number of times in one bucket
+    uint32_t bucket_count (uint16_t bucket) const { return counts[bucket]; }
+
+    static uint16_t bucket_of (uint32_t time_us);
+    static uint32_t bucket_top (uint16_t bucket);
+};
+
+
+// Add a route whose times are kept, returning its index
+uint8_t stats_route (const char* name);
+
+// Get the name a route was added with
+const char* stats_route_name (uint8_t route);
+
+// Count the time one request for a route took
+void stats_record (uint8_t route, uint32_t time_us);
+
+// Forget every time counted
+void stats_reset (void);
+
+// Write every route's times as JSON members
+void stats_write_json (JsonWriter& json, bool buckets);
+
+#endif // _ROUTE_STATS_H_
@@ -0,0 +1,311 @@
+/** @file sample_codec.cpp
+ *  This file contains the delta, zigzag varint and bit-packing block codec
+ *  for 12-bit ADC samples. Neighboring readings from the wear sensors differ
+ *  by only a few counts, so most deltas fit in one byte or a few bits.
+ *
+ *  The code uses no Arduino or FreeRTOS calls so that it can also be built
+ *  on a PC to decode logs and data downloaded from the tester.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "sample_codec.h"
+
+
+/** @brief   Map a signed delta onto an unsigned number so that small negative
+ *           and small positive deltas both become small numbers.
+ *  @param   delta The difference between two consecutive samples
+ *  @returns The zigzag-coded delta
+ */
+static inline uint16_t zigzag_encode (int16_t delta)
+{
+    return (uint16_t)((delta << 1) ^ (delta >> 15));
+}
+
+
+/** @brief   Undo the zigzag mapping done by @c zigzag_encode().
+ *  @param   value The zigzag-coded delta
+ *  @returns The signed delta
+ */
+static inline int16_t zigzag_decode (uint16_t value)
+{
+    return (int16_t)((value >> 1) ^ (uint16_t)(-(int16_t)(value & 1)));
+}
+
+
+/** @brief   Find the number of bytes a value takes as a LEB128 varint.
+ *  @param   value The value to be encoded
+ *  @returns The number of bytes, from 1 to 3
+ */
+static inline size_t varint_size (uint16_t value)
+{
+    return (value < 0x80) ? 1 : ((value < 0x4000) ? 2 : 3);
+}
+
+
+/** @brief   Find the number of bits needed to hold a value.
+ *  @param   value The value to be held
+ *  @returns The number of significant bits in @c value, zero for zero
+ */
+static inline uint8_t bit_width (uint16_t value)
+{
+    uint8_t bits = 0;
+    while (value)
+    {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+}
+
+
+/** @brief   Store a 16-bit number in little-endian order.
+ */
+static inline void put_u16 (uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+
+/** @brief   Store a 32-bit number in little-endian order.
+ */
+static inline void put_u32 (uint8_t* p, uint32_t value)
+{
+    put_u16 (p, (uint16_t)value);
+    put_u16 (p + 2, (uint16_t)(value >> 16));
+}
+
+
+/** @brief   Read a little-endian 16-bit number.
+ */
+static inline uint16_t get_u16 (const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+/** @brief   Read a little-endian 32-bit number.
+ */
+static inline uint32_t get_u32 (const uint8_t* p)
+{
+    return (uint32_t)get_u16 (p) | ((uint32_t)get_u16 (p + 2) << 16);
+}
+
+
+/** @brief   Find the largest number of bytes a block of samples can need.
+ *  @details Buffers of this size can always hold an encoded block, since the
+ *           bit-packed form never needs more than 13 bits per delta.
+ *  @param   count The number of samples in the block
+ *  @returns The size in bytes of the worst-case encoded block
+ */
+size_t codec_max_encoded_size (uint16_t count)
+{
+    size_t deltas = (count > 0) ? count - 1 : 0;
+    return CODEC_HEADER_SIZE + (deltas * 13 + 7) / 8;
+}
+
+
+/** @brief   Encode a block of samples from one channel.
+ *  @details Both payload forms are sized first and the smaller one is written.
+ *           Samples are expected to be 12-bit ADC counts, though any value
+ *           which fits in 16 bits with deltas of less than 2^15 will work.
+ *  @param   samples Pointer to the samples to be encoded
+ *  @param   count The number of samples, at least one
+ *  @param   channel The number of the sensor channel the samples came from
+ *  @param   timestamp The time at which the first sample was taken in ms
+ *  @param   out Pointer to a buffer into which the block is written
+ *  @param   out_size The size of the buffer in bytes
+ *  @returns The number of bytes written, or zero if the buffer is too small
+ *           or there were no samples
+ */
+size_t codec_encode_block (const uint16_t* samples, uint16_t count,
+                           uint8_t channel, uint32_t timestamp,
+                           uint8_t* out, size_t out_size)
+{
+    if (count == 0 || out_size < CODEC_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    // Size both representations of the deltas so the smaller can be chosen
+    size_t varint_bytes = 0;
+    uint16_t largest = 0;
+    for (uint16_t index = 1; index < count; index++)
+    {
+        uint16_t zz = zigzag_encode ((int16_t)(samples[index]
+                                               - samples[index - 1]));
+        varint_bytes += varint_size (zz);
+        if (zz > largest)
+        {
+            largest = zz;
+        }
+    }
+    uint8_t width = bit_width (largest);
+    size_t packed_bytes = ((size_t)(count - 1) * width + 7) / 8;
+
+    codec_mode_t mode = (packed_bytes <= varint_bytes) ? CODEC_BITPACK
+                                                       : CODEC_VARINT;
+    size_t payload = (mode == CODEC_BITPACK) ? packed_bytes : varint_bytes;
+    if (payload > 0xFFFF || CODEC_HEADER_SIZE + payload > out_size)
+    {
+        return 0;
+    }
+
+    // Write the header
+    out[0] = CODEC_MAGIC;
+    out[1] = mode;
+    out[2] = channel;
+    out[3] = (mode == CODEC_BITPACK) ? width : 0;
+    put_u16 (out + 4, count);
+    put_u16 (out + 6, samples[0]);
+    put_u32 (out + 8, timestamp);
+    put_u16 (out + 12, (uint16_t)payload);
+
+    // Then the deltas in whichever form was chosen
+    uint8_t* p = out + CODEC_HEADER_SIZE;
+    if (mode == CODEC_VARINT)
+    {
+        for (uint16_t index = 1; index < count; index++)
+        {
+            uint16_t zz = zigzag_encode ((int16_t)(samples[index]
+                                                   - samples[index - 1]));
+            while (zz >= 0x80)
+            {
+                *p++ = (uint8_t)(zz | 0x80);
+                zz >>= 7;
+            }
+            *p++ = (uint8_t)zz;
+        }
+    }
+    else
+    {
+        uint32_t bits = 0;
+        uint8_t held = 0;
+        for (uint16_t index = 1; index < count; index++)
+        {
+            uint16_t zz = zigzag_encode ((int16_t)(samples[index]
+                                                   - samples[index - 1]));
+            bits |= (uint32_t)zz << held;
+            held += width;
+            while (held >= 8)
+            {
+                *p++ = (uint8_t)bits;
+                bits >>= 8;
+                held -= 8;
+            }
+        }
+        if (held)
+        {
+            *p++ = (uint8_t)bits;
+        }
+    }
+
+    return CODEC_HEADER_SIZE + payload;
+}
+
+
+/** @brief   Read and check the header of an encoded block.
+ *  @param   in Pointer to the start of the encoded block
+ *  @param   in_size The number of bytes available at @c in
+ *  @param   info A structure into which the header fields are put
+ *  @returns @c true if a complete, sensible block is present
+ */
+bool codec_read_header (const uint8_t* in, size_t in_size,
+                        codec_block_info_t& info)
+{
+    if (in_size < CODEC_HEADER_SIZE || in[0] != CODEC_MAGIC)
+    {
+        return false;
+    }
+    info.mode = (codec_mode_t)in[1];
+    info.channel = in[2];
+    info.bit_width = in[3];
+    info.count = get_u16 (in + 4);
+    info.base = get_u16 (in + 6);
+    info.timestamp = get_u32 (in + 8);
+    info.payload_len = get_u16 (in + 12);
+
+    if ((info.mode != CODEC_VARINT && info.mode != CODEC_BITPACK)
+        || info.count == 0 || info.bit_width > 16
+        || CODEC_HEADER_SIZE + info.payload_len > in_size)
+    {
+        return false;
+    }
+    return true;
+}
+
+
+/** @brief   Decode a block of samples which was made by
+ *           @c codec_encode_block().
+ *  @param   in Pointer to the start of the encoded block
+ *  @param   in_size The number of bytes available at @c in
+ *  @param   info A structure into which the header fields are put
+ *  @param   samples Pointer to an array into which samples are written
+ *  @param   max_samples The size of the @c samples array
+ *  @returns The number of bytes the block occupied, or zero if the block is
+ *           damaged or has more samples than will fit in the array
+ */
+size_t codec_decode_block (const uint8_t* in, size_t in_size,
+                           codec_block_info_t& info,
+                           uint16_t* samples, uint16_t max_samples)
+{
+    if (!codec_read_header (in, in_size, info) || info.count > max_samples)
+    {
+        return 0;
+    }
+
+    const uint8_t* p = in + CODEC_HEADER_SIZE;
+    const uint8_t* end = p + info.payload_len;
+    uint16_t value = info.base;
+    samples[0] = value;
+
+    if (info.mode == CODEC_VARINT)
+    {
+        for (uint16_t index = 1; index < info.count; index++)
+        {
+            uint16_t zz = 0;
+            uint8_t shift = 0;
+            uint8_t byte;
+            do
+            {
+                if (p >= end || shift > 14)
+                {
+                    return 0;
+                }
+                byte = *p++;
+                zz |= (uint16_t)(byte & 0x7F) << shift;
+                shift += 7;
+            }
+            while (byte & 0x80);
+            value += zigzag_decode (zz);
+            samples[index] = value;
+        }
+    }
+    else
+    {
+        uint32_t bits = 0;
+        uint8_t held = 0;
+        uint16_t mask = (uint16_t)((1UL << info.bit_width) - 1);
+        for (uint16_t index = 1; index < info.count; index++)
+        {
+            while (held < info.bit_width)
+            {
+                if (p >= end)
+                {
+                    return 0;
+                }
+                bits |= (uint32_t)*p++ << held;
+                held += 8;
+            }
+            value += zigzag_decode ((uint16_t)(bits & mask));
+            bits >>= info.bit_width;
+            held -= info.bit_width;
+            samples[index] = value;
+        }
+    }
+
+    return CODEC_HEADER_SIZE + info.payload_len;
+}
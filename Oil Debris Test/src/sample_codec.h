@@ -0,0 +1,68 @@
+/** @file sample_codec.h
+ *  This file contains a compact block codec for 12-bit ADC samples. A block
+ *  holds consecutive readings from one channel; they are stored as deltas
+ *  from the previous reading, and the deltas are either zigzag varint coded
+ *  or bit-packed at a fixed width, whichever is smaller for that block.
+ *
+ *  Each encoded block starts with a small header carrying the base value and
+ *  a timestamp, so a block is self-describing and can be appended to a log
+ *  file or sent over the network as-is.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SAMPLE_CODEC_H_
+#define _SAMPLE_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Marker byte at the start of every encoded block
+const uint8_t CODEC_MAGIC = 0xDB;
+
+/// Number of bytes in a serialized block header
+const size_t CODEC_HEADER_SIZE = 14;
+
+/// Ways in which the deltas of a block may be stored
+enum codec_mode_t : uint8_t
+{
+    CODEC_VARINT = 1,     ///< Zigzag-coded deltas as LEB128 varints
+    CODEC_BITPACK = 2     ///< Zigzag-coded deltas packed at a fixed width
+};
+
+/** @brief   Description of one encoded block, as read from its header.
+ *  @details In the serialized form all multi-byte fields are little-endian:
+ *           magic (1), mode (1), channel (1), bit width (1), count (2),
+ *           base (2), timestamp (4), payload length (2).
+ */
+struct codec_block_info_t
+{
+    codec_mode_t mode;        ///< How the deltas are stored
+    uint8_t channel;          ///< Which sensor channel the samples came from
+    uint8_t bit_width;        ///< Bits per delta in bit-packed mode
+    uint16_t count;           ///< Number of samples in the block
+    uint16_t base;            ///< Value of the first sample
+    uint32_t timestamp;       ///< Time of the first sample in milliseconds
+    uint16_t payload_len;     ///< Number of bytes following the header
+};
+
+// Worst-case number of bytes needed to encode a block of the given size
+size_t codec_max_encoded_size (uint16_t count);
+
+// Encode a block of samples from one channel into a byte buffer
+size_t codec_encode_block (const uint16_t* samples, uint16_t count,
+                           uint8_t channel, uint32_t timestamp,
+                           uint8_t* out, size_t out_size);
+
+// Read the header of an encoded block without decoding its samples
+bool codec_read_header (const uint8_t* in, size_t in_size,
+                        codec_block_info_t& info);
+
+// Decode a block of samples, returning the number of bytes consumed
+size_t codec_decode_block (const uint8_t* in, size_t in_size,
+                           codec_block_info_t& info,
+                           uint16_t* samples, uint16_t max_samples);
+
+#endif // _SAMPLE_CODEC_H_
@@ -0,0 +1,595 @@
+/** @file sample_log.cpp
+ *  This file contains a log of compressed sample blocks and debris events
+ *  kept in a LittleFS file. Each is appended whole as a record with a
+ *  sequence number, so the file is simply a run of self-describing records.
+ *  When the file reaches @c SAMPLE_LOG_MAX_BYTES it replaces the previous
+ *  old file, which bounds the flash used to twice that size.
+ *
+ *  Readers see the old file followed by the current one as a single run of
+ *  bytes. Moving the current file aside changes where everything is in that
+ *  run, so each move bumps a generation number, kept in flash, which
+ *  downloads use to tell whether an offset they saved still means the same
+ *  thing. The next sequence number is saved alongside it, and the files are
+ *  scanned at startup, so sequence numbers never repeat after a restart.
+ *
+ *  Opening a file takes memory from the heap, which the processing task
+ *  mustn't use once the program is running; see @c mem_pool.h. The current
+ *  file is therefore opened when the log is mounted and kept open, and is
+ *  only opened again, with the heap guard's leave, when it's moved aside.
+ *  If it can't be opened, the log is marked unavailable and records are
+ *  refused until it is mounted again, rather than trying to open the file
+ *  for every record.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "sample_log.h"
+#include "mem_pool.h"
+
+/// Number of places in the log remembered from recent calls to
+/// @c sample_log_find(), so polling clients needn't scan from the start
+const uint8_t SYNC_HINTS = 4;
+
+/// A sequence number and the offset of the record which follows it
+struct sync_hint_t
+{
+    uint32_t generation;      ///< Log generation the offset belongs to
+    uint32_t seq;             ///< Sequence number of a record
+    size_t offset;            ///< Offset just past that record
+};
+
+/// What is kept in the generation file
+struct log_gen_t
+{
+    uint32_t generation;      ///< Number of times the log was moved aside
+    uint32_t next_seq;        ///< Next sequence number when it last moved
+};
+
+/// Mutex which keeps readers from seeing a half-written record
+static SemaphoreHandle_t log_mutex = NULL;
+
+/// Number of bytes in the current log file
+static size_t log_size = 0;
+
+/// Number of bytes of good records in the old log file
+static size_t old_size = 0;
+
+/// Number of times the log file has been moved aside
+static uint32_t log_generation = 0;
+
+/// Sequence number the next record will get; zero is never used
+static uint32_t next_seq = 1;
+
+/// Sequence number the first record written since mounting got
+static uint32_t mount_seq = 1;
+
+/// Sequence number of the first record in the current file
+static uint32_t log_first_seq = 1;
+
+/// Sequence number of the first record in the old file
+static uint32_t old_first_seq = 1;
+
+/// The current log file, kept open for adding records
+static File log_file;
+
+/// Set once the file system has been mounted and the log file opened;
+/// cleared if the file can't be opened again when it's moved aside
+static volatile bool log_ready = false;
+
+/// Set when a record couldn't be written whole, so that the next record
+/// starts a new file rather than following a damaged one
+static bool log_damaged = false;
+
+/// Places found by recent calls to @c sample_log_find()
+static sync_hint_t hints[SYNC_HINTS];
+
+/// Which hint is to be replaced next
+static uint8_t next_hint = 0;
+
+
+/** @brief   Find the size of a file, or zero if it doesn't exist.
+ */
+static size_t file_size (const char* name)
+{
+    size_t size = 0;
+    File file = LittleFS.open (name, "r");
+    if (file)
+    {
+        size = file.size ();
+        file.close ();
+    }
+    return size;
+}
+
+
+/** @brief   Read bytes from part of a file.
+ *  @returns The number of bytes read
+ */
+static size_t read_file (const char* name, size_t offset, uint8_t* buffer,
+                         size_t length)
+{
+    size_t count = 0;
+    File file = LittleFS.open (name, "r");
+    if (file)
+    {
+        if (file.seek (offset))
+        {
+            count = file.read (buffer, length);
+        }
+        file.close ();
+    }
+    return count;
+}
+
+
+/** @brief   Read and check the header of the record at an offset in a file.
+ *  @param   file The open log file
+ *  @param   offset Where the record starts in the file
+ *  @param   size The number of bytes in the file
+ *  @param   seq Set to the record's sequence number
+ *  @returns The size of the whole record, or zero if there isn't a whole,
+ *           sensible record there
+ */
+static size_t read_record (File& file, size_t offset, size_t size,
+                           uint32_t& seq)
+{
+    uint8_t header[LOG_RECORD_HEADER_SIZE];
+    if (offset + LOG_RECORD_HEADER_SIZE > size || !file.seek (offset)
+        || file.read (header, LOG_RECORD_HEADER_SIZE)
+           != LOG_RECORD_HEADER_SIZE
+        || header[0] != LOG_RECORD_MAGIC)
+    {
+        return 0;
+    }
+    size_t length = LOG_RECORD_HEADER_SIZE + (header[2] | (header[3] << 8));
+    seq = (uint32_t)header[4] | ((uint32_t)header[5] << 8)
+          | ((uint32_t)header[6] << 16) | ((uint32_t)header[7] << 24);
+
+    return (offset + length <= size) ? length : 0;
+}
+
+
+/** @brief   Walk through the records in a file.
+ *  @param   name The name of the file
+ *  @param   first_seq Set to the sequence number of the first record
+ *  @param   last_seq Set to the sequence number of the last record
+ *  @param   good_size Set to the number of bytes of whole records at the
+ *           start of the file; anything after them is damaged or is from
+ *           before the log held records
+ *  @returns @c true if the file holds at least one record
+ */
+static bool scan_file (const char* name, uint32_t& first_seq,
+                       uint32_t& last_seq, size_t& good_size)
+{
+    good_size = 0;
+    File file = LittleFS.open (name, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    size_t size = file.size ();
+    uint32_t seq;
+    size_t length;
+    while ((length = read_record (file, good_size, size, seq)) > 0)
+    {
+        if (good_size == 0)
+        {
+            first_seq = seq;
+        }
+        last_seq = seq;
+        good_size += length;
+    }
+    file.close ();
+
+    return good_size > 0;
+}
+
+
+/** @brief   Save the generation and next sequence number in flash.
+ */
+static void save_generation (void)
+{
+    log_gen_t saved = { log_generation, next_seq };
+    File file = LittleFS.open (SAMPLE_LOG_GEN_FILE, "w");
+    if (file)
+    {
+        file.write ((const uint8_t*)&saved, sizeof (saved));
+        file.close ();
+    }
+}
+
+
+/** @brief   Move the current log file aside and start a new one.
+ *  @details The new generation is saved first; if power fails before the
+ *           files are moved, downloads merely start over when not needed.
+ *           The new file is left open for adding records. The caller must
+ *           hold the log mutex, or be the only task.
+ */
+static void rotate (void)
+{
+    log_generation++;
+    save_generation ();
+
+    log_file.close ();
+    LittleFS.remove (SAMPLE_LOG_OLD_FILE);
+    LittleFS.rename (SAMPLE_LOG_FILE, SAMPLE_LOG_OLD_FILE);
+    log_file = LittleFS.open (SAMPLE_LOG_FILE, "a");
+    old_size = log_size;
+    old_first_seq = log_first_seq;
+    log_size = 0;
+    log_first_seq = next_seq;
+    log_damaged = false;
+}
+
+
+/** @brief   Mount the file system and read where the log stands; the
+ *           caller holds the mutex.
+ *  @returns @c true if the file system is ready and the log file is open
+ */
+static bool mount (void)
+{
+    // A second mount starts afresh, as a restart would
+    log_file.close ();
+    memset (hints, 0, sizeof (hints));
+    if (!LittleFS.begin (true))
+    {
+        return false;
+    }
+
+    log_gen_t saved = { 0, 1 };
+    File file = LittleFS.open (SAMPLE_LOG_GEN_FILE, "r");
+    if (file)
+    {
+        file.read ((uint8_t*)&saved, sizeof (saved));
+        file.close ();
+    }
+    log_generation = saved.generation;
+    next_seq = (saved.next_seq > 0) ? saved.next_seq : 1;
+
+    uint32_t first_seq;
+    uint32_t last_seq;
+    bool old_records = scan_file (SAMPLE_LOG_OLD_FILE, first_seq, last_seq,
+                                  old_size);
+    if (old_records)
+    {
+        old_first_seq = first_seq;
+        if (last_seq >= next_seq)
+        {
+            next_seq = last_seq + 1;
+        }
+    }
+
+    log_size = file_size (SAMPLE_LOG_FILE);
+    size_t good_size;
+    log_first_seq = next_seq;
+    if (scan_file (SAMPLE_LOG_FILE, first_seq, last_seq, good_size))
+    {
+        log_first_seq = first_seq;
+        if (last_seq >= next_seq)
+        {
+            next_seq = last_seq + 1;
+        }
+    }
+    if (!old_records)
+    {
+        old_first_seq = log_first_seq;
+    }
+
+    if (good_size < log_size)
+    {
+        log_size = good_size;
+        rotate ();
+    }
+    else
+    {
+        log_file = LittleFS.open (SAMPLE_LOG_FILE, "a");
+    }
+    return (bool)log_file;
+}
+
+
+/** @brief   Create the mutex which protects the log.
+ *  @details This is quick, so it can be done before any task starts; the
+ *           slow part is left to @c sample_log_mount().
+ */
+void sample_log_init (void)
+{
+    log_mutex = xSemaphoreCreateMutex ();
+}
+
+
+/** @brief   Mount the flash file system and find where the log stands.
+ *  @details The file system is formatted if it can't be mounted, as happens
+ *           the first time the program runs on a new board. Both files are
+ *           scanned to find the sequence numbers they hold. If the current
+ *           file ends with something other than whole records, it is moved
+ *           aside so that new records don't follow the damage.
+ *
+ *           This can take from tens of milliseconds to a few seconds, so it
+ *           is done by the task which writes the log rather than at startup.
+ *           The mutex is held throughout, so readers wait until it's done.
+ *           Mounting uses the heap, which the heap guard allows here even
+ *           if the task is watched and setup has finished meanwhile.
+ *  @returns @c true if the file system is ready and the log file is open
+ */
+bool sample_log_mount (void)
+{
+    xSemaphoreTake (log_mutex, portMAX_DELAY);
+    heap_guard_allow (true);
+    bool mounted = mount ();
+    heap_guard_allow (false);
+    mount_seq = next_seq;
+    log_ready = mounted;
+    xSemaphoreGive (log_mutex);
+    return mounted;
+}
+
+
+/** @brief   Find out whether the log has been mounted and can be used.
+ *  @returns @c true once @c sample_log_mount() has succeeded, unless the
+ *           log file couldn't be opened again since
+ */
+bool sample_log_ready (void)
+{
+    return log_ready;
+}
+
+
+/** @brief   Add a record to the end of the log.
+ *  @details The record is written to the open file and then flushed;
+ *           LittleFS makes everything written since the last flush part of
+ *           the file at once, so a record is either all there or not there
+ *           at all. Nothing here uses the heap unless the file has to be
+ *           moved aside. If the log isn't available, because it hasn't been
+ *           mounted or its file couldn't be opened, the record is refused
+ *           at once without touching the file system.
+ *  @param   kind What the record holds
+ *  @param   data Pointer to the record's contents
+ *  @param   length The number of bytes of contents
+ *  @returns @c true if the whole record was written
+ */
+bool sample_log_append (log_record_kind_t kind, const uint8_t* data,
+                        size_t length)
+{
+    bool ok = false;
+    size_t record = LOG_RECORD_HEADER_SIZE + length;
+    if (length > 0xFFFF)
+    {
+        return false;
+    }
+
+    xSemaphoreTake (log_mutex, portMAX_DELAY);
+    if (log_ready
+        && (log_size + record > SAMPLE_LOG_MAX_BYTES || log_damaged))
+    {
+        heap_guard_allow (true);
+        rotate ();
+        heap_guard_allow (false);
+        log_ready = (bool)log_file;
+    }
+
+    uint8_t header[LOG_RECORD_HEADER_SIZE] =
+    {
+        LOG_RECORD_MAGIC, kind, (uint8_t)length, (uint8_t)(length >> 8),
+        (uint8_t)next_seq, (uint8_t)(next_seq >> 8),
+        (uint8_t)(next_seq >> 16), (uint8_t)(next_seq >> 24)
+    };
+    if (log_ready)
+    {
+        ok = (log_file.write (header, LOG_RECORD_HEADER_SIZE)
+              == LOG_RECORD_HEADER_SIZE)
+             && (log_file.write (data, length) == length);
+        log_file.flush ();
+        size_t size = log_file.size ();
+
+        if (ok)
+        {
+            log_size = size;
+            next_seq++;
+        }
+        else
+        {
+            log_damaged = (size != log_size);
+        }
+    }
+    xSemaphoreGive (log_mutex);
+
+    return ok;
+}
+
+
+/** @brief   Get the number of bytes in the current log file.
+ */
+size_t sample_log_size (void)
+{
+    return log_size;
+}
+
+
+/** @brief   Get the number of bytes in the old and current log files together.
+ */
+size_t sample_log_total (void)
+{
+    xSemaphoreTake (log_mutex, portMAX_DELAY);
+    size_t total = old_size + log_size;
+    xSemaphoreGive (log_mutex);
+
+    return total;
+}
+
+
+/** @brief   Get the number which changes each time the log file is moved
+ *           aside, so that byte offsets into the log are no longer valid.
+ */
+uint32_t sample_log_generation (void)
+{
+    return log_generation;
+}
+
+
+/** @brief   Get the sequence number the next record will get.
+ */
+uint32_t sample_log_next_seq (void)
+{
+    return next_seq;
+}
+
+
+/** @brief   Get the sequence number of the first record written since the
+ *           log was mounted, that is, since the program started.
+ */
+uint32_t sample_log_mount_seq (void)
+{
+    return mount_seq;
+}
+
+
+/** @brief   Read bytes from the log, with the old file coming first.
+ *  @details Reading stops if the log has been moved aside since the caller
+ *           got @c generation, since the bytes at @c offset are then
+ *           different ones.
+ *  @param   offset Where to start reading, counting from the start of the
+ *           old file
+ *  @param   buffer Where the bytes go
+ *  @param   length The most bytes to read
+ *  @param   generation The value from @c sample_log_generation() which the
+ *           caller's offsets are based on
+ *  @returns The number of bytes read, which is zero at the end of the log
+ *           or if the generation has changed
+ */
+size_t sample_log_read (size_t offset, uint8_t* buffer, size_t length,
+                        uint32_t generation)
+{
+    size_t count = 0;
+
+    xSemaphoreTake (log_mutex, portMAX_DELAY);
+    if (generation == log_generation)
+    {
+        if (offset < old_size)
+        {
+            size_t part = old_size - offset;
+            count = read_file (SAMPLE_LOG_OLD_FILE, offset, buffer,
+                               (length < part) ? length : part);
+        }
+        else if (offset < old_size + log_size)
+        {
+            size_t part = old_size + log_size - offset;
+            count = read_file (SAMPLE_LOG_FILE, offset - old_size, buffer,
+                               (length < part) ? length : part);
+        }
+    }
+    xSemaphoreGive (log_mutex);
+
+    return count;
+}
+
+
+/** @brief   Find the records which come after a given sequence number.
+ *  @details The search starts from the nearest known place at or before
+ *           the record wanted: the start of either file, the end of the
+ *           log, or where a recent search ended. A client which keeps
+ *           asking for what follows the last record it got therefore costs
+ *           only as much as the new records, however long the log is.
+ *
+ *           If @c after is older than the oldest record kept, the span
+ *           starts with the oldest record; the caller can tell that records
+ *           were lost because @c span.oldest_seq is above @c after + 1.
+ *  @param   after Sequence number of the last record the caller already
+ *           has, or zero for everything
+ *  @param   max The most records to put in the span
+ *  @param   span Set to where the records lie; read them with
+ *           @c sample_log_read() using @c span.generation
+ *  @returns @c true if there is at least one record in the span
+ */
+bool sample_log_find (uint32_t after, uint16_t max, log_span_t& span)
+{
+    xSemaphoreTake (log_mutex, portMAX_DELAY);
+    span.generation = log_generation;
+    span.oldest_seq = old_first_seq;
+    span.next_seq = next_seq;
+    span.count = 0;
+    span.last_seq = after;
+
+    // Choose the latest known place which isn't past the record wanted
+    uint32_t from_seq = old_first_seq - 1;
+    size_t offset = 0;
+    if (log_first_seq - 1 <= after)
+    {
+        from_seq = log_first_seq - 1;
+        offset = old_size;
+    }
+    for (uint8_t index = 0; index < SYNC_HINTS; index++)
+    {
+        if (hints[index].generation == log_generation
+            && hints[index].seq > from_seq && hints[index].seq <= after
+            && hints[index].offset <= old_size + log_size)
+        {
+            from_seq = hints[index].seq;
+            offset = hints[index].offset;
+        }
+    }
+    if (next_seq - 1 <= after)
+    {
+        offset = old_size + log_size;
+    }
+
+    // Walk forward from there, skipping records the caller already has
+    bool in_old = (offset < old_size);
+    File file = LittleFS.open (in_old ? SAMPLE_LOG_OLD_FILE
+                                      : SAMPLE_LOG_FILE, "r");
+    span.start = offset;
+    while (file && span.count < max)
+    {
+        if (in_old && offset >= old_size)
+        {
+            file.close ();
+            file = LittleFS.open (SAMPLE_LOG_FILE, "r");
+            in_old = false;
+            if (!file)
+            {
+                break;
+            }
+        }
+        size_t base = in_old ? 0 : old_size;
+        size_t size = in_old ? old_size : log_size;
+        uint32_t seq;
+        size_t length = read_record (file, offset - base, size, seq);
+        if (length == 0)
+        {
+            break;
+        }
+
+        if (seq <= after)
+        {
+            span.start = offset + length;
+        }
+        else
+        {
+            span.count++;
+            span.last_seq = seq;
+        }
+        offset += length;
+    }
+    if (file)
+    {
+        file.close ();
+    }
+    span.end = offset;
+
+    // Remember where this search ended for the caller's next request
+    if (span.count > 0)
+    {
+        hints[next_hint].generation = log_generation;
+        hints[next_hint].seq = span.last_seq;
+        hints[next_hint].offset = span.end;
+        next_hint = (next_hint + 1) % SYNC_HINTS;
+    }
+    xSemaphoreGive (log_mutex);
+
+    return span.count > 0;
+}
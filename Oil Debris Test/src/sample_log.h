@@ -0,0 +1,98 @@
+/** @file sample_log.h
+ *  This file contains the interface to the log of compressed sample blocks
+ *  and debris events which is kept in the ESP32's flash file system.
+ *
+ *  Everything in the log is kept as records, each of which starts with an
+ *  8-byte little-endian header: magic (1), kind (1), payload length (2) and
+ *  sequence number (4). Sequence numbers go up by one with every record and
+ *  carry on across restarts, so a client which remembers the last one it
+ *  saw can ask for only the records which came after it.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SAMPLE_LOG_H_
+#define _SAMPLE_LOG_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Name of the file which blocks are being added to
+#define SAMPLE_LOG_FILE "/samples.log"
+
+/// Name to which a full log file is moved when a new one is started
+#define SAMPLE_LOG_OLD_FILE "/samples.old"
+
+/// Name of the file which holds the log's generation and sequence numbers
+#define SAMPLE_LOG_GEN_FILE "/samples.gen"
+
+/// Marker byte at the start of every log record
+const uint8_t LOG_RECORD_MAGIC = 0xA5;
+
+/// Number of bytes in a record header
+const size_t LOG_RECORD_HEADER_SIZE = 8;
+
+/// Kinds of record kept in the log
+enum log_record_kind_t : uint8_t
+{
+    LOG_SAMPLES = 1,      ///< A codec block for each channel, in order
+    LOG_EVENT = 2,        ///< A debris event; see @c stage_detect()
+    LOG_TRUTH = 3,        ///< A simulated particle; see @c signal_gen.h
+    LOG_CHANNELS = 4      ///< The channels' names; see @c stage_store()
+};
+
+/** @brief   Where a run of consecutive records lies in the log, as found by
+ *           @c sample_log_find().
+ */
+struct log_span_t
+{
+    uint32_t generation;      ///< Log generation the offsets belong to
+    size_t start;             ///< Offset of the first record in the span
+    size_t end;               ///< Offset just past the last record
+    uint32_t last_seq;        ///< Sequence number of the last record
+    uint16_t count;           ///< Number of records in the span
+    uint32_t oldest_seq;      ///< Sequence number of the oldest record kept
+    uint32_t next_seq;        ///< Sequence number the next record will get
+};
+
+/// Size at which the log file is moved aside and a new one started
+const size_t SAMPLE_LOG_MAX_BYTES = 512 * 1024;
+
+// Create the mutex which protects the log
+void sample_log_init (void);
+
+// Mount the file system and find where the log stands
+bool sample_log_mount (void);
+
+// Find out whether the log has been mounted and can be used
+bool sample_log_ready (void);
+
+// Add a record to the end of the log
+bool sample_log_append (log_record_kind_t kind, const uint8_t* data,
+                        size_t length);
+
+// Get the number of bytes in the current log file
+size_t sample_log_size (void);
+
+// Get the number of bytes in the old and current log files together
+size_t sample_log_total (void);
+
+// Get the number which changes each time the log file is moved aside
+uint32_t sample_log_generation (void);
+
+// Read bytes from the old file followed by the current one
+size_t sample_log_read (size_t offset, uint8_t* buffer, size_t length,
+                        uint32_t generation);
+
+// Get the sequence number the next record will get
+uint32_t sample_log_next_seq (void);
+
+// Get the sequence number of the first record written since mounting
+uint32_t sample_log_mount_seq (void);
+
+// Find the records which come after a given sequence number
+bool sample_log_find (uint32_t after, uint16_t max, log_span_t& span);
+
+#endif // _SAMPLE_LOG_H_
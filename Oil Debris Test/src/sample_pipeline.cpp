@@ -0,0 +1,180 @@
+/** @file sample_pipeline.cpp
+ *  This file contains the double-buffered sample block pipeline. Each of the
+ *  two blocks goes from @c FREE to @c FILLING in the producer, then to
+ *  @c READY, then to @c PROCESSING in the consumer and back to @c FREE.
+ *  Both sides take the blocks in strict alternation, so blocks are processed
+ *  in the order they were filled.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "sample_pipeline.h"
+
+/// Value of @c filling when the producer has no block
+const uint8_t NO_BLOCK = 0xFF;
+
+
+/** @brief   Create a pipeline; this is done by @c StaticPipeline.
+ *  @param   block_size The number of samples per channel in a full block
+ *  @param   channels The number of readings in each sample
+ *  @param   storage Room for both blocks' readings, then both blocks'
+ *           times, each @c channels arrays of @c block_size
+ *  @param   chain The function which runs every stage on a block
+ *  @param   chain_context Pointer which is passed to @c chain
+ *  @param   num_stages The number of stages @c chain runs
+ */
+SamplePipeline::SamplePipeline (uint16_t block_size, uint8_t channels,
+                                uint16_t* storage, pipeline_stage_t chain,
+                                void* chain_context, uint8_t num_stages)
+    : filling (NO_BLOCK), next_fill (0), next_ready (0),
+      block_size (block_size), channels (channels), next_sequence (0),
+      offered (0), dropping (false), chain (chain),
+      chain_context (chain_context), num_stages (num_stages), samples_in (0),
+      samples_dropped (0), overflows (0), blocks_processed (0)
+{
+    size_t array_size = block_size;
+    for (uint8_t index = 0; index < 2; index++)
+    {
+        for (uint8_t channel = 0; channel < channels; channel++)
+        {
+            blocks[index].samples[channel] = storage
+                + (index * channels + channel) * array_size;
+            blocks[index].offsets[channel] = storage
+                + ((2 + index) * channels + channel) * array_size;
+        }
+        states[index] = FREE;
+    }
+}
+
+
+/** @brief   Put one reading from each channel into the block being filled.
+ *  @details This is called only from the acquisition task. When the block is
+ *           full it is handed to the processing side. If the next block is
+ *           still being processed, the reading is dropped and counted.
+ *  @param   time The time at which the readings were taken in milliseconds
+ *  @param   readings The channels' ADC readings, in channel order
+ *  @param   offsets When each reading was converted, in microseconds after
+ *           @c time, in channel order; @c NULL if they were all at once
+ *  @returns @c true if the readings were stored, @c false if dropped
+ */
+bool SamplePipeline::put (uint32_t time, const uint16_t* readings,
+                          const uint16_t* offsets)
+{
+    uint32_t sample_number = offered++;
+
+    if (filling == NO_BLOCK)
+    {
+        if (states[next_fill].load (std::memory_order_acquire) != FREE)
+        {
+            // Backpressure: processing hasn't finished with the next block
+            if (!dropping)
+            {
+                dropping = true;
+                overflows.fetch_add (1, std::memory_order_relaxed);
+            }
+            samples_dropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+        dropping = false;
+        filling = next_fill;
+        next_fill ^= 1;
+        states[filling].store (FILLING, std::memory_order_relaxed);
+
+        sample_block_t& block = blocks[filling];
+        block.sequence = next_sequence++;
+        block.first_sample = sample_number;
+        block.start_time = time;
+        block.count = 0;
+        block.channels = channels;
+    }
+
+    sample_block_t& block = blocks[filling];
+    for (uint8_t channel = 0; channel < channels; channel++)
+    {
+        block.samples[channel][block.count] = readings[channel];
+        block.offsets[channel][block.count] = offsets ? offsets[channel] : 0;
+    }
+    block.count++;
+    samples_in.fetch_add (1, std::memory_order_relaxed);
+
+    if (block.count >= block_size)
+    {
+        flush ();
+    }
+    return true;
+}
+
+
+/** @brief   Hand a partly filled block to the processing side.
+ *  @details This is called only from the acquisition task, for example
+ *           before going to sleep, so that recent samples aren't held back.
+ *  @returns @c true if a block was handed over
+ */
+bool SamplePipeline::flush (void)
+{
+    if (filling == NO_BLOCK || blocks[filling].count == 0)
+    {
+        return false;
+    }
+    states[filling].store (READY, std::memory_order_release);
+    filling = NO_BLOCK;
+    return true;
+}
+
+
+/** @brief   Run the next full block, if there is one, through every stage.
+ *  @details This is called only from the processing task. It returns at once
+ *           if no block is ready, so the task can wait a little and retry.
+ *  @returns @c true if a block was processed
+ */
+bool SamplePipeline::process (void)
+{
+    if (states[next_ready].load (std::memory_order_acquire) != READY)
+    {
+        return false;
+    }
+    states[next_ready].store (PROCESSING, std::memory_order_relaxed);
+
+    chain (blocks[next_ready], chain_context);
+
+    states[next_ready].store (FREE, std::memory_order_release);
+    next_ready ^= 1;
+    blocks_processed.fetch_add (1, std::memory_order_relaxed);
+    return true;
+}
+
+
+/** @brief   Find out whether the processing side has nothing to do.
+ *  @details This is called from the acquisition task, which in low-power
+ *           mode puts the chip to sleep only when no block is waiting for
+ *           or going through the stages.
+ *  @returns @c true if neither block is ready or being processed
+ */
+bool SamplePipeline::is_idle (void) const
+{
+    for (uint8_t index = 0; index < 2; index++)
+    {
+        uint8_t state = states[index].load (std::memory_order_acquire);
+        if (state == READY || state == PROCESSING)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Get a copy of the pipeline's throughput and overflow counters.
+ *  @returns A structure holding the counters
+ */
+pipeline_stats_t SamplePipeline::stats (void) const
+{
+    pipeline_stats_t result;
+    result.samples_in = samples_in.load (std::memory_order_relaxed);
+    result.samples_dropped = samples_dropped.load (std::memory_order_relaxed);
+    result.overflows = overflows.load (std::memory_order_relaxed);
+    result.blocks_processed = blocks_processed.load (std::memory_order_relaxed);
+    return result;
+}
@@ -0,0 +1,218 @@
+/** @file sample_pipeline.h
+ *  This file contains a double-buffered pipeline for blocks of ADC samples.
+ *  Each block holds the readings of each channel in an array of their own,
+ *  so the stages can run through one channel's readings in order.
+ *  The sensor task fills one block while a processing task runs the other
+ *  through a chain of stages such as filtering, debris detection, storage
+ *  and streaming. If processing falls behind so that no empty block is
+ *  available, new samples are dropped and counted rather than overwriting a
+ *  block which is still in use.
+ *
+ *  The pipeline holds one producer and one consumer and uses no locks, only
+ *  atomic block states, so the code also runs on a PC for testing.
+ *
+ *  A pipeline is made from the @c StaticPipeline template, which is given
+ *  the number of channels, the block size and the chain of stages when the
+ *  program is compiled. The blocks are then sized exactly for it, and the
+ *  chain calls each stage directly rather than through a table of
+ *  pointers, so the linker can leave out a stage which no chain names.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SAMPLE_PIPELINE_H_
+#define _SAMPLE_PIPELINE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/// The largest number of samples per channel in one block; the stages'
+/// own buffers are sized for this
+const uint16_t PIPELINE_MAX_BLOCK = 256;
+
+/// The largest number of sensor channels a pipeline carries; the stages'
+/// state is kept for this many
+const uint8_t PIPELINE_MAX_CHANNELS = 8;
+
+
+/** @brief   A block of readings from the wear sensors.
+ *  @details @c samples[channel][index] is a channel's reading number
+ *           @c index in the block, and @c offsets[channel][index] is when
+ *           it was converted, in microseconds after the start of its scan.
+ *           The arrays belong to the pipeline, which sizes them for its
+ *           block size; only the first @c channels pointers are set.
+ */
+struct sample_block_t
+{
+    uint32_t sequence;                    ///< Number of the block since boot
+    uint32_t first_sample;                ///< Samples offered before the block
+    uint32_t start_time;                  ///< Time of the first sample in ms
+    uint16_t count;                       ///< Number of samples in the block
+    uint8_t channels;                     ///< Number of channels in use
+    uint16_t* samples[PIPELINE_MAX_CHANNELS];  ///< Readings of each channel
+    uint16_t* offsets[PIPELINE_MAX_CHANNELS];  ///< Times of each channel
+};
+
+
+/** @brief   Type of a function which does one step of processing on a block.
+ *  @details Stages run one after another in the processing task and may
+ *           change the samples in the block for the stages which follow.
+ *  @param   block The block being processed
+ *  @param   p_context Pointer to whatever data the stage was registered with
+ */
+typedef void (*pipeline_stage_t) (sample_block_t& block, void* p_context);
+
+
+/** @brief   Counters which show how well processing keeps up with sampling.
+ */
+struct pipeline_stats_t
+{
+    uint32_t samples_in;          ///< Samples accepted into blocks
+    uint32_t samples_dropped;     ///< Samples thrown away for lack of a block
+    uint32_t overflows;           ///< Times the producer first found no block
+    uint32_t blocks_processed;    ///< Blocks which went through every stage
+};
+
+
+/** @brief   Class which passes blocks of samples from an acquisition task to
+ *           a chain of processing stages.
+ *  @details This holds everything which doesn't depend on the size of the
+ *           blocks or the stages; see @c StaticPipeline for those.
+ */
+class SamplePipeline
+{
+protected:
+    /// States through which each of the two blocks cycles
+    enum block_state_t : uint8_t { FREE, FILLING, READY, PROCESSING };
+
+    sample_block_t blocks[2];                 ///< The two sample blocks
+    std::atomic<uint8_t> states[2];           ///< State of each block
+    uint8_t filling;                          ///< Block being filled, if any
+    uint8_t next_fill;                        ///< Block the producer takes
+    uint8_t next_ready;                       ///< Block the consumer takes
+    uint16_t block_size;                      ///< Samples per full block
+    uint8_t channels;                         ///< Readings in each sample
+    uint32_t next_sequence;                   ///< Number for the next block
+    uint32_t offered;                         ///< Samples given to @c put()
+    bool dropping;                            ///< Producer is in overflow
+
+    pipeline_stage_t chain;                   ///< Runs every stage in turn
+    void* chain_context;                      ///< Passed to @c chain
+    uint8_t num_stages;                       ///< Stages in the chain
+
+    std::atomic<uint32_t> samples_in;         ///< See @c pipeline_stats_t
+    std::atomic<uint32_t> samples_dropped;    ///< See @c pipeline_stats_t
+    std::atomic<uint32_t> overflows;          ///< See @c pipeline_stats_t
+    std::atomic<uint32_t> blocks_processed;   ///< See @c pipeline_stats_t
+
+    SamplePipeline (uint16_t block_size, uint8_t channels,
+                    uint16_t* storage, pipeline_stage_t chain,
+                    void* chain_context, uint8_t num_stages);
+
+public:
+    bool put (uint32_t time, const uint16_t* readings,
+              const uint16_t* offsets = NULL);
+    bool flush (void);
+    bool process (void);
+    bool is_idle (void) const;
+    pipeline_stats_t stats (void) const;
+
+    /// Get the number of samples per channel in each full block
+    uint16_t get_block_size (void) const { return block_size; }
+
+    /// Get the number of channels in each sample
+    uint8_t get_channels (void) const { return channels; }
+
+    /// Get the number of stages in the chain
+    uint8_t stage_count (void) const { return num_stages; }
+};
+
+
+/** @brief   A chain of processing stages, fixed when the program is compiled.
+ *  @details The stages run in the order they are listed. Each is called
+ *           directly, with the context at the same place in the array given
+ *           to @c run().
+ */
+template <pipeline_stage_t... STAGES>
+struct StageChain;
+
+/// The end of a chain, which does nothing
+template <>
+struct StageChain<>
+{
+    static const uint8_t COUNT = 0;     ///< Number of stages
+
+    /// Run no stages
+    static inline void run (sample_block_t& block, void* const* contexts)
+    {
+    }
+};
+
+/// A chain which runs its first stage, then the rest
+template <pipeline_stage_t FIRST, pipeline_stage_t... REST>
+struct StageChain<FIRST, REST...>
+{
+    static const uint8_t COUNT = 1 + sizeof... (REST);  ///< Number of stages
+
+    /// Run every stage on a block, in order
+    static inline void run (sample_block_t& block, void* const* contexts)
+    {
+        FIRST (block, contexts[0]);
+        StageChain<REST...>::run (block, contexts + 1);
+    }
+};
+
+
+/** @brief   A sample pipeline whose channel count, block size and stages are
+ *           fixed when the program is compiled.
+ *  @details Both blocks' readings and times are members, sized exactly, so
+ *           a pipeline made as a global takes no heap and shows its full
+ *           size in the linker's map.
+ *  @tparam  CHANNELS The number of readings in each sample, from 1 to
+ *           @c PIPELINE_MAX_CHANNELS
+ *  @tparam  BLOCK_SIZE The number of samples per channel in a full block,
+ *           from 1 to @c PIPELINE_MAX_BLOCK
+ *  @tparam  CHAIN A @c StageChain of the stages run on each block
+ */
+template <uint8_t CHANNELS, uint16_t BLOCK_SIZE, typename CHAIN>
+class StaticPipeline : public SamplePipeline
+{
+    static_assert (CHANNELS >= 1 && CHANNELS <= PIPELINE_MAX_CHANNELS,
+                   "A pipeline carries 1 to PIPELINE_MAX_CHANNELS channels");
+    static_assert (BLOCK_SIZE >= 1 && BLOCK_SIZE <= PIPELINE_MAX_BLOCK,
+                   "A block holds 1 to PIPELINE_MAX_BLOCK samples");
+    static_assert (CHAIN::COUNT >= 1, "A pipeline needs at least one stage");
+
+protected:
+    /// Both blocks' readings, then both blocks' times, by channel
+    uint16_t storage[2][2][CHANNELS][BLOCK_SIZE];
+
+    /// Context of each stage, in the order of the chain
+    void* contexts[CHAIN::COUNT];
+
+    /// Run the chain on a block; the context is the pipeline
+    static void run_chain (sample_block_t& block, void* p_self)
+    {
+        CHAIN::run (block, ((StaticPipeline*)p_self)->contexts);
+    }
+
+public:
+    /** @brief   Create a pipeline.
+     *  @param   stage_contexts The pointer passed to each stage, in the
+     *           order of the chain; @c NULL for a stage which needs none
+     */
+    StaticPipeline (void* const (&stage_contexts)[CHAIN::COUNT])
+        : SamplePipeline (BLOCK_SIZE, CHANNELS, &storage[0][0][0][0],
+                          run_chain, this, CHAIN::COUNT)
+    {
+        for (uint8_t index = 0; index < CHAIN::COUNT; index++)
+        {
+            contexts[index] = stage_contexts[index];
+        }
+    }
+};
+
+#endif // _SAMPLE_PIPELINE_H_
@@ -0,0 +1,73 @@
+/** @file sample_schedule.cpp
+ *  This file contains the scheduler which orders the conversions of each
+ *  scan and times them.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "sample_schedule.h"
+
+
+/** @brief   Create a scheduler.
+ *  @param   channels The number of channels in each scan, from 1 to
+ *           @c PIPELINE_MAX_CHANNELS
+ *  @param   order The pattern in which they are converted
+ */
+SampleSchedule::SampleSchedule (uint8_t channels, schedule_order_t order)
+    : channels (channels), order (order), scans (0)
+{
+    if (this->channels == 0)
+    {
+        this->channels = 1;
+    }
+    else if (this->channels > PIPELINE_MAX_CHANNELS)
+    {
+        this->channels = PIPELINE_MAX_CHANNELS;
+    }
+}
+
+
+/** @brief   Find which channel is converted in a slot of the next scan.
+ *  @param   slot The place in the scan, from zero
+ */
+uint8_t SampleSchedule::channel_at (uint8_t slot) const
+{
+    if (order == SCHEDULE_MIRRORED && (scans & 1))
+    {
+        return channels - 1 - slot;
+    }
+    return slot;
+}
+
+
+/** @brief   Convert every channel once, in the order of the pattern.
+ *  @details The time of each conversion is taken as halfway between the
+ *           clock readings before and after it, which allows for the time
+ *           the conversion takes.
+ *  @param   read The function which converts a channel
+ *  @param   clock The function which gives the time in microseconds
+ *  @param   p_context Pointer which is passed to @c read
+ *  @param   readings Set to the reading of each channel, in channel order
+ *  @param   offsets Set to the time of each channel's conversion, in
+ *           microseconds from the start of the scan, in channel order
+ *  @returns The time at which the scan started, from @c clock
+ */
+uint32_t SampleSchedule::scan (schedule_read_t read, schedule_clock_t clock,
+                               void* p_context, uint16_t* readings,
+                               uint16_t* offsets)
+{
+    uint32_t start = clock ();
+    uint32_t before = start;
+    for (uint8_t slot = 0; slot < channels; slot++)
+    {
+        uint8_t channel = channel_at (slot);
+        readings[channel] = read (channel, p_context);
+        uint32_t after = clock ();
+        offsets[channel] = (uint16_t)(before + (after - before) / 2 - start);
+        before = after;
+    }
+    scans++;
+    return start;
+}
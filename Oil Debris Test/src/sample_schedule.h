@@ -0,0 +1,60 @@
+/** @file sample_schedule.h
+ *  This file contains the scheduler which decides the order in which the
+ *  channels are converted in each scan and notes when each conversion was
+ *  made. One ADC converts the channels one after another, so they are never
+ *  read at quite the same time; the times let the align stage work out
+ *  what each channel read at the start of the scan, so that pulses seen on
+ *  several channels can be compared.
+ *
+ *  The mirrored order reverses every other scan, so no channel is always
+ *  read last and any error left after aligning doesn't build up on one
+ *  channel. Nothing here touches hardware, so it runs on a PC.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SAMPLE_SCHEDULE_H_
+#define _SAMPLE_SCHEDULE_H_
+
+#include <stdint.h>
+#include "sample_pipeline.h"
+
+/// Orders in which the channels of a scan may be converted
+enum schedule_order_t : uint8_t
+{
+    SCHEDULE_FORWARD,           ///< Always in channel order
+    SCHEDULE_MIRRORED           ///< In channel order, then reversed, and so on
+};
+
+
+/// Type of a function which converts one channel and returns the reading
+typedef uint16_t (*schedule_read_t) (uint8_t channel, void* p_context);
+
+/// Type of a function which gives the time in microseconds
+typedef uint32_t (*schedule_clock_t) (void);
+
+
+/** @brief   Class which converts the channels of each scan in a fixed
+ *           pattern and notes the time of each conversion.
+ */
+class SampleSchedule
+{
+protected:
+    uint8_t channels;           ///< Channels in each scan
+    schedule_order_t order;     ///< Pattern of the scans
+    uint32_t scans;             ///< Scans done
+
+public:
+    SampleSchedule (uint8_t channels, schedule_order_t order);
+
+    uint8_t channel_at (uint8_t slot) const;
+    uint32_t scan (schedule_read_t read, schedule_clock_t clock,
+                   void* p_context, uint16_t* readings, uint16_t* offsets);
+
+    /// Get the number of scans done
+    uint32_t get_scans (void) const { return scans; }
+};
+
+#endif // _SAMPLE_SCHEDULE_H_
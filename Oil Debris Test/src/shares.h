@@ -20,4 +20,8 @@
 extern Share<uint8_t> ax_pwm;
 extern Share<uint8_t> ay_pwm;
 
+// Shares which hold the latest fine and coarse wear voltages in millivolts
+extern Share<uint16_t> v_fine;
+extern Share<uint16_t> v_coarse;
+
 #endif // _SHARES_H_
\ No newline at end of file
@@ -0,0 +1,284 @@
+/** @file signal_gen.cpp
+ *  This file contains a generator of synthetic wear sensor signals with
+ *  labels which tell the truth about every particle.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "signal_gen.h"
+
+/// Two pi, for turning cycles into radians
+static const float TWO_PI = 6.28318531f;
+
+/// A time which never comes
+static const uint64_t NEVER = 0xFFFFFFFFFFFFFFFFULL;
+
+
+/** @brief   Create a generator.
+ *  @param   config How the signals are made; it's copied
+ */
+SignalGenerator::SignalGenerator (const signal_config_t& config)
+    : config (config), random (config.seed ? config.seed : 1),
+      started (false), last_us (0), now_us (0), next_us (NEVER),
+      num_pulses (0), particles (0), labels_put (0), labels_taken (0),
+      labels_lost (0)
+{
+    if (this->config.channels > SIGNAL_MAX_CHANNELS)
+    {
+        this->config.channels = SIGNAL_MAX_CHANNELS;
+    }
+}
+
+
+/** @brief   Get a random number from 0 up to but not including 1.
+ *  @details The numbers come from a 32-bit xorshift generator, which is
+ *           quick on the ESP32 and gives the same run from the same seed.
+ */
+float SignalGenerator::uniform (void)
+{
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return (random >> 8) * (1.0f / 16777216.0f);
+}
+
+
+/** @brief   Get a random number from a normal distribution with a mean of 0
+ *           and a standard deviation of 1, near enough for noise.
+ *  @details The sum of four uniform numbers is close to a bell curve.
+ */
+float SignalGenerator::gaussian (void)
+{
+    float sum = uniform () + uniform () + uniform () + uniform ();
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+
+/** @brief   Choose the size of a particle from the configured spread.
+ *  @returns The size in microns
+ */
+uint16_t SignalGenerator::particle_size (void)
+{
+    float low = config.min_um;
+    float high = (config.max_um > config.min_um) ? config.max_um : low;
+    float size = low;
+    if (config.sizes == SIZES_UNIFORM)
+    {
+        size = low + uniform () * (high - low);
+    }
+    else if (config.sizes == SIZES_POWER_LAW && config.exponent > 1.0f)
+    {
+        // Turn a uniform number into one whose density falls off as
+        // size^-exponent between the smallest and largest sizes
+        float power = 1.0f - config.exponent;
+        float from = powf (low, power);
+        float to = powf (high, power);
+        size = powf (from + uniform () * (to - from), 1.0f / power);
+    }
+    return (uint16_t)(size + 0.5f);
+}
+
+
+/** @brief   Start the pulse of a particle which arrives now, label it, and
+ *           choose when the next one arrives.
+ */
+void SignalGenerator::arrive (void)
+{
+    uint64_t start = next_us;
+    float wait = -logf (1.0f - uniform ()) / config.rate;
+    next_us = start + (uint64_t)(wait * 1e6f) + 1;
+
+    // A particle which would overlap too many others is left out
+    if (num_pulses == SIGNAL_MAX_PULSES)
+    {
+        return;
+    }
+
+    signal_label_t label;
+    memset (&label, 0, sizeof (label));
+    label.time_ms = (uint32_t)(start / 1000);
+    label.width_ms = config.pulse_ms;
+    label.size_um = particle_size ();
+
+    // A pulse grows with the particle's volume
+    pulse_t& pulse = pulses[num_pulses++];
+    pulse.start_us = start;
+    float scale = label.size_um / SIGNAL_REFERENCE_UM;
+    scale = scale * scale * scale;
+    for (uint8_t channel = 0; channel < config.channels; channel++)
+    {
+        float height = config.channel[channel].gain * scale;
+        pulse.height[channel] = height;
+        float room = SIGNAL_MAX_COUNTS - config.channel[channel].baseline;
+        label.peak[channel] = (uint16_t)((height < room ? height : room)
+                                         + 0.5f);
+    }
+    particles++;
+
+    uint32_t put = labels_put.load (std::memory_order_relaxed);
+    if (put - labels_taken.load (std::memory_order_acquire)
+        >= SIGNAL_LABEL_RING)
+    {
+        labels_lost++;
+        return;
+    }
+    labels[put % SIGNAL_LABEL_RING] = label;
+    labels_put.store (put + 1, std::memory_order_release);
+}
+
+
+/** @brief   Make one reading of one channel.
+ *  @param   channel The channel, from zero
+ *  @param   time_us When the reading is taken, in microseconds; this may
+ *           wrap past 32 bits, but must not go backwards
+ *  @returns The reading in ADC counts
+ */
+uint16_t SignalGenerator::read (uint8_t channel, uint32_t time_us)
+{
+    if (!started)
+    {
+        now_us = time_us;
+        last_us = time_us;
+        if (config.rate > 0.0f)
+        {
+            next_us = now_us;
+            next_us += (uint64_t)(-logf (1.0f - uniform ()) / config.rate
+                                  * 1e6f);
+        }
+        started = true;
+    }
+    now_us += (uint32_t)(time_us - last_us);
+    last_us = time_us;
+
+    // Particles which have arrived start their pulses, and those which have
+    // passed are forgotten
+    while (next_us <= now_us)
+    {
+        arrive ();
+    }
+    uint64_t width_us = (uint64_t)config.pulse_ms * 1000;
+    for (uint8_t index = 0; index < num_pulses; )
+    {
+        if (now_us - pulses[index].start_us >= width_us)
+        {
+            pulses[index] = pulses[--num_pulses];
+        }
+        else
+        {
+            index++;
+        }
+    }
+
+    if (channel >= config.channels)
+    {
+        return 0;
+    }
+    const signal_channel_t& how = config.channel[channel];
+    float value = how.baseline + how.noise * gaussian ();
+    if (how.drift && config.drift_period_ms)
+    {
+        uint64_t period_us = (uint64_t)config.drift_period_ms * 1000;
+        value += how.drift * sinf (TWO_PI * (now_us % period_us)
+                                   / (float)period_us);
+    }
+    if (how.hum && config.hum_hz)
+    {
+        uint32_t period_us = 1000000 / config.hum_hz;
+        value += how.hum * sinf (TWO_PI * (now_us % period_us)
+                                 / (float)period_us);
+    }
+
+    // Each pulse rises and falls as the square of a half sine
+    for (uint8_t index = 0; index < num_pulses; index++)
+    {
+        float phase = (now_us - pulses[index].start_us) / (float)width_us;
+        float shape = sinf (phase * (TWO_PI / 2));
+        value += pulses[index].height[channel] * shape * shape;
+    }
+
+    if (value <= 0.0f)
+    {
+        return 0;
+    }
+    return (value >= SIGNAL_MAX_COUNTS) ? SIGNAL_MAX_COUNTS
+                                        : (uint16_t)(value + 0.5f);
+}
+
+
+/** @brief   Take the oldest label which hasn't been taken yet.
+ *  @details This may be called from a different task than @c read().
+ *  @param   label Set to the label
+ *  @returns @c true if there was a label
+ */
+bool SignalGenerator::take_label (signal_label_t& label)
+{
+    uint32_t taken = labels_taken.load (std::memory_order_relaxed);
+    if (taken == labels_put.load (std::memory_order_acquire))
+    {
+        return false;
+    }
+    label = labels[taken % SIGNAL_LABEL_RING];
+    labels_taken.store (taken + 1, std::memory_order_release);
+    return true;
+}
+
+
+/** @brief   Fill in a configuration like the tester's two sensors.
+ *  @details A particle's pulse reaches the detector's usual threshold of
+ *           40 counts, before filtering, from about 90 microns on the fine
+ *           sensor, which saturates above about 350; on the coarse sensor it
+ *           does so from about 170 microns. One particle arrives every two
+ *           seconds on average, mostly small ones.
+ *  @param   config The configuration to fill in
+ */
+void signal_defaults (signal_config_t& config)
+{
+    memset (&config, 0, sizeof (config));
+    config.seed = 1;
+    config.channels = 2;
+    config.drift_period_ms = 600000;
+    config.hum_hz = 60;
+    config.rate = 0.5f;
+    config.sizes = SIZES_POWER_LAW;
+    config.min_um = 40;
+    config.max_um = 600;
+    config.exponent = 3.0f;
+    config.pulse_ms = 40;
+    config.channel[0] = { 1500, 40, 4.0f, 6, 60.0f };
+    config.channel[1] = { 1450, 40, 4.0f, 6, 8.0f };
+}
+
+
+/** @brief   Pack a label into little-endian bytes for the log.
+ *  @details The bytes are time (4), width (2), size (2), number of channels
+ *           (1) and then the peak on each channel (2 each).
+ *  @param   label The label
+ *  @param   channels The number of channels whose peaks are packed
+ *  @param   out Where the bytes go, which must have room for
+ *           9 + 2 * @c channels of them
+ *  @returns The number of bytes written
+ */
+size_t signal_label_pack (const signal_label_t& label, uint8_t channels,
+                          uint8_t* out)
+{
+    size_t length = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 8)
+    {
+        out[length++] = (uint8_t)(label.time_ms >> shift);
+    }
+    out[length++] = (uint8_t)label.width_ms;
+    out[length++] = (uint8_t)(label.width_ms >> 8);
+    out[length++] = (uint8_t)label.size_um;
+    out[length++] = (uint8_t)(label.size_um >> 8);
+    out[length++] = channels;
+    for (uint8_t channel = 0; channel < channels; channel++)
+    {
+        out[length++] = (uint8_t)label.peak[channel];
+        out[length++] = (uint8_t)(label.peak[channel] >> 8);
+    }
+    return length;
+}
@@ -0,0 +1,151 @@
+/** @file signal_gen.h
+ *  This file contains a generator of synthetic wear sensor signals, used
+ *  to test the debris detector and to load the data path without a sensor.
+ *  Each channel's reading is a baseline which drifts slowly, plus noise,
+ *  plus mains hum, plus a pulse for each particle which passes. Particles
+ *  arrive at random at a given mean rate, and their sizes follow a chosen
+ *  distribution. A particle's pulse on each channel grows with its volume
+ *  times the channel's gain, so the fine sensor sees small particles which
+ *  the coarse one misses and the coarse sensor measures large particles
+ *  which saturate the fine one.
+ *
+ *  Every particle is also written down as a label, which gives when its
+ *  pulse began and how high it was on each channel. Comparing the labels
+ *  with the events the detector finds shows the detector's precision and
+ *  recall. The generator is read by one task and its labels taken by
+ *  another without locks. Nothing here touches hardware, so the host
+ *  benchmark uses it too.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SIGNAL_GEN_H_
+#define _SIGNAL_GEN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/// The largest number of channels the generator makes
+const uint8_t SIGNAL_MAX_CHANNELS = 8;
+
+/// The most particles whose pulses can overlap
+const uint8_t SIGNAL_MAX_PULSES = 8;
+
+/// Labels which can wait to be taken; more are counted and thrown away
+const uint8_t SIGNAL_LABEL_RING = 32;
+
+/// The largest reading, as from a 12-bit ADC
+const uint16_t SIGNAL_MAX_COUNTS = 4095;
+
+/// Size in microns at which a channel's pulse is as high as its gain
+const float SIGNAL_REFERENCE_UM = 100.0f;
+
+
+/// Ways in which particle sizes may be spread
+enum signal_sizes_t : uint8_t
+{
+    SIZES_FIXED,                ///< Every particle is the smallest size
+    SIZES_UNIFORM,              ///< Evenly spread from smallest to largest
+    SIZES_POWER_LAW             ///< Many small particles and a few large
+};
+
+
+/** @brief   How one channel's signal is made.
+ */
+struct signal_channel_t
+{
+    uint16_t baseline;          ///< Reading with no particle, in counts
+    uint16_t drift;             ///< Height of the slow drift in counts
+    float noise;                ///< Standard deviation of the noise in counts
+    uint16_t hum;               ///< Height of the mains hum in counts
+    float gain;                 ///< Pulse height of a reference particle
+};
+
+
+/** @brief   How the signals are made.
+ */
+struct signal_config_t
+{
+    uint32_t seed;              ///< Start of the random numbers, not zero
+    uint8_t channels;           ///< Channels made
+    uint32_t drift_period_ms;   ///< Time of one cycle of the drift
+    uint16_t hum_hz;            ///< Frequency of the mains hum
+    float rate;                 ///< Mean particles per second
+    signal_sizes_t sizes;       ///< How particle sizes are spread
+    uint16_t min_um;            ///< Smallest particle in microns
+    uint16_t max_um;            ///< Largest particle in microns
+    float exponent;             ///< Power of a power-law spread, above 1
+    uint16_t pulse_ms;          ///< Time a particle takes to pass a sensor
+    signal_channel_t channel[SIGNAL_MAX_CHANNELS];  ///< Each channel
+};
+
+
+/** @brief   The truth about one particle.
+ */
+struct signal_label_t
+{
+    uint32_t time_ms;           ///< When its pulse began
+    uint16_t width_ms;          ///< How long its pulse lasted
+    uint16_t size_um;           ///< Its size in microns
+    uint16_t peak[SIGNAL_MAX_CHANNELS];   ///< Pulse height on each channel
+};
+
+
+/** @brief   Class which makes synthetic wear sensor readings.
+ *  @details Readings must be asked for in order of time, as from a sampling
+ *           task; the channels of a scan may be read at slightly different
+ *           times, and the drift, hum and pulses are found for each one.
+ */
+class SignalGenerator
+{
+protected:
+    /// A particle which is passing the sensors
+    struct pulse_t
+    {
+        uint64_t start_us;      ///< When its pulse began
+        float height[SIGNAL_MAX_CHANNELS];  ///< Its height on each channel
+    };
+
+    signal_config_t config;     ///< How the signals are made
+    uint32_t random;            ///< State of the random number generator
+    bool started;               ///< The first reading has been made
+    uint32_t last_us;           ///< The last time given to @c read()
+    uint64_t now_us;            ///< That time, carried past 32 bits
+    uint64_t next_us;           ///< When the next particle arrives
+    pulse_t pulses[SIGNAL_MAX_PULSES];  ///< Particles passing the sensors
+    uint8_t num_pulses;         ///< Number of them
+    uint32_t particles;         ///< Particles made
+    signal_label_t labels[SIGNAL_LABEL_RING];   ///< Labels not yet taken
+    std::atomic<uint32_t> labels_put;       ///< Labels put into the ring
+    std::atomic<uint32_t> labels_taken;     ///< Labels taken from the ring
+    uint32_t labels_lost;       ///< Labels thrown away for lack of room
+
+    float uniform (void);
+    float gaussian (void);
+    uint16_t particle_size (void);
+    void arrive (void);
+
+public:
+    SignalGenerator (const signal_config_t& config);
+
+    uint16_t read (uint8_t channel, uint32_t time_us);
+    bool take_label (signal_label_t& label);
+
+    /// Get the number of particles made
+    uint32_t get_particles (void) const { return particles; }
+
+    /// Get the number of labels thrown away because none were being taken
+    uint32_t get_labels_lost (void) const { return labels_lost; }
+};
+
+// Fill in a configuration like the tester's two sensors
+void signal_defaults (signal_config_t& config);
+
+// Pack a label into little-endian bytes, returning how many were written
+size_t signal_label_pack (const signal_label_t& label, uint8_t channels,
+                          uint8_t* out);
+
+#endif // _SIGNAL_GEN_H_
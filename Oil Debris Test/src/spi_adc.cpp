@@ -0,0 +1,259 @@
+/** @file spi_adc.cpp
+ *  This file contains the commands and replies of the external ADCs, and a
+ *  mock of each chip which follows its data sheet closely enough to test
+ *  the framing against.
+ *
+ *  Every frame is 32 bits. The MCP3208 needs only 24, so each of its frames
+ *  starts with a zero byte, which it ignores while it waits for a start bit.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "spi_adc.h"
+
+/// Descriptions of the kinds of ADC, in the order of @c spi_adc_model_t
+static const spi_adc_info_t models[] =
+{
+    { "MCP3208", 8, 12, 0, 0, 1000000 },
+    { "ADS8688", 8, 16, 1, 1, 10000000 }
+};
+
+/// ADS8688 command which selects input n is this plus n shifted left by 10
+static const uint16_t ADS8688_MAN_CH = 0xC000;
+
+
+/** @brief   Get the description of a kind of ADC.
+ *  @param   model The kind of ADC
+ */
+const spi_adc_info_t& spi_adc_info (spi_adc_model_t model)
+{
+    return models[model];
+}
+
+
+/** @brief   Create a driver for a kind of ADC which reads input 0 only.
+ *  @param   model The kind of ADC
+ */
+SpiAdc::SpiAdc (spi_adc_model_t model)
+    : model (model), inputs (), channels (1), scans (0), bad_frames (0)
+{
+}
+
+
+/** @brief   Choose which ADC inputs are read in each scan.
+ *  @param   inputs The ADC input of each channel, in channel order
+ *  @param   count The number of channels
+ *  @returns @c true if the inputs were set, @c false if there are too many
+ *           channels or an input the ADC doesn't have
+ */
+bool SpiAdc::set_inputs (const uint8_t* inputs, uint8_t count)
+{
+    if (count == 0 || count > SPI_ADC_MAX_CHANNELS)
+    {
+        return false;
+    }
+    for (uint8_t channel = 0; channel < count; channel++)
+    {
+        if (inputs[channel] >= models[model].inputs)
+        {
+            return false;
+        }
+    }
+    for (uint8_t channel = 0; channel < count; channel++)
+    {
+        this->inputs[channel] = inputs[channel];
+    }
+    channels = count;
+    return true;
+}
+
+
+/** @brief   Get the most scans which fit in one batch.
+ */
+uint16_t SpiAdc::max_scans (void) const
+{
+    return (SPI_ADC_MAX_FRAMES - models[model].latency) / channels;
+}
+
+
+/** @brief   Write the command which converts one input.
+ *  @param   input The ADC input to convert
+ *  @param   tx The frame to write
+ */
+void SpiAdc::command (uint8_t input, uint8_t* tx) const
+{
+    if (model == SPI_ADC_MCP3208)
+    {
+        // Zero byte, then start bit, single-ended and the input number
+        tx[0] = 0x00;
+        tx[1] = 0x06 | (input >> 2);
+        tx[2] = (uint8_t)((input & 0x03) << 6);
+        tx[3] = 0x00;
+    }
+    else
+    {
+        uint16_t word = ADS8688_MAN_CH | ((uint16_t)input << 10);
+        tx[0] = (uint8_t)(word >> 8);
+        tx[1] = (uint8_t)word;
+        tx[2] = 0x00;
+        tx[3] = 0x00;
+    }
+}
+
+
+/** @brief   Pick the reading out of a reply.
+ *  @param   rx The frame received
+ *  @param   reading Set to the reading, scaled to 12 bits
+ *  @returns @c false if the reply can't be from a working ADC
+ */
+bool SpiAdc::result (const uint8_t* rx, uint16_t& reading) const
+{
+    if (model == SPI_ADC_MCP3208)
+    {
+        // The MCP3208 sends a zero bit just before the result; an input
+        // pulled high because no chip answers has a one there
+        reading = (uint16_t)(((rx[2] & 0x0F) << 8) | rx[3]);
+        return (rx[2] & 0x10) == 0;
+    }
+    reading = (uint16_t)(((rx[2] << 8) | rx[3]) >> 4);
+    return true;
+}
+
+
+/** @brief   Fill a batch with the commands for some scans of every channel.
+ *  @details Each scan converts the channels in order, one frame each. For
+ *           an ADC which answers a frame late, one more frame is added to
+ *           collect the last answer; it repeats the first command, so the
+ *           ADC isn't sent anywhere new.
+ *  @param   batch The batch to fill; only its commands are written
+ *  @param   scans The number of scans, from 1 to @c max_scans()
+ *  @returns @c true if the batch was filled
+ */
+bool SpiAdc::prepare (spi_adc_batch_t& batch, uint16_t scans) const
+{
+    if (scans == 0 || scans > max_scans ())
+    {
+        return false;
+    }
+
+    uint16_t frame = 0;
+    for (uint16_t scan = 0; scan < scans; scan++)
+    {
+        for (uint8_t channel = 0; channel < channels; channel++)
+        {
+            command (inputs[channel], batch.tx[frame++]);
+        }
+    }
+    for (uint8_t extra = 0; extra < models[model].latency; extra++)
+    {
+        command (inputs[0], batch.tx[frame++]);
+    }
+    batch.frames = frame;
+    return true;
+}
+
+
+/** @brief   Pass the readings in a finished batch to a function, one scan at
+ *           a time.
+ *  @details The first @c latency replies answer the end of the batch before,
+ *           so they are skipped. A scan with any reply which makes no sense
+ *           is left out and its bad frames are counted.
+ *  @param   batch A batch which the bus has run
+ *  @param   sink The function given each scan's readings
+ *  @param   p_context Pointer which is passed to @c sink
+ *  @returns The number of scans passed to @c sink
+ */
+uint16_t SpiAdc::decode (const spi_adc_batch_t& batch, spi_adc_sink_t sink,
+                         void* p_context)
+{
+    uint16_t readings[SPI_ADC_MAX_CHANNELS];
+    uint8_t latency = models[model].latency;
+    uint16_t passed = 0;
+    bool good = true;
+
+    for (uint16_t frame = latency; frame < batch.frames; frame++)
+    {
+        uint8_t channel = (frame - latency) % channels;
+        if (!result (batch.rx[frame], readings[channel]))
+        {
+            good = false;
+            bad_frames++;
+        }
+        if (channel == channels - 1)
+        {
+            if (good)
+            {
+                sink (readings, p_context);
+                passed++;
+                scans++;
+            }
+            good = true;
+        }
+    }
+    return passed;
+}
+
+
+/** @brief   Create a mock ADC.
+ *  @param   model The kind of ADC to act as
+ *  @param   signal A function which gives the reading of each input, with
+ *           as many bits as the ADC has
+ *  @param   p_context Pointer which is passed to @c signal
+ */
+SpiAdcMock::SpiAdcMock (spi_adc_model_t model, spi_adc_signal_t signal,
+                        void* p_context)
+    : model (model), signal (signal), p_context (p_context), selected (-1),
+      conversions (0)
+{
+}
+
+
+/** @brief   Answer every frame of a batch as the ADC would.
+ *  @details An MCP3208 frame without a proper start bit gets all ones, as
+ *           if no chip were there. An ADS8688 sends the conversion of the
+ *           input chosen by the frame before, or zeros if there was none.
+ *  @param   batch The batch whose replies are filled in
+ */
+void SpiAdcMock::transfer (spi_adc_batch_t& batch)
+{
+    for (uint16_t frame = 0; frame < batch.frames; frame++)
+    {
+        const uint8_t* tx = batch.tx[frame];
+        uint8_t* rx = batch.rx[frame];
+
+        if (model == SPI_ADC_MCP3208)
+        {
+            rx[0] = rx[1] = rx[2] = rx[3] = 0xFF;
+            if (tx[0] == 0x00 && (tx[1] & 0xFC) == 0x04 && (tx[1] & 0x02))
+            {
+                uint8_t input = (uint8_t)(((tx[1] & 0x01) << 2) | (tx[2] >> 6));
+                uint16_t value = signal (input, p_context) & 0x0FFF;
+                rx[2] = 0xE0 | (uint8_t)(value >> 8);
+                rx[3] = (uint8_t)value;
+                conversions++;
+            }
+        }
+        else
+        {
+            uint16_t value = 0;
+            if (selected >= 0)
+            {
+                value = signal ((uint8_t)selected, p_context);
+                conversions++;
+            }
+            rx[0] = 0x00;
+            rx[1] = 0x00;
+            rx[2] = (uint8_t)(value >> 8);
+            rx[3] = (uint8_t)value;
+
+            // Other commands, such as NO_OP, keep the same input
+            uint16_t word = (uint16_t)((tx[0] << 8) | tx[1]);
+            if ((word & 0xE3FF) == ADS8688_MAN_CH)
+            {
+                selected = (word >> 10) & 0x07;
+            }
+        }
+    }
+}
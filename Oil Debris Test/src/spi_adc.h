@@ -0,0 +1,138 @@
+/** @file spi_adc.h
+ *  This file contains the framing for external SPI ADCs, which can be used
+ *  in place of the ESP32's own ADC for cleaner, more linear readings. A
+ *  batch holds many conversions, one 32-bit SPI frame each, which the SPI
+ *  hardware runs back to back by DMA while the CPU does other work; see
+ *  @c spi_adc_bus.h. The classes here only fill in the commands and pick
+ *  the results out of the replies, so they also run on a PC, where
+ *  @c SpiAdcMock stands in for the chip.
+ *
+ *  Two kinds of chip are supported. The MCP3208 answers each command in the
+ *  same frame. The ADS8688 answers it in the next frame, so a batch ends
+ *  with one extra frame to collect the last answer. Results are scaled to
+ *  12 bits, as the rest of the tester expects.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SPI_ADC_H_
+#define _SPI_ADC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Bytes in each SPI frame; a whole word, so the DMA needs no bounce buffer
+const uint8_t SPI_ADC_FRAME_BYTES = 4;
+
+/// The most frames in one batch
+const uint16_t SPI_ADC_MAX_FRAMES = 64;
+
+/// The most channels read in each scan
+const uint8_t SPI_ADC_MAX_CHANNELS = 8;
+
+
+/// Kinds of external ADC
+enum spi_adc_model_t : uint8_t
+{
+    SPI_ADC_MCP3208,            ///< Microchip 12-bit, 8 inputs, 1 MHz here
+    SPI_ADC_ADS8688             ///< TI 16-bit, 8 inputs, up to 17 MHz
+};
+
+
+/** @brief   What the driver needs to know about a kind of ADC.
+ */
+struct spi_adc_info_t
+{
+    const char* name;           ///< Part number
+    uint8_t inputs;             ///< Number of analog inputs
+    uint8_t bits;               ///< Bits in each result
+    uint8_t latency;            ///< Frames before a command is answered
+    uint8_t spi_mode;           ///< SPI clock polarity and phase
+    uint32_t clock_hz;          ///< SPI clock to use
+};
+
+
+/** @brief   A batch of SPI frames which the bus runs back to back.
+ *  @details The buffers are word-aligned for the DMA and must be in internal
+ *           RAM, which they are if the batch is a global or static.
+ */
+struct spi_adc_batch_t
+{
+    uint16_t frames;                                    ///< Frames to run
+    alignas (4) uint8_t tx[SPI_ADC_MAX_FRAMES][SPI_ADC_FRAME_BYTES]; ///< Out
+    alignas (4) uint8_t rx[SPI_ADC_MAX_FRAMES][SPI_ADC_FRAME_BYTES]; ///< In
+};
+
+
+/// Type of a function which is given the readings of each complete scan,
+/// one per channel in channel order, scaled to 12 bits
+typedef void (*spi_adc_sink_t) (const uint16_t* readings, void* p_context);
+
+/// Type of a function which gives a mock ADC's full-scale reading of an input
+typedef uint16_t (*spi_adc_signal_t) (uint8_t input, void* p_context);
+
+
+// Get the description of a kind of ADC
+const spi_adc_info_t& spi_adc_info (spi_adc_model_t model);
+
+
+/** @brief   Class which builds batches of conversions for an external ADC and
+ *           picks the readings out of the replies.
+ */
+class SpiAdc
+{
+protected:
+    spi_adc_model_t model;                      ///< Kind of ADC
+    uint8_t inputs[SPI_ADC_MAX_CHANNELS];       ///< ADC input of each channel
+    uint8_t channels;                           ///< Channels in each scan
+    uint32_t scans;                             ///< Scans decoded
+    uint32_t bad_frames;                        ///< Replies which made no sense
+
+    void command (uint8_t input, uint8_t* tx) const;
+    bool result (const uint8_t* rx, uint16_t& reading) const;
+
+public:
+    SpiAdc (spi_adc_model_t model);
+
+    bool set_inputs (const uint8_t* inputs, uint8_t count);
+    uint16_t max_scans (void) const;
+    bool prepare (spi_adc_batch_t& batch, uint16_t scans) const;
+    uint16_t decode (const spi_adc_batch_t& batch, spi_adc_sink_t sink,
+                     void* p_context);
+
+    /// Get the kind of ADC
+    spi_adc_model_t get_model (void) const { return model; }
+
+    /// Get the number of scans decoded since startup
+    uint32_t get_scans (void) const { return scans; }
+
+    /// Get the number of replies which made no sense, as when no chip answers
+    uint32_t get_bad_frames (void) const { return bad_frames; }
+};
+
+
+/** @brief   Class which answers SPI frames as an external ADC would, so the
+ *           driver can be tested on a PC.
+ */
+class SpiAdcMock
+{
+protected:
+    spi_adc_model_t model;      ///< Kind of ADC to act as
+    spi_adc_signal_t signal;    ///< Gives the reading of each input
+    void* p_context;            ///< Passed to @c signal
+    int16_t selected;           ///< Input chosen by the last frame, if any
+    uint32_t conversions;       ///< Conversions done
+
+public:
+    SpiAdcMock (spi_adc_model_t model, spi_adc_signal_t signal,
+                void* p_context = NULL);
+
+    void transfer (spi_adc_batch_t& batch);
+
+    /// Get the number of conversions done
+    uint32_t get_conversions (void) const { return conversions; }
+};
+
+#endif // _SPI_ADC_H_
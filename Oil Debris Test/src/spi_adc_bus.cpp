@@ -0,0 +1,112 @@
+/** @file spi_adc_bus.cpp
+ *  This file contains the SPI transport for an external ADC, using the
+ *  ESP-IDF SPI master driver on the VSPI host. The transactions and the
+ *  batches' buffers are all static, so queueing a batch never touches the
+ *  heap, which the sampling task must not use.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <driver/spi_master.h>
+#include "spi_adc_bus.h"
+
+/// The ADC's handle on the bus, or @c NULL before it's set up
+static spi_device_handle_t device = NULL;
+
+/// One set of transactions for each batch which may be in flight
+static spi_transaction_t transactions[SPI_ADC_BATCHES_IN_FLIGHT]
+                                     [SPI_ADC_MAX_FRAMES];
+
+/// Set of transactions the next batch started uses
+static uint8_t next_set = 0;
+
+
+/** @brief   Set up the SPI bus and add the ADC to it.
+ *  @details The clock and SPI mode come from the ADC's description. The
+ *           driver's queue holds every frame of the batches in flight.
+ *  @param   pins The pins to which the ADC is wired
+ *  @param   model The kind of ADC
+ *  @returns @c true if the bus and the ADC were set up
+ */
+bool spi_adc_bus_begin (const spi_adc_pins_t& pins, spi_adc_model_t model)
+{
+    const spi_adc_info_t& info = spi_adc_info (model);
+
+    spi_bus_config_t bus = {};
+    bus.sclk_io_num = pins.sclk;
+    bus.miso_io_num = pins.miso;
+    bus.mosi_io_num = pins.mosi;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = SPI_ADC_FRAME_BYTES;
+    if (spi_bus_initialize (VSPI_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK)
+    {
+        return false;
+    }
+
+    spi_device_interface_config_t config = {};
+    config.mode = info.spi_mode;
+    config.clock_speed_hz = info.clock_hz;
+    config.spics_io_num = pins.cs;
+    config.queue_size = SPI_ADC_BATCHES_IN_FLIGHT * SPI_ADC_MAX_FRAMES;
+    return spi_bus_add_device (VSPI_HOST, &config, &device) == ESP_OK;
+}
+
+
+/** @brief   Queue every frame of a batch and return at once.
+ *  @details The batch's buffers must not be touched until
+ *           @c spi_adc_bus_finish() has returned it.
+ *  @param   batch A batch filled by @c SpiAdc::prepare()
+ *  @returns @c true if every frame was queued
+ */
+bool spi_adc_bus_start (spi_adc_batch_t& batch)
+{
+    if (device == NULL)
+    {
+        return false;
+    }
+
+    spi_transaction_t* set = transactions[next_set];
+    next_set = (next_set + 1) % SPI_ADC_BATCHES_IN_FLIGHT;
+    for (uint16_t frame = 0; frame < batch.frames; frame++)
+    {
+        spi_transaction_t& trans = set[frame];
+        trans = spi_transaction_t ();
+        trans.length = 8 * SPI_ADC_FRAME_BYTES;
+        trans.rxlength = 8 * SPI_ADC_FRAME_BYTES;
+        trans.tx_buffer = batch.tx[frame];
+        trans.rx_buffer = batch.rx[frame];
+        if (spi_device_queue_trans (device, &trans, portMAX_DELAY) != ESP_OK)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Wait until every frame of the oldest batch started has run.
+ *  @details Batches finish in the order they were started.
+ *  @param   batch The batch which was started first of those in flight
+ *  @returns @c true if every frame ran
+ */
+bool spi_adc_bus_finish (spi_adc_batch_t& batch)
+{
+    if (device == NULL)
+    {
+        return false;
+    }
+
+    for (uint16_t frame = 0; frame < batch.frames; frame++)
+    {
+        spi_transaction_t* p_done;
+        if (spi_device_get_trans_result (device, &p_done, portMAX_DELAY)
+            != ESP_OK)
+        {
+            return false;
+        }
+    }
+    return true;
+}
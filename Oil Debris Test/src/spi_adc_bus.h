@@ -0,0 +1,43 @@
+/** @file spi_adc_bus.h
+ *  This file contains the SPI transport for an external ADC. Each frame of
+ *  a batch is queued as its own transaction, so the chip select rises
+ *  between conversions as the ADCs need, and the whole batch then runs
+ *  back to back by DMA without the CPU. Two batches may be in flight, so
+ *  one can be decoded while the next converts.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _SPI_ADC_BUS_H_
+#define _SPI_ADC_BUS_H_
+
+#include <Arduino.h>
+#include "spi_adc.h"
+
+/// Number of batches which may be queued at once
+const uint8_t SPI_ADC_BATCHES_IN_FLIGHT = 2;
+
+
+/** @brief   Pins to which the external ADC is wired.
+ */
+struct spi_adc_pins_t
+{
+    uint8_t sclk;               ///< Serial clock
+    uint8_t miso;               ///< Data from the ADC
+    uint8_t mosi;               ///< Data to the ADC
+    uint8_t cs;                 ///< Chip select
+};
+
+
+// Set up the SPI bus and add the ADC to it
+bool spi_adc_bus_begin (const spi_adc_pins_t& pins, spi_adc_model_t model);
+
+// Queue every frame of a batch and return at once
+bool spi_adc_bus_start (spi_adc_batch_t& batch);
+
+// Wait until every frame of the oldest batch started has run
+bool spi_adc_bus_finish (spi_adc_batch_t& batch);
+
+#endif // _SPI_ADC_BUS_H_
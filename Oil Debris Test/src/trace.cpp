@@ -0,0 +1,243 @@
+/** @file trace.cpp
+ *  This file contains the ring of traced spans and the code which sends
+ *  them as Chrome trace-event JSON.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "trace.h"
+
+#if defined (USE_TRACE) && !defined (ARDUINO_ARCH_ESP32)
+#include <chrono>
+#include <functional>
+#include <thread>
+#endif
+
+#ifdef USE_TRACE
+/// The ring which the macros put spans into
+TraceRing trace_ring;
+#endif
+
+
+/** @brief   Make an empty ring, which takes spans at once.
+ */
+TraceRing::TraceRing (void) : head (0), recording (true)
+{
+    for (uint16_t slot = 0; slot < TRACE_RING_SPANS; slot++)
+    {
+        slots[slot].sequence.store (0, std::memory_order_relaxed);
+    }
+}
+
+
+/** @brief   Put a span into the ring, over the oldest one if it's full.
+ *  @details This may be called by any task on either core at once; it
+ *           never waits.
+ *  @param   name What ran, which must never be freed
+ *  @param   start The cycle count when it began
+ *  @param   end The cycle count when it ended
+ *  @param   task Which task it ran in
+ *  @param   cpu Which core it ran on
+ */
+void TraceRing::put (const char* name, uint32_t start, uint32_t end,
+                     uint32_t task, uint8_t cpu)
+{
+    if (!recording.load (std::memory_order_relaxed))
+    {
+        return;
+    }
+    uint32_t number = head.fetch_add (1, std::memory_order_relaxed);
+    uint16_t slot = number % TRACE_RING_SPANS;
+
+    // The slot is marked as being written before it's changed, and given
+    // the span's number when it's whole again
+    slot_t& place = slots[slot];
+    place.sequence.store (0, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+    place.start.store (start, std::memory_order_relaxed);
+    place.cycles.store (end - start, std::memory_order_relaxed);
+    place.name.store (name, std::memory_order_relaxed);
+    place.task.store (task, std::memory_order_relaxed);
+    place.cpu.store (cpu, std::memory_order_relaxed);
+    place.sequence.store (number + 1, std::memory_order_release);
+}
+
+
+/** @brief   Copy one span out of the ring.
+ *  @param   number The span's number, counting from the first ever put
+ *  @param   span Where the span is copied to
+ *  @returns @c false if the span has been overwritten, was cleared or
+ *           was being written while it was copied
+ */
+bool TraceRing::get (uint32_t number, trace_span_t& span) const
+{
+    const slot_t& place = slots[number % TRACE_RING_SPANS];
+    uint32_t before = place.sequence.load (std::memory_order_acquire);
+    span.start = place.start.load (std::memory_order_relaxed);
+    span.cycles = place.cycles.load (std::memory_order_relaxed);
+    span.name = place.name.load (std::memory_order_relaxed);
+    span.task = place.task.load (std::memory_order_relaxed);
+    span.cpu = place.cpu.load (std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_acquire);
+    uint32_t after = place.sequence.load (std::memory_order_relaxed);
+    return before == number + 1 && after == before;
+}
+
+
+/** @brief   Throw away the spans in the ring.
+ *  @details Spans being put in meanwhile may be kept or thrown away.
+ */
+void TraceRing::clear (void)
+{
+    for (uint16_t slot = 0; slot < TRACE_RING_SPANS; slot++)
+    {
+        slots[slot].sequence.store (0, std::memory_order_relaxed);
+    }
+}
+
+
+/** @brief   Turn a span's cycle count into time on one line from the
+ *           oldest span.
+ *  @details The counter wraps, so each span's count is taken as a step
+ *           forward or back from the one before it.
+ *  @param   span The span
+ *  @param   first Whether it's the first span found
+ *  @param   last The previous span's count, which is updated
+ *  @param   time The previous span's time in cycles, which is updated
+ */
+static void unwrap (const trace_span_t& span, bool first, uint32_t& last,
+                    int64_t& time)
+{
+    time = first ? 0 : time + (int32_t)(span.start - last);
+    last = span.start;
+}
+
+
+/** @brief   Write the spans in a ring as the members of a Chrome trace-event
+ *           JSON object.
+ *  @details Each span is a complete event, @c "ph":"X", in process 1 and in
+ *           the thread of its task, with its core as an argument; the tasks
+ *           are named by metadata events. Times are in microseconds from
+ *           the oldest span. The ring should be stopped from recording
+ *           while this runs, or new spans may take the place of those not
+ *           yet written.
+ *  @param   json The writer, inside an object
+ *  @param   ring The ring
+ *  @param   cycles_per_us The CPU's clock in MHz
+ *  @param   task_name Function which gives a task's name, or @c NULL
+ */
+void trace_write_json (JsonWriter& json, const TraceRing& ring,
+                       uint32_t cycles_per_us,
+                       const char* (*task_name) (uint32_t task))
+{
+    uint32_t newest = ring.get_head ();
+    uint32_t oldest = (newest > TRACE_RING_SPANS)
+                      ? newest - TRACE_RING_SPANS : 0;
+
+    // Find the earliest time, which may not be the oldest span's, and the
+    // tasks the spans ran in
+    uint32_t tasks[TRACE_MAX_TASKS];
+    uint8_t task_count = 0;
+    uint32_t kept = 0;
+    uint32_t last = 0;
+    int64_t time = 0;
+    int64_t earliest = 0;
+    trace_span_t span;
+    for (uint32_t number = oldest; number != newest; number++)
+    {
+        if (!ring.get (number, span))
+        {
+            continue;
+        }
+        unwrap (span, kept == 0, last, time);
+        earliest = (time < earliest) ? time : earliest;
+        kept++;
+
+        uint8_t task = 0;
+        while (task < task_count && tasks[task] != span.task)
+        {
+            task++;
+        }
+        if (task == task_count && task_count < TRACE_MAX_TASKS)
+        {
+            tasks[task_count++] = span.task;
+        }
+    }
+
+    json.begin_array ("traceEvents");
+    for (uint8_t task = 0; task < task_count; task++)
+    {
+        json.begin_object ();
+        json.member_string ("name", "thread_name");
+        json.member_string ("ph", "M");
+        json.member_uint ("pid", 1);
+        json.member_uint ("tid", tasks[task]);
+        json.begin_object ("args");
+        json.member_string ("name", task_name ? task_name (tasks[task])
+                                              : "task");
+        json.end_object ();
+        json.end_object ();
+    }
+
+    // Times are written in tenths of a microsecond
+    uint32_t written = 0;
+    for (uint32_t number = oldest; number != newest; number++)
+    {
+        if (!ring.get (number, span))
+        {
+            continue;
+        }
+        unwrap (span, written == 0, last, time);
+        written++;
+        int64_t tenths = (time - earliest) * 10 / cycles_per_us;
+        tenths = (tenths < INT32_MAX) ? tenths : INT32_MAX;
+
+        json.begin_object ();
+        json.member_string ("name", span.name);
+        json.member_string ("ph", "X");
+        json.member_uint ("pid", 1);
+        json.member_uint ("tid", span.task);
+        json.member_fixed ("ts", (int32_t)tenths, 1);
+        json.member_fixed ("dur", (int32_t)((uint64_t)span.cycles * 10
+                                            / cycles_per_us), 1);
+        json.begin_object ("args");
+        json.member_uint ("cpu", span.cpu);
+        json.end_object ();
+        json.end_object ();
+    }
+    json.end_array ();
+
+    json.member_string ("displayTimeUnit", "ns");
+    json.member_uint ("spans_recorded", newest);
+    json.member_uint ("spans_sent", written);
+    json.member_uint ("cycles_per_us", cycles_per_us);
+}
+
+
+#if defined (USE_TRACE) && !defined (ARDUINO_ARCH_ESP32)
+/// When the program started, from which the host's clock counts
+static const std::chrono::steady_clock::time_point trace_started
+    = std::chrono::steady_clock::now ();
+
+
+/** @brief   Get the time in nanoseconds, which stands in for the cycle
+ *           count on a PC.
+ */
+uint32_t trace_clock (void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now () - trace_started).count ();
+}
+
+
+/** @brief   Get a number for the running thread, which stands in for the
+ *           task on a PC.
+ */
+uint32_t trace_task (void)
+{
+    return (uint32_t)std::hash<std::thread::id> () (std::this_thread::
+                                                     get_id ());
+}
+#endif
@@ -0,0 +1,188 @@
+/** @file trace.h
+ *  This file contains a profiler for the tester's busiest code. A piece of
+ *  code is marked with @c TRACE_SCOPE(), or with @c TRACE_BEGIN() and
+ *  @c TRACE_END() around it, and each time it runs its start and length in
+ *  CPU cycles, read from the core's CCOUNT register, go into a ring along
+ *  with the task and core it ran on. Any task on either core may add spans
+ *  without locks; the ring keeps the newest @c TRACE_RING_SPANS of them.
+ *  @c /trace sends them as Chrome trace-event JSON, which Perfetto
+ *  (ui.perfetto.dev) or @c chrome://tracing show as a timeline.
+ *
+ *  Tracing is only built when @c USE_TRACE is defined for every file, in
+ *  the @c build_flags in @c platformio.ini. Otherwise the macros are empty,
+ *  and neither the ring nor @c /trace is built, so tracing costs nothing.
+ *
+ *  Each core has a cycle counter of its own; the two start together but
+ *  aren't kept in step, so spans on different cores may be a little out
+ *  of line. The counters run at the CPU's clock and stop in light sleep,
+ *  so the times are wrong with @c USE_LOW_POWER. A counter wraps every
+ *  18 seconds at 240 MHz, which is allowed for as long as spans come more
+ *  often than every 8 seconds, as the sensor task's do.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include "json_writer.h"
+
+/// Spans kept in the ring, a power of two; at 100 readings per second
+/// this is a few seconds of the sensor task and whatever ran beside it
+const uint16_t TRACE_RING_SPANS = 512;
+
+/// The most tasks named in an export
+const uint8_t TRACE_MAX_TASKS = 16;
+
+
+/** @brief   One run of a traced piece of code.
+ */
+struct trace_span_t
+{
+    uint32_t start;             ///< Cycle count when it began
+    uint32_t cycles;            ///< Cycles it took
+    const char* name;           ///< What ran, which must never be freed
+    uint32_t task;              ///< Which task it ran in
+    uint8_t cpu;                ///< Which core it ran on
+};
+
+
+/** @brief   Class which keeps the newest spans, which any task may add.
+ *  @details A span's slot is claimed by counting up the head, so writers
+ *           never wait for each other. Each slot has a sequence number,
+ *           which is cleared while the slot is written and then set to
+ *           the span's number plus one, so a reader can tell a whole span
+ *           from one half overwritten. The slot's parts are atomic only so
+ *           that the reader's copy is well defined; on the ESP32 they are
+ *           read and written as plain words. A span is lost if its writer
+ *           is held up while the whole ring is filled again.
+ */
+class TraceRing
+{
+protected:
+    /// Where one span is kept
+    struct slot_t
+    {
+        std::atomic<uint32_t> sequence;     ///< Span's number plus one
+        std::atomic<uint32_t> start;        ///< Cycle count when it began
+        std::atomic<uint32_t> cycles;       ///< Cycles it took
+        std::atomic<const char*> name;      ///< What ran
+        std::atomic<uint32_t> task;         ///< Which task it ran in
+        std::atomic<uint8_t> cpu;           ///< Which core it ran on
+    };
+
+    slot_t slots[TRACE_RING_SPANS];     ///< The ring
+    std::atomic<uint32_t> head;         ///< Spans ever put into the ring
+    std::atomic<bool> recording;        ///< Spans are being taken
+
+public:
+    TraceRing (void);
+
+    void put (const char* name, uint32_t start, uint32_t end, uint32_t task,
+              uint8_t cpu);
+    bool get (uint32_t number, trace_span_t& span) const;
+    void clear (void);
+
+    /// Start or stop taking spans, such as while they're being sent
+    void set_recording (bool on)
+    {
+        recording.store (on, std::memory_order_relaxed);
+    }
+
+    /// Get the number of spans ever put into the ring
+    uint32_t get_head (void) const
+    {
+        return head.load (std::memory_order_acquire);
+    }
+};
+
+// Write the spans in a ring as Chrome trace-event JSON
+void trace_write_json (JsonWriter& json, const TraceRing& ring,
+                       uint32_t cycles_per_us,
+                       const char* (*task_name) (uint32_t task));
+
+
+#ifdef USE_TRACE
+
+/// The ring which the macros put spans into
+extern TraceRing trace_ring;
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <Arduino.h>
+
+/// Read the running core's cycle counter
+inline uint32_t trace_clock (void)
+{
+    return ESP.getCycleCount ();
+}
+
+/// Get the running task, as a number
+inline uint32_t trace_task (void)
+{
+    return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle ();
+}
+
+/// Get the running core
+inline uint8_t trace_cpu (void)
+{
+    return xPortGetCoreID ();
+}
+#else
+// On a PC, nanoseconds stand in for cycles and threads for tasks
+uint32_t trace_clock (void);
+uint32_t trace_task (void);
+inline uint8_t trace_cpu (void) { return 0; }
+#endif
+
+/** @brief   Put a span which began at a given cycle count and ends now
+ *           into the ring.
+ *  @param   name What ran, which must never be freed
+ *  @param   start The cycle count when it began
+ */
+inline void trace_span (const char* name, uint32_t start)
+{
+    trace_ring.put (name, start, trace_clock (), trace_task (), trace_cpu ());
+}
+
+
+/** @brief   Class which traces the rest of the block it's made in.
+ */
+class TraceScope
+{
+protected:
+    const char* name;           ///< What runs in the block
+    uint32_t start;             ///< Cycle count when the block began
+
+public:
+    /// Start a span when the block begins
+    TraceScope (const char* name) : name (name), start (trace_clock ()) { }
+
+    /// End the span when the block ends
+    ~TraceScope (void) { trace_span (name, start); }
+};
+
+#define TRACE_JOIN2(a, b) a ## b
+#define TRACE_JOIN(a, b) TRACE_JOIN2 (a, b)
+
+/// Trace the rest of the block, under the given name
+#define TRACE_SCOPE(name) TraceScope TRACE_JOIN (trace_scope_, __LINE__) (name)
+
+/// Start a span, which @c TRACE_END() with the same label ends
+#define TRACE_BEGIN(label) uint32_t label ## _trace_start = trace_clock ()
+
+/// End the span which @c TRACE_BEGIN() began, under the given name
+#define TRACE_END(label, name) trace_span (name, label ## _trace_start)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(label) ((void)0)
+#define TRACE_END(label, name) ((void)0)
+
+#endif // USE_TRACE
+
+#endif // _TRACE_H_
@@ -0,0 +1,162 @@
+/** @file ulp_ring.cpp
+ *  This file contains the main CPUs' side of the ULP ring, and an emulation
+ *  of the ULP program's side which follows it step for step.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "ulp_ring.h"
+
+
+/** @brief   Create an object to read the ring in a data block.
+ *  @param   data Pointer to @c ULP_DATA_WORDS words of RTC memory
+ */
+UlpRing::UlpRing (volatile uint32_t* data)
+    : data (data), seen_dropped (0), seen_events (0)
+{
+}
+
+
+/** @brief   Empty the ring and clear its counts.
+ *  @details This must be called before the ULP program is started. The
+ *           thresholds are set as high as they go, so that nothing wakes
+ *           the CPUs but a full ring until @c set_thresholds() is called.
+ */
+void UlpRing::reset (void)
+{
+    for (size_t index = 0; index < ULP_DATA_WORDS; index++)
+    {
+        data[index] = 0;
+    }
+    data[ULP_ARMED] = 1;
+    data[ULP_THRESH_FINE] = 0xFFFF;
+    data[ULP_THRESH_COARSE] = 0xFFFF;
+    seen_dropped = 0;
+    seen_events = 0;
+}
+
+
+/** @brief   Set the readings at or above which the ULP wakes the CPUs.
+ *  @details The ULP wakes them once as readings cross a threshold and not
+ *           again until readings have fallen back below both.
+ *  @param   fine The fine channel's threshold in ADC counts
+ *  @param   coarse The coarse channel's threshold in ADC counts
+ */
+void UlpRing::set_thresholds (uint16_t fine, uint16_t coarse)
+{
+    data[ULP_THRESH_FINE] = fine;
+    data[ULP_THRESH_COARSE] = coarse;
+}
+
+
+/** @brief   Get the number of readings waiting in the ring.
+ */
+uint16_t UlpRing::available (void) const
+{
+    return (get (ULP_HEAD) - get (ULP_TAIL)) & ULP_RING_MASK;
+}
+
+
+/** @brief   Take the oldest reading from the ring.
+ *  @param   fine Set to the fine channel's reading
+ *  @param   coarse Set to the coarse channel's reading
+ *  @returns @c true if there was a reading to take
+ */
+bool UlpRing::pop (uint16_t& fine, uint16_t& coarse)
+{
+    uint16_t tail = get (ULP_TAIL);
+    if (tail == get (ULP_HEAD))
+    {
+        return false;
+    }
+    fine = get (ULP_RING + 2 * tail);
+    coarse = get (ULP_RING + 2 * tail + 1);
+    data[ULP_TAIL] = (tail + 1) & ULP_RING_MASK;
+    return true;
+}
+
+
+/** @brief   Get the number of readings the ULP has had to throw away for
+ *           lack of room since this was last called.
+ */
+uint16_t UlpRing::new_drops (void)
+{
+    uint16_t dropped = get (ULP_DROPPED);
+    uint16_t count = dropped - seen_dropped;
+    seen_dropped = dropped;
+    return count;
+}
+
+
+/** @brief   Get the number of threshold crossings the ULP has seen since
+ *           this was last called.
+ */
+uint16_t UlpRing::new_events (void)
+{
+    uint16_t events = get (ULP_EVENTS);
+    uint16_t count = events - seen_events;
+    seen_events = events;
+    return count;
+}
+
+
+/** @brief   Do what one run of the ULP program does.
+ *  @details This follows the program built in @c ulp_sampler.cpp
+ *           instruction for instruction, with the ADC readings passed in,
+ *           so the hand-off can be tested on a PC. Keep the two in step.
+ *  @param   data The data block
+ *  @param   fine The fine channel's ADC reading
+ *  @param   coarse The coarse channel's ADC reading
+ *  @param   cpu_asleep Whether the main CPUs are asleep and so can be woken
+ *  @returns @c true if the program would wake the main CPUs
+ */
+bool ulp_ring_emulate (volatile uint32_t* data, uint16_t fine,
+                       uint16_t coarse, bool cpu_asleep)
+{
+    bool wake = false;
+    data[ULP_LAST_FINE] = fine;
+    data[ULP_LAST_COARSE] = coarse;
+
+    // Store the readings unless the ring is full, in which case count them
+    uint16_t head = data[ULP_HEAD] & 0xFFFF;
+    uint16_t waiting = (head - (data[ULP_TAIL] & 0xFFFF)) & ULP_RING_MASK;
+    if (waiting >= ULP_RING_SAMPLES - 1)
+    {
+        data[ULP_DROPPED] = (data[ULP_DROPPED] + 1) & 0xFFFF;
+    }
+    else
+    {
+        data[ULP_RING + 2 * head] = fine;
+        data[ULP_RING + 2 * head + 1] = coarse;
+        data[ULP_HEAD] = (head + 1) & ULP_RING_MASK;
+    }
+
+    // Wake once on crossing either threshold; arm again below both
+    if (fine >= (data[ULP_THRESH_FINE] & 0xFFFF)
+        || coarse >= (data[ULP_THRESH_COARSE] & 0xFFFF))
+    {
+        if (data[ULP_ARMED] & 0xFFFF)
+        {
+            data[ULP_ARMED] = 0;
+            data[ULP_EVENTS] = (data[ULP_EVENTS] + 1) & 0xFFFF;
+            wake = true;
+        }
+    }
+    else
+    {
+        data[ULP_ARMED] = 1;
+    }
+
+    // Wake when the ring is filling up
+    waiting = ((data[ULP_HEAD] & 0xFFFF) - (data[ULP_TAIL] & 0xFFFF))
+              & ULP_RING_MASK;
+    if (waiting >= ULP_WAKE_LEVEL)
+    {
+        wake = true;
+    }
+
+    // The ULP can only wake CPUs which are asleep
+    return wake && cpu_asleep;
+}
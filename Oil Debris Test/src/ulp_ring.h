@@ -0,0 +1,81 @@
+/** @file ulp_ring.h
+ *  This file contains the ring buffer through which the ULP coprocessor
+ *  hands readings to the main CPUs. The ring lives in RTC slow memory, which
+ *  the ULP can reach while the main CPUs sleep. The ULP can only write the
+ *  low 16 bits of each 32-bit word there, so every field is a whole word of
+ *  which only the low half counts.
+ *
+ *  Nothing here touches hardware, so the hand-off can be built and tested
+ *  on a PC with @c ulp_ring_emulate() standing in for the ULP program.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _ULP_RING_H_
+#define _ULP_RING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Number of samples the ring holds; a power of two, since the ULP wraps
+/// its index with a mask. One slot is always kept empty.
+const uint16_t ULP_RING_SAMPLES = 256;
+
+/// Mask which wraps a ring index
+const uint16_t ULP_RING_MASK = ULP_RING_SAMPLES - 1;
+
+/// Number of waiting samples at which the ULP wakes the main CPUs, leaving
+/// the rest of the ring for the time they take to wake and drain it
+const uint16_t ULP_WAKE_LEVEL = 192;
+
+/// Word offsets of the fields at the start of the ULP's data block
+enum ulp_field_t : uint8_t
+{
+    ULP_HEAD = 0,               ///< Next slot the ULP writes; ULP only
+    ULP_TAIL = 1,               ///< Next slot the CPU reads; CPU only
+    ULP_DROPPED = 2,            ///< Readings lost to a full ring; ULP only
+    ULP_EVENTS = 3,             ///< Threshold crossings seen; ULP only
+    ULP_ARMED = 4,              ///< 1 once readings fall below the thresholds
+    ULP_THRESH_FINE = 5,        ///< Fine reading which wakes the CPU; CPU only
+    ULP_THRESH_COARSE = 6,      ///< Coarse reading which does; CPU only
+    ULP_LAST_FINE = 7,          ///< Scratch for the ULP's fine reading
+    ULP_LAST_COARSE = 8,        ///< Scratch for the ULP's coarse reading
+    ULP_RING = 16               ///< Fine, coarse pairs of the ring start here
+};
+
+/// Number of 32-bit words in the whole data block
+const size_t ULP_DATA_WORDS = ULP_RING + 2 * ULP_RING_SAMPLES;
+
+
+/** @brief   Class with which the main CPUs take readings from the ULP's ring.
+ *  @details The ULP only ever writes the head and the CPU only the tail, so
+ *           no lock is needed between them.
+ */
+class UlpRing
+{
+protected:
+    volatile uint32_t* data;    ///< The data block in RTC memory
+    uint16_t seen_dropped;      ///< Dropped count when last checked
+    uint16_t seen_events;       ///< Event count when last checked
+
+    /// Read the low 16 bits of a field, which are all that the ULP writes
+    uint16_t get (uint16_t field) const { return data[field] & 0xFFFF; }
+
+public:
+    UlpRing (volatile uint32_t* data);
+
+    void reset (void);
+    void set_thresholds (uint16_t fine, uint16_t coarse);
+    uint16_t available (void) const;
+    bool pop (uint16_t& fine, uint16_t& coarse);
+    uint16_t new_drops (void);
+    uint16_t new_events (void);
+};
+
+// Do what one run of the ULP program does, for testing on a PC
+bool ulp_ring_emulate (volatile uint32_t* data, uint16_t fine,
+                       uint16_t coarse, bool cpu_asleep);
+
+#endif // _ULP_RING_H_
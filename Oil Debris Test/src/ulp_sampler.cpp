@@ -0,0 +1,166 @@
+/** @file ulp_sampler.cpp
+ *  This file contains the ULP program, built from the macros in
+ *  @c esp32/ulp.h, and the code which loads and starts it. The program
+ *  does just what @c ulp_ring_emulate() does; a change to one must be made
+ *  to the other, so that tests of the emulation still say something about
+ *  the program.
+ *
+ *  R3 holds the address of the data block throughout. The ULP addresses
+ *  RTC slow memory in 32-bit words, and its loads and stores use the low
+ *  16 bits of each word.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <esp32/ulp.h>
+#include <driver/adc.h>
+#include <soc/rtc_cntl_reg.h>
+#include <esp_sleep.h>
+#include "ulp_sampler.h"
+
+/// The data block shared with the ULP; RTC slow memory keeps its contents
+/// through sleep and the ULP can reach it
+static RTC_SLOW_ATTR uint32_t ulp_data[ULP_DATA_WORDS];
+
+/// The main CPUs' view of the ring
+static UlpRing ring (ulp_data);
+
+/// Labels in the ULP program
+enum ulp_label_t
+{
+    L_STORE,                    ///< The ring has room for the readings
+    L_CHECK,                    ///< Compare the readings to the thresholds
+    L_FINE_BELOW,               ///< The fine reading is below its threshold
+    L_ABOVE,                    ///< A reading is at or above its threshold
+    L_BELOW,                    ///< Both readings are below their thresholds
+    L_LEVEL,                    ///< See whether the ring is filling up
+    L_WAKE,                     ///< Wake the main CPUs if they're asleep
+    L_DONE                      ///< Halt until the timer next fires
+};
+
+
+/** @brief   Load the ULP program and start it reading the sensors.
+ *  @details The ring is emptied and its thresholds set so that only a full
+ *           ring wakes the CPUs until the caller sets them. The ULP is also
+ *           made a wakeup source for light sleep.
+ *  @param   period_us Time between readings in microseconds
+ *  @returns @c true if the program was loaded and started
+ */
+bool ulp_sampler_begin (uint32_t period_us)
+{
+    // The ULP addresses words from the start of RTC slow memory
+    uint16_t base = (uint16_t)(((uintptr_t)ulp_data - (uintptr_t)RTC_SLOW_MEM)
+                               / sizeof (uint32_t));
+
+    const ulp_insn_t program[] =
+    {
+        I_MOVI (R3, base),
+
+        // Read both sensors and keep the readings
+        I_ADC (R1, 0, ULP_FINE_CHANNEL),
+        I_ADC (R2, 0, ULP_COARSE_CHANNEL),
+        I_ST (R1, R3, ULP_LAST_FINE),
+        I_ST (R2, R3, ULP_LAST_COARSE),
+
+        // If the ring is full, count the readings as dropped
+        I_LD (R0, R3, ULP_HEAD),
+        I_LD (R1, R3, ULP_TAIL),
+        I_SUBR (R0, R0, R1),
+        I_ANDI (R0, R0, ULP_RING_MASK),
+        M_BL (L_STORE, ULP_RING_SAMPLES - 1),
+        I_LD (R0, R3, ULP_DROPPED),
+        I_ADDI (R0, R0, 1),
+        I_ST (R0, R3, ULP_DROPPED),
+        M_BX (L_CHECK),
+
+        // Otherwise put them at the head of the ring and move the head on
+        M_LABEL (L_STORE),
+        I_LD (R0, R3, ULP_HEAD),
+        I_LSHI (R2, R0, 1),
+        I_ADDR (R2, R2, R3),
+        I_LD (R1, R3, ULP_LAST_FINE),
+        I_ST (R1, R2, ULP_RING),
+        I_LD (R1, R3, ULP_LAST_COARSE),
+        I_ST (R1, R2, ULP_RING + 1),
+        I_ADDI (R0, R0, 1),
+        I_ANDI (R0, R0, ULP_RING_MASK),
+        I_ST (R0, R3, ULP_HEAD),
+
+        // A subtraction which goes below zero sets the overflow flag, so
+        // it means the reading is below the threshold
+        M_LABEL (L_CHECK),
+        I_LD (R1, R3, ULP_LAST_FINE),
+        I_LD (R2, R3, ULP_THRESH_FINE),
+        I_SUBR (R0, R1, R2),
+        M_BXF (L_FINE_BELOW),
+        M_BX (L_ABOVE),
+        M_LABEL (L_FINE_BELOW),
+        I_LD (R1, R3, ULP_LAST_COARSE),
+        I_LD (R2, R3, ULP_THRESH_COARSE),
+        I_SUBR (R0, R1, R2),
+        M_BXF (L_BELOW),
+
+        // At or above a threshold: wake once, then wait to be armed again
+        M_LABEL (L_ABOVE),
+        I_LD (R0, R3, ULP_ARMED),
+        M_BL (L_LEVEL, 1),
+        I_MOVI (R0, 0),
+        I_ST (R0, R3, ULP_ARMED),
+        I_LD (R0, R3, ULP_EVENTS),
+        I_ADDI (R0, R0, 1),
+        I_ST (R0, R3, ULP_EVENTS),
+        M_BX (L_WAKE),
+
+        M_LABEL (L_BELOW),
+        I_MOVI (R0, 1),
+        I_ST (R0, R3, ULP_ARMED),
+
+        // Wake the CPUs when the ring is filling up
+        M_LABEL (L_LEVEL),
+        I_LD (R0, R3, ULP_HEAD),
+        I_LD (R1, R3, ULP_TAIL),
+        I_SUBR (R0, R0, R1),
+        I_ANDI (R0, R0, ULP_RING_MASK),
+        M_BL (L_DONE, ULP_WAKE_LEVEL),
+
+        // Only CPUs which are asleep can be woken
+        M_LABEL (L_WAKE),
+        I_RD_REG (RTC_CNTL_LOW_POWER_ST_REG, RTC_CNTL_RDY_FOR_WAKEUP_S,
+                  RTC_CNTL_RDY_FOR_WAKEUP_S),
+        M_BL (L_DONE, 1),
+        I_WAKE (),
+
+        M_LABEL (L_DONE),
+        I_HALT ()
+    };
+
+    ring.reset ();
+
+    // The ULP reads with the same range as analogRead() did
+    adc1_config_width (ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten ((adc1_channel_t)ULP_FINE_CHANNEL,
+                               ADC_ATTEN_DB_11);
+    adc1_config_channel_atten ((adc1_channel_t)ULP_COARSE_CHANNEL,
+                               ADC_ATTEN_DB_11);
+    adc1_ulp_enable ();
+
+    size_t size = sizeof (program) / sizeof (ulp_insn_t);
+    if (ulp_process_macros_and_load (0, program, &size) != ESP_OK)
+    {
+        return false;
+    }
+    ulp_set_wakeup_period (0, period_us);
+    esp_sleep_enable_ulp_wakeup ();
+
+    return ulp_run (0) == ESP_OK;
+}
+
+
+/** @brief   Get the ring into which the ULP puts its readings.
+ */
+UlpRing& ulp_sampler_ring (void)
+{
+    return ring;
+}
@@ -0,0 +1,36 @@
+/** @file ulp_sampler.h
+ *  This file contains the ULP coprocessor program which reads the fine and
+ *  coarse sensors while the main CPUs sleep. Each time its timer fires, the
+ *  ULP reads both channels of ADC1, puts the readings into the ring in RTC
+ *  memory described in @c ulp_ring.h and halts again. It wakes the main
+ *  CPUs only when a reading crosses a threshold or the ring is filling up,
+ *  so they can sleep through many readings at a time.
+ *
+ *  Once the ULP owns ADC1, @c analogRead() can't be used on its channels;
+ *  every reading must come from the ring.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _ULP_SAMPLER_H_
+#define _ULP_SAMPLER_H_
+
+#include <Arduino.h>
+#include "ulp_ring.h"
+
+/// ADC1 channel of the fine sensor, on GPIO 36
+const uint8_t ULP_FINE_CHANNEL = 0;
+
+/// ADC1 channel of the coarse sensor, on GPIO 39
+const uint8_t ULP_COARSE_CHANNEL = 3;
+
+
+// Load the ULP program and start it reading every so many microseconds
+bool ulp_sampler_begin (uint32_t period_us);
+
+// Get the ring into which the ULP puts its readings
+UlpRing& ulp_sampler_ring (void);
+
+#endif // _ULP_SAMPLER_H_
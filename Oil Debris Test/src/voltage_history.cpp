@@ -0,0 +1,93 @@
+/** @file voltage_history.cpp
+ *  This file contains a compressed history of calibrated wear voltages. Two
+ *  Gorilla blocks are used in turn: when the active block fills up, the
+ *  other one is cleared and becomes active, so at least one full block of
+ *  history is always available.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include "gorilla.h"
+#include "channels.h"
+#include "sample_pipeline.h"
+#include "voltage_history.h"
+
+static_assert (PIPELINE_MAX_CHANNELS <= GORILLA_MAX_COLUMNS,
+               "The history needs a column for every channel");
+
+/// Memory for the two blocks of compressed history
+static uint8_t history_buffers[2][HISTORY_BLOCK_SIZE];
+
+/// Encoders for the two blocks, each with a column for every channel
+static GorillaEncoder history_blocks[2] =
+{
+    GorillaEncoder (history_buffers[0], HISTORY_BLOCK_SIZE, CHANNEL_COUNT),
+    GorillaEncoder (history_buffers[1], HISTORY_BLOCK_SIZE, CHANNEL_COUNT)
+};
+
+/// Index of the block to which new rows are being added
+static uint8_t history_active = 0;
+
+/// Mutex which keeps the web server from copying a half-written row
+static SemaphoreHandle_t history_mutex = NULL;
+
+
+/** @brief   Create the mutex which protects the history.
+ *  @details This must be called before the sensor and web server tasks start.
+ */
+void history_init (void)
+{
+    history_mutex = xSemaphoreCreateMutex ();
+}
+
+
+/** @brief   Add one voltage for each channel to the history.
+ *  @param   time The time at which the readings were taken in milliseconds
+ *  @param   volts Pointer to the voltages, one for each of the
+ *           @c CHANNEL_COUNT channels, in the order of the channel table
+ */
+void history_append (uint32_t time, const float* volts)
+{
+    xSemaphoreTake (history_mutex, portMAX_DELAY);
+    if (!history_blocks[history_active].append (time, volts))
+    {
+        // The active block is full, so recycle the older one
+        history_active ^= 1;
+        history_blocks[history_active].reset ();
+        history_blocks[history_active].append (time, volts);
+    }
+    xSemaphoreGive (history_mutex);
+}
+
+
+/** @brief   Copy the whole history into a buffer.
+ *  @details The older block is copied first, followed directly by the active
+ *           one. Each block records its own size in its header, so the
+ *           receiver can split them apart.
+ *  @param   buffer Pointer to memory into which the blocks are copied; it
+ *           should hold @c 2 * HISTORY_BLOCK_SIZE bytes
+ *  @param   size The size of the buffer in bytes
+ *  @returns The number of bytes copied
+ */
+size_t history_snapshot (uint8_t* buffer, size_t size)
+{
+    size_t used = 0;
+
+    xSemaphoreTake (history_mutex, portMAX_DELAY);
+    for (uint8_t which = 1; which <= 2; which++)
+    {
+        const GorillaEncoder& block = history_blocks[(history_active + which)
+                                                     & 1];
+        if (block.count () > 0 && used + block.size () <= size)
+        {
+            memcpy (buffer + used, block.data (), block.size ());
+            used += block.size ();
+        }
+    }
+    xSemaphoreGive (history_mutex);
+
+    return used;
+}
@@ -0,0 +1,30 @@
+/** @file voltage_history.h
+ *  This file contains the interface to a compressed history of calibrated
+ *  voltages kept in RAM, with a column for each channel in the table of
+ *  @c channels.h. The processing task adds a row for every block, and the
+ *  web server sends the history as Gorilla blocks.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _VOLTAGE_HISTORY_H_
+#define _VOLTAGE_HISTORY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Size in bytes of each of the two blocks of compressed history
+const size_t HISTORY_BLOCK_SIZE = 8192;
+
+// Create the blocks and the mutex which protects them
+void history_init (void);
+
+// Add one voltage for each channel to the history
+void history_append (uint32_t time, const float* volts);
+
+// Copy the whole history, oldest block first, into a buffer
+size_t history_snapshot (uint8_t* buffer, size_t size);
+
+#endif // _VOLTAGE_HISTORY_H_
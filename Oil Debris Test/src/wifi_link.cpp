@@ -0,0 +1,255 @@
+/** @file wifi_link.cpp
+ *  This file contains the state machine which brings up the WiFi
+ *  connection and keeps it up. The WiFi driver's own reconnecting is turned
+ *  off so that there is one place which decides when to try again.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include "wifi_link.h"
+
+/// The one link to which the driver's events are passed
+static WifiLink* p_the_link = NULL;
+
+
+/** @brief   Create a link which hasn't been started.
+ */
+WifiLink::WifiLink (void)
+    : ssid (NULL), password (NULL), on_up (NULL), on_down (NULL),
+      got_ip (false), lost (false), suspended (false), state (WIFI_IDLE),
+      state_since (0), down_since (0), backoff_ms (0), wait_ms (0), stats ()
+{
+}
+
+
+/** @brief   Start connecting to a network in the background.
+ *  @details This returns at once; the first attempt is made by the next
+ *           call to @c run().
+ *  @param   ssid The name of the network
+ *  @param   password The network's password
+ *  @param   on_up A function to call each time the connection comes up, or
+ *           @c NULL
+ *  @param   on_down A function to call each time it's lost, or @c NULL
+ */
+void WifiLink::begin (const char* ssid, const char* password,
+                      wifi_callback_t on_up, wifi_callback_t on_down)
+{
+    this->ssid = ssid;
+    this->password = password;
+    this->on_up = on_up;
+    this->on_down = on_down;
+    p_the_link = this;
+
+    WiFi.mode (WIFI_STA);
+    WiFi.setAutoReconnect (false);
+    WiFi.onEvent (on_event, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent (on_event, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+
+    state = WIFI_IDLE;
+    down_since = millis ();
+}
+
+
+/** @brief   Note events from the WiFi driver for @c run() to act on.
+ *  @details This runs in the driver's event task, so it only sets flags.
+ *  @param   event Which event happened
+ */
+void WifiLink::on_event (arduino_event_id_t event)
+{
+    if (p_the_link == NULL)
+    {
+        return;
+    }
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+    {
+        p_the_link->got_ip = true;
+    }
+    else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+    {
+        p_the_link->lost = true;
+    }
+}
+
+
+/** @brief   Ask the WiFi driver to connect.
+ *  @param   now The time in milliseconds
+ */
+void WifiLink::start_attempt (uint32_t now)
+{
+    lost = false;
+    WiFi.begin (ssid, password);
+    stats.attempts++;
+    state = WIFI_CONNECTING;
+    state_since = now;
+}
+
+
+/** @brief   Give up on an attempt and wait longer than last time before the
+ *           next one.
+ *  @param   now The time in milliseconds
+ */
+void WifiLink::fail_attempt (uint32_t now)
+{
+    WiFi.disconnect ();
+
+    backoff_ms = (backoff_ms == 0) ? WIFI_BACKOFF_MIN_MS : backoff_ms * 2;
+    if (backoff_ms > WIFI_BACKOFF_MAX_MS)
+    {
+        backoff_ms = WIFI_BACKOFF_MAX_MS;
+    }
+    wait_ms = backoff_ms + random (backoff_ms / 4 + 1);
+
+    state = WIFI_BACKOFF;
+    state_since = now;
+}
+
+
+/** @brief   Move the connection along: notice what the driver reported,
+ *           give up on attempts which take too long and retry when it's time.
+ *  @details The callbacks are called from here, so they run in the caller's
+ *           task and may take their time.
+ */
+void WifiLink::run (void)
+{
+    if (suspended)
+    {
+        got_ip = false;
+        lost = false;
+        return;
+    }
+    uint32_t now = millis ();
+
+    // An address counts only if the driver still has the connection; the
+    // flag may have been set just before the connection was lost again
+    if (got_ip)
+    {
+        got_ip = false;
+        if (state != WIFI_CONNECTED && WiFi.status () == WL_CONNECTED)
+        {
+            uint32_t outage = now - down_since;
+            stats.connects++;
+            if (stats.connects == 1)
+            {
+                stats.first_connect_ms = now;
+            }
+            stats.last_outage_ms = outage;
+            stats.total_outage_ms += outage;
+            if (outage > stats.max_outage_ms)
+            {
+                stats.max_outage_ms = outage;
+            }
+
+            lost = false;
+            backoff_ms = 0;
+            state = WIFI_CONNECTED;
+            state_since = now;
+            if (on_up != NULL)
+            {
+                on_up ();
+            }
+        }
+    }
+
+    if (lost)
+    {
+        lost = false;
+        if (state == WIFI_CONNECTED)
+        {
+            // Retry at once after losing a working connection; the backoff
+            // is for networks which keep refusing us
+            stats.disconnects++;
+            down_since = now;
+            backoff_ms = 0;
+            if (on_down != NULL)
+            {
+                on_down ();
+            }
+            start_attempt (now);
+        }
+        else if (state == WIFI_CONNECTING)
+        {
+            fail_attempt (now);
+        }
+    }
+
+    switch (state)
+    {
+        case WIFI_IDLE:
+            if (ssid != NULL)
+            {
+                start_attempt (now);
+            }
+            break;
+
+        case WIFI_CONNECTING:
+            if (now - state_since >= WIFI_CONNECT_TIMEOUT_MS)
+            {
+                fail_attempt (now);
+            }
+            break;
+
+        case WIFI_BACKOFF:
+            if (now - state_since >= wait_ms)
+            {
+                start_attempt (now);
+            }
+            break;
+
+        case WIFI_CONNECTED:
+            break;
+    }
+}
+
+
+/** @brief   Turn the radio off on purpose, as the low-power mode does
+ *           between its radio windows.
+ *  @details Nothing is tried until @c resume() is called, and the time off
+ *           doesn't count as an outage. This and @c resume() must be called
+ *           from the task which calls @c run().
+ */
+void WifiLink::suspend (void)
+{
+    suspended = true;
+    WiFi.disconnect (true);
+    state = WIFI_IDLE;
+    state_since = millis ();
+}
+
+
+/** @brief   Turn the radio back on and connect again after @c suspend().
+ */
+void WifiLink::resume (void)
+{
+    WiFi.mode (WIFI_STA);
+    got_ip = false;
+    lost = false;
+    backoff_ms = 0;
+    down_since = millis ();
+    state = WIFI_IDLE;
+    suspended = false;
+}
+
+
+/** @brief   Get the name of the connection's state, for diagnostics.
+ *  @returns A short name such as @c "connected"
+ */
+const char* WifiLink::state_name (void) const
+{
+    switch (state)
+    {
+        case WIFI_CONNECTING:
+            return "connecting";
+        case WIFI_CONNECTED:
+            return "connected";
+        case WIFI_BACKOFF:
+            return "waiting to retry";
+        default:
+            if (suspended)
+            {
+                return "off";
+            }
+            return "idle";
+    }
+}
@@ -0,0 +1,110 @@
+/** @file wifi_link.h
+ *  This file contains a class which keeps the ESP32 connected to an existing
+ *  WiFi network without ever making anyone wait for it. Connecting and
+ *  reconnecting happen in the background, with a growing delay between
+ *  failed attempts, so that sampling can start at once and carry on through
+ *  any number of outages.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#ifndef _WIFI_LINK_H_
+#define _WIFI_LINK_H_
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+/// Longest an attempt to connect may take before it's given up
+const uint32_t WIFI_CONNECT_TIMEOUT_MS = 15000;
+
+/// Delay before retrying after the first failed attempt
+const uint32_t WIFI_BACKOFF_MIN_MS = 500;
+
+/// Longest delay between attempts, however many have failed
+const uint32_t WIFI_BACKOFF_MAX_MS = 30000;
+
+
+/** @brief   The states through which the connection goes.
+ */
+enum wifi_state_t : uint8_t
+{
+    WIFI_IDLE,                  ///< Not started yet
+    WIFI_CONNECTING,            ///< Waiting for an attempt to get an address
+    WIFI_CONNECTED,             ///< Connected, with an IP address
+    WIFI_BACKOFF                ///< Waiting to try again after a failure
+};
+
+
+/** @brief   Counts kept by the connection, shown on the diagnostics page.
+ *  @details An outage runs from losing the connection, or from startup for
+ *           the first one, until an IP address is had again.
+ */
+struct wifi_stats_t
+{
+    uint32_t attempts;          ///< Attempts made to connect
+    uint32_t connects;          ///< Times an IP address was had
+    uint32_t disconnects;       ///< Times a working connection was lost
+    uint32_t first_connect_ms;  ///< Time from startup to the first address
+    uint32_t last_outage_ms;    ///< Length of the latest outage
+    uint32_t max_outage_ms;     ///< Length of the longest outage
+    uint32_t total_outage_ms;   ///< Time spent without a connection
+};
+
+/// Type of the functions called when the connection comes up or goes down
+typedef void (*wifi_callback_t) (void);
+
+
+/** @brief   Class which connects to a WiFi network and reconnects after
+ *           outages, never blocking the caller.
+ *  @details The WiFi driver's events only set flags; all the work, and the
+ *           callbacks, happen in @c run(), which should be called every
+ *           hundred milliseconds or so from a low-priority task. After each
+ *           failed attempt the delay before the next one doubles, up to
+ *           @c WIFI_BACKOFF_MAX_MS, with a little randomness added so that a
+ *           room full of testers doesn't retry in lockstep.
+ */
+class WifiLink
+{
+protected:
+    const char* ssid;                   ///< Name of the network
+    const char* password;               ///< Password for the network
+    wifi_callback_t on_up;              ///< Called when an address is had
+    wifi_callback_t on_down;            ///< Called when it's lost
+    volatile bool got_ip;               ///< The driver reported an address
+    volatile bool lost;                 ///< The driver reported a disconnect
+    volatile bool suspended;            ///< Radio turned off on purpose
+    wifi_state_t state;                 ///< Where the connection stands
+    uint32_t state_since;               ///< When the state was entered
+    uint32_t down_since;                ///< When the outage began
+    uint32_t backoff_ms;                ///< Delay after the last failure
+    uint32_t wait_ms;                   ///< Delay, with randomness, to wait
+    wifi_stats_t stats;                 ///< Counts for diagnostics
+
+    static void on_event (arduino_event_id_t event);
+    void start_attempt (uint32_t now);
+    void fail_attempt (uint32_t now);
+
+public:
+    WifiLink (void);
+
+    void begin (const char* ssid, const char* password,
+                wifi_callback_t on_up = NULL, wifi_callback_t on_down = NULL);
+    void run (void);
+    void suspend (void);
+    void resume (void);
+
+    /// Get the state of the connection
+    wifi_state_t get_state (void) const { return state; }
+
+    /// Find out whether the network can be used
+    bool is_connected (void) const { return state == WIFI_CONNECTED; }
+
+    /// Get a copy of the connection's counts
+    wifi_stats_t get_stats (void) const { return stats; }
+
+    const char* state_name (void) const;
+};
+
+#endif // _WIFI_LINK_H_
@@ -0,0 +1,357 @@
+/** @file test_main.cpp
+ *  This file contains tests that every set of block kernels built for the
+ *  target gives exactly the plain set's results: over every length up to a
+ *  few times the widest loop, so each unrolled and SSE2 loop's leftover
+ *  readings are covered, from unaligned starts, and with readings at the
+ *  ends of the 16-bit range where signed compares would go wrong. The plain
+ *  kernels are themselves checked against answers worked out here.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "fixed_format.h"
+#include "block_kernels.h"
+
+/// Longest run of readings given to the kernels
+const uint16_t TEST_SAMPLES = 70;
+
+/// Readings after the start in which runs may begin, to test unaligned loads
+const uint8_t TEST_STARTS = 8;
+
+/// Kinds of readings the kernels are run over
+enum fill_t : uint8_t
+{
+    FILL_NOISE_12,              ///< 12-bit noise, as the ADC gives
+    FILL_NOISE_16,              ///< Noise over the whole 16 bits
+    FILL_ENDS,                  ///< Readings next to 0 and 0xFFFF
+    FILL_RISING,                ///< Readings which only go up
+    FILL_COUNT
+};
+
+/// Readings which every test fills in
+static uint16_t samples[TEST_SAMPLES + TEST_STARTS];
+
+/// Results of the plain kernels and of the set being compared
+static uint16_t expected[TEST_SAMPLES + TEST_STARTS];
+static uint16_t result[TEST_SAMPLES + TEST_STARTS];
+
+
+/** @brief   Fill @c samples with one kind of readings.
+ */
+static void fill (fill_t kind)
+{
+    uint32_t seed = 777 + kind;
+    for (uint16_t index = 0; index < TEST_SAMPLES + TEST_STARTS; index++)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint16_t noise = (uint16_t)(seed >> 16);
+        switch (kind)
+        {
+            case FILL_NOISE_12:
+                samples[index] = noise & 0x0FFF;
+                break;
+            case FILL_NOISE_16:
+                samples[index] = noise;
+                break;
+            case FILL_ENDS:
+                samples[index] = (noise & 1) ? 0xFFFF - (noise & 6)
+                                             : (noise & 6);
+                break;
+            default:
+                samples[index] = (uint16_t)(index * 900);
+                break;
+        }
+    }
+}
+
+
+/** @brief   Get the number of sets of kernels built for this target.
+ */
+static uint8_t set_count (void)
+{
+    uint8_t count = 0;
+    while (kernel_set_at (count) != NULL)
+    {
+        count++;
+    }
+    return count;
+}
+
+
+void setUp (void)
+{
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   The plain set comes first and the fastest set last; on a PC
+ *           with SSE2, that's the SSE2 set.
+ */
+void test_sets_in_order (void)
+{
+    TEST_ASSERT_EQUAL_STRING ("plain", kernel_set_at (0)->name);
+    TEST_ASSERT_EQUAL_STRING ("unrolled", kernel_set_at (1)->name);
+    TEST_ASSERT_EQUAL_PTR (kernel_set_at (set_count () - 1), &kernels ());
+#ifdef __SSE2__
+    TEST_ASSERT_EQUAL_UINT8 (3, set_count ());
+    TEST_ASSERT_EQUAL_STRING ("sse2", kernels ().name);
+#else
+    TEST_ASSERT_EQUAL_UINT8 (2, set_count ());
+#endif
+}
+
+
+/** @brief   The plain kernels give the answers worked out by hand.
+ */
+void test_plain_kernels (void)
+{
+    const kernel_set_t& plain = *kernel_set_at (0);
+    const uint16_t readings[] = { 7, 4095, 0, 2048, 4095, 1 };
+
+    block_stats_t stats;
+    plain.stats (readings, 6, stats);
+    TEST_ASSERT_EQUAL_UINT32 (7 + 4095 + 2048 + 4095 + 1, stats.sum);
+    TEST_ASSERT_EQUAL_UINT16 (0, stats.min);
+    TEST_ASSERT_EQUAL_UINT16 (4095, stats.max);
+
+    // No readings leave the range empty
+    plain.stats (readings, 0, stats);
+    TEST_ASSERT_EQUAL_UINT32 (0, stats.sum);
+    TEST_ASSERT_EQUAL_HEX16 (0xFFFF, stats.min);
+    TEST_ASSERT_EQUAL_HEX16 (0, stats.max);
+
+    uint16_t millivolts[6];
+    plain.scale (readings, millivolts, 6);
+    TEST_ASSERT_EQUAL_UINT16 (9, millivolts[0]);
+    TEST_ASSERT_EQUAL_UINT16 (FULL_SCALE_MV, millivolts[1]);
+    TEST_ASSERT_EQUAL_UINT16 (0, millivolts[2]);
+    TEST_ASSERT_EQUAL_UINT16 (2501, millivolts[3]);
+
+    TEST_ASSERT_EQUAL_UINT16 (1, plain.above (readings, 6, 2048));
+    TEST_ASSERT_EQUAL_UINT16 (0, plain.above (readings, 6, 0));
+    TEST_ASSERT_EQUAL_UINT16 (6, plain.above (readings, 6, 4095));
+    TEST_ASSERT_EQUAL_UINT16 (0, plain.above (readings, 0, 0));
+
+    // A step from 0 to 4000 with a shift of 2 closes a quarter of the gap
+    // each reading
+    uint16_t step[3] = { 4000, 4000, 4000 };
+    int32_t level = 0;
+    plain.filter (step, 3, level, 2);
+    TEST_ASSERT_EQUAL_UINT16 (1000, step[0]);
+    TEST_ASSERT_EQUAL_UINT16 (1750, step[1]);
+    TEST_ASSERT_EQUAL_UINT16 (2312, step[2]);
+    TEST_ASSERT_EQUAL_INT32 (9250, level);
+}
+
+
+/** @brief   Every set finds the same sum and range as the plain set, for
+ *           every length and start and every kind of readings.
+ */
+void test_stats_match_plain (void)
+{
+    const kernel_set_t& plain = *kernel_set_at (0);
+    for (uint8_t kind = 0; kind < FILL_COUNT; kind++)
+    {
+        fill ((fill_t)kind);
+        for (uint8_t set = 1; set < set_count (); set++)
+        {
+            const kernel_set_t& other = *kernel_set_at (set);
+            for (uint8_t start = 0; start < TEST_STARTS; start++)
+            {
+                for (uint16_t count = 0; count <= TEST_SAMPLES; count++)
+                {
+                    block_stats_t want;
+                    block_stats_t got;
+                    plain.stats (samples + start, count, want);
+                    other.stats (samples + start, count, got);
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE (want.sum, got.sum,
+                                                      other.name);
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE (want.min, got.min,
+                                                      other.name);
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE (want.max, got.max,
+                                                      other.name);
+                }
+            }
+        }
+    }
+}
+
+
+/** @brief   Every set finds the smallest or largest reading wherever it is,
+ *           including in the readings left over after the widest loop.
+ */
+void test_stats_find_ends_anywhere (void)
+{
+    for (uint8_t set = 0; set < set_count (); set++)
+    {
+        const kernel_set_t& other = *kernel_set_at (set);
+        for (uint16_t count = 1; count <= TEST_SAMPLES; count++)
+        {
+            for (uint16_t place = 0; place < count; place++)
+            {
+                for (uint16_t index = 0; index < count; index++)
+                {
+                    samples[index] = 0x8000;
+                }
+                samples[place] = 0xFFFF;
+                samples[(place + 1) % count] = 0;
+
+                block_stats_t got;
+                other.stats (samples, count, got);
+                TEST_ASSERT_EQUAL_HEX16 (count > 1 ? 0xFFFF : 0, got.max);
+                TEST_ASSERT_EQUAL_HEX16 (0, got.min);
+            }
+        }
+    }
+}
+
+
+/** @brief   Every set scales every 12-bit reading as the plain set does,
+ *           into another buffer or in place.
+ */
+void test_scale_matches_plain (void)
+{
+    static uint16_t counts[ADC_MAX_COUNTS + 1];
+    static uint16_t want[ADC_MAX_COUNTS + 1];
+    static uint16_t got[ADC_MAX_COUNTS + 1];
+    for (uint16_t index = 0; index <= ADC_MAX_COUNTS; index++)
+    {
+        counts[index] = index;
+    }
+    const kernel_set_t& plain = *kernel_set_at (0);
+    plain.scale (counts, want, ADC_MAX_COUNTS + 1);
+    TEST_ASSERT_EQUAL_UINT16 (FULL_SCALE_MV, want[ADC_MAX_COUNTS]);
+
+    for (uint8_t set = 1; set < set_count (); set++)
+    {
+        const kernel_set_t& other = *kernel_set_at (set);
+        other.scale (counts, got, ADC_MAX_COUNTS + 1);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY (want, got, ADC_MAX_COUNTS + 1);
+
+        // The odd lengths, from unaligned starts, and in place
+        for (uint8_t kind = 0; kind < FILL_COUNT; kind++)
+        {
+            fill ((fill_t)kind);
+            for (uint8_t start = 0; start < TEST_STARTS; start++)
+            {
+                for (uint16_t count = 0; count <= TEST_SAMPLES; count++)
+                {
+                    plain.scale (samples + start, expected, count);
+                    memcpy (result, samples + start,
+                            count * sizeof (uint16_t));
+                    other.scale (result, result, count);
+                    TEST_ASSERT_EQUAL_UINT16_ARRAY (expected, result, count);
+                }
+            }
+        }
+    }
+}
+
+
+/** @brief   Every set finds the same first reading above each limit as the
+ *           plain set, whichever lane of a loop it falls in.
+ */
+void test_above_matches_plain (void)
+{
+    const kernel_set_t& plain = *kernel_set_at (0);
+    for (uint8_t kind = 0; kind < FILL_COUNT; kind++)
+    {
+        fill ((fill_t)kind);
+        for (uint8_t set = 1; set < set_count (); set++)
+        {
+            const kernel_set_t& other = *kernel_set_at (set);
+            for (uint8_t start = 0; start < TEST_STARTS; start++)
+            {
+                for (uint16_t count = 0; count <= TEST_SAMPLES; count++)
+                {
+                    const uint16_t* first = samples + start;
+                    const uint16_t limits[] = { 0, 7, 2047, 0x7FFF, 0x8000,
+                                                0xFFF8, 0xFFFE, 0xFFFF };
+                    for (uint8_t limit = 0; limit < 8; limit++)
+                    {
+                        TEST_ASSERT_EQUAL_UINT32_MESSAGE (
+                            plain.above (first, count, limits[limit]),
+                            other.above (first, count, limits[limit]),
+                            other.name);
+                    }
+                }
+            }
+        }
+    }
+
+    // A lone reading above the limit is found at each place
+    for (uint8_t set = 0; set < set_count (); set++)
+    {
+        const kernel_set_t& other = *kernel_set_at (set);
+        for (uint16_t place = 0; place < TEST_SAMPLES; place++)
+        {
+            memset (samples, 0, sizeof (samples));
+            samples[place] = 0xFFFF;
+            TEST_ASSERT_EQUAL_UINT16 (place, other.above (samples,
+                                                          TEST_SAMPLES,
+                                                          0xFFFE));
+        }
+    }
+}
+
+
+/** @brief   Every set's filter gives the plain set's readings and state,
+ *           and the state carries from one block to the next.
+ */
+void test_filter_matches_plain (void)
+{
+    const kernel_set_t& plain = *kernel_set_at (0);
+    for (uint8_t set = 1; set < set_count (); set++)
+    {
+        const kernel_set_t& other = *kernel_set_at (set);
+        for (uint8_t kind = 0; kind < FILL_COUNT; kind++)
+        {
+            fill ((fill_t)kind);
+            for (uint8_t shift = 0; shift <= 4; shift++)
+            {
+                int32_t want_level = 1000 << shift;
+                int32_t got_level = want_level;
+                for (uint16_t count = 0; count <= TEST_SAMPLES; count += 7)
+                {
+                    memcpy (expected, samples, count * sizeof (uint16_t));
+                    memcpy (result, samples, count * sizeof (uint16_t));
+                    plain.filter (expected, count, want_level, shift);
+                    other.filter (result, count, got_level, shift);
+                    TEST_ASSERT_EQUAL_INT32 (want_level, got_level);
+                    TEST_ASSERT_EQUAL_UINT16_ARRAY (expected, result, count);
+                }
+            }
+        }
+    }
+}
+
+
+/** @brief   The check the tester runs at startup finds no differences.
+ */
+void test_built_in_check_passes (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (0, kernels_check ());
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_sets_in_order);
+    RUN_TEST (test_plain_kernels);
+    RUN_TEST (test_stats_match_plain);
+    RUN_TEST (test_stats_find_ends_anywhere);
+    RUN_TEST (test_scale_matches_plain);
+    RUN_TEST (test_above_matches_plain);
+    RUN_TEST (test_filter_matches_plain);
+    RUN_TEST (test_built_in_check_passes);
+    return UNITY_END ();
+}
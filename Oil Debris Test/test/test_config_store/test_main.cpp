@@ -0,0 +1,300 @@
+/** @file test_main.cpp
+ *  This file contains tests of the settings store: the table of settings,
+ *  numbers and text parsed from a web form and checked against their
+ *  ranges, changes refused when they come too soon after the last one, and
+ *  snapshots which are left alone until @c CONFIG_SNAPSHOTS - 1 more
+ *  changes have been made.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "config_store.h"
+
+/// Settings as main.cpp starts with them
+static const config_t DEFAULTS = { 0, 10, 40, 2, "ESP32-Access-Point",
+                                   "123456789" };
+
+/// Settings which are changed by the tests
+static config_t config;
+
+/// The time given to @c config_publish(), which only goes forward, since
+/// the store remembers its last change from one test to the next
+static uint32_t clock_ms = 1000000;
+
+
+/** @brief   Find a setting which must be in the table.
+ */
+static const config_item_t& item (const char* key)
+{
+    const config_item_t* p_item = config_find (key);
+    TEST_ASSERT_NOT_NULL (p_item);
+    return *p_item;
+}
+
+
+/** @brief   Make some text of a given length.
+ */
+static const char* text_of (size_t length)
+{
+    static char text[128];
+    memset (text, 'a', length);
+    text[length] = '\0';
+    return text;
+}
+
+
+void setUp (void)
+{
+    config = DEFAULTS;
+    clock_ms += 10 * CONFIG_MIN_CHANGE_MS;
+    config_begin (DEFAULTS);
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Every setting can be found by its name, which is short enough
+ *           for NVS, and fits in the snapshot; there are no others.
+ */
+void test_table (void)
+{
+    uint8_t index = 0;
+    for (const config_item_t* p_item; (p_item = config_item_at (index));
+         index++)
+    {
+        TEST_ASSERT_EQUAL_PTR (p_item, config_find (p_item->key));
+        TEST_ASSERT_LESS_OR_EQUAL (15, strlen (p_item->key));
+        TEST_ASSERT_LESS_OR_EQUAL (sizeof (config_t),
+                                   p_item->offset + p_item->size);
+        TEST_ASSERT_LESS_OR_EQUAL (p_item->max, p_item->min);
+    }
+    TEST_ASSERT_EQUAL_UINT8 (5, index);
+    TEST_ASSERT_NULL (config_find ("period"));
+    TEST_ASSERT_NULL (config_find (""));
+    TEST_ASSERT_TRUE (item ("ap_password").secret);
+    TEST_ASSERT_FALSE (item ("ap_ssid").secret);
+}
+
+
+/** @brief   Numbers are read back as they were put in, at each size.
+ */
+void test_numbers_read_back (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (10, config_get_uint (config,
+                                                   item ("period_ms")));
+    TEST_ASSERT_EQUAL_UINT32 (40, config_get_uint (config,
+                                                   item ("threshold")));
+    TEST_ASSERT_EQUAL_UINT32 (2, config_get_uint (config,
+                                                  item ("filter_shift")));
+
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, item ("threshold"),
+                                                "4095"));
+    TEST_ASSERT_EQUAL_UINT16 (4095, config.detect_threshold);
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, item ("filter_shift"),
+                                                "0"));
+    TEST_ASSERT_EQUAL_UINT8 (0, config.filter_shift);
+    TEST_ASSERT_EQUAL_UINT16 (10, config.sample_period_ms);
+    TEST_ASSERT_EQUAL_UINT16 (4095, config.detect_threshold);
+}
+
+
+/** @brief   Numbers are checked against each end of their range, and a
+ *           refused number changes nothing.
+ */
+void test_number_ranges (void)
+{
+    const config_item_t& period = item ("period_ms");
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE, config_parse (config, period,
+                                                          "0"));
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, period, "1"));
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, period, "1000"));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE, config_parse (config, period,
+                                                          "1001"));
+    TEST_ASSERT_EQUAL_UINT16 (1000, config.sample_period_ms);
+
+    // Too big for the setting's two bytes, or for any setting at all
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE, config_parse (config, period,
+                                                          "65546"));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, period, "99999999999999999999"));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, item ("filter_shift"), "9"));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, item ("threshold"), "4096"));
+    TEST_ASSERT_EQUAL_UINT16 (1000, config.sample_period_ms);
+    TEST_ASSERT_EQUAL_UINT8 (2, config.filter_shift);
+    TEST_ASSERT_EQUAL_UINT16 (40, config.detect_threshold);
+}
+
+
+/** @brief   Text which isn't a whole decimal number is refused.
+ */
+void test_not_a_number (void)
+{
+    const char* const bad[] = { "", "abc", "12x", "x12", "-1", "1.5", " " };
+    const config_item_t& threshold = item ("threshold");
+    for (uint8_t index = 0; index < 7; index++)
+    {
+        TEST_ASSERT_EQUAL (CONFIG_NOT_A_NUMBER,
+                           config_parse (config, threshold, bad[index]));
+    }
+    TEST_ASSERT_EQUAL_UINT16 (40, config.detect_threshold);
+
+    // Text can't be put into a number, nor a number into text
+    TEST_ASSERT_EQUAL (CONFIG_NOT_A_NUMBER,
+                       config_set_uint (config, item ("ap_ssid"), 5));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_set_text (config, threshold, "5"));
+    TEST_ASSERT_EQUAL_STRING (DEFAULTS.ap_ssid, config.ap_ssid);
+}
+
+
+/** @brief   Text is checked against its shortest and longest lengths, which
+ *           are those WiFi allows, and a refused text changes nothing.
+ */
+void test_text_lengths (void)
+{
+    const config_item_t& ssid = item ("ap_ssid");
+    const config_item_t& password = item ("ap_password");
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE, config_parse (config, ssid, ""));
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, ssid, "Tester"));
+    TEST_ASSERT_EQUAL_STRING ("Tester", config_get_text (config, ssid));
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, ssid,
+                                                text_of (CONFIG_SSID_MAX)));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, ssid,
+                                     text_of (CONFIG_SSID_MAX + 1)));
+    TEST_ASSERT_EQUAL_STRING (text_of (CONFIG_SSID_MAX), config.ap_ssid);
+
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, password, "1234567"));
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_parse (config, password,
+                                                "12345678"));
+    TEST_ASSERT_EQUAL (CONFIG_OK,
+                       config_parse (config, password,
+                                     text_of (CONFIG_PASSWORD_MAX)));
+    TEST_ASSERT_EQUAL (CONFIG_OUT_OF_RANGE,
+                       config_parse (config, password,
+                                     text_of (CONFIG_PASSWORD_MAX + 1)));
+    TEST_ASSERT_EQUAL_size_t (CONFIG_PASSWORD_MAX,
+                              strlen (config.ap_password));
+}
+
+
+/** @brief   Each result has a name of its own for error messages.
+ */
+void test_result_names (void)
+{
+    for (uint8_t first = CONFIG_OK; first <= CONFIG_TOO_SOON; first++)
+    {
+        const char* name = config_result_name ((config_result_t)first);
+        TEST_ASSERT_GREATER_THAN (0, strlen (name));
+        for (uint8_t second = first + 1; second <= CONFIG_TOO_SOON; second++)
+        {
+            const char* other = config_result_name ((config_result_t)second);
+            TEST_ASSERT_TRUE (strcmp (name, other) != 0);
+        }
+    }
+}
+
+
+/** @brief   The first snapshot is the settings given at start-up, and a
+ *           change is put into use with its version counted.
+ */
+void test_publish (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (0, config_now ().version);
+    TEST_ASSERT_EQUAL_STRING (DEFAULTS.ap_ssid, config_now ().ap_ssid);
+
+    config.detect_threshold = 123;
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, clock_ms));
+    TEST_ASSERT_EQUAL_UINT32 (1, config_now ().version);
+    TEST_ASSERT_EQUAL_UINT16 (123, config_now ().detect_threshold);
+
+    // The snapshot is a copy, which later changes to the settings don't touch
+    config.detect_threshold = 456;
+    TEST_ASSERT_EQUAL_UINT16 (123, config_now ().detect_threshold);
+}
+
+
+/** @brief   A change less than @c CONFIG_MIN_CHANGE_MS after the last one is
+ *           refused and changes nothing, even as the clock wraps around.
+ */
+void test_throttle (void)
+{
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, clock_ms));
+    config.filter_shift = 5;
+    TEST_ASSERT_EQUAL (CONFIG_TOO_SOON, config_publish (config, clock_ms));
+    TEST_ASSERT_EQUAL (CONFIG_TOO_SOON,
+                       config_publish (config,
+                                       clock_ms + CONFIG_MIN_CHANGE_MS - 1));
+    TEST_ASSERT_EQUAL_UINT8 (2, config_now ().filter_shift);
+    TEST_ASSERT_EQUAL_UINT32 (1, config_now ().version);
+
+    TEST_ASSERT_EQUAL (CONFIG_OK,
+                       config_publish (config,
+                                       clock_ms + CONFIG_MIN_CHANGE_MS));
+    TEST_ASSERT_EQUAL_UINT8 (5, config_now ().filter_shift);
+    TEST_ASSERT_EQUAL_UINT32 (2, config_now ().version);
+
+    // Changes just before and just after the millisecond count wraps
+    uint32_t wrap_ms = 0xFFFFFFFF - CONFIG_MIN_CHANGE_MS / 2;
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, wrap_ms));
+    TEST_ASSERT_EQUAL (CONFIG_TOO_SOON, config_publish (config, 0));
+    TEST_ASSERT_EQUAL (CONFIG_OK,
+                       config_publish (config,
+                                       wrap_ms + CONFIG_MIN_CHANGE_MS));
+    clock_ms = CONFIG_MIN_CHANGE_MS * 10;
+}
+
+
+/** @brief   A snapshot which has been replaced keeps its settings for
+ *           @c CONFIG_SNAPSHOTS - 1 more changes, so a task still reading
+ *           it sees no change, and is then reused.
+ */
+void test_snapshot_rotation (void)
+{
+    config.sample_period_ms = 20;
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, clock_ms));
+    const config_t* p_held = &config_now ();
+
+    for (uint8_t change = 1; change < CONFIG_SNAPSHOTS; change++)
+    {
+        clock_ms += CONFIG_MIN_CHANGE_MS;
+        config.sample_period_ms = 20 + change;
+        TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, clock_ms));
+        TEST_ASSERT_TRUE (p_held != &config_now ());
+        TEST_ASSERT_EQUAL_UINT16 (20, p_held->sample_period_ms);
+        TEST_ASSERT_EQUAL_UINT32 (1, p_held->version);
+    }
+
+    clock_ms += CONFIG_MIN_CHANGE_MS;
+    config.sample_period_ms = 99;
+    TEST_ASSERT_EQUAL (CONFIG_OK, config_publish (config, clock_ms));
+    TEST_ASSERT_EQUAL_PTR (p_held, &config_now ());
+    TEST_ASSERT_EQUAL_UINT16 (99, p_held->sample_period_ms);
+    TEST_ASSERT_EQUAL_UINT32 (CONFIG_SNAPSHOTS + 1, config_now ().version);
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_table);
+    RUN_TEST (test_numbers_read_back);
+    RUN_TEST (test_number_ranges);
+    RUN_TEST (test_not_a_number);
+    RUN_TEST (test_text_lengths);
+    RUN_TEST (test_result_names);
+    RUN_TEST (test_publish);
+    RUN_TEST (test_throttle);
+    RUN_TEST (test_snapshot_rotation);
+    return UNITY_END ();
+}
@@ -0,0 +1,210 @@
+/** @file test_main.cpp
+ *  This file contains tests of the fixed-point number formatter: the edges
+ *  where a number gains a digit, the largest and smallest 32-bit numbers,
+ *  negative voltages below one volt, and every count of decimal places.
+ *  Each result is checked against @c snprintf(), and the byte after it must
+ *  be left alone, as the formatter adds no terminating null.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "fixed_format.h"
+
+/// Byte put in the output before each call, to see what was written
+const char UNTOUCHED = '#';
+
+/// Where the formatter writes, with room to spare
+static char text[2 * FMT_MAX_CHARS];
+
+/// The text @c snprintf() writes for the same number
+static char expected[2 * FMT_MAX_CHARS];
+
+/// Numbers where the count of digits changes, and the ends of 32 bits
+static const uint32_t EDGES[] =
+{
+    0, 1, 9, 10, 11, 99, 100, 101, 999, 1000, 9999, 10000, 99999, 100000,
+    999999, 1000000, 9999999, 10000000, 99999999, 100000000, 999999999,
+    1000000000, 2147483647, 2147483648UL, 4294967294UL, 4294967295UL
+};
+const size_t EDGE_COUNT = sizeof (EDGES) / sizeof (EDGES[0]);
+
+
+/** @brief   Check the text the formatter wrote against @c expected.
+ *  @param   length The number of characters the formatter said it wrote
+ */
+static void check_text (size_t length)
+{
+    TEST_ASSERT_EQUAL_size_t (strlen (expected), length);
+    TEST_ASSERT_LESS_OR_EQUAL (FMT_MAX_CHARS, length);
+    TEST_ASSERT_EQUAL_MEMORY (expected, text, length);
+    TEST_ASSERT_EQUAL_HEX8 (UNTOUCHED, text[length]);
+}
+
+
+/** @brief   Write a fixed-point number as @c snprintf() would, from the
+ *           integer part and the fraction, without rounding through floats.
+ */
+static void expect_fixed (int32_t value, uint8_t decimals)
+{
+    uint32_t magnitude = (value < 0) ? 0 - (uint32_t)value : (uint32_t)value;
+    uint32_t scale = 1;
+    for (uint8_t place = 0; place < decimals; place++)
+    {
+        scale *= 10;
+    }
+    if (decimals == 0)
+    {
+        snprintf (expected, sizeof (expected), "%ld", (long)value);
+    }
+    else
+    {
+        snprintf (expected, sizeof (expected), "%s%lu.%0*lu",
+                  value < 0 ? "-" : "", (unsigned long)(magnitude / scale),
+                  (int)decimals, (unsigned long)(magnitude % scale));
+    }
+}
+
+
+void setUp (void)
+{
+    memset (text, UNTOUCHED, sizeof (text));
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Test unsigned numbers at each edge where they gain a digit.
+ */
+void test_uint_edges (void)
+{
+    for (size_t index = 0; index < EDGE_COUNT; index++)
+    {
+        setUp ();
+        snprintf (expected, sizeof (expected), "%lu",
+                  (unsigned long)EDGES[index]);
+        check_text (fmt_uint (text, EDGES[index]));
+    }
+    TEST_ASSERT_EQUAL_size_t (10, fmt_uint (text, UINT32_MAX));
+    TEST_ASSERT_EQUAL_MEMORY ("4294967295", text, 10);
+}
+
+
+/** @brief   Test signed numbers at the same edges, either side of zero, and
+ *           the most negative number, whose magnitude has no positive twin.
+ */
+void test_int_edges (void)
+{
+    for (size_t index = 0; index < EDGE_COUNT; index++)
+    {
+        if (EDGES[index] > (uint32_t)INT32_MAX)
+        {
+            continue;
+        }
+        for (int32_t sign = 1; sign >= -1; sign -= 2)
+        {
+            int32_t value = sign * (int32_t)EDGES[index];
+            setUp ();
+            snprintf (expected, sizeof (expected), "%ld", (long)value);
+            check_text (fmt_int (text, value));
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t (11, fmt_int (text, INT32_MIN));
+    TEST_ASSERT_EQUAL_MEMORY ("-2147483648", text, 11);
+    TEST_ASSERT_EQUAL_size_t (10, fmt_int (text, INT32_MAX));
+    TEST_ASSERT_EQUAL_MEMORY ("2147483647", text, 10);
+}
+
+
+/** @brief   Test voltages as the pages show them, in millivolts with three
+ *           decimals, including ones below a volt either side of zero.
+ */
+void test_fixed_millivolts (void)
+{
+    static const struct { int32_t millivolts; const char* text; } CASES[] =
+    {
+        { 0, "0.000" }, { 5, "0.005" }, { 9, "0.009" }, { 10, "0.010" },
+        { 99, "0.099" }, { 100, "0.100" }, { 999, "0.999" },
+        { 1000, "1.000" }, { 1234, "1.234" }, { 5000, "5.000" },
+        { -1, "-0.001" }, { -9, "-0.009" }, { -10, "-0.010" },
+        { -99, "-0.099" }, { -100, "-0.100" }, { -999, "-0.999" },
+        { -1000, "-1.000" }, { -4321, "-4.321" }
+    };
+    for (size_t index = 0; index < sizeof (CASES) / sizeof (CASES[0]);
+         index++)
+    {
+        setUp ();
+        strcpy (expected, CASES[index].text);
+        check_text (fmt_fixed (text, CASES[index].millivolts, 3));
+    }
+}
+
+
+/** @brief   Test every count of decimals from 0 to 9 on the edges, either
+ *           side of zero, and on the ends of the signed range.
+ */
+void test_fixed_every_decimals (void)
+{
+    for (uint8_t decimals = 0; decimals <= 9; decimals++)
+    {
+        for (size_t index = 0; index < EDGE_COUNT; index++)
+        {
+            if (EDGES[index] > (uint32_t)INT32_MAX)
+            {
+                continue;
+            }
+            for (int32_t sign = 1; sign >= -1; sign -= 2)
+            {
+                int32_t value = sign * (int32_t)EDGES[index];
+                setUp ();
+                expect_fixed (value, decimals);
+                check_text (fmt_fixed (text, value, decimals));
+            }
+        }
+        setUp ();
+        expect_fixed (INT32_MIN, decimals);
+        check_text (fmt_fixed (text, INT32_MIN, decimals));
+    }
+
+    // The longest text there is fills the room the header promises
+    setUp ();
+    TEST_ASSERT_EQUAL_size_t (FMT_MAX_CHARS, fmt_fixed (text, INT32_MIN, 9));
+    TEST_ASSERT_EQUAL_MEMORY ("-2.147483648", text, FMT_MAX_CHARS);
+}
+
+
+/** @brief   Test every ADC reading's voltage against @c snprintf() of the
+ *           same voltage, as the serial line and @c /csv write them.
+ */
+void test_every_reading (void)
+{
+    TEST_ASSERT_EQUAL_UINT16 (0, counts_to_millivolts (0));
+    TEST_ASSERT_EQUAL_UINT16 (FULL_SCALE_MV,
+                              counts_to_millivolts (ADC_MAX_COUNTS));
+    for (uint32_t counts = 0; counts <= ADC_MAX_COUNTS; counts++)
+    {
+        uint16_t millivolts = counts_to_millivolts (counts);
+        setUp ();
+        snprintf (expected, sizeof (expected), "%.3f", millivolts / 1000.0);
+        check_text (fmt_fixed (text, millivolts, 3));
+    }
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_uint_edges);
+    RUN_TEST (test_int_edges);
+    RUN_TEST (test_fixed_millivolts);
+    RUN_TEST (test_fixed_every_decimals);
+    RUN_TEST (test_every_reading);
+    return UNITY_END ();
+}
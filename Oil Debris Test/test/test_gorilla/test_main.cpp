@@ -0,0 +1,352 @@
+/** @file test_main.cpp
+ *  This file contains round-trip tests of the Gorilla blocks which hold the
+ *  voltage history: a constant signal, noisy readings quantised by the ADC
+ *  as @c voltage_history.cpp gets them, timestamps which wrap past 32 bits,
+ *  and a timestamp step at each edge of the delta-of-delta codes. Values
+ *  must come back bit for bit, full blocks must still decode, and blocks
+ *  sent one after another must split apart at their recorded sizes.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "gorilla.h"
+
+/// Most rows put in a block by the tests
+const uint32_t TEST_MAX_ROWS = 4000;
+
+/// Columns of the voltage history, fine and coarse
+const uint8_t TEST_COLUMNS = 2;
+
+/// Volts for each count of the 12-bit ADC, as the sensor task scales them
+const float VOLTS_PER_COUNT = 5.0f / 4095.0f;
+
+/// Memory for the blocks; the history's blocks are as large
+static uint8_t block[8192];
+
+/// Rows put into a block and read back out of it
+static uint32_t times[TEST_MAX_ROWS];
+static float values[TEST_MAX_ROWS][TEST_COLUMNS];
+
+/// State of the test's random numbers
+static uint32_t seed;
+
+
+/** @brief   Get a repeatable pseudo-random number.
+ */
+static uint32_t next_random (void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+
+/** @brief   Check that two floats have exactly the same bits.
+ */
+static void assert_same_bits (float expected, float actual)
+{
+    uint32_t want, got;
+    memcpy (&want, &expected, sizeof (want));
+    memcpy (&got, &actual, sizeof (got));
+    TEST_ASSERT_EQUAL_HEX32 (want, got);
+}
+
+
+/** @brief   Encode the first @c count rows, decode them again and check that
+ *           every time and value came back unchanged.
+ *  @returns The number of bits the block used
+ */
+static size_t round_trip (uint32_t count)
+{
+    GorillaEncoder encoder (block, sizeof (block), TEST_COLUMNS);
+    for (uint32_t row = 0; row < count; row++)
+    {
+        TEST_ASSERT_TRUE (encoder.append (times[row], values[row]));
+    }
+    TEST_ASSERT_EQUAL_UINT32 (count, encoder.count ());
+
+    GorillaDecoder decoder (encoder.data (), encoder.size ());
+    TEST_ASSERT_TRUE (decoder.valid ());
+    TEST_ASSERT_EQUAL_UINT8 (TEST_COLUMNS, decoder.column_count ());
+    TEST_ASSERT_EQUAL_UINT32 (count, decoder.count ());
+    TEST_ASSERT_EQUAL_size_t (encoder.size (), decoder.block_size ());
+    for (uint32_t row = 0; row < count; row++)
+    {
+        uint32_t time;
+        float read[TEST_COLUMNS];
+        TEST_ASSERT_TRUE (decoder.next (time, read));
+        TEST_ASSERT_EQUAL_UINT32 (times[row], time);
+        for (uint8_t col = 0; col < TEST_COLUMNS; col++)
+        {
+            assert_same_bits (values[row][col], read[col]);
+        }
+    }
+    uint32_t time;
+    float read[TEST_COLUMNS];
+    TEST_ASSERT_FALSE (decoder.next (time, read));
+    return encoder.bits ();
+}
+
+
+void setUp (void)
+{
+    seed = 1;
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Test that a constant signal at a steady rate costs one bit for
+ *           the time and one for each value after the first row.
+ */
+void test_constant_signal (void)
+{
+    const uint32_t ROWS = 1000;
+    for (uint32_t row = 0; row < ROWS; row++)
+    {
+        times[row] = 5000 + 10 * row;
+        values[row][0] = 1.25f;
+        values[row][1] = 0.0f;
+    }
+    size_t bits = round_trip (ROWS);
+
+    // The header, the first row verbatim, the first delta in the 7-bit
+    // code, then 3 bits for every other row
+    TEST_ASSERT_EQUAL_size_t (GORILLA_HEADER_SIZE * 8 + 32 * TEST_COLUMNS
+                              + (2 + 7 - 1) + (ROWS - 1) * (1 + TEST_COLUMNS),
+                              bits);
+}
+
+
+/** @brief   Test noisy readings scaled from ADC counts, whose mantissas
+ *           differ in many bits, with a little jitter in the timestamps.
+ */
+void test_noisy_adc_readings (void)
+{
+    const uint32_t ROWS = 1000;
+    int32_t fine = 1200;
+    int32_t coarse = 3000;
+    uint32_t time = 123456;
+    for (uint32_t row = 0; row < ROWS; row++)
+    {
+        fine += (int32_t)(next_random () % 9) - 4;
+        coarse += (int32_t)(next_random () % 33) - 16;
+        times[row] = time;
+        values[row][0] = fine * VOLTS_PER_COUNT;
+        values[row][1] = coarse * VOLTS_PER_COUNT;
+        time += 9 + next_random () % 3;
+    }
+    size_t bits = round_trip (ROWS);
+
+    // Noisy volts cost more than constant ones but less than raw floats
+    TEST_ASSERT_LESS_THAN (ROWS * (32 + 32 * TEST_COLUMNS), bits);
+    TEST_ASSERT_GREATER_THAN (ROWS * (1 + TEST_COLUMNS), bits);
+}
+
+
+/** @brief   Test full-scale swings, zero, negative values and a value which
+ *           only changes in its lowest bit, which need new windows.
+ */
+void test_value_windows (void)
+{
+    const float SPECIAL[] =
+    {
+        0.0f, 4095 * VOLTS_PER_COUNT, -0.0f, 1 * VOLTS_PER_COUNT, -3.5f,
+        1.0f, 1.0000001f, 1.0f, 2048 * VOLTS_PER_COUNT, 0.0f
+    };
+    const uint32_t ROWS = sizeof (SPECIAL) / sizeof (SPECIAL[0]);
+    for (uint32_t row = 0; row < ROWS; row++)
+    {
+        times[row] = 10 * row;
+        values[row][0] = SPECIAL[row];
+        values[row][1] = SPECIAL[ROWS - 1 - row];
+    }
+    round_trip (ROWS);
+}
+
+
+/** @brief   Test timestamps which wrap from near the top of 32 bits to near
+ *           zero, as the millisecond counter does after 49.7 days.
+ */
+void test_wrapping_timestamps (void)
+{
+    const uint32_t ROWS = 200;
+    for (uint32_t row = 0; row < ROWS; row++)
+    {
+        times[row] = 0xFFFFFC00UL + 10 * row + (row % 7 == 3 ? 1 : 0);
+        values[row][0] = (row % 50) * VOLTS_PER_COUNT;
+        values[row][1] = 2.5f;
+    }
+    TEST_ASSERT_TRUE (times[ROWS - 1] < times[0]);
+    round_trip (ROWS);
+}
+
+
+/** @brief   Test a step in the timestamps' delta at each edge of the
+ *           delta-of-delta codes, and steps larger than any of them.
+ */
+void test_delta_of_delta_edges (void)
+{
+    const int32_t STEPS[] =
+    {
+        0, 63, -64, 64, -65, 255, -256, 256, -257, 2047, -2048, 2048,
+        -2049, 100000, -100000, 0x7FFFFFF0, 0
+    };
+    uint32_t count = 0;
+    uint32_t time = 1000;
+    for (const int32_t step : STEPS)
+    {
+        // Each step is taken once then taken back, with plain rows between
+        const int32_t changes[] = { step, -step, 0 };
+        for (const int32_t change : changes)
+        {
+            times[count] = time;
+            values[count][0] = values[count][1] = 1.0f;
+            count++;
+            time += 100 + (uint32_t)change;
+        }
+    }
+    round_trip (count);
+}
+
+
+/** @brief   Test that a block which fills up refuses rows but still holds
+ *           every row it took.
+ */
+void test_full_block (void)
+{
+    const size_t SMALL = 256;
+    GorillaEncoder encoder (block, SMALL, TEST_COLUMNS);
+    uint32_t count = 0;
+    int32_t reading = 2000;
+    while (count < TEST_MAX_ROWS)
+    {
+        reading += (int32_t)(next_random () % 201) - 100;
+        times[count] = 10 * count;
+        values[count][0] = reading * VOLTS_PER_COUNT;
+        values[count][1] = -reading * VOLTS_PER_COUNT;
+        if (!encoder.append (times[count], values[count]))
+        {
+            break;
+        }
+        count++;
+    }
+    TEST_ASSERT_GREATER_THAN (1, count);
+    TEST_ASSERT_LESS_THAN (TEST_MAX_ROWS, count);
+    TEST_ASSERT_LESS_OR_EQUAL (SMALL, encoder.size ());
+    TEST_ASSERT_FALSE (encoder.append (times[count], values[count]));
+
+    GorillaDecoder decoder (encoder.data (), encoder.size ());
+    TEST_ASSERT_EQUAL_UINT32 (count, decoder.count ());
+    for (uint32_t row = 0; row < count; row++)
+    {
+        uint32_t time;
+        float read[TEST_COLUMNS];
+        TEST_ASSERT_TRUE (decoder.next (time, read));
+        TEST_ASSERT_EQUAL_UINT32 (times[row], time);
+        assert_same_bits (values[row][0], read[0]);
+        assert_same_bits (values[row][1], read[1]);
+    }
+}
+
+
+/** @brief   Test that two blocks sent one after the other, as the history's
+ *           snapshot sends them, split apart at the recorded block size.
+ */
+void test_consecutive_blocks (void)
+{
+    static uint8_t second[512];
+    GorillaEncoder first_encoder (block, 512, TEST_COLUMNS);
+    GorillaEncoder second_encoder (second, sizeof (second), TEST_COLUMNS);
+    for (uint32_t row = 0; row < 40; row++)
+    {
+        float one[TEST_COLUMNS] = { row * VOLTS_PER_COUNT, 1.5f };
+        float two[TEST_COLUMNS] = { 3.0f, row * 0.25f };
+        first_encoder.append (100 * row, one);
+        second_encoder.append (7 + 20 * row, two);
+    }
+    size_t first_size = first_encoder.size ();
+    memcpy (block + first_size, second, second_encoder.size ());
+    size_t total = first_size + second_encoder.size ();
+
+    GorillaDecoder first (block, total);
+    TEST_ASSERT_TRUE (first.valid ());
+    TEST_ASSERT_EQUAL_size_t (first_size, first.block_size ());
+    GorillaDecoder next (block + first.block_size (),
+                         total - first.block_size ());
+    TEST_ASSERT_TRUE (next.valid ());
+    TEST_ASSERT_EQUAL_UINT32 (40, next.count ());
+
+    uint32_t time;
+    float read[TEST_COLUMNS];
+    for (uint32_t row = 0; row < 40; row++)
+    {
+        TEST_ASSERT_TRUE (next.next (time, read));
+        TEST_ASSERT_EQUAL_UINT32 (7 + 20 * row, time);
+        assert_same_bits (row * 0.25f, read[1]);
+    }
+    TEST_ASSERT_FALSE (next.next (time, read));
+}
+
+
+/** @brief   Test that bad headers are refused and cut-off blocks stop
+ *           rather than reading past their end.
+ */
+void test_bad_blocks (void)
+{
+    for (uint32_t row = 0; row < 100; row++)
+    {
+        times[row] = 10 * row;
+        values[row][0] = (row * 37 % 4096) * VOLTS_PER_COUNT;
+        values[row][1] = 1.0f;
+    }
+    GorillaEncoder encoder (block, sizeof (block), TEST_COLUMNS);
+    for (uint32_t row = 0; row < 100; row++)
+    {
+        encoder.append (times[row], values[row]);
+    }
+    size_t size = encoder.size ();
+
+    TEST_ASSERT_FALSE (GorillaDecoder (block, GORILLA_HEADER_SIZE - 1)
+                       .valid ());
+    block[0] = 'X';
+    TEST_ASSERT_FALSE (GorillaDecoder (block, size).valid ());
+    block[0] = GORILLA_MAGIC;
+    block[1] = 0;
+    TEST_ASSERT_FALSE (GorillaDecoder (block, size).valid ());
+    block[1] = GORILLA_MAX_COLUMNS + 1;
+    TEST_ASSERT_FALSE (GorillaDecoder (block, size).valid ());
+    block[1] = TEST_COLUMNS;
+
+    // Only half the block arrived, so reading stops early
+    GorillaDecoder cut (block, size / 2);
+    uint32_t time;
+    float read[TEST_COLUMNS];
+    uint32_t rows = 0;
+    while (cut.next (time, read))
+    {
+        rows++;
+    }
+    TEST_ASSERT_LESS_THAN (100, rows);
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_constant_signal);
+    RUN_TEST (test_noisy_adc_readings);
+    RUN_TEST (test_value_windows);
+    RUN_TEST (test_wrapping_timestamps);
+    RUN_TEST (test_delta_of_delta_edges);
+    RUN_TEST (test_full_block);
+    RUN_TEST (test_consecutive_blocks);
+    RUN_TEST (test_bad_blocks);
+    return UNITY_END ();
+}
@@ -0,0 +1,257 @@
+/** @file test_main.cpp
+ *  This file contains tests of the streaming JSON writer: strings with
+ *  quotes, backslashes and control characters escaped as JSON requires,
+ *  commas between the items of objects and arrays nested in each other
+ *  but not after an empty one, members and array items of each kind, and
+ *  nesting as deep as the writer keeps track of.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "json_writer.h"
+
+/// Most bytes the client keeps
+const size_t CLIENT_MAX_BYTES = 4096;
+
+
+/** @brief   Class which stands in for a web client's connection, keeping
+ *           the text it's given.
+ */
+class TextClient : public Print
+{
+public:
+    char bytes[CLIENT_MAX_BYTES];           ///< Everything taken, in order
+    size_t taken;                           ///< Bytes taken
+
+    /// Forget everything taken
+    void reset (void)
+    {
+        taken = 0;
+        bytes[0] = '\0';
+    }
+
+    using Print::write;
+
+    /// Take one byte
+    size_t write (uint8_t byte)
+    {
+        return write (&byte, 1);
+    }
+
+    /// Take as many bytes as there's room for, keeping them terminated
+    size_t write (const uint8_t* data, size_t count)
+    {
+        size_t room = CLIENT_MAX_BYTES - 1 - taken;
+        size_t take = (count < room) ? count : room;
+        memcpy (bytes + taken, data, take);
+        taken += take;
+        bytes[taken] = '\0';
+        return take;
+    }
+
+    /// Get the body, after the headers
+    const char* body (void) const
+    {
+        const char* end = strstr (bytes, "\r\n\r\n");
+        return end ? end + 4 : bytes;
+    }
+};
+
+
+/// The client the responses go to, and the buffer they're sent from
+static TextClient client;
+static char buffer[RESPONSE_CHUNK_SIZE];
+
+
+/** @brief   Finish a response and get the JSON which was sent.
+ */
+static const char* sent (ResponseWriter& page)
+{
+    page.end ();
+    return client.body ();
+}
+
+
+void setUp (void)
+{
+    client.reset ();
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Plain text is sent as it is, and a quote or backslash gets a
+ *           backslash before it.
+ */
+void test_escape_quote_backslash (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_string ("plain", "Oil debris 1.5 V");
+    json.member_string ("quote", "say \"hi\"");
+    json.member_string ("path", "C:\\data\\log.bin");
+    json.member_string ("both", "\\\"");
+    json.member_string ("empty", "");
+    json.end_object ();
+    TEST_ASSERT_EQUAL_STRING ("{\"plain\":\"Oil debris 1.5 V\","
+                              "\"quote\":\"say \\\"hi\\\"\","
+                              "\"path\":\"C:\\\\data\\\\log.bin\","
+                              "\"both\":\"\\\\\\\"\",\"empty\":\"\"}",
+                              sent (page));
+}
+
+
+/** @brief   Control characters are sent as @c \\u escapes, and characters
+ *           from a space up, including those past 0x7F, as they are.
+ */
+void test_escape_control (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_array ();
+    json.value_string ("tab\there");
+    json.value_string ("line\r\n");
+    json.value_string ("\x01\x1F ");
+    json.value_string ("\x7F\xC2\xB5m");
+    json.end_array ();
+    TEST_ASSERT_EQUAL_STRING ("[\"tab\\u0009here\",\"line\\u000d\\u000a\","
+                              "\"\\u0001\\u001f \",\"\x7F\xC2\xB5m\"]",
+                              sent (page));
+}
+
+
+/** @brief   Names are escaped as values are.
+ */
+void test_escape_name (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("a\"b", 1);
+    json.begin_array ("c\\d\n");
+    json.end_array ();
+    json.end_object ();
+    TEST_ASSERT_EQUAL_STRING ("{\"a\\\"b\":1,\"c\\\\d\\u000a\":[]}",
+                              sent (page));
+}
+
+
+/** @brief   Items are split by commas at each level, with none after an
+ *           item which opens a level nor after an empty object or array.
+ */
+void test_nesting_commas (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("schema", 1);
+    json.begin_object ("empty");
+    json.end_object ();
+    json.begin_array ("rows");
+    json.begin_array ();
+    json.value_uint (1);
+    json.value_uint (2);
+    json.end_array ();
+    json.begin_array ();
+    json.end_array ();
+    json.begin_object ();
+    json.member_bool ("ok", true);
+    json.end_object ();
+    json.value_uint (3);
+    json.end_array ();
+    json.begin_object ("last");
+    json.begin_array ("none");
+    json.end_array ();
+    json.end_object ();
+    json.end_object ();
+    TEST_ASSERT_EQUAL_STRING ("{\"schema\":1,\"empty\":{},"
+                              "\"rows\":[[1,2],[],{\"ok\":true},3],"
+                              "\"last\":{\"none\":[]}}",
+                              sent (page));
+}
+
+
+/** @brief   Each kind of member and array item is written as JSON has it.
+ */
+void test_members_and_values (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    json.member_uint ("max", 0xFFFFFFFF);
+    json.member_uint ("zero", 0);
+    json.member_int ("low", -2147483647 - 1);
+    json.member_int ("high", 42);
+    json.member_fixed ("volts", 1234, 3);
+    json.member_fixed ("below", -5, 3);
+    json.member_fixed ("whole", 7, 0);
+    json.member_bool ("on", true);
+    json.member_bool ("off", false);
+    json.begin_array ("items");
+    json.value_fixed (-1500, 3);
+    json.value_fixed (25, 1);
+    json.value_string ("x");
+    json.value_uint (9);
+    json.end_array ();
+    json.end_object ();
+    TEST_ASSERT_EQUAL_STRING ("{\"max\":4294967295,\"zero\":0,"
+                              "\"low\":-2147483648,\"high\":42,"
+                              "\"volts\":1.234,\"below\":-0.005,\"whole\":7,"
+                              "\"on\":true,\"off\":false,"
+                              "\"items\":[-1.500,2.5,\"x\",9]}",
+                              sent (page));
+}
+
+
+/** @brief   Objects and arrays nested as deeply as the writer keeps track of
+ *           still get their commas, and a document may be a bare array.
+ */
+void test_deepest_nesting (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_array ();
+    for (uint8_t level = 1; level < JSON_MAX_DEPTH; level++)
+    {
+        json.value_uint (level);
+        json.begin_array ();
+    }
+    json.value_uint (JSON_MAX_DEPTH);
+    json.value_uint (0);
+    for (uint8_t level = JSON_MAX_DEPTH - 1; level > 0; level--)
+    {
+        json.end_array ();
+        json.value_uint (level);
+    }
+    json.end_array ();
+    TEST_ASSERT_EQUAL_STRING ("[1,[2,[3,[4,[5,[6,[7,[8,0],"
+                              "7],6],5],4],3],2],1]",
+                              sent (page));
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_escape_quote_backslash);
+    RUN_TEST (test_escape_control);
+    RUN_TEST (test_escape_name);
+    RUN_TEST (test_nesting_commas);
+    RUN_TEST (test_members_and_values);
+    RUN_TEST (test_deepest_nesting);
+    return UNITY_END ();
+}
@@ -0,0 +1,248 @@
+/** @file test_main.cpp
+ *  This file contains tests of the low-power mode, run on the simulated
+ *  clock of @c bench/host/esp_timer.h. Three hours and a second of the
+ *  sensor task are simulated as @c main.cpp runs it: a scan of the sensors
+ *  every 10 ms taking 120 us, and a block every 50 samples which keeps the
+ *  chip awake while it's processed. The chip takes 250 us to wake from
+ *  light sleep.
+ *  The tests check that no sample is late by more than a tick, that the
+ *  radio's windows open and close on schedule, and that each hour's times
+ *  and estimate of the current are what the schedule gives.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <unity.h>
+#include "low_power.h"
+
+/// Time between samples, in microseconds
+const int64_t TEST_PERIOD_US = 10000;
+
+/// Time taken to scan the sensors, in microseconds
+const int64_t TEST_SCAN_US = 120;
+
+/// Samples in each block, after the last of which the chip stays awake
+const uint32_t TEST_BLOCK_SIZE = 50;
+
+/// Time the chip takes to wake from light sleep, in microseconds
+const uint32_t TEST_WAKE_LATENCY_US = 250;
+
+/// Samples between runs of the power task, every @c POWER_POLL_MS of 100
+const uint32_t TEST_POLL_SAMPLES = 10;
+
+/// Whole hours simulated; a second more is run so the last hour is over
+const uint8_t TEST_HOURS = 3;
+
+/// Samples simulated
+const uint32_t TEST_SAMPLES = (TEST_HOURS * 3600UL + 1) * 100;
+
+/// How far a radio switch may be from its scheduled time, in microseconds:
+/// a poll of the power task and a sample
+const int64_t TEST_SWITCH_SLACK_US = 110000;
+
+/// When the schedule started, the times the radio was switched on and off,
+/// and how many times each was switched
+static int64_t started;
+static int64_t switched_on[TEST_HOURS];
+static int64_t switched_off[TEST_HOURS];
+static uint8_t on_count = 0;
+static uint8_t off_count = 0;
+
+/// The latest any sample was taken, after its time, in microseconds
+static int64_t latest = 0;
+
+/// Samples taken and how many were taken early
+static uint32_t samples = 0;
+static uint32_t early = 0;
+
+
+/** @brief   Note when the radio is switched on.
+ */
+static void radio_on (void)
+{
+    if (on_count < TEST_HOURS)
+    {
+        switched_on[on_count] = esp_timer_get_time () - started;
+    }
+    on_count++;
+}
+
+
+/** @brief   Note when the radio is switched off.
+ */
+static void radio_off (void)
+{
+    if (off_count < TEST_HOURS)
+    {
+        switched_off[off_count] = esp_timer_get_time () - started;
+    }
+    off_count++;
+}
+
+
+/** @brief   Run the sensor task for some hours on the simulated clock.
+ */
+static void simulate (void)
+{
+    host_sleep_latency (TEST_WAKE_LATENCY_US);
+    started = esp_timer_get_time ();
+    power_begin (radio_on, radio_off);
+
+    int64_t next_wake = started;
+    for (uint32_t sample = 0; sample < TEST_SAMPLES; sample++)
+    {
+        // As in main.cpp, the chip may not sleep while a block is waiting
+        next_wake += TEST_PERIOD_US;
+        power_wait_until (next_wake,
+                          (sample + 1) % TEST_BLOCK_SIZE != 0);
+        int64_t late = esp_timer_get_time () - next_wake;
+        if (late < 0)
+        {
+            early++;
+        }
+        if (late > latest)
+        {
+            latest = late;
+        }
+        samples++;
+
+        host_clock_advance (TEST_SCAN_US);
+        if (sample % TEST_POLL_SAMPLES == 0)
+        {
+            power_run ();
+        }
+    }
+}
+
+
+void setUp (void)
+{
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Every sample is taken at its time or within a tick after it.
+ */
+void test_samples_on_time (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (TEST_SAMPLES, samples);
+    TEST_ASSERT_EQUAL_UINT32 (0, early);
+    TEST_ASSERT_LESS_OR_EQUAL (1000, (uint32_t)latest);
+}
+
+
+/** @brief   The radio, on at startup, goes off after the first window and
+ *           comes on and off again for each window after that; the last
+ *           one opened just before the run ended.
+ */
+void test_radio_windows (void)
+{
+    const int64_t period = (int64_t)POWER_RADIO_PERIOD_S * 1000000LL;
+    const int64_t window = (int64_t)POWER_RADIO_WINDOW_S * 1000000LL;
+
+    TEST_ASSERT_EQUAL_UINT8 (TEST_HOURS, on_count);
+    TEST_ASSERT_EQUAL_UINT8 (TEST_HOURS, off_count);
+    TEST_ASSERT_TRUE (power_radio_is_on ());
+    for (uint8_t hour = 0; hour < TEST_HOURS; hour++)
+    {
+        int64_t off_late = switched_off[hour] - (hour * period + window);
+        TEST_ASSERT_TRUE (off_late >= 0);
+        TEST_ASSERT_TRUE (off_late <= TEST_SWITCH_SLACK_US);
+
+        int64_t on_late = switched_on[hour] - (hour + 1) * period;
+        TEST_ASSERT_TRUE (on_late >= 0);
+        TEST_ASSERT_TRUE (on_late <= TEST_SWITCH_SLACK_US);
+    }
+}
+
+
+/** @brief   Each whole hour is kept, and its times and estimate match the
+ *           schedule: awake for about 1.7 ms of each 10 ms sample and all
+ *           of each block's last, and for the whole radio window.
+ */
+void test_hours_and_estimate (void)
+{
+    power_hour_t hour;
+    for (uint8_t ago = 1; ago <= TEST_HOURS; ago++)
+    {
+        TEST_ASSERT_TRUE (power_get_hour (ago, hour));
+
+        uint32_t total_ms = hour.awake_ms + hour.asleep_ms;
+        TEST_ASSERT_UINT32_WITHIN (50, 3600000, total_ms);
+        TEST_ASSERT_UINT32_WITHIN (200, POWER_RADIO_WINDOW_S * 1000,
+                                   hour.radio_ms);
+
+        // Every sample after the window sleeps but each block's last
+        uint32_t asleep_samples = (3600 - POWER_RADIO_WINDOW_S) * 100;
+        asleep_samples -= asleep_samples / TEST_BLOCK_SIZE;
+        TEST_ASSERT_UINT32_WITHIN (20, asleep_samples, hour.sleeps);
+
+        power_budget_t budget;
+        power_estimate (hour, budget);
+        TEST_ASSERT_UINT32_WITHIN (5, 69, budget.awake_permille);
+        TEST_ASSERT_UINT32_WITHIN (1, 33, budget.radio_permille);
+        TEST_ASSERT_UINT32_WITHIN (300, 6200, budget.average_ua);
+        TEST_ASSERT_UINT32_WITHIN (15, 324, budget.battery_hours);
+    }
+
+    // The hour so far holds only the last second, and there are no hours
+    // from before the run
+    TEST_ASSERT_TRUE (power_get_hour (0, hour));
+    TEST_ASSERT_LESS_OR_EQUAL (1000, hour.awake_ms + hour.asleep_ms);
+    TEST_ASSERT_FALSE (power_get_hour (TEST_HOURS + 1, hour));
+}
+
+
+/** @brief   The estimate weighs each state's current by its time, worked
+ *           out here by hand, and is all zeros with no time counted.
+ */
+void test_estimate_arithmetic (void)
+{
+    power_budget_t budget;
+
+    // 100 ms at 40 mA and 900 ms at 0.8 mA average 4.72 mA
+    power_hour_t dozing = { 100, 900, 0, 9 };
+    power_estimate (dozing, budget);
+    TEST_ASSERT_EQUAL_UINT32 (100, budget.awake_permille);
+    TEST_ASSERT_EQUAL_UINT32 (0, budget.radio_permille);
+    TEST_ASSERT_EQUAL_UINT32 (4720, budget.average_ua);
+    TEST_ASSERT_EQUAL_UINT32 (113, budget.mah_per_day);
+    TEST_ASSERT_EQUAL_UINT32 (2000000 / 4720, budget.battery_hours);
+
+    // Awake with the radio on all the time draws 120 mA
+    power_hour_t busy = { 1000, 0, 1000, 0 };
+    power_estimate (busy, budget);
+    TEST_ASSERT_EQUAL_UINT32 (1000, budget.awake_permille);
+    TEST_ASSERT_EQUAL_UINT32 (1000, budget.radio_permille);
+    TEST_ASSERT_EQUAL_UINT32 (POWER_AWAKE_UA + POWER_RADIO_UA,
+                              budget.average_ua);
+    TEST_ASSERT_EQUAL_UINT32 (2880, budget.mah_per_day);
+    TEST_ASSERT_EQUAL_UINT32 (16, budget.battery_hours);
+
+    power_hour_t nothing = { 0, 0, 0, 0 };
+    power_estimate (nothing, budget);
+    TEST_ASSERT_EQUAL_UINT32 (0, budget.average_ua);
+    TEST_ASSERT_EQUAL_UINT32 (0, budget.battery_hours);
+}
+
+
+int main (int argc, char** argv)
+{
+    simulate ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_samples_on_time);
+    RUN_TEST (test_radio_windows);
+    RUN_TEST (test_hours_and_estimate);
+    RUN_TEST (test_estimate_arithmetic);
+    return UNITY_END ();
+}
@@ -0,0 +1,323 @@
+/** @file test_main.cpp
+ *  This file contains tests of the double-buffered sample pipeline: the
+ *  order in which blocks reach the stages, the backpressure which drops
+ *  samples while both blocks are in use, the counts of what was dropped,
+ *  and a producer and consumer running in threads of their own.
+ *
+ *  Each reading put in is its sample's number plus a step per channel, so
+ *  a stage can tell from the readings alone whether any were lost, moved
+ *  or mixed up between the two blocks.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <thread>
+#include <unity.h>
+#include "sample_pipeline.h"
+
+/// Channels and samples per block of the pipelines tested
+const uint8_t TEST_CHANNELS = 3;
+const uint16_t TEST_BLOCK_SIZE = 8;
+
+/// Step added to a reading for each channel
+const uint16_t CHANNEL_STEP = 1000;
+
+/// The most blocks a test keeps track of
+const uint16_t MAX_SEEN = 4096;
+
+
+/** @brief   What a stage saw of one block.
+ */
+struct seen_t
+{
+    uint32_t sequence;          ///< The block's number
+    uint32_t first_sample;      ///< Samples offered before it
+    uint32_t start_time;        ///< Time of its first sample
+    uint16_t count;             ///< Samples in it
+    bool whole;                 ///< Every reading was where it should be
+};
+
+/// Blocks the first stage saw, in order
+static seen_t seen[MAX_SEEN];
+static uint16_t num_seen = 0;
+
+/// Each stage notes its number here as it runs
+static uint8_t stage_order[4];
+static uint8_t num_stage_runs = 0;
+
+
+/** @brief   Get the reading which sample @c number of a channel is given.
+ */
+static uint16_t reading (uint32_t number, uint8_t channel)
+{
+    return (uint16_t)(number + channel * CHANNEL_STEP);
+}
+
+
+/** @brief   Put sample @c number into a pipeline, with its time and offsets.
+ */
+static bool put_sample (SamplePipeline& pipeline, uint32_t number)
+{
+    uint16_t readings[TEST_CHANNELS];
+    uint16_t offsets[TEST_CHANNELS];
+    for (uint8_t channel = 0; channel < TEST_CHANNELS; channel++)
+    {
+        readings[channel] = reading (number, channel);
+        offsets[channel] = channel * 10;
+    }
+    return pipeline.put (number * 10, readings, offsets);
+}
+
+
+/** @brief   Stage which notes each block and checks its readings.
+ */
+static void stage_note (sample_block_t& block, void* p_context)
+{
+    seen_t& note = seen[num_seen < MAX_SEEN ? num_seen++ : MAX_SEEN - 1];
+    note.sequence = block.sequence;
+    note.first_sample = block.first_sample;
+    note.start_time = block.start_time;
+    note.count = block.count;
+    note.whole = (block.channels == TEST_CHANNELS);
+    for (uint8_t channel = 0; channel < block.channels; channel++)
+    {
+        for (uint16_t index = 0; index < block.count; index++)
+        {
+            note.whole = note.whole
+                && block.samples[channel][index]
+                   == reading (block.first_sample + index, channel)
+                && block.offsets[channel][index] == channel * 10;
+        }
+    }
+    stage_order[num_stage_runs++ % 4] = 1;
+}
+
+
+/** @brief   Stage which notes that it ran, after the first.
+ */
+static void stage_second (sample_block_t& block, void* p_context)
+{
+    stage_order[num_stage_runs++ % 4] = *(uint8_t*)p_context;
+}
+
+/// The chain of the pipelines tested
+typedef StageChain<stage_note, stage_second> test_chain_t;
+
+/// The second stage's context
+static uint8_t second_number = 2;
+
+/// Contexts of the stages
+static void* const CONTEXTS[] = { NULL, &second_number };
+
+/// The type of pipeline tested
+typedef StaticPipeline<TEST_CHANNELS, TEST_BLOCK_SIZE, test_chain_t>
+    test_pipeline_t;
+
+
+void setUp (void)
+{
+    num_seen = 0;
+    num_stage_runs = 0;
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Blocks reach the stages in the order they were filled, taking
+ *           turns between the two buffers, with every reading in place.
+ */
+void test_blocks_keep_their_order (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    for (uint32_t number = 0; number < 5 * TEST_BLOCK_SIZE; number++)
+    {
+        TEST_ASSERT_TRUE (put_sample (pipeline, number));
+        pipeline.process ();
+    }
+    TEST_ASSERT_EQUAL_UINT16 (5, num_seen);
+    for (uint16_t index = 0; index < num_seen; index++)
+    {
+        TEST_ASSERT_EQUAL_UINT32 (index, seen[index].sequence);
+        TEST_ASSERT_EQUAL_UINT32 (index * TEST_BLOCK_SIZE,
+                                  seen[index].first_sample);
+        TEST_ASSERT_EQUAL_UINT32 (index * TEST_BLOCK_SIZE * 10,
+                                  seen[index].start_time);
+        TEST_ASSERT_EQUAL_UINT16 (TEST_BLOCK_SIZE, seen[index].count);
+        TEST_ASSERT_TRUE (seen[index].whole);
+    }
+    TEST_ASSERT_TRUE (pipeline.is_idle ());
+}
+
+
+/** @brief   The stages run in the order of the chain, with their contexts.
+ */
+void test_stages_run_in_chain_order (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    TEST_ASSERT_EQUAL_UINT8 (2, pipeline.stage_count ());
+    for (uint32_t number = 0; number < TEST_BLOCK_SIZE; number++)
+    {
+        put_sample (pipeline, number);
+    }
+    TEST_ASSERT_TRUE (pipeline.process ());
+    TEST_ASSERT_EQUAL_UINT8 (2, num_stage_runs);
+    TEST_ASSERT_EQUAL_UINT8 (1, stage_order[0]);
+    TEST_ASSERT_EQUAL_UINT8 (2, stage_order[1]);
+    TEST_ASSERT_FALSE (pipeline.process ());
+}
+
+
+/** @brief   When both blocks are waiting to be processed, new samples are
+ *           dropped and counted, and one overflow is counted for the run.
+ */
+void test_backpressure_drops_and_counts (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    uint32_t number = 0;
+    for (; number < 2 * TEST_BLOCK_SIZE; number++)
+    {
+        TEST_ASSERT_TRUE (put_sample (pipeline, number));
+    }
+    for (uint16_t drop = 0; drop < 5; drop++, number++)
+    {
+        TEST_ASSERT_FALSE (put_sample (pipeline, number));
+    }
+    pipeline_stats_t stats = pipeline.stats ();
+    TEST_ASSERT_EQUAL_UINT32 (2 * TEST_BLOCK_SIZE, stats.samples_in);
+    TEST_ASSERT_EQUAL_UINT32 (5, stats.samples_dropped);
+    TEST_ASSERT_EQUAL_UINT32 (1, stats.overflows);
+    TEST_ASSERT_FALSE (pipeline.is_idle ());
+
+    // Freeing one block lets samples in again; the block which follows
+    // starts with the first sample offered after the drops
+    TEST_ASSERT_TRUE (pipeline.process ());
+    TEST_ASSERT_TRUE (put_sample (pipeline, number++));
+    TEST_ASSERT_TRUE (pipeline.process ());
+    TEST_ASSERT_TRUE (pipeline.flush ());
+    TEST_ASSERT_TRUE (pipeline.process ());
+
+    TEST_ASSERT_EQUAL_UINT16 (3, num_seen);
+    TEST_ASSERT_EQUAL_UINT32 (0, seen[0].first_sample);
+    TEST_ASSERT_EQUAL_UINT32 (TEST_BLOCK_SIZE, seen[1].first_sample);
+    TEST_ASSERT_EQUAL_UINT32 (2, seen[2].sequence);
+    TEST_ASSERT_EQUAL_UINT32 (2 * TEST_BLOCK_SIZE + 5, seen[2].first_sample);
+    TEST_ASSERT_EQUAL_UINT16 (1, seen[2].count);
+    for (uint16_t index = 0; index < num_seen; index++)
+    {
+        TEST_ASSERT_TRUE (seen[index].whole);
+    }
+}
+
+
+/** @brief   Each separate run of drops counts as one more overflow.
+ */
+void test_each_overflow_counted_once (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    uint32_t number = 0;
+    for (uint8_t run = 0; run < 3; run++)
+    {
+        while (put_sample (pipeline, number))
+        {
+            number++;
+        }
+        number++;
+        put_sample (pipeline, number++);
+        while (pipeline.process ())
+        {
+        }
+    }
+    pipeline_stats_t stats = pipeline.stats ();
+    TEST_ASSERT_EQUAL_UINT32 (3, stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32 (6, stats.samples_dropped);
+    TEST_ASSERT_EQUAL_UINT32 (number, stats.samples_in
+                                      + stats.samples_dropped);
+    TEST_ASSERT_EQUAL_UINT32 (num_seen, stats.blocks_processed);
+}
+
+
+/** @brief   A part block is handed on by @c flush(), and an empty one
+ *           isn't.
+ */
+void test_flush_hands_on_part_blocks (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    TEST_ASSERT_FALSE (pipeline.flush ());
+    put_sample (pipeline, 0);
+    put_sample (pipeline, 1);
+    TEST_ASSERT_FALSE (pipeline.process ());
+    TEST_ASSERT_TRUE (pipeline.flush ());
+    TEST_ASSERT_FALSE (pipeline.flush ());
+    TEST_ASSERT_TRUE (pipeline.process ());
+    TEST_ASSERT_EQUAL_UINT16 (1, num_seen);
+    TEST_ASSERT_EQUAL_UINT16 (2, seen[0].count);
+    TEST_ASSERT_TRUE (seen[0].whole);
+}
+
+
+/** @brief   A producer and a consumer in threads of their own, as the sensor
+ *           and processing tasks are, lose nothing but what's counted as
+ *           dropped, and blocks come out in order and whole.
+ */
+void test_threads_keep_order (void)
+{
+    static test_pipeline_t pipeline (CONTEXTS);
+    const uint32_t SAMPLES = (uint32_t)MAX_SEEN * TEST_BLOCK_SIZE;
+    std::atomic<bool> done (false);
+
+    std::thread consumer ([&] ()
+    {
+        while (!done.load () || !pipeline.is_idle ())
+        {
+            if (!pipeline.process ())
+            {
+                std::this_thread::yield ();
+            }
+        }
+    });
+    for (uint32_t number = 0; number < SAMPLES; number++)
+    {
+        put_sample (pipeline, number);
+    }
+    pipeline.flush ();
+    done.store (true);
+    consumer.join ();
+
+    pipeline_stats_t stats = pipeline.stats ();
+    TEST_ASSERT_EQUAL_UINT32 (SAMPLES, stats.samples_in
+                                       + stats.samples_dropped);
+    TEST_ASSERT_EQUAL_UINT32 (num_seen, stats.blocks_processed);
+
+    uint32_t counted = 0;
+    for (uint16_t index = 0; index < num_seen; index++)
+    {
+        TEST_ASSERT_EQUAL_UINT32 (index, seen[index].sequence);
+        TEST_ASSERT_TRUE (seen[index].whole);
+        if (index > 0)
+        {
+            TEST_ASSERT_GREATER_OR_EQUAL (seen[index - 1].first_sample
+                                          + seen[index - 1].count,
+                                          seen[index].first_sample);
+        }
+        counted += seen[index].count;
+    }
+    TEST_ASSERT_EQUAL_UINT32 (stats.samples_in, counted);
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_blocks_keep_their_order);
+    RUN_TEST (test_stages_run_in_chain_order);
+    RUN_TEST (test_backpressure_drops_and_counts);
+    RUN_TEST (test_each_overflow_counted_once);
+    RUN_TEST (test_flush_hands_on_part_blocks);
+    RUN_TEST (test_threads_keep_order);
+    return UNITY_END ();
+}
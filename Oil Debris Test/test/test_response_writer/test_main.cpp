@@ -0,0 +1,333 @@
+/** @file test_main.cpp
+ *  This file contains tests of the response writer against a client which
+ *  counts what it's given: the bytes of the status line and headers, pages
+ *  going out in as few TCP-sized writes as they can, long bodies sent
+ *  straight from the caller's memory with only a top-up copied, a client
+ *  which takes less than it's given, and no use of the heap throughout.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "response_writer.h"
+#include "mem_pool.h"
+
+/// Most bytes and writes the client keeps track of
+const size_t CLIENT_MAX_BYTES = 65536;
+const uint16_t CLIENT_MAX_WRITES = 256;
+
+/// The headers of a 200 response of CSV with no length given
+static const char CSV_HEADERS[] = "HTTP/1.1 200 OK\r\n"
+                                  "Content-Type: text/csv\r\n"
+                                  "Connection: close\r\n\r\n";
+
+
+/** @brief   Class which stands in for a web client's connection, keeping
+ *           every byte and the size of every write it's given.
+ */
+class CountingClient : public Print
+{
+public:
+    char bytes[CLIENT_MAX_BYTES];           ///< Everything taken, in order
+    size_t taken;                           ///< Bytes taken
+    size_t sizes[CLIENT_MAX_WRITES];        ///< Size of each write
+    uint16_t writes;                        ///< Writes made
+    size_t limit;                           ///< Most bytes it will take
+
+    CountingClient (void)
+    {
+        reset ();
+    }
+
+    /// Forget everything taken, and take as much as there's room for
+    void reset (void)
+    {
+        taken = 0;
+        writes = 0;
+        limit = CLIENT_MAX_BYTES;
+    }
+
+    using Print::write;
+
+    /// Take one byte, as a write of its own
+    size_t write (uint8_t byte)
+    {
+        return write (&byte, 1);
+    }
+
+    /// Take as many bytes as the limit allows
+    size_t write (const uint8_t* data, size_t count)
+    {
+        if (writes < CLIENT_MAX_WRITES)
+        {
+            sizes[writes] = count;
+        }
+        writes++;
+        size_t room = limit - taken;
+        size_t take = (count < room) ? count : room;
+        memcpy (bytes + taken, data, take);
+        taken += take;
+        return take;
+    }
+
+    /// Find out whether the bytes taken are those given
+    bool holds (const char* text) const
+    {
+        return taken == strlen (text) && memcmp (bytes, text, taken) == 0;
+    }
+};
+
+/// The client, which is large, so it isn't kept on the stack
+static CountingClient client;
+
+/// The writer's buffer, as a block from the response pool would be
+static char buffer[RESPONSE_CHUNK_SIZE];
+
+/// A long body to send
+static char body[16384];
+
+/// Heap allocations counted when each test started
+static uint32_t allocations;
+
+
+void setUp (void)
+{
+    client.reset ();
+    allocations = heap_guard_count ();
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   The status line and headers are written as HTTP has them, and a
+ *           response with no body goes out in one write.
+ */
+void test_headers (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    TEST_ASSERT_TRUE (page.end ());
+    TEST_ASSERT_TRUE (client.holds (CSV_HEADERS));
+    TEST_ASSERT_EQUAL_UINT16 (1, client.writes);
+
+    client.reset ();
+    ResponseWriter sized (client, buffer, sizeof (buffer));
+    sized.begin (206, "application/octet-stream", 1234);
+    sized.header ("Content-Range", "bytes 0-1233/5000");
+    sized.end ();
+    TEST_ASSERT_TRUE (client.holds ("HTTP/1.1 206 Partial Content\r\n"
+                                    "Content-Type: application/octet-stream"
+                                    "\r\nContent-Length: 1234\r\n"
+                                    "Connection: close\r\n"
+                                    "Content-Range: bytes 0-1233/5000\r\n"
+                                    "\r\n"));
+}
+
+
+/** @brief   Each status the tester sends has its reason phrase.
+ */
+void test_status_text (void)
+{
+    const int codes[] = { 200, 204, 400, 404, 416, 429, 503 };
+    const char* const lines[] = { "HTTP/1.1 200 OK\r\n",
+                                  "HTTP/1.1 204 No Content\r\n",
+                                  "HTTP/1.1 400 Bad Request\r\n",
+                                  "HTTP/1.1 404 Not Found\r\n",
+                                  "HTTP/1.1 416 Range Not Satisfiable\r\n",
+                                  "HTTP/1.1 429 Too Many Requests\r\n",
+                                  "HTTP/1.1 503 Service Unavailable\r\n" };
+    for (uint8_t index = 0; index < 7; index++)
+    {
+        client.reset ();
+        ResponseWriter page (client, buffer, sizeof (buffer));
+        page.begin (codes[index], "text/plain");
+        page.end ();
+        TEST_ASSERT_EQUAL_STRING_LEN (lines[index], client.bytes,
+                                      strlen (lines[index]));
+    }
+}
+
+
+/** @brief   Numbers are written in decimal, with a decimal point where asked.
+ */
+void test_numbers (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    page.write_uint (0);
+    page.write (",");
+    page.write_uint (4294967295U);
+    page.write (",");
+    page.write_int (-42);
+    page.write (",");
+    page.write_fixed (12345, 3);
+    page.write (",");
+    page.write_fixed (-5, 3);
+    page.end ();
+
+    char expected[200];
+    strcpy (expected, CSV_HEADERS);
+    strcat (expected, "0,4294967295,-42,12.345,-0.005");
+    TEST_ASSERT_TRUE (client.holds (expected));
+}
+
+
+/** @brief   A page shorter than a chunk, written a little at a time as
+ *           @c /csv is, goes out in one write with every byte copied once.
+ */
+void test_short_page_one_write (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    page.write ("time_ms,fine_V,coarse_V\n");
+    for (uint32_t row = 0; row < 20; row++)
+    {
+        page.write_uint (row * 10);
+        page.write (",");
+        page.write_fixed (1650 + row, 3);
+        page.write (",");
+        page.write_fixed (2200 - row, 3);
+        page.write ("\n");
+    }
+    TEST_ASSERT_TRUE (page.end ());
+
+    TEST_ASSERT_EQUAL_UINT16 (1, client.writes);
+    TEST_ASSERT_EQUAL_UINT16 (1, page.get_flushes ());
+    TEST_ASSERT_EQUAL_UINT32 (client.taken, page.get_bytes_sent ());
+    TEST_ASSERT_EQUAL_UINT32 (client.taken, page.get_bytes_copied ());
+    TEST_ASSERT_EQUAL_UINT32 (allocations, heap_guard_count ());
+}
+
+
+/** @brief   A page longer than a chunk, written a little at a time, goes out
+ *           in full chunks and then what's left.
+ */
+void test_long_page_full_chunks (void)
+{
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    for (uint32_t row = 0; row < 1000; row++)
+    {
+        page.write_uint (row);
+        page.write ("\n");
+    }
+    page.end ();
+
+    uint16_t expected = (client.taken + RESPONSE_CHUNK_SIZE - 1)
+                        / RESPONSE_CHUNK_SIZE;
+    TEST_ASSERT_EQUAL_UINT16 (expected, client.writes);
+    for (uint16_t index = 0; index + 1 < client.writes; index++)
+    {
+        TEST_ASSERT_EQUAL_size_t (RESPONSE_CHUNK_SIZE, client.sizes[index]);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (client.taken, page.get_bytes_copied ());
+    TEST_ASSERT_EQUAL_UINT32 (allocations, heap_guard_count ());
+}
+
+
+/** @brief   A long body written at once tops up the buffer, sends the full
+ *           chunks after that straight from the caller's memory, and copies
+ *           only what's left at the end: three writes for 16 KB.
+ */
+void test_long_write_sent_directly (void)
+{
+    for (size_t index = 0; index < sizeof (body); index++)
+    {
+        body[index] = (char)('a' + index % 26);
+    }
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    page.write (body, sizeof (body));
+    TEST_ASSERT_TRUE (page.end ());
+
+    size_t headers = strlen (CSV_HEADERS);
+    TEST_ASSERT_EQUAL_UINT16 (3, client.writes);
+    TEST_ASSERT_EQUAL_size_t (RESPONSE_CHUNK_SIZE, client.sizes[0]);
+    TEST_ASSERT_EQUAL_size_t (0, client.sizes[1] % RESPONSE_CHUNK_SIZE);
+    TEST_ASSERT_EQUAL_UINT32 (headers + sizeof (body), client.taken);
+    TEST_ASSERT_EQUAL_MEMORY (body, client.bytes + headers, sizeof (body));
+
+    // Only the first chunk and the tail were copied
+    uint32_t tail = (headers + sizeof (body)) % RESPONSE_CHUNK_SIZE;
+    TEST_ASSERT_EQUAL_UINT32 (RESPONSE_CHUNK_SIZE + tail,
+                              page.get_bytes_copied ());
+    TEST_ASSERT_LESS_THAN (2 * RESPONSE_CHUNK_SIZE, page.get_bytes_copied ());
+    TEST_ASSERT_EQUAL_UINT32 (allocations, heap_guard_count ());
+}
+
+
+/** @brief   A write which would fill less than two chunks is copied, so the
+ *           client isn't given a short write in the middle of a page.
+ */
+void test_medium_write_copied (void)
+{
+    memset (body, 'x', 2000);
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    page.write (body, 2000);
+    page.end ();
+    TEST_ASSERT_EQUAL_UINT16 (2, client.writes);
+    TEST_ASSERT_EQUAL_size_t (RESPONSE_CHUNK_SIZE, client.sizes[0]);
+    TEST_ASSERT_EQUAL_UINT32 (client.taken, page.get_bytes_copied ());
+}
+
+
+/** @brief   A buffer smaller than a chunk sends pieces of its own size.
+ */
+void test_small_buffer (void)
+{
+    char small[100];
+    memset (body, 'y', 1000);
+    ResponseWriter page (client, small, sizeof (small));
+    page.begin (200, "text/csv");
+    page.write (body, 1000);
+    page.end ();
+    for (uint16_t index = 0; index + 1 < client.writes; index++)
+    {
+        TEST_ASSERT_EQUAL_size_t (0, client.sizes[index] % sizeof (small));
+    }
+    TEST_ASSERT_EQUAL_UINT32 (strlen (CSV_HEADERS) + 1000, client.taken);
+    TEST_ASSERT_EQUAL_MEMORY (body, client.bytes + strlen (CSV_HEADERS),
+                              1000);
+}
+
+
+/** @brief   A client which stops taking bytes, as one whose connection has
+ *           dropped does, makes @c end() report the failure, and only what
+ *           it took is counted as sent.
+ */
+void test_client_which_stops (void)
+{
+    client.limit = 2000;
+    memset (body, 'z', 5000);
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "text/csv");
+    page.write (body, 5000);
+    TEST_ASSERT_FALSE (page.end ());
+    TEST_ASSERT_EQUAL_UINT32 (2000, page.get_bytes_sent ());
+    TEST_ASSERT_EQUAL_size_t (2000, client.taken);
+}
+
+
+int main (int argc, char** argv)
+{
+    heap_guard_seal ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_headers);
+    RUN_TEST (test_status_text);
+    RUN_TEST (test_numbers);
+    RUN_TEST (test_short_page_one_write);
+    RUN_TEST (test_long_page_full_chunks);
+    RUN_TEST (test_long_write_sent_directly);
+    RUN_TEST (test_medium_write_copied);
+    RUN_TEST (test_small_buffer);
+    RUN_TEST (test_client_which_stops);
+    return UNITY_END ();
+}
@@ -0,0 +1,219 @@
+/** @file test_main.cpp
+ *  This file contains tests of the latency histograms which @c /stats
+ *  reports: the buckets either side of the edge of the exact ones and of
+ *  each power of two, the last bucket and the times past it, that every
+ *  time's bucket reaches up to it and no more than 1/8 past it, and the
+ *  percentiles of distributions whose answers are known.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <unity.h>
+#include "route_stats.h"
+
+/// The histogram each test fills
+static LatencyHistogram histogram;
+
+
+/** @brief   Check that a time's bucket reaches up to the time, and no more
+ *           than an eighth past it.
+ */
+static void check_bucket_holds (uint32_t time_us)
+{
+    uint32_t top = LatencyHistogram::bucket_top (
+        LatencyHistogram::bucket_of (time_us));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32 (time_us, top);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32 (time_us + time_us / 8, top);
+}
+
+
+void setUp (void)
+{
+    histogram.reset ();
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Test the buckets at the edge of the exact ones, at a power of
+ *           two, and at the end of the range and past it.
+ */
+void test_bucket_edges (void)
+{
+    // Up to 15 us each time has its own bucket; 16 and 17 share one
+    TEST_ASSERT_EQUAL_UINT16 (0, LatencyHistogram::bucket_of (0));
+    TEST_ASSERT_EQUAL_UINT16 (15, LatencyHistogram::bucket_of (15));
+    TEST_ASSERT_EQUAL_UINT32 (15, LatencyHistogram::bucket_top (15));
+    TEST_ASSERT_EQUAL_UINT16 (16, LatencyHistogram::bucket_of (16));
+    TEST_ASSERT_EQUAL_UINT16 (16, LatencyHistogram::bucket_of (17));
+    TEST_ASSERT_EQUAL_UINT32 (17, LatencyHistogram::bucket_top (16));
+    TEST_ASSERT_EQUAL_UINT16 (17, LatencyHistogram::bucket_of (18));
+
+    // 31 ends the octave from 16, and 32 starts one of buckets 4 us wide
+    TEST_ASSERT_EQUAL_UINT16 (23, LatencyHistogram::bucket_of (31));
+    TEST_ASSERT_EQUAL_UINT32 (31, LatencyHistogram::bucket_top (23));
+    TEST_ASSERT_EQUAL_UINT16 (24, LatencyHistogram::bucket_of (32));
+    TEST_ASSERT_EQUAL_UINT32 (35, LatencyHistogram::bucket_top (24));
+
+    // The longest time told apart ends the last bucket, and longer times
+    // go in it too
+    TEST_ASSERT_EQUAL_UINT16 (STATS_BUCKETS - 1,
+                              LatencyHistogram::bucket_of (STATS_MAX_US));
+    TEST_ASSERT_EQUAL_UINT32 (STATS_MAX_US,
+                              LatencyHistogram::bucket_top (STATS_BUCKETS
+                                                            - 1));
+    TEST_ASSERT_EQUAL_UINT16 (STATS_BUCKETS - 1,
+                              LatencyHistogram::bucket_of (STATS_MAX_US + 1));
+    TEST_ASSERT_EQUAL_UINT16 (STATS_BUCKETS - 1,
+                              LatencyHistogram::bucket_of (0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_UINT16 (STATS_BUCKETS - 2,
+                              LatencyHistogram::bucket_of (
+                                  STATS_MAX_US - (1UL << 20)));
+}
+
+
+/** @brief   Test that the buckets follow each other with no gaps: each
+ *           bucket's top is in it and the next time is in the next one.
+ */
+void test_buckets_follow_on (void)
+{
+    for (uint16_t bucket = 0; bucket < STATS_BUCKETS; bucket++)
+    {
+        uint32_t top = LatencyHistogram::bucket_top (bucket);
+        TEST_ASSERT_EQUAL_UINT16 (bucket, LatencyHistogram::bucket_of (top));
+        if (bucket + 1 < STATS_BUCKETS)
+        {
+            TEST_ASSERT_EQUAL_UINT16 (bucket + 1,
+                                      LatencyHistogram::bucket_of (top + 1));
+        }
+    }
+}
+
+
+/** @brief   Test that every time up to a second, and times spread over the
+ *           rest of the range, are held by buckets no wider than 1/8.
+ */
+void test_bucket_holds_time (void)
+{
+    for (uint32_t time_us = 0; time_us <= 1000000; time_us++)
+    {
+        check_bucket_holds (time_us);
+    }
+    for (uint32_t time_us = 1000000; time_us <= STATS_MAX_US;
+         time_us += time_us / 1000 + 1)
+    {
+        check_bucket_holds (time_us);
+    }
+    check_bucket_holds (STATS_MAX_US);
+}
+
+
+/** @brief   Test the count, mean, shortest and longest times, and that an
+ *           empty histogram reports zeros.
+ */
+void test_summary (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (0, histogram.count ());
+    TEST_ASSERT_EQUAL_UINT32 (0, histogram.mean ());
+    TEST_ASSERT_EQUAL_UINT32 (0, histogram.shortest ());
+    TEST_ASSERT_EQUAL_UINT32 (0, histogram.longest ());
+    TEST_ASSERT_EQUAL_UINT32 (0, histogram.percentile (50.0f));
+
+    histogram.record (100);
+    histogram.record (20);
+    histogram.record (3000);
+    TEST_ASSERT_EQUAL_UINT32 (3, histogram.count ());
+    TEST_ASSERT_EQUAL_UINT32 (1040, histogram.mean ());
+    TEST_ASSERT_EQUAL_UINT32 (20, histogram.shortest ());
+    TEST_ASSERT_EQUAL_UINT32 (3000, histogram.longest ());
+    TEST_ASSERT_EQUAL_UINT32 (1, histogram.bucket_count (
+        LatencyHistogram::bucket_of (3000)));
+}
+
+
+/** @brief   Test the percentiles of times from 1 to 1000 us, one each: each
+ *           is the top of the bucket of its exact answer, but never past the
+ *           longest time.
+ */
+void test_uniform_percentiles (void)
+{
+    for (uint32_t time_us = 1; time_us <= 1000; time_us++)
+    {
+        histogram.record (time_us);
+    }
+    static const float PERCENTS[] = { 1.0f, 10.0f, 50.0f, 90.0f, 99.0f };
+    for (size_t index = 0; index < sizeof (PERCENTS) / sizeof (PERCENTS[0]);
+         index++)
+    {
+        uint32_t exact = (uint32_t)(PERCENTS[index] * 10.0f);
+        uint32_t top = LatencyHistogram::bucket_top (
+            LatencyHistogram::bucket_of (exact));
+        TEST_ASSERT_EQUAL_UINT32 ((top < 1000) ? top : 1000,
+                                  histogram.percentile (PERCENTS[index]));
+    }
+    TEST_ASSERT_EQUAL_UINT32 (511, histogram.percentile (50.0f));
+    TEST_ASSERT_EQUAL_UINT32 (1, histogram.percentile (0.0f));
+    TEST_ASSERT_EQUAL_UINT32 (1000, histogram.percentile (100.0f));
+}
+
+
+/** @brief   Test distributions whose percentiles are exact: one time over
+ *           and over, and two clusters split at the 90th percentile.
+ */
+void test_known_percentiles (void)
+{
+    for (uint32_t count = 0; count < 1000; count++)
+    {
+        histogram.record (123);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (123, histogram.percentile (0.0f));
+    TEST_ASSERT_EQUAL_UINT32 (123, histogram.percentile (50.0f));
+    TEST_ASSERT_EQUAL_UINT32 (123, histogram.percentile (100.0f));
+
+    histogram.reset ();
+    for (uint32_t count = 0; count < 900; count++)
+    {
+        histogram.record (10);
+    }
+    for (uint32_t count = 0; count < 100; count++)
+    {
+        histogram.record (50000);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (10, histogram.percentile (50.0f));
+    TEST_ASSERT_EQUAL_UINT32 (10, histogram.percentile (90.0f));
+    TEST_ASSERT_EQUAL_UINT32 (50000, histogram.percentile (91.0f));
+    TEST_ASSERT_EQUAL_UINT32 (50000, histogram.percentile (99.9f));
+}
+
+
+/** @brief   Test that times past the range are counted in the last bucket,
+ *           and that their percentile is the end of the range.
+ */
+void test_times_past_range (void)
+{
+    histogram.record (STATS_MAX_US + 1);
+    histogram.record (0xFFFFFFFF);
+    TEST_ASSERT_EQUAL_UINT32 (2, histogram.bucket_count (STATS_BUCKETS - 1));
+    TEST_ASSERT_EQUAL_UINT32 (0xFFFFFFFF, histogram.longest ());
+    TEST_ASSERT_EQUAL_UINT32 (STATS_MAX_US, histogram.percentile (50.0f));
+    TEST_ASSERT_EQUAL_UINT32 (STATS_MAX_US, histogram.percentile (100.0f));
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_bucket_edges);
+    RUN_TEST (test_buckets_follow_on);
+    RUN_TEST (test_bucket_holds_time);
+    RUN_TEST (test_summary);
+    RUN_TEST (test_uniform_percentiles);
+    RUN_TEST (test_known_percentiles);
+    RUN_TEST (test_times_past_range);
+    return UNITY_END ();
+}
@@ -0,0 +1,362 @@
+/** @file test_main.cpp
+ *  This file contains tests of the scan schedule and the align stage: the
+ *  order of the conversions and the times noted for them, the straight-line
+ *  step back to the start of the scan, and a simulation which puts a pulse
+ *  through a channel-by-channel ADC and checks how far the readings are
+ *  from what each channel would have read at the start of its scan.
+ *
+ *  The simulated ADC takes @c CONVERT_US plus up to @c JITTER_US for each
+ *  conversion, and reads the signal halfway through, as the schedule
+ *  assumes. Every channel sees the same Gaussian pulse, so with perfect
+ *  alignment all channels would read the same.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <math.h>
+#include <unity.h>
+#include "sample_schedule.h"
+#include "pipeline_stages.h"
+
+/// Time each simulated conversion takes, and the most it may run over
+const uint32_t CONVERT_US = 11;
+const uint32_t JITTER_US = 2;
+
+/// Scans in each simulation, and in each block given to the align stage
+const uint16_t SIM_SCANS = 2000;
+const uint16_t SIM_BLOCK_SIZE = 50;
+
+/// The pulse's height above the baseline, and the baseline, in counts
+const double PULSE_COUNTS = 2000.0;
+const double BASELINE_COUNTS = 1000.0;
+
+/// Scans from one pulse to the next
+const uint16_t PULSE_EVERY = 100;
+
+
+/** @brief   What the simulated ADC is measuring.
+ */
+struct sim_t
+{
+    uint32_t now;               ///< The time, in microseconds
+    uint32_t seed;              ///< State of the jitter's random numbers
+    double sigma_us;            ///< Standard deviation of the pulse
+    uint32_t period_us;         ///< Time between scans
+};
+
+/// The simulation being run; the clock function can't be given a context
+static sim_t sim;
+
+
+/** @brief   Get the signal at a time: a Gaussian pulse every
+ *           @c PULSE_EVERY scans, centred in between.
+ */
+static double signal_at (double time_us)
+{
+    double every = (double)sim.period_us * PULSE_EVERY;
+    double from_peak = fmod (time_us, every) - every / 2;
+    return BASELINE_COUNTS + PULSE_COUNTS
+           * exp (-from_peak * from_peak / (2 * sim.sigma_us * sim.sigma_us));
+}
+
+
+/** @brief   Give the simulated time.
+ */
+static uint32_t sim_clock (void)
+{
+    return sim.now;
+}
+
+
+/** @brief   Convert a channel, reading the signal halfway through.
+ */
+static uint16_t sim_read (uint8_t channel, void* p_context)
+{
+    sim.seed = sim.seed * 1103515245 + 12345;
+    uint32_t took = CONVERT_US + (sim.seed >> 16) % (JITTER_US + 1);
+    double reading = signal_at (sim.now + took / 2.0);
+    sim.now += took;
+    return (uint16_t)lround (reading);
+}
+
+
+/** @brief   Run a simulation and find the RMS error of the readings against
+ *           the signal at the start of each scan.
+ *  @param   channels The number of channels
+ *  @param   order The order of the conversions in each scan
+ *  @param   period_us The time between scans
+ *  @param   width The pulse's standard deviation, in scan periods
+ *  @param   aligned Whether the readings go through the align stage
+ *  @returns The RMS error, in counts, over every channel and scan
+ */
+static double rms_error (uint8_t channels, schedule_order_t order,
+                         uint32_t period_us, double width, bool aligned)
+{
+    static uint16_t readings[PIPELINE_MAX_CHANNELS][SIM_BLOCK_SIZE];
+    static uint16_t offsets[PIPELINE_MAX_CHANNELS][SIM_BLOCK_SIZE];
+    static uint32_t starts[SIM_BLOCK_SIZE];
+    sim.seed = 4321;
+    sim.sigma_us = width * period_us;
+    sim.period_us = period_us;
+
+    SampleSchedule schedule (channels, order);
+    align_state_t align = { period_us, false, {} };
+    sample_block_t block;
+    block.channels = channels;
+    block.count = SIM_BLOCK_SIZE;
+    for (uint8_t channel = 0; channel < channels; channel++)
+    {
+        block.samples[channel] = readings[channel];
+        block.offsets[channel] = offsets[channel];
+    }
+
+    double squares = 0.0;
+    for (uint16_t scan = 0; scan < SIM_SCANS; scan++)
+    {
+        uint16_t index = scan % SIM_BLOCK_SIZE;
+        uint16_t one[PIPELINE_MAX_CHANNELS];
+        uint16_t times[PIPELINE_MAX_CHANNELS];
+        sim.now = (uint32_t)scan * period_us;
+        starts[index] = schedule.scan (sim_read, sim_clock, NULL, one, times);
+        for (uint8_t channel = 0; channel < channels; channel++)
+        {
+            readings[channel][index] = one[channel];
+            offsets[channel][index] = times[channel];
+        }
+        if (index < SIM_BLOCK_SIZE - 1)
+        {
+            continue;
+        }
+
+        if (aligned)
+        {
+            stage_align (block, &align);
+        }
+        for (uint16_t sample = 0; sample < SIM_BLOCK_SIZE; sample++)
+        {
+            double truth = signal_at (starts[sample]);
+            for (uint8_t channel = 0; channel < channels; channel++)
+            {
+                double error = readings[channel][sample] - truth;
+                squares += error * error;
+            }
+        }
+    }
+    return sqrt (squares / ((double)SIM_SCANS * channels));
+}
+
+
+void setUp (void)
+{
+    sim.now = 0;
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   The forward order converts the channels in order every scan;
+ *           the mirrored order reverses every other scan.
+ */
+void test_schedule_orders (void)
+{
+    SampleSchedule forward (3, SCHEDULE_FORWARD);
+    SampleSchedule mirrored (3, SCHEDULE_MIRRORED);
+    uint16_t readings[3];
+    uint16_t offsets[3];
+    for (uint8_t scan = 0; scan < 4; scan++)
+    {
+        for (uint8_t slot = 0; slot < 3; slot++)
+        {
+            TEST_ASSERT_EQUAL_UINT8 (slot, forward.channel_at (slot));
+            TEST_ASSERT_EQUAL_UINT8 ((scan & 1) ? 2 - slot : slot,
+                                     mirrored.channel_at (slot));
+        }
+        forward.scan (sim_read, sim_clock, NULL, readings, offsets);
+        mirrored.scan (sim_read, sim_clock, NULL, readings, offsets);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (4, mirrored.get_scans ());
+
+    // Channel counts out of range are brought into it
+    SampleSchedule none (0, SCHEDULE_MIRRORED);
+    SampleSchedule many (PIPELINE_MAX_CHANNELS + 3, SCHEDULE_MIRRORED);
+    many.scan (sim_read, sim_clock, NULL, readings, offsets);
+    TEST_ASSERT_EQUAL_UINT8 (0, none.channel_at (0));
+    TEST_ASSERT_EQUAL_UINT8 (PIPELINE_MAX_CHANNELS - 1, many.channel_at (0));
+}
+
+
+/** @brief   Each conversion's time is halfway through it, from the start of
+ *           the scan, and is given in channel order whatever the slot.
+ */
+void test_schedule_offsets (void)
+{
+    SampleSchedule schedule (2, SCHEDULE_MIRRORED);
+    uint16_t readings[2];
+    uint16_t offsets[2];
+    sim.seed = 0;
+    sim.period_us = 1000;
+    sim.sigma_us = 1.0;
+
+    sim.now = 5000;
+    TEST_ASSERT_EQUAL_UINT32 (5000, schedule.scan (sim_read, sim_clock, NULL,
+                                                   readings, offsets));
+    TEST_ASSERT_GREATER_OR_EQUAL (CONVERT_US / 2, offsets[0]);
+    TEST_ASSERT_LESS_OR_EQUAL ((CONVERT_US + JITTER_US) / 2, offsets[0]);
+    TEST_ASSERT_GREATER_OR_EQUAL (CONVERT_US * 3 / 2, offsets[1]);
+    TEST_ASSERT_LESS_OR_EQUAL ((CONVERT_US + JITTER_US) * 3 / 2, offsets[1]);
+
+    // The second scan runs backwards, so channel 1 comes first
+    sim.now = 6000;
+    schedule.scan (sim_read, sim_clock, NULL, readings, offsets);
+    TEST_ASSERT_GREATER_THAN (offsets[1], offsets[0]);
+    TEST_ASSERT_GREATER_OR_EQUAL (CONVERT_US / 2, offsets[1]);
+    TEST_ASSERT_LESS_OR_EQUAL ((CONVERT_US + JITTER_US) / 2, offsets[1]);
+}
+
+
+/** @brief   Readings taken at the start of the scan, or with no period set,
+ *           are left as they are.
+ */
+void test_align_leaves_on_time_readings (void)
+{
+    uint16_t readings[] = { 100, 900, 300, 4095, 0 };
+    uint16_t offsets[] = { 0, 0, 0, 0, 0 };
+    sample_block_t block;
+    block.channels = 1;
+    block.count = 5;
+    block.samples[0] = readings;
+    block.offsets[0] = offsets;
+
+    align_state_t align = { 1000, false, {} };
+    stage_align (block, &align);
+    const uint16_t expected[] = { 100, 900, 300, 4095, 0 };
+    TEST_ASSERT_EQUAL_UINT16_ARRAY (expected, readings, 5);
+    TEST_ASSERT_EQUAL_UINT16 (0, align.last[0]);
+
+    align_state_t off = { 0, false, {} };
+    for (uint8_t index = 0; index < 5; index++)
+    {
+        offsets[index] = 500;
+    }
+    stage_align (block, &off);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY (expected, readings, 5);
+    TEST_ASSERT_FALSE (off.primed);
+}
+
+
+/** @brief   A reading taken part way through the period is moved that far
+ *           back along the line from the reading before, which carries over
+ *           from the block before.
+ */
+void test_align_steps_back_along_the_line (void)
+{
+    uint16_t readings[] = { 1000, 2000, 2000, 1000 };
+    uint16_t offsets[] = { 250, 250, 500, 1500 };
+    sample_block_t block;
+    block.channels = 1;
+    block.count = 4;
+    block.samples[0] = readings;
+    block.offsets[0] = offsets;
+
+    // The first reading of all has nothing before it, so it stays put;
+    // an offset past the period is taken as the whole period
+    align_state_t align = { 1000, false, {} };
+    stage_align (block, &align);
+    TEST_ASSERT_TRUE (align.primed);
+    TEST_ASSERT_EQUAL_UINT16 (1000, readings[0]);
+    TEST_ASSERT_EQUAL_UINT16 (1750, readings[1]);
+    TEST_ASSERT_EQUAL_UINT16 (2000, readings[2]);
+    TEST_ASSERT_EQUAL_UINT16 (2000, readings[3]);
+    TEST_ASSERT_EQUAL_UINT16 (1000, align.last[0]);
+
+    // The next block starts from the last reading of this one
+    readings[0] = 3000;
+    offsets[0] = 100;
+    block.count = 1;
+    stage_align (block, &align);
+    TEST_ASSERT_EQUAL_UINT16 (2800, readings[0]);
+    TEST_ASSERT_EQUAL_UINT16 (3000, align.last[0]);
+}
+
+
+/** @brief   Where the pulse is slow next to the skew between channels,
+ *           nothing needs aligning and aligning costs nothing; what's left
+ *           is the rounding to whole counts.
+ */
+void test_slow_pulse_needs_no_align (void)
+{
+    double forward = rms_error (2, SCHEDULE_FORWARD, 10000, 5.0, false);
+    double aligned = rms_error (2, SCHEDULE_MIRRORED, 10000, 5.0, true);
+    TEST_ASSERT_LESS_THAN_FLOAT (0.4f, (float)forward);
+    TEST_ASSERT_LESS_THAN_FLOAT (0.4f, (float)aligned);
+}
+
+
+/** @brief   Once the skew is a noticeable part of the period, aligning cuts
+ *           the error to well under half that of the raw readings.
+ */
+void test_align_cuts_skew_error (void)
+{
+    /** @brief   A simulation and the most RMS error allowed after aligning.
+     */
+    struct sim_case_t
+    {
+        uint8_t channels;       ///< Channels converted in each scan
+        uint32_t period_us;     ///< Time between scans
+        double width;           ///< Pulse's standard deviation in periods
+        float most_aligned;     ///< Most RMS error after aligning
+    };
+    const sim_case_t cases[] =
+    {
+        { 2, 1000, 5.0, 0.5f },
+        { 2, 200, 5.0, 1.5f },
+        { 2, 200, 20.0, 1.0f },
+        { 8, 1000, 5.0, 1.2f },
+        { 8, 200, 5.0, 12.0f },
+    };
+    for (uint8_t index = 0; index < sizeof (cases) / sizeof (cases[0]);
+         index++)
+    {
+        const sim_case_t& sim_case = cases[index];
+        double raw = rms_error (sim_case.channels, SCHEDULE_MIRRORED,
+                                sim_case.period_us, sim_case.width, false);
+        double aligned = rms_error (sim_case.channels, SCHEDULE_MIRRORED,
+                                    sim_case.period_us, sim_case.width, true);
+        TEST_ASSERT_LESS_THAN_FLOAT (sim_case.most_aligned, (float)aligned);
+        TEST_ASSERT_LESS_THAN_FLOAT ((float)(raw / 2), (float)aligned);
+    }
+}
+
+
+/** @brief   A pulse only two scans wide is cut down by the straight line
+ *           between readings, so aligning helps far less than for wider
+ *           pulses; the error is still below the raw readings' and within
+ *           one percent of the pulse's height.
+ */
+void test_narrow_pulse_limits_align (void)
+{
+    double raw = rms_error (8, SCHEDULE_MIRRORED, 200, 2.0, false);
+    double aligned = rms_error (8, SCHEDULE_MIRRORED, 200, 2.0, true);
+    TEST_ASSERT_LESS_THAN_FLOAT ((float)raw, (float)aligned);
+    TEST_ASSERT_LESS_THAN_FLOAT ((float)(0.01 * PULSE_COUNTS),
+                                 (float)aligned);
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_schedule_orders);
+    RUN_TEST (test_schedule_offsets);
+    RUN_TEST (test_align_leaves_on_time_readings);
+    RUN_TEST (test_align_steps_back_along_the_line);
+    RUN_TEST (test_slow_pulse_needs_no_align);
+    RUN_TEST (test_align_cuts_skew_error);
+    RUN_TEST (test_narrow_pulse_limits_align);
+    return UNITY_END ();
+}
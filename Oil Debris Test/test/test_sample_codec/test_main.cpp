@@ -0,0 +1,326 @@
+/** @file test_main.cpp
+ *  This file contains round-trip tests of the sample block codec: quiet and
+ *  noisy blocks, the worst case of 13-bit deltas swinging from one end of
+ *  the 12-bit range to the other, single full-scale steps, blocks of one
+ *  sample and of the largest size, and damaged or cut-off blocks which must
+ *  be refused rather than decoded into nonsense.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "sample_codec.h"
+
+/// Most samples in a block tested; more than the pipeline's largest block
+const uint16_t TEST_MAX_SAMPLES = 1024;
+
+/// Largest 12-bit reading
+const uint16_t FULL_SCALE = 0x0FFF;
+
+/// Samples encoded, decoded, and the bytes between
+static uint16_t samples[TEST_MAX_SAMPLES];
+static uint16_t decoded[TEST_MAX_SAMPLES];
+static uint8_t encoded[CODEC_HEADER_SIZE + 2 * TEST_MAX_SAMPLES];
+
+
+/** @brief   Encode @c samples, check the size against the worst case, decode
+ *           them again and check that they came back unchanged.
+ *  @returns The header of the encoded block
+ */
+static codec_block_info_t round_trip (uint16_t count)
+{
+    size_t size = codec_encode_block (samples, count, 3, 123456, encoded,
+                                      sizeof (encoded));
+    TEST_ASSERT_GREATER_THAN (0, size);
+    TEST_ASSERT_LESS_OR_EQUAL (codec_max_encoded_size (count), size);
+
+    codec_block_info_t info;
+    memset (decoded, 0xA5, sizeof (decoded));
+    TEST_ASSERT_EQUAL_size_t (size, codec_decode_block (encoded, size, info,
+                                                        decoded, count));
+    TEST_ASSERT_EQUAL_UINT16 (count, info.count);
+    TEST_ASSERT_EQUAL_UINT8 (3, info.channel);
+    TEST_ASSERT_EQUAL_UINT32 (123456, info.timestamp);
+    TEST_ASSERT_EQUAL_UINT16 (samples[0], info.base);
+    TEST_ASSERT_EQUAL_size_t (size, CODEC_HEADER_SIZE + info.payload_len);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY (samples, decoded, count);
+    return info;
+}
+
+
+void setUp (void)
+{
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   A steady reading packs to no bits at all.
+ */
+void test_constant_block (void)
+{
+    for (uint16_t index = 0; index < 200; index++)
+    {
+        samples[index] = 1234;
+    }
+    codec_block_info_t info = round_trip (200);
+    TEST_ASSERT_EQUAL (CODEC_BITPACK, info.mode);
+    TEST_ASSERT_EQUAL_UINT8 (0, info.bit_width);
+    TEST_ASSERT_EQUAL_UINT16 (0, info.payload_len);
+}
+
+
+/** @brief   A block of one sample is its header alone, at any value.
+ */
+void test_single_sample (void)
+{
+    const uint16_t values[] = { 0, 1, 2048, FULL_SCALE, 0xFFFF };
+    for (uint8_t index = 0; index < 5; index++)
+    {
+        samples[0] = values[index];
+        codec_block_info_t info = round_trip (1);
+        TEST_ASSERT_EQUAL_UINT16 (0, info.payload_len);
+    }
+}
+
+
+/** @brief   Quiet noise of a few counts packs to a few bits a sample.
+ */
+void test_quiet_noise (void)
+{
+    uint32_t seed = 99;
+    for (uint16_t index = 0; index < 500; index++)
+    {
+        seed = seed * 1103515245 + 12345;
+        samples[index] = (uint16_t)(2000 + (seed >> 16) % 7);
+    }
+    codec_block_info_t info = round_trip (500);
+    TEST_ASSERT_EQUAL (CODEC_BITPACK, info.mode);
+    TEST_ASSERT_LESS_OR_EQUAL (4, info.bit_width);
+}
+
+
+/** @brief   Readings swinging between zero and full scale give the largest
+ *           deltas a 12-bit reading can have, which zigzag to 13 bits; the
+ *           block fills the worst-case size exactly.
+ */
+void test_worst_case_13_bit_deltas (void)
+{
+    for (uint16_t count = 2; count <= TEST_MAX_SAMPLES; count += 61)
+    {
+        for (uint16_t index = 0; index < count; index++)
+        {
+            samples[index] = (index & 1) ? FULL_SCALE : 0;
+        }
+        codec_block_info_t info = round_trip (count);
+        TEST_ASSERT_EQUAL (CODEC_BITPACK, info.mode);
+        TEST_ASSERT_EQUAL_UINT8 (13, info.bit_width);
+        TEST_ASSERT_EQUAL_size_t (codec_max_encoded_size (count),
+                                  CODEC_HEADER_SIZE + info.payload_len);
+    }
+
+    // Starting at full scale makes the first delta the negative one
+    for (uint16_t index = 0; index < 301; index++)
+    {
+        samples[index] = (index & 1) ? 0 : FULL_SCALE;
+    }
+    TEST_ASSERT_EQUAL_UINT8 (13, round_trip (301).bit_width);
+}
+
+
+/** @brief   One full-scale step in a steady block is coded as varints, with
+ *           only the step taking more than one byte; up or down, and at
+ *           the start, middle or end of the block.
+ */
+void test_full_scale_steps (void)
+{
+    const uint16_t places[] = { 1, 100, 199 };
+    for (uint8_t place = 0; place < 3; place++)
+    {
+        for (uint8_t rising = 0; rising < 2; rising++)
+        {
+            for (uint16_t index = 0; index < 200; index++)
+            {
+                bool after = index >= places[place];
+                samples[index] = (after == (bool)rising) ? FULL_SCALE : 0;
+            }
+            codec_block_info_t info = round_trip (200);
+            TEST_ASSERT_EQUAL (CODEC_VARINT, info.mode);
+            TEST_ASSERT_EQUAL_UINT16 (198 + 2, info.payload_len);
+        }
+    }
+}
+
+
+/** @brief   Every delta a 12-bit reading can have comes back, from every
+ *           reading, in blocks which take each coding in turn.
+ */
+void test_every_delta (void)
+{
+    uint16_t count = 0;
+    for (uint32_t value = 0; value <= FULL_SCALE; value++)
+    {
+        // Up from zero to the value, and back down again
+        samples[count++] = 0;
+        samples[count++] = (uint16_t)value;
+        samples[count++] = (uint16_t)(FULL_SCALE - value);
+        if (count + 3 > TEST_MAX_SAMPLES || value == FULL_SCALE)
+        {
+            round_trip (count);
+            count = 0;
+        }
+    }
+}
+
+
+/** @brief   Readings outside 12 bits work while the deltas stay below 2^15,
+ *           though they may need more room than the 12-bit worst case.
+ */
+void test_wide_readings (void)
+{
+    for (uint16_t index = 0; index < 100; index++)
+    {
+        samples[index] = (uint16_t)(0x8000 + (index & 1) * 0x7FFF);
+    }
+    size_t size = codec_encode_block (samples, 100, 0, 0, encoded,
+                                      sizeof (encoded));
+    TEST_ASSERT_EQUAL_size_t (CODEC_HEADER_SIZE + 99 * 2, size);
+
+    codec_block_info_t info;
+    TEST_ASSERT_EQUAL_size_t (size, codec_decode_block (encoded, size, info,
+                                                        decoded, 100));
+    TEST_ASSERT_EQUAL_UINT8 (16, info.bit_width);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY (samples, decoded, 100);
+}
+
+
+/** @brief   Blocks written one after another are read back in order, each
+ *           taking the bytes it said it would.
+ */
+void test_consecutive_blocks (void)
+{
+    static uint8_t stream[3 * (CODEC_HEADER_SIZE + 2 * 300)];
+    size_t used = 0;
+    for (uint8_t block = 0; block < 3; block++)
+    {
+        for (uint16_t index = 0; index < 300; index++)
+        {
+            samples[index] = (uint16_t)((index * (block * 40 + 1)) & 0xFFF);
+        }
+        used += codec_encode_block (samples, 300, block, block * 1000,
+                                    stream + used, sizeof (stream) - used);
+    }
+
+    size_t place = 0;
+    for (uint8_t block = 0; block < 3; block++)
+    {
+        codec_block_info_t info;
+        size_t size = codec_decode_block (stream + place, used - place, info,
+                                          decoded, TEST_MAX_SAMPLES);
+        TEST_ASSERT_GREATER_THAN (0, size);
+        TEST_ASSERT_EQUAL_UINT8 (block, info.channel);
+        TEST_ASSERT_EQUAL_UINT32 (block * 1000, info.timestamp);
+        TEST_ASSERT_EQUAL_UINT16 ((299 * (block * 40 + 1)) & 0xFFF,
+                                  decoded[299]);
+        place += size;
+    }
+    TEST_ASSERT_EQUAL_size_t (used, place);
+}
+
+
+/** @brief   Nothing is written when there are no samples or the buffer is
+ *           too small, even by one byte.
+ */
+void test_encode_refuses_small_buffers (void)
+{
+    for (uint16_t index = 0; index < 50; index++)
+    {
+        samples[index] = (index & 1) ? FULL_SCALE : 0;
+    }
+    size_t size = codec_max_encoded_size (50);
+    TEST_ASSERT_EQUAL_size_t (0, codec_encode_block (samples, 0, 0, 0,
+                                                     encoded, size));
+    TEST_ASSERT_EQUAL_size_t (0, codec_encode_block (samples, 50, 0, 0,
+                                                     encoded, size - 1));
+    TEST_ASSERT_EQUAL_size_t (0, codec_encode_block (samples, 1, 0, 0,
+                                                     encoded,
+                                                     CODEC_HEADER_SIZE - 1));
+    TEST_ASSERT_EQUAL_size_t (size, codec_encode_block (samples, 50, 0, 0,
+                                                        encoded, size));
+}
+
+
+/** @brief   Blocks which are cut off, damaged or too big for the array are
+ *           refused.
+ */
+void test_decode_refuses_bad_blocks (void)
+{
+    for (uint16_t index = 0; index < 64; index++)
+    {
+        samples[index] = (uint16_t)(index * 50);
+    }
+    size_t size = codec_encode_block (samples, 64, 0, 0, encoded,
+                                      sizeof (encoded));
+    codec_block_info_t info;
+    for (size_t cut = 0; cut < size; cut++)
+    {
+        TEST_ASSERT_EQUAL_size_t (0, codec_decode_block (encoded, cut, info,
+                                                         decoded, 64));
+    }
+    TEST_ASSERT_EQUAL_size_t (0, codec_decode_block (encoded, size, info,
+                                                     decoded, 63));
+
+    // A wrong marker, an unknown mode, no samples or too wide a delta
+    const uint8_t places[] = { 0, 1, 4, 3 };
+    const uint8_t values[] = { 0x00, 7, 0, 17 };
+    for (uint8_t index = 0; index < 4; index++)
+    {
+        uint8_t saved = encoded[places[index]];
+        uint8_t saved_high = encoded[5];
+        encoded[places[index]] = values[index];
+        if (places[index] == 4)
+        {
+            encoded[5] = 0;
+        }
+        TEST_ASSERT_FALSE (codec_read_header (encoded, size, info));
+        TEST_ASSERT_EQUAL_size_t (0, codec_decode_block (encoded, size, info,
+                                                         decoded, 64));
+        encoded[places[index]] = saved;
+        encoded[5] = saved_high;
+    }
+
+    // A payload said to be shorter than its varints are runs out
+    for (uint16_t index = 0; index < 64; index++)
+    {
+        samples[index] = (index == 10) ? FULL_SCALE : 0;
+    }
+    size = codec_encode_block (samples, 64, 0, 0, encoded, sizeof (encoded));
+    TEST_ASSERT_TRUE (codec_read_header (encoded, size, info));
+    TEST_ASSERT_EQUAL (CODEC_VARINT, info.mode);
+    encoded[12] = (uint8_t)(info.payload_len - 1);
+    TEST_ASSERT_EQUAL_size_t (0, codec_decode_block (encoded, size, info,
+                                                     decoded, 64));
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_constant_block);
+    RUN_TEST (test_single_sample);
+    RUN_TEST (test_quiet_noise);
+    RUN_TEST (test_worst_case_13_bit_deltas);
+    RUN_TEST (test_full_scale_steps);
+    RUN_TEST (test_every_delta);
+    RUN_TEST (test_wide_readings);
+    RUN_TEST (test_consecutive_blocks);
+    RUN_TEST (test_encode_refuses_small_buffers);
+    RUN_TEST (test_decode_refuses_bad_blocks);
+    return UNITY_END ();
+}
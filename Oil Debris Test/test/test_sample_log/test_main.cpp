@@ -0,0 +1,372 @@
+/** @file test_main.cpp
+ *  This file contains tests of the flash log's sequence numbers and of
+ *  @c sample_log_find(), which @c /sync and the MQTT publisher use to fetch
+ *  what a client hasn't got. The log is kept in the in-memory file system
+ *  of @c bench/host/LittleFS.h, whose @c power_cut() stands in for a
+ *  restart; records must then carry on without gaps or repeats, across
+ *  restarts and across the file being moved aside. A log whose file can't
+ *  be opened must refuse records until it is mounted again.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "sample_log.h"
+
+/// Payload of the records added; large ones fill a file in a few hundred
+const size_t SMALL_RECORD = 20;
+const size_t LARGE_RECORD = 4000;
+
+/// The most records a test reads back at once
+const uint16_t MAX_READ = 600;
+
+/// Room for the records of a span, and their sequence numbers
+static uint8_t span_bytes[MAX_READ * (LOG_RECORD_HEADER_SIZE + LARGE_RECORD)];
+static uint32_t seqs[MAX_READ];
+
+
+/** @brief   Add a record whose payload is made from its sequence number.
+ */
+static bool append (size_t length)
+{
+    static uint8_t payload[LARGE_RECORD];
+    uint32_t seq = sample_log_next_seq ();
+    for (size_t index = 0; index < length; index++)
+    {
+        payload[index] = (uint8_t)(seq * 7 + index);
+    }
+    return sample_log_append (LOG_SAMPLES, payload, length);
+}
+
+
+/** @brief   Restart, as after a power failure, and mount the log again.
+ */
+static void restart (void)
+{
+    LittleFS.power_cut ();
+    TEST_ASSERT_TRUE (sample_log_mount ());
+}
+
+
+/** @brief   Read the records in a span and check each one.
+ *  @returns The number of records, whose sequence numbers go in @c seqs,
+ *           or zero if the log moved on before they could all be read
+ */
+static uint16_t read_span (const log_span_t& span)
+{
+    size_t length = span.end - span.start;
+    TEST_ASSERT_LESS_OR_EQUAL (sizeof (span_bytes), length);
+    size_t got = 0;
+    while (got < length)
+    {
+        size_t part = sample_log_read (span.start + got, span_bytes + got,
+                                       length - got, span.generation);
+        if (part == 0)
+        {
+            return 0;
+        }
+        got += part;
+    }
+
+    uint16_t count = 0;
+    for (size_t at = 0; at < length; count++)
+    {
+        const uint8_t* header = span_bytes + at;
+        TEST_ASSERT_EQUAL_HEX8 (LOG_RECORD_MAGIC, header[0]);
+        size_t size = header[2] | (header[3] << 8);
+        seqs[count] = header[4] | (header[5] << 8) | (header[6] << 16)
+                      | ((uint32_t)header[7] << 24);
+        TEST_ASSERT_EQUAL_UINT8 ((uint8_t)(seqs[count] * 7),
+                                 header[LOG_RECORD_HEADER_SIZE]);
+        at += LOG_RECORD_HEADER_SIZE + size;
+        TEST_ASSERT_LESS_OR_EQUAL (length, at);
+    }
+    TEST_ASSERT_EQUAL_UINT16 (span.count, count);
+    return count;
+}
+
+
+/** @brief   Fetch everything after @c after, a few records at a time, as a
+ *           client of @c /sync does, checking that the sequence numbers
+ *           follow on one by one.
+ *  @returns The sequence number of the last record fetched
+ */
+static uint32_t sync_from (uint32_t after, uint16_t max)
+{
+    log_span_t span;
+    while (sample_log_find (after, max, span))
+    {
+        uint16_t count = read_span (span);
+        if (count == 0)
+        {
+            continue;
+        }
+        for (uint16_t index = 0; index < count; index++)
+        {
+            TEST_ASSERT_EQUAL_UINT32 (after + 1, seqs[index]);
+            after = seqs[index];
+        }
+        TEST_ASSERT_EQUAL_UINT32 (span.last_seq, after);
+    }
+    return after;
+}
+
+
+void setUp (void)
+{
+    LittleFS.format ();
+    TEST_ASSERT_TRUE (sample_log_mount ());
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   A new log numbers its records from one.
+ */
+void test_new_log_starts_at_one (void)
+{
+    TEST_ASSERT_EQUAL_UINT32 (1, sample_log_next_seq ());
+    TEST_ASSERT_EQUAL_UINT32 (1, sample_log_mount_seq ());
+    TEST_ASSERT_EQUAL_UINT32 (0, sample_log_generation ());
+    for (uint8_t count = 0; count < 10; count++)
+    {
+        TEST_ASSERT_TRUE (append (SMALL_RECORD));
+    }
+    TEST_ASSERT_EQUAL_UINT32 (11, sample_log_next_seq ());
+    TEST_ASSERT_EQUAL_size_t (10 * (LOG_RECORD_HEADER_SIZE + SMALL_RECORD),
+                              sample_log_size ());
+}
+
+
+/** @brief   @c sample_log_find() gives the records after the one asked
+ *           for, no more than @c max of them, and nothing at the end.
+ */
+void test_find_gives_what_follows (void)
+{
+    for (uint8_t count = 0; count < 10; count++)
+    {
+        append (SMALL_RECORD);
+    }
+    log_span_t span;
+    TEST_ASSERT_TRUE (sample_log_find (0, 100, span));
+    TEST_ASSERT_EQUAL_UINT16 (10, span.count);
+    TEST_ASSERT_EQUAL_size_t (0, span.start);
+    TEST_ASSERT_EQUAL_size_t (sample_log_total (), span.end);
+    TEST_ASSERT_EQUAL_UINT32 (1, span.oldest_seq);
+    TEST_ASSERT_EQUAL_UINT32 (11, span.next_seq);
+
+    TEST_ASSERT_TRUE (sample_log_find (5, 3, span));
+    TEST_ASSERT_EQUAL_UINT16 (3, read_span (span));
+    TEST_ASSERT_EQUAL_UINT32 (6, seqs[0]);
+    TEST_ASSERT_EQUAL_UINT32 (8, span.last_seq);
+
+    TEST_ASSERT_FALSE (sample_log_find (10, 100, span));
+    TEST_ASSERT_EQUAL_size_t (span.start, span.end);
+    TEST_ASSERT_EQUAL_UINT16 (0, span.count);
+    TEST_ASSERT_EQUAL_UINT32 (10, sync_from (0, 4));
+}
+
+
+/** @brief   After a restart, numbering carries on from the last record, and
+ *           a client which kept its place gets no repeats.
+ */
+void test_next_seq_after_remount (void)
+{
+    for (uint8_t count = 0; count < 5; count++)
+    {
+        append (SMALL_RECORD);
+    }
+    uint32_t last = sync_from (0, 2);
+    restart ();
+    TEST_ASSERT_EQUAL_UINT32 (6, sample_log_next_seq ());
+    TEST_ASSERT_EQUAL_UINT32 (6, sample_log_mount_seq ());
+    TEST_ASSERT_EQUAL_size_t (5 * (LOG_RECORD_HEADER_SIZE + SMALL_RECORD),
+                              sample_log_size ());
+
+    append (SMALL_RECORD);
+    TEST_ASSERT_EQUAL_UINT32 (6, sync_from (last, 2));
+    TEST_ASSERT_EQUAL_UINT32 (6, sync_from (0, 100));
+
+    // A restart with nothing added since the last one changes nothing
+    restart ();
+    restart ();
+    TEST_ASSERT_EQUAL_UINT32 (7, sample_log_next_seq ());
+}
+
+
+/** @brief   A file which ends with something other than whole records is
+ *           moved aside at mount, and its records are still found.
+ */
+void test_damaged_file_moved_aside (void)
+{
+    for (uint8_t count = 0; count < 3; count++)
+    {
+        append (SMALL_RECORD);
+    }
+    const uint8_t junk[] = { LOG_RECORD_MAGIC, LOG_SAMPLES, 0xFF, 0xFF };
+    LittleFS.power_cut ();
+    TEST_ASSERT_TRUE (LittleFS.append_raw (SAMPLE_LOG_FILE, junk,
+                                           sizeof (junk)));
+    TEST_ASSERT_TRUE (sample_log_mount ());
+
+    TEST_ASSERT_EQUAL_UINT32 (1, sample_log_generation ());
+    TEST_ASSERT_EQUAL_UINT32 (4, sample_log_next_seq ());
+    TEST_ASSERT_EQUAL_size_t (0, sample_log_size ());
+    append (SMALL_RECORD);
+
+    log_span_t span;
+    TEST_ASSERT_TRUE (sample_log_find (0, 100, span));
+    TEST_ASSERT_EQUAL_UINT32 (1, span.oldest_seq);
+    TEST_ASSERT_EQUAL_UINT16 (4, read_span (span));
+    TEST_ASSERT_EQUAL_UINT32 (4, sync_from (0, 3));
+}
+
+
+/** @brief   A full file is moved aside; its records are still found before
+ *           the new file's, and @c oldest_seq still points at the first.
+ */
+void test_rotation_keeps_the_old_file (void)
+{
+    uint32_t last = 0;
+    while (sample_log_generation () == 0)
+    {
+        append (LARGE_RECORD);
+        last = sync_from (last, 50);
+    }
+    append (LARGE_RECORD);
+    TEST_ASSERT_TRUE (LittleFS.exists (SAMPLE_LOG_OLD_FILE));
+    TEST_ASSERT_EQUAL_UINT32 (sample_log_next_seq () - 1, sync_from (last, 7));
+
+    log_span_t span;
+    TEST_ASSERT_TRUE (sample_log_find (0, MAX_READ, span));
+    TEST_ASSERT_EQUAL_UINT32 (1, span.oldest_seq);
+    TEST_ASSERT_EQUAL_UINT32 (1, span.generation);
+    TEST_ASSERT_EQUAL_UINT32 (sample_log_next_seq () - 1, sync_from (0, 9));
+
+    // A saved offset is no good once the generation has changed
+    uint8_t byte;
+    TEST_ASSERT_EQUAL_size_t (0, sample_log_read (0, &byte, 1, 0));
+
+    // The generation and numbering are kept across a restart
+    uint32_t next = sample_log_next_seq ();
+    restart ();
+    TEST_ASSERT_EQUAL_UINT32 (1, sample_log_generation ());
+    TEST_ASSERT_EQUAL_UINT32 (next, sample_log_next_seq ());
+    TEST_ASSERT_TRUE (sample_log_find (0, 1, span));
+    TEST_ASSERT_EQUAL_UINT32 (1, span.oldest_seq);
+}
+
+
+/** @brief   Once the first file has been thrown away, a client which asks
+ *           for records older than any kept gets the oldest there is, and
+ *           can tell from @c oldest_seq that some were lost.
+ */
+void test_oldest_seq_after_second_rotation (void)
+{
+    uint32_t first_in_second = 0;
+    while (sample_log_generation () < 2)
+    {
+        if (sample_log_generation () == 1 && first_in_second == 0)
+        {
+            first_in_second = sample_log_next_seq () - 1;
+        }
+        append (LARGE_RECORD);
+    }
+
+    log_span_t span;
+    TEST_ASSERT_TRUE (sample_log_find (0, 1, span));
+    TEST_ASSERT_EQUAL_UINT32 (first_in_second, span.oldest_seq);
+    TEST_ASSERT_GREATER_THAN (1, span.oldest_seq);
+    TEST_ASSERT_EQUAL_UINT16 (1, read_span (span));
+    TEST_ASSERT_EQUAL_UINT32 (span.oldest_seq, seqs[0]);
+
+    // From the oldest record on, nothing is missing or repeated
+    uint32_t last = sync_from (span.oldest_seq - 1, 13);
+    TEST_ASSERT_EQUAL_UINT32 (sample_log_next_seq () - 1, last);
+
+    // And the same holds after a restart
+    restart ();
+    TEST_ASSERT_TRUE (sample_log_find (0, 1, span));
+    TEST_ASSERT_EQUAL_UINT32 (first_in_second, span.oldest_seq);
+    append (SMALL_RECORD);
+    TEST_ASSERT_EQUAL_UINT32 (last + 1, sync_from (last, 13));
+}
+
+
+/** @brief   A client which keeps up while records are added, the files
+ *           are moved aside and the tester restarts sees every record
+ *           once, in order.
+ */
+void test_sync_across_restarts_and_rotation (void)
+{
+    uint32_t last = 0;
+    for (uint16_t round = 0; round < 400; round++)
+    {
+        for (uint8_t count = 0; count < 5; count++)
+        {
+            append ((round % 3) ? SMALL_RECORD : LARGE_RECORD);
+        }
+        if (round % 37 == 36)
+        {
+            restart ();
+        }
+        last = sync_from (last, 1 + round % 6);
+        TEST_ASSERT_EQUAL_UINT32 (sample_log_next_seq () - 1, last);
+    }
+    TEST_ASSERT_GREATER_THAN (0, sample_log_generation ());
+}
+
+
+/** @brief   A log whose file can't be opened is marked unavailable and
+ *           refuses records at once, without trying to open the file again
+ *           for each one, until it is mounted again.
+ */
+void test_unavailable_log_refuses_records (void)
+{
+    // Take every slot of the file system, so the log file can't be made
+    LittleFS.format ();
+    char name[HOST_FS_NAME_SIZE];
+    for (uint8_t slot = 0; slot < HOST_FS_FILES; slot++)
+    {
+        snprintf (name, sizeof (name), "/fill%u", slot);
+        LittleFS.open (name, "w").close ();
+    }
+    TEST_ASSERT_FALSE (sample_log_mount ());
+    TEST_ASSERT_FALSE (sample_log_ready ());
+    TEST_ASSERT_FALSE (append (SMALL_RECORD));
+
+    // Room is made, but records are still refused until the next mount
+    LittleFS.remove ("/fill0");
+    TEST_ASSERT_FALSE (append (SMALL_RECORD));
+    TEST_ASSERT_FALSE (LittleFS.exists (SAMPLE_LOG_FILE));
+
+    TEST_ASSERT_TRUE (sample_log_mount ());
+    TEST_ASSERT_TRUE (sample_log_ready ());
+    TEST_ASSERT_TRUE (append (SMALL_RECORD));
+    TEST_ASSERT_EQUAL_UINT32 (1, sync_from (0, 10));
+}
+
+
+int main (int argc, char** argv)
+{
+    sample_log_init ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_new_log_starts_at_one);
+    RUN_TEST (test_find_gives_what_follows);
+    RUN_TEST (test_next_seq_after_remount);
+    RUN_TEST (test_damaged_file_moved_aside);
+    RUN_TEST (test_rotation_keeps_the_old_file);
+    RUN_TEST (test_oldest_seq_after_second_rotation);
+    RUN_TEST (test_sync_across_restarts_and_rotation);
+    RUN_TEST (test_unavailable_log_refuses_records);
+    return UNITY_END ();
+}
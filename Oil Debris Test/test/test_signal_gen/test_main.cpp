@@ -0,0 +1,349 @@
+/** @file test_main.cpp
+ *  This file contains tests of the synthetic signal generator, each run
+ *  from a fixed seed so it gives the same answer every time: the same seed
+ *  making the same readings, particles arriving at the configured rate
+ *  with exponential gaps, sizes and pulse heights spread as configured,
+ *  and each label's time and peak found again in the readings.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <math.h>
+#include <unity.h>
+#include "signal_gen.h"
+
+/// Most labels a test keeps
+const uint32_t TEST_MAX_LABELS = 40000;
+
+/// Labels taken from the generator in a run
+static signal_label_t labels[TEST_MAX_LABELS];
+static uint32_t label_count;
+
+
+/** @brief   Fill in a configuration with no drift, hum or noise, so that
+ *           the readings are the baseline plus the pulses.
+ */
+static void quiet_config (signal_config_t& config)
+{
+    signal_defaults (config);
+    config.seed = 12345;
+    for (uint8_t channel = 0; channel < config.channels; channel++)
+    {
+        config.channel[channel].drift = 0;
+        config.channel[channel].hum = 0;
+        config.channel[channel].noise = 0.0f;
+    }
+}
+
+
+/** @brief   Take every label waiting in a generator.
+ */
+static void take_labels (SignalGenerator& generator)
+{
+    signal_label_t label;
+    while (generator.take_label (label))
+    {
+        if (label_count < TEST_MAX_LABELS)
+        {
+            labels[label_count] = label;
+        }
+        label_count++;
+    }
+}
+
+
+/** @brief   Read every channel once per period for a time, taking the
+ *           labels as they come.
+ */
+static void run (SignalGenerator& generator, uint8_t channels,
+                 uint32_t period_us, uint32_t seconds)
+{
+    label_count = 0;
+    uint32_t reads = seconds * (1000000 / period_us);
+    for (uint32_t read = 0; read < reads; read++)
+    {
+        for (uint8_t channel = 0; channel < channels; channel++)
+        {
+            generator.read (channel, read * period_us);
+        }
+        take_labels (generator);
+    }
+}
+
+
+/** @brief   Get the share of power-law sizes below a size, from the
+ *           spread's cumulative distribution.
+ */
+static float power_law_below (const signal_config_t& config, float size)
+{
+    float power = 1.0f - config.exponent;
+    return (powf (size, power) - powf (config.min_um, power))
+           / (powf (config.max_um, power) - powf (config.min_um, power));
+}
+
+
+void setUp (void)
+{
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Generators with the same seed make the same readings and
+ *           labels; another seed makes others.
+ */
+void test_same_seed_same_run (void)
+{
+    signal_config_t config;
+    signal_defaults (config);
+    config.rate = 20.0f;
+    SignalGenerator first (config);
+    SignalGenerator second (config);
+    config.seed = 2;
+    SignalGenerator other (config);
+
+    uint32_t differ = 0;
+    for (uint32_t time_us = 0; time_us < 10000000; time_us += 1000)
+    {
+        for (uint8_t channel = 0; channel < 2; channel++)
+        {
+            uint16_t reading = first.read (channel, time_us);
+            TEST_ASSERT_EQUAL_UINT16 (reading,
+                                      second.read (channel, time_us));
+            differ += reading != other.read (channel, time_us);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32 (first.get_particles (),
+                              second.get_particles ());
+    TEST_ASSERT_GREATER_THAN (0, first.get_particles ());
+    TEST_ASSERT_GREATER_THAN (1000, differ);
+
+    signal_label_t one;
+    signal_label_t two;
+    while (first.take_label (one))
+    {
+        TEST_ASSERT_TRUE (second.take_label (two));
+        TEST_ASSERT_EQUAL_UINT32 (one.time_ms, two.time_ms);
+        TEST_ASSERT_EQUAL_UINT16 (one.size_um, two.size_um);
+    }
+}
+
+
+/** @brief   Particles arrive at the configured rate, and the gaps between
+ *           them are spread exponentially: about 1/e of them are longer
+ *           than the mean and 1 - 1/e^2 shorter than twice the mean.
+ */
+void test_arrival_rate (void)
+{
+    signal_config_t config;
+    quiet_config (config);
+    config.rate = 20.0f;
+    config.pulse_ms = 2;
+    SignalGenerator generator (config);
+    run (generator, 1, 1000, 1000);
+
+    // 20000 expected; a Poisson count's standard deviation is about 141
+    TEST_ASSERT_EQUAL_UINT32 (0, generator.get_labels_lost ());
+    TEST_ASSERT_EQUAL_UINT32 (generator.get_particles (), label_count);
+    TEST_ASSERT_UINT32_WITHIN (600, 20000, label_count);
+
+    uint32_t mean_ms = 1000 / 20;
+    uint32_t longer = 0;
+    uint32_t shorter_twice = 0;
+    for (uint32_t index = 1; index < label_count; index++)
+    {
+        uint32_t gap = labels[index].time_ms - labels[index - 1].time_ms;
+        longer += gap > mean_ms;
+        shorter_twice += gap < 2 * mean_ms;
+    }
+    float gaps = label_count - 1;
+    TEST_ASSERT_FLOAT_WITHIN (0.02f, expf (-1.0f), longer / gaps);
+    TEST_ASSERT_FLOAT_WITHIN (0.02f, 1.0f - expf (-2.0f),
+                              shorter_twice / gaps);
+}
+
+
+/** @brief   Sizes are spread as configured, and each label's peak on each
+ *           channel is the channel's gain times the particle's volume over
+ *           the reference one, cut off where the reading saturates.
+ */
+void test_size_and_peak_spread (void)
+{
+    signal_config_t config;
+    quiet_config (config);
+    config.rate = 20.0f;
+    config.pulse_ms = 2;
+
+    // Every particle is the smallest size
+    config.sizes = SIZES_FIXED;
+    SignalGenerator fixed (config);
+    run (fixed, 1, 1000, 100);
+    TEST_ASSERT_GREATER_THAN (1000, label_count);
+    for (uint32_t index = 0; index < label_count; index++)
+    {
+        TEST_ASSERT_EQUAL_UINT16 (config.min_um, labels[index].size_um);
+    }
+
+    // Sizes spread evenly, whose mean is half way
+    config.sizes = SIZES_UNIFORM;
+    config.min_um = 50;
+    config.max_um = 250;
+    SignalGenerator uniform (config);
+    run (uniform, 1, 1000, 1000);
+    float sum = 0.0f;
+    uint32_t lowest_quarter = 0;
+    for (uint32_t index = 0; index < label_count; index++)
+    {
+        uint16_t size = labels[index].size_um;
+        TEST_ASSERT_TRUE (size >= 50 && size <= 250);
+        sum += size;
+        lowest_quarter += size < 100;
+    }
+    TEST_ASSERT_FLOAT_WITHIN (2.0f, 150.0f, sum / label_count);
+    TEST_ASSERT_FLOAT_WITHIN (0.02f, 0.25f,
+                              lowest_quarter / (float)label_count);
+
+    // The tester's power law: mostly small particles and a few large ones
+    quiet_config (config);
+    config.rate = 20.0f;
+    config.pulse_ms = 2;
+    SignalGenerator power (config);
+    run (power, 2, 1000, 1000);
+    static const uint16_t BELOW[] = { 50, 80, 150, 300 };
+    for (uint8_t edge = 0; edge < 4; edge++)
+    {
+        uint32_t below = 0;
+        for (uint32_t index = 0; index < label_count; index++)
+        {
+            below += labels[index].size_um < BELOW[edge];
+        }
+        TEST_ASSERT_FLOAT_WITHIN (0.015f,
+                                  power_law_below (config,
+                                                   BELOW[edge] - 0.5f),
+                                  below / (float)label_count);
+    }
+
+    uint32_t saturated = 0;
+    for (uint32_t index = 0; index < label_count; index++)
+    {
+        const signal_label_t& label = labels[index];
+        TEST_ASSERT_TRUE (label.size_um >= config.min_um
+                          && label.size_um <= config.max_um);
+        float volume = label.size_um / SIGNAL_REFERENCE_UM;
+        volume = volume * volume * volume;
+        for (uint8_t channel = 0; channel < 2; channel++)
+        {
+            float height = config.channel[channel].gain * volume;
+            float room = SIGNAL_MAX_COUNTS - config.channel[channel].baseline;
+            TEST_ASSERT_FLOAT_WITHIN (0.51f, (height < room) ? height : room,
+                                      label.peak[channel]);
+            saturated += channel == 0 && height >= room;
+        }
+    }
+
+    // The fine channel saturates above about 351 microns
+    float share = 1.0f - power_law_below (config, 351.2f);
+    TEST_ASSERT_UINT32_WITHIN (40, (uint32_t)(share * label_count),
+                               saturated);
+}
+
+
+/** @brief   Each label's time is when its pulse starts in the readings, and
+ *           its peak is how far the readings rise above the baseline.
+ *           Readings are taken every 100 us, and only particles whose
+ *           pulses overlap no other are checked.
+ */
+void test_labels_match_readings (void)
+{
+    const uint32_t PERIOD_US = 100;
+    const uint32_t SECONDS = 200;
+    const uint32_t READS = SECONDS * (1000000 / PERIOD_US);
+    static uint16_t readings[2][READS];
+
+    signal_config_t config;
+    quiet_config (config);
+    config.rate = 5.0f;
+    config.pulse_ms = 20;
+    SignalGenerator generator (config);
+    label_count = 0;
+    for (uint32_t read = 0; read < READS; read++)
+    {
+        for (uint8_t channel = 0; channel < 2; channel++)
+        {
+            readings[channel][read] = generator.read (channel,
+                                                      read * PERIOD_US);
+        }
+        take_labels (generator);
+    }
+    TEST_ASSERT_UINT32_WITHIN (150, 1000, label_count);
+
+    uint32_t width = config.pulse_ms * 1000 / PERIOD_US;
+    uint32_t checked = 0;
+    for (uint32_t index = 0; index < label_count; index++)
+    {
+        const signal_label_t& label = labels[index];
+        uint32_t start = label.time_ms * 1000 / PERIOD_US;
+        bool alone = (index == 0
+                      || labels[index - 1].time_ms + 2 * config.pulse_ms
+                         < label.time_ms)
+                     && (index + 1 == label_count
+                         || label.time_ms + 2 * config.pulse_ms
+                            < labels[index + 1].time_ms);
+        if (!alone || start == 0 || start + width + 10 >= READS)
+        {
+            continue;
+        }
+        checked++;
+        TEST_ASSERT_EQUAL_UINT16 (config.pulse_ms, label.width_ms);
+
+        for (uint8_t channel = 0; channel < 2; channel++)
+        {
+            uint16_t baseline = config.channel[channel].baseline;
+
+            // Nothing before the label's time, and the highest reading
+            // during the pulse is the label's peak
+            TEST_ASSERT_EQUAL_UINT16 (baseline, readings[channel][start - 1]);
+            uint16_t highest = 0;
+            uint32_t rise = 0;
+            for (uint32_t read = start; read < start + width + 10; read++)
+            {
+                uint16_t value = readings[channel][read];
+                if (rise == 0 && value > baseline)
+                {
+                    rise = read;
+                }
+                highest = (value > highest) ? value : highest;
+            }
+            TEST_ASSERT_UINT32_WITHIN (1, label.peak[channel],
+                                       highest - baseline);
+
+            // The label's time is rounded down to a millisecond, and a
+            // pulse of 100 counts takes under half of one to rise a count
+            if (label.peak[channel] >= 100)
+            {
+                TEST_ASSERT_TRUE (rise >= start);
+                TEST_ASSERT_TRUE (rise < start + 2000 / PERIOD_US);
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT16 (config.channel[0].baseline,
+                                  readings[0][start + width + 10]);
+    }
+    // Two in three particles at 5/s have 40 ms clear either side
+    TEST_ASSERT_GREATER_THAN (500, checked);
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_same_seed_same_run);
+    RUN_TEST (test_arrival_rate);
+    RUN_TEST (test_size_and_peak_spread);
+    RUN_TEST (test_labels_match_readings);
+    return UNITY_END ();
+}
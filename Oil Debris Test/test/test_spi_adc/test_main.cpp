@@ -0,0 +1,414 @@
+/** @file test_main.cpp
+ *  This file contains tests of the framing for the external SPI ADCs, with
+ *  @c SpiAdcMock standing in for each chip: the commands written for each
+ *  input, the extra frame an ADS8688 needs, the readings picked out of the
+ *  replies and scaled to 12 bits, scans with bad replies being dropped and
+ *  counted, and batch after batch of full-size scans losing no conversions.
+ *
+ *  The mock's signal gives each conversion of an input the input's number
+ *  times @c INPUT_STEP plus the number of times that input was converted
+ *  before, so a reading tells which input it came from and in what order.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "spi_adc.h"
+
+/// Step in the 12-bit reading from one input to the next
+const uint16_t INPUT_STEP = 0x200;
+
+/// The most scans a test keeps; few enough that an input's readings don't
+/// reach the next input's
+const uint16_t MAX_KEPT = 500;
+
+/// Inputs read by most of the tests, two channels as on the tester
+static const uint8_t TWO_INPUTS[] = { 5, 2 };
+
+/// Conversions of each input the mock has done
+static uint16_t converted[8];
+
+/// Readings of the scans passed to the sink, channel by channel
+static uint16_t kept[MAX_KEPT][SPI_ADC_MAX_CHANNELS];
+static uint16_t num_kept = 0;
+
+/// The batch, which the driver and the mock share as they would the bus
+static spi_adc_batch_t batch;
+
+
+/** @brief   Give the next conversion of an input, with as many bits as the
+ *           ADC in @c p_context has.
+ */
+static uint16_t signal (uint8_t input, void* p_context)
+{
+    uint16_t reading = (uint16_t)(input * INPUT_STEP + converted[input]++);
+    if (*(spi_adc_model_t*)p_context == SPI_ADC_ADS8688)
+    {
+        return (uint16_t)((reading << 4) | 0x0F);
+    }
+    return reading;
+}
+
+
+/** @brief   Keep the readings of a scan.
+ */
+static void sink (const uint16_t* readings, void* p_context)
+{
+    if (num_kept < MAX_KEPT)
+    {
+        memcpy (kept[num_kept++], readings,
+                *(uint8_t*)p_context * sizeof (uint16_t));
+    }
+}
+
+
+void setUp (void)
+{
+    memset (converted, 0, sizeof (converted));
+    memset (&batch, 0, sizeof (batch));
+    num_kept = 0;
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   The descriptions match the data sheets.
+ */
+void test_model_info (void)
+{
+    const spi_adc_info_t& mcp = spi_adc_info (SPI_ADC_MCP3208);
+    TEST_ASSERT_EQUAL_STRING ("MCP3208", mcp.name);
+    TEST_ASSERT_EQUAL_UINT8 (8, mcp.inputs);
+    TEST_ASSERT_EQUAL_UINT8 (12, mcp.bits);
+    TEST_ASSERT_EQUAL_UINT8 (0, mcp.latency);
+
+    const spi_adc_info_t& ads = spi_adc_info (SPI_ADC_ADS8688);
+    TEST_ASSERT_EQUAL_STRING ("ADS8688", ads.name);
+    TEST_ASSERT_EQUAL_UINT8 (8, ads.inputs);
+    TEST_ASSERT_EQUAL_UINT8 (16, ads.bits);
+    TEST_ASSERT_EQUAL_UINT8 (1, ads.latency);
+    TEST_ASSERT_EQUAL_UINT8 (1, ads.spi_mode);
+}
+
+
+/** @brief   Channels must be from one to eight inputs the ADC has, and a
+ *           batch must hold from one scan to as many as fit.
+ */
+void test_inputs_and_scans_checked (void)
+{
+    SpiAdc adc (SPI_ADC_MCP3208);
+    const uint8_t bad_input[] = { 1, 8 };
+    const uint8_t nine[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0 };
+    TEST_ASSERT_FALSE (adc.set_inputs (TWO_INPUTS, 0));
+    TEST_ASSERT_FALSE (adc.set_inputs (bad_input, 2));
+    TEST_ASSERT_FALSE (adc.set_inputs (nine, 9));
+    TEST_ASSERT_TRUE (adc.set_inputs (nine, 8));
+    TEST_ASSERT_EQUAL_UINT16 (8, adc.max_scans ());
+
+    TEST_ASSERT_TRUE (adc.set_inputs (TWO_INPUTS, 2));
+    TEST_ASSERT_EQUAL_UINT16 (32, adc.max_scans ());
+    TEST_ASSERT_FALSE (adc.prepare (batch, 0));
+    TEST_ASSERT_FALSE (adc.prepare (batch, 33));
+    TEST_ASSERT_TRUE (adc.prepare (batch, 32));
+    TEST_ASSERT_EQUAL_UINT16 (SPI_ADC_MAX_FRAMES, batch.frames);
+
+    // The ADS8688's extra frame takes the place of one scan
+    SpiAdc ads (SPI_ADC_ADS8688);
+    TEST_ASSERT_TRUE (ads.set_inputs (TWO_INPUTS, 2));
+    TEST_ASSERT_EQUAL_UINT16 (31, ads.max_scans ());
+    TEST_ASSERT_TRUE (ads.prepare (batch, 31));
+    TEST_ASSERT_EQUAL_UINT16 (63, batch.frames);
+}
+
+
+/** @brief   MCP3208 frames are a zero byte, then the start bit, the
+ *           single-ended bit and the input number, one frame a channel.
+ */
+void test_mcp3208_commands (void)
+{
+    SpiAdc adc (SPI_ADC_MCP3208);
+    adc.set_inputs (TWO_INPUTS, 2);
+    TEST_ASSERT_TRUE (adc.prepare (batch, 3));
+    TEST_ASSERT_EQUAL_UINT16 (6, batch.frames);
+
+    const uint8_t input_5[] = { 0x00, 0x07, 0x40, 0x00 };
+    const uint8_t input_2[] = { 0x00, 0x06, 0x80, 0x00 };
+    for (uint16_t frame = 0; frame < batch.frames; frame += 2)
+    {
+        TEST_ASSERT_EQUAL_HEX8_ARRAY (input_5, batch.tx[frame], 4);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY (input_2, batch.tx[frame + 1], 4);
+    }
+}
+
+
+/** @brief   ADS8688 frames are manual channel selects, and the extra frame
+ *           at the end selects the first channel again.
+ */
+void test_ads8688_commands (void)
+{
+    SpiAdc adc (SPI_ADC_ADS8688);
+    adc.set_inputs (TWO_INPUTS, 2);
+    TEST_ASSERT_TRUE (adc.prepare (batch, 3));
+    TEST_ASSERT_EQUAL_UINT16 (7, batch.frames);
+
+    const uint8_t input_5[] = { 0xD4, 0x00, 0x00, 0x00 };
+    const uint8_t input_2[] = { 0xC8, 0x00, 0x00, 0x00 };
+    for (uint16_t frame = 0; frame < 6; frame += 2)
+    {
+        TEST_ASSERT_EQUAL_HEX8_ARRAY (input_5, batch.tx[frame], 4);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY (input_2, batch.tx[frame + 1], 4);
+    }
+    TEST_ASSERT_EQUAL_HEX8_ARRAY (input_5, batch.tx[6], 4);
+}
+
+
+/** @brief   MCP3208 readings come out in channel order, one scan at a time,
+ *           with every bit of the 12 in place.
+ */
+void test_mcp3208_readings (void)
+{
+    spi_adc_model_t model = SPI_ADC_MCP3208;
+    uint8_t channels = 2;
+    SpiAdc adc (model);
+    SpiAdcMock mock (model, signal, &model);
+    adc.set_inputs (TWO_INPUTS, channels);
+
+    adc.prepare (batch, 4);
+    mock.transfer (batch);
+    TEST_ASSERT_EQUAL_UINT16 (4, adc.decode (batch, sink, &channels));
+    TEST_ASSERT_EQUAL_UINT16 (4, num_kept);
+    for (uint16_t scan = 0; scan < num_kept; scan++)
+    {
+        TEST_ASSERT_EQUAL_UINT16 (5 * INPUT_STEP + scan, kept[scan][0]);
+        TEST_ASSERT_EQUAL_UINT16 (2 * INPUT_STEP + scan, kept[scan][1]);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (8, mock.get_conversions ());
+    TEST_ASSERT_EQUAL_UINT32 (0, adc.get_bad_frames ());
+
+    // Full scale and zero both survive the framing
+    const uint8_t one_input[] = { 7 };
+    channels = 1;
+    adc.set_inputs (one_input, channels);
+    converted[7] = 0x0FFF - 7 * INPUT_STEP;
+    adc.prepare (batch, 1);
+    mock.transfer (batch);
+    adc.decode (batch, sink, &channels);
+    TEST_ASSERT_EQUAL_HEX16 (0x0FFF, kept[4][0]);
+
+    const uint8_t zero_input[] = { 0 };
+    adc.set_inputs (zero_input, channels);
+    adc.prepare (batch, 1);
+    mock.transfer (batch);
+    adc.decode (batch, sink, &channels);
+    TEST_ASSERT_EQUAL_HEX16 (0x0000, kept[5][0]);
+}
+
+
+/** @brief   ADS8688 readings are scaled from 16 bits to 12, and the reply to
+ *           the first frame of each batch, which answers the batch before,
+ *           is skipped.
+ */
+void test_ads8688_readings (void)
+{
+    spi_adc_model_t model = SPI_ADC_ADS8688;
+    uint8_t channels = 2;
+    SpiAdc adc (model);
+    SpiAdcMock mock (model, signal, &model);
+    adc.set_inputs (TWO_INPUTS, channels);
+
+    // The first frame ever has nothing to answer
+    adc.prepare (batch, 4);
+    mock.transfer (batch);
+    TEST_ASSERT_EQUAL_UINT32 (8, mock.get_conversions ());
+    TEST_ASSERT_EQUAL_UINT16 (4, adc.decode (batch, sink, &channels));
+    for (uint16_t scan = 0; scan < 4; scan++)
+    {
+        TEST_ASSERT_EQUAL_UINT16 (5 * INPUT_STEP + scan, kept[scan][0]);
+        TEST_ASSERT_EQUAL_UINT16 (2 * INPUT_STEP + scan, kept[scan][1]);
+    }
+
+    // The extra frame chose the first input again; its conversion is the
+    // reply which opens the next batch, and isn't passed on
+    TEST_ASSERT_EQUAL_UINT16 (4, converted[5]);
+    adc.prepare (batch, 4);
+    mock.transfer (batch);
+    TEST_ASSERT_EQUAL_UINT16 (4, adc.decode (batch, sink, &channels));
+    for (uint16_t scan = 0; scan < 4; scan++)
+    {
+        TEST_ASSERT_EQUAL_UINT16 (5 * INPUT_STEP + 5 + scan,
+                                  kept[4 + scan][0]);
+        TEST_ASSERT_EQUAL_UINT16 (2 * INPUT_STEP + 4 + scan,
+                                  kept[4 + scan][1]);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (8, adc.get_scans ());
+    TEST_ASSERT_EQUAL_UINT32 (0, adc.get_bad_frames ());
+}
+
+
+/** @brief   With no chip answering, every MCP3208 reply is all ones; each
+ *           frame is counted as bad and no scan is passed on.
+ */
+void test_no_chip_drops_every_scan (void)
+{
+    uint8_t channels = 2;
+    SpiAdc adc (SPI_ADC_MCP3208);
+    adc.set_inputs (TWO_INPUTS, channels);
+    adc.prepare (batch, 10);
+    memset (batch.rx, 0xFF, sizeof (batch.rx));
+
+    TEST_ASSERT_EQUAL_UINT16 (0, adc.decode (batch, sink, &channels));
+    TEST_ASSERT_EQUAL_UINT16 (0, num_kept);
+    TEST_ASSERT_EQUAL_UINT32 (20, adc.get_bad_frames ());
+    TEST_ASSERT_EQUAL_UINT32 (0, adc.get_scans ());
+}
+
+
+/** @brief   One bad reply drops only the scan it's in; the scans around it
+ *           keep their channels in order.
+ */
+void test_bad_frame_drops_its_scan (void)
+{
+    spi_adc_model_t model = SPI_ADC_MCP3208;
+    uint8_t channels = 2;
+    SpiAdc adc (model);
+    SpiAdcMock mock (model, signal, &model);
+    adc.set_inputs (TWO_INPUTS, channels);
+    adc.prepare (batch, 5);
+
+    // A corrupted start bit in scan 2's second frame gets no conversion
+    batch.tx[5][1] = 0x02;
+    mock.transfer (batch);
+    TEST_ASSERT_EQUAL_UINT16 (4, adc.decode (batch, sink, &channels));
+    TEST_ASSERT_EQUAL_UINT32 (1, adc.get_bad_frames ());
+
+    const uint16_t scans[] = { 0, 1, 3, 4 };
+    for (uint16_t index = 0; index < 4; index++)
+    {
+        TEST_ASSERT_EQUAL_UINT16 (5 * INPUT_STEP + scans[index],
+                                  kept[index][0]);
+    }
+    TEST_ASSERT_EQUAL_UINT16 (2 * INPUT_STEP + 2, kept[2][1]);
+}
+
+
+/** @brief   Run full batches of every channel count through a chip's mock,
+ *           checking that each conversion reaches the sink in order and that
+ *           the frames in a batch which carry no reading are the latency's.
+ */
+static void run_full_batches (spi_adc_model_t model)
+{
+    const spi_adc_info_t& info = spi_adc_info (model);
+    const uint8_t inputs[] = { 3, 6, 0, 7, 1, 4, 2, 5 };
+
+    for (uint8_t channels = 1; channels <= SPI_ADC_MAX_CHANNELS; channels++)
+    {
+        setUp ();
+        SpiAdc adc (model);
+        SpiAdcMock mock (model, signal, &model);
+        TEST_ASSERT_TRUE (adc.set_inputs (inputs, channels));
+
+        uint16_t scans = adc.max_scans ();
+        uint16_t batches = 0;
+        while (num_kept + scans <= MAX_KEPT)
+        {
+            adc.prepare (batch, scans);
+            TEST_ASSERT_EQUAL_UINT16 (scans * channels + info.latency,
+                                      batch.frames);
+            TEST_ASSERT_GREATER_THAN (SPI_ADC_MAX_FRAMES - channels,
+                                      batch.frames);
+            mock.transfer (batch);
+            TEST_ASSERT_EQUAL_UINT16 (scans, adc.decode (batch, sink,
+                                                         &channels));
+            batches++;
+        }
+        TEST_ASSERT_EQUAL_UINT32 (num_kept, adc.get_scans ());
+        TEST_ASSERT_EQUAL_UINT32 (0, adc.get_bad_frames ());
+
+        // Only the latency frames' conversions are lost: the very first
+        // frame converts nothing, and each later batch's first reply
+        // answers the extra frame of the batch before
+        uint32_t wasted = (batches - 1) * info.latency;
+        TEST_ASSERT_EQUAL_UINT32 ((uint32_t)num_kept * channels + wasted,
+                                  mock.get_conversions ());
+
+        uint16_t extra = 0;
+        for (uint16_t scan = 0; scan < num_kept; scan++)
+        {
+            if (scan > 0 && scan % scans == 0)
+            {
+                extra += info.latency;
+            }
+            for (uint8_t channel = 0; channel < channels; channel++)
+            {
+                uint16_t expected = inputs[channel] * INPUT_STEP + scan
+                                    + (channel == 0 ? extra : 0);
+                TEST_ASSERT_EQUAL_UINT16 (expected, kept[scan][channel]);
+            }
+        }
+    }
+}
+
+
+/** @brief   The MCP3208 keeps every conversion of batch after batch.
+ */
+void test_mcp3208_full_batches (void)
+{
+    run_full_batches (SPI_ADC_MCP3208);
+}
+
+
+/** @brief   The ADS8688 keeps every conversion but those of its extra
+ *           frames, batch after batch.
+ */
+void test_ads8688_full_batches (void)
+{
+    run_full_batches (SPI_ADC_ADS8688);
+}
+
+
+/** @brief   At each chip's clock, a full batch of the tester's two channels
+ *           is read fast enough for many kilohertz of scans.
+ */
+void test_bus_throughput (void)
+{
+    const spi_adc_model_t models[] = { SPI_ADC_MCP3208, SPI_ADC_ADS8688 };
+    const uint32_t least_hz[] = { 15000, 150000 };
+    for (uint8_t index = 0; index < 2; index++)
+    {
+        SpiAdc adc (models[index]);
+        adc.set_inputs (TWO_INPUTS, 2);
+        adc.prepare (batch, adc.max_scans ());
+
+        // Scans a second is the bus's bits a second over the bits a scan
+        // takes, counting the extra frames
+        uint32_t bits = (uint32_t)batch.frames * SPI_ADC_FRAME_BYTES * 8;
+        uint32_t scan_hz = (uint32_t)((uint64_t)spi_adc_info
+                                      (models[index]).clock_hz
+                                      * adc.max_scans () / bits);
+        TEST_ASSERT_GREATER_OR_EQUAL (least_hz[index], scan_hz);
+    }
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_model_info);
+    RUN_TEST (test_inputs_and_scans_checked);
+    RUN_TEST (test_mcp3208_commands);
+    RUN_TEST (test_ads8688_commands);
+    RUN_TEST (test_mcp3208_readings);
+    RUN_TEST (test_ads8688_readings);
+    RUN_TEST (test_no_chip_drops_every_scan);
+    RUN_TEST (test_bad_frame_drops_its_scan);
+    RUN_TEST (test_mcp3208_full_batches);
+    RUN_TEST (test_ads8688_full_batches);
+    RUN_TEST (test_bus_throughput);
+    return UNITY_END ();
+}
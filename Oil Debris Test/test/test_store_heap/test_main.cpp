@@ -0,0 +1,134 @@
+/** @file test_main.cpp
+ *  This file contains tests which run the store stage with the heap guard
+ *  sealed and watching the running task, as the processing task is watched
+ *  on the tester when it's built with @c NO_HEAP_AFTER_SETUP. Any use of
+ *  the heap outside the log's mount and rotation stops the test program.
+ *  The log is kept in the in-memory file system of @c bench/host/LittleFS.h,
+ *  which takes memory from the heap to open a file, as LittleFS does.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "sample_log.h"
+#include "sample_pipeline.h"
+#include "pipeline_stages.h"
+#include "mem_pool.h"
+
+/// Samples in each channel of the blocks stored
+const uint16_t TEST_BLOCK_SIZE = 50;
+
+/// Readings of the block stored, and the block which holds them
+static uint16_t readings[2][TEST_BLOCK_SIZE];
+static sample_block_t block;
+
+
+/** @brief   Make a block of two channels of changing readings.
+ */
+static void make_block (uint32_t number)
+{
+    block.sequence = number;
+    block.first_sample = number * TEST_BLOCK_SIZE;
+    block.start_time = number * TEST_BLOCK_SIZE * 10;
+    block.count = TEST_BLOCK_SIZE;
+    block.channels = 2;
+    for (uint8_t channel = 0; channel < 2; channel++)
+    {
+        block.samples[channel] = readings[channel];
+        block.offsets[channel] = NULL;
+        for (uint16_t index = 0; index < TEST_BLOCK_SIZE; index++)
+        {
+            readings[channel][index] = (uint16_t)((number * 37 + index * 11
+                                                   + channel * 500) & 0xFFF);
+        }
+    }
+}
+
+
+void setUp (void)
+{
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Mounting the log after the heap is sealed, as the processing
+ *           task may do while @c setup() finishes, is allowed.
+ */
+void test_mount_after_seal (void)
+{
+    heap_guard_watch (xTaskGetCurrentTaskHandle ());
+    heap_guard_seal ();
+
+    uint32_t before = heap_guard_count ();
+    TEST_ASSERT_TRUE (sample_log_mount ());
+    TEST_ASSERT_TRUE (sample_log_ready ());
+    TEST_ASSERT_GREATER_THAN (before, heap_guard_count ());
+}
+
+
+/** @brief   Storing blocks in a mounted log doesn't use the heap.
+ */
+void test_store_uses_no_heap (void)
+{
+    uint32_t seq = sample_log_next_seq ();
+    uint32_t before = heap_guard_count ();
+    for (uint32_t number = 0; number < 1000; number++)
+    {
+        make_block (number);
+        stage_store (block, NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (before, heap_guard_count ());
+
+    // The first block after the mount is preceded by the channels' names
+    TEST_ASSERT_EQUAL_UINT32 (seq + 1001, sample_log_next_seq ());
+}
+
+
+/** @brief   Filling the log file moves it aside and opens a new one, which
+ *           is the only heap the store stage uses; records carry on.
+ */
+void test_rotation_opens_the_new_file (void)
+{
+    uint32_t generation = sample_log_generation ();
+    uint32_t number = 0;
+    while (sample_log_generation () == generation)
+    {
+        make_block (number++);
+        uint32_t seq = sample_log_next_seq ();
+        stage_store (block, NULL);
+        TEST_ASSERT_EQUAL_UINT32 (seq + 1, sample_log_next_seq ());
+    }
+    TEST_ASSERT_TRUE (LittleFS.exists (SAMPLE_LOG_OLD_FILE));
+
+    // Once the new file is open, storing is free of the heap again
+    uint32_t before = heap_guard_count ();
+    for (uint32_t count = 0; count < 100; count++)
+    {
+        make_block (number++);
+        stage_store (block, NULL);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (before, heap_guard_count ());
+    TEST_ASSERT_EQUAL_size_t (sample_log_size (),
+                              LittleFS.file_bytes (SAMPLE_LOG_FILE));
+}
+
+
+int main (int argc, char** argv)
+{
+    LittleFS.format ();
+    sample_log_init ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_mount_after_seal);
+    RUN_TEST (test_store_uses_no_heap);
+    RUN_TEST (test_rotation_opens_the_new_file);
+    return UNITY_END ();
+}
@@ -0,0 +1,384 @@
+/** @file test_main.cpp
+ *  This file contains tests of the profiler's ring of spans and its JSON
+ *  export: spans copied out whole, slots being written or already taken by
+ *  a newer span refused by their sequence numbers, a writer and a reader in
+ *  threads of their own, the ring wrapping over its oldest spans, and cycle
+ *  counts which wrap or go back a little between cores being put on one
+ *  line of time in the export.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <unity.h>
+#include "trace.h"
+#include "json_writer.h"
+
+/// Most bytes of an export the client keeps
+const size_t CLIENT_MAX_BYTES = 131072;
+
+/// Names the spans are given in turn
+static const char* const NAMES[] = { "scan", "filter", "store", "stream" };
+const uint8_t NAME_COUNT = sizeof (NAMES) / sizeof (NAMES[0]);
+
+
+/** @brief   Class which stands in for a web client's connection, keeping
+ *           the bytes it's given as a string.
+ */
+class TextClient : public Print
+{
+public:
+    char bytes[CLIENT_MAX_BYTES];           ///< Everything taken, in order
+    size_t taken;                           ///< Bytes taken
+
+    /// Forget everything taken
+    void reset (void)
+    {
+        taken = 0;
+        bytes[0] = '\0';
+    }
+
+    using Print::write;
+
+    /// Take one byte
+    size_t write (uint8_t byte)
+    {
+        return write (&byte, 1);
+    }
+
+    /// Take as many bytes as there's room for, keeping them terminated
+    size_t write (const uint8_t* data, size_t count)
+    {
+        size_t room = CLIENT_MAX_BYTES - 1 - taken;
+        size_t take = (count < room) ? count : room;
+        memcpy (bytes + taken, data, take);
+        taken += take;
+        bytes[taken] = '\0';
+        return take;
+    }
+
+    /// Get the body, after the headers
+    const char* body (void) const
+    {
+        const char* end = strstr (bytes, "\r\n\r\n");
+        return end ? end + 4 : bytes;
+    }
+};
+
+
+/** @brief   Ring whose slots a test can mark as a writer would leave them.
+ */
+class MarkedRing : public TraceRing
+{
+public:
+    /// Set the sequence number of the slot a span is kept in
+    void mark (uint32_t number, uint32_t sequence)
+    {
+        slots[number % TRACE_RING_SPANS].sequence.store (sequence);
+    }
+};
+
+/// The ring each test uses, which is large, so it isn't kept on the stack
+static MarkedRing ring;
+
+/// The client the export goes to, and the writer's buffer
+static TextClient client;
+static char buffer[RESPONSE_CHUNK_SIZE];
+
+
+/** @brief   Put a span whose parts all follow from its number.
+ */
+static void put_numbered (TraceRing& into, uint32_t number)
+{
+    into.put (NAMES[number % NAME_COUNT], number * 1000,
+              number * 1000 + number % 500, number % 3 + 1, number & 1);
+}
+
+
+/** @brief   Check that a span copied out is the one put with a number.
+ */
+static bool is_numbered (const trace_span_t& span, uint32_t number)
+{
+    return span.start == number * 1000 && span.cycles == number % 500
+           && span.name == NAMES[number % NAME_COUNT]
+           && span.task == number % 3 + 1 && span.cpu == (number & 1);
+}
+
+
+/** @brief   Name a task as the tester's /trace does.
+ */
+static const char* name_task (uint32_t task)
+{
+    static const char* const TASKS[] = { "none", "Sensor", "Process", "Web" };
+    return (task < 4) ? TASKS[task] : "other";
+}
+
+
+/** @brief   Export the ring as @c /trace does, into the client.
+ *  @param   cycles_per_us The clock to give the export
+ *  @returns The JSON text
+ */
+static const char* export_ring (uint32_t cycles_per_us)
+{
+    client.reset ();
+    ResponseWriter page (client, buffer, sizeof (buffer));
+    page.begin (200, "application/json");
+    JsonWriter json (page);
+    json.begin_object ();
+    trace_write_json (json, ring, cycles_per_us, name_task);
+    json.end_object ();
+    TEST_ASSERT_TRUE (page.end ());
+    return client.body ();
+}
+
+
+/** @brief   Count the places a piece of text is found in another.
+ */
+static uint32_t count_of (const char* text, const char* piece)
+{
+    uint32_t found = 0;
+    while ((text = strstr (text, piece)) != NULL)
+    {
+        found++;
+        text += strlen (piece);
+    }
+    return found;
+}
+
+
+void setUp (void)
+{
+    ring.clear ();
+    ring.set_recording (true);
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   Spans are copied out as they were put, with lengths across a
+ *           wrap of the counter, and none are put while not recording.
+ */
+void test_put_and_get (void)
+{
+    uint32_t first = ring.get_head ();
+    ring.put ("wrap", 0xFFFFFF00, 0x100, 7, 1);
+    put_numbered (ring, first + 1);
+
+    trace_span_t span;
+    TEST_ASSERT_TRUE (ring.get (first, span));
+    TEST_ASSERT_EQUAL_HEX32 (0xFFFFFF00, span.start);
+    TEST_ASSERT_EQUAL_UINT32 (0x200, span.cycles);
+    TEST_ASSERT_EQUAL_STRING ("wrap", span.name);
+    TEST_ASSERT_EQUAL_UINT32 (7, span.task);
+    TEST_ASSERT_EQUAL_UINT8 (1, span.cpu);
+    TEST_ASSERT_TRUE (ring.get (first + 1, span));
+    TEST_ASSERT_TRUE (is_numbered (span, first + 1));
+
+    // Spans not yet put aren't there, and none are put while stopped
+    TEST_ASSERT_FALSE (ring.get (first + 2, span));
+    ring.set_recording (false);
+    put_numbered (ring, first + 2);
+    TEST_ASSERT_EQUAL_UINT32 (first + 2, ring.get_head ());
+
+    ring.clear ();
+    TEST_ASSERT_FALSE (ring.get (first, span));
+}
+
+
+/** @brief   A slot whose sequence number shows it being written, or taken
+ *           by a newer span, is refused; the span is whole again after.
+ */
+void test_torn_slot_refused (void)
+{
+    uint32_t number = ring.get_head ();
+    put_numbered (ring, number);
+    trace_span_t span;
+    TEST_ASSERT_TRUE (ring.get (number, span));
+
+    // A writer clears the number while it writes the slot
+    ring.mark (number, 0);
+    TEST_ASSERT_FALSE (ring.get (number, span));
+
+    // A writer a whole ring later has put its span in the same slot
+    ring.mark (number, number + 1 + TRACE_RING_SPANS);
+    TEST_ASSERT_FALSE (ring.get (number, span));
+
+    ring.mark (number, number + 1);
+    TEST_ASSERT_TRUE (ring.get (number, span));
+    TEST_ASSERT_TRUE (is_numbered (span, number));
+}
+
+
+/** @brief   A reader in a thread of its own, copying spans while another
+ *           thread writes over them, only ever gets whole spans.
+ */
+void test_reader_never_sees_torn_spans (void)
+{
+    const uint32_t SPANS = 20000000;
+    uint32_t first = ring.get_head ();
+    std::atomic<bool> done (false);
+    uint32_t whole = 0;
+    uint32_t torn = 0;
+
+    std::thread reader ([&] ()
+    {
+        trace_span_t span;
+        while (!done.load ())
+        {
+            // The oldest spans are those the writer is about to write over
+            uint32_t head = ring.get_head ();
+            for (uint32_t back = TRACE_RING_SPANS;
+                 back > TRACE_RING_SPANS - 4; back--)
+            {
+                if (head - first < back)
+                {
+                    continue;
+                }
+                uint32_t number = head - back;
+                if (ring.get (number, span))
+                {
+                    whole++;
+                    torn += !is_numbered (span, number);
+                }
+            }
+        }
+    });
+    for (uint32_t number = first; number != first + SPANS; number++)
+    {
+        put_numbered (ring, number);
+    }
+    done.store (true);
+    reader.join ();
+
+    TEST_ASSERT_EQUAL_UINT32 (0, torn);
+    TEST_ASSERT_GREATER_THAN (0, whole);
+}
+
+
+/** @brief   Once the ring wraps, the oldest spans are gone and the newest
+ *           whole ring of them is kept and sent in order.
+ */
+void test_ring_wraps (void)
+{
+    const uint32_t EXTRA = 100;
+    uint32_t first = ring.get_head ();
+    for (uint32_t number = first; number != first + TRACE_RING_SPANS + EXTRA;
+         number++)
+    {
+        put_numbered (ring, number);
+    }
+
+    trace_span_t span;
+    for (uint32_t number = first; number != first + EXTRA; number++)
+    {
+        TEST_ASSERT_FALSE (ring.get (number, span));
+    }
+    for (uint32_t number = first + EXTRA;
+         number != first + EXTRA + TRACE_RING_SPANS; number++)
+    {
+        TEST_ASSERT_TRUE (ring.get (number, span));
+        TEST_ASSERT_TRUE (is_numbered (span, number));
+    }
+
+    // Every span kept is sent, and the oldest kept is at the start of time
+    const char* json = export_ring (1000);
+    char expected[160];
+    snprintf (expected, sizeof (expected), "\"spans_recorded\":%u",
+              (unsigned)ring.get_head ());
+    TEST_ASSERT_NOT_NULL (strstr (json, expected));
+    snprintf (expected, sizeof (expected), "\"spans_sent\":%u",
+              (unsigned)TRACE_RING_SPANS);
+    TEST_ASSERT_NOT_NULL (strstr (json, expected));
+    TEST_ASSERT_EQUAL_UINT32 (TRACE_RING_SPANS,
+                              count_of (json, "\"ph\":\"X\""));
+
+    uint32_t oldest = first + EXTRA;
+    snprintf (expected, sizeof (expected),
+              "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+              "\"ts\":0.0,", NAMES[oldest % NAME_COUNT],
+              (unsigned)(oldest % 3 + 1));
+    TEST_ASSERT_NOT_NULL (strstr (json, expected));
+
+    // A slot in the middle being written is left out of the export
+    ring.mark (oldest + 10, 0);
+    json = export_ring (1000);
+    snprintf (expected, sizeof (expected), "\"spans_sent\":%u",
+              (unsigned)TRACE_RING_SPANS - 1);
+    TEST_ASSERT_NOT_NULL (strstr (json, expected));
+}
+
+
+/** @brief   Cycle counts which wrap past zero, or go back a little as they
+ *           may between cores, are put on one line of time from the
+ *           earliest span, and each task is named once.
+ */
+void test_export_unwraps_counts (void)
+{
+    ring.put ("a", 0xFFFFFF00, 0xFFFFFF10, 1, 0);
+    ring.put ("b", 0xFFFFFE00, 0xFFFFFE40, 2, 1);
+    ring.put ("c", 0x00000100, 0x00000180, 1, 0);
+    ring.put ("d", 0x00000F00, 0x00001000, 3, 0);
+
+    // At 1 cycle per microsecond, the times are the steps between counts
+    const char* json = export_ring (1);
+    const char* const EVENTS[] =
+    {
+        "{\"name\":\"a\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":256.0,"
+        "\"dur\":16.0,\"args\":{\"cpu\":0}}",
+        "{\"name\":\"b\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":0.0,"
+        "\"dur\":64.0,\"args\":{\"cpu\":1}}",
+        "{\"name\":\"c\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":768.0,"
+        "\"dur\":128.0,\"args\":{\"cpu\":0}}",
+        "{\"name\":\"d\",\"ph\":\"X\",\"pid\":1,\"tid\":3,\"ts\":4352.0,"
+        "\"dur\":256.0,\"args\":{\"cpu\":0}}"
+    };
+    const char* from = json;
+    for (uint8_t index = 0; index < 4; index++)
+    {
+        const char* found = strstr (from, EVENTS[index]);
+        TEST_ASSERT_NOT_NULL (found);
+        from = found;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32 (3, count_of (json, "\"thread_name\""));
+    TEST_ASSERT_NOT_NULL (strstr (json, "\"tid\":2,\"args\":{\"name\":"
+                                        "\"Process\"}"));
+    TEST_ASSERT_NOT_NULL (strstr (json, "\"cycles_per_us\":1"));
+
+    // At 240 MHz the same steps are 240 times shorter
+    json = export_ring (240);
+    TEST_ASSERT_NOT_NULL (strstr (json, "\"name\":\"d\",\"ph\":\"X\","
+                                        "\"pid\":1,\"tid\":3,\"ts\":18.1,"
+                                        "\"dur\":1.0,"));
+}
+
+
+/** @brief   An empty ring sends no spans.
+ */
+void test_export_empty (void)
+{
+    const char* json = export_ring (240);
+    TEST_ASSERT_NOT_NULL (strstr (json, "\"traceEvents\":[]"));
+    TEST_ASSERT_NOT_NULL (strstr (json, "\"spans_sent\":0"));
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_put_and_get);
+    RUN_TEST (test_torn_slot_refused);
+    RUN_TEST (test_reader_never_sees_torn_spans);
+    RUN_TEST (test_ring_wraps);
+    RUN_TEST (test_export_unwraps_counts);
+    RUN_TEST (test_export_empty);
+    return UNITY_END ();
+}
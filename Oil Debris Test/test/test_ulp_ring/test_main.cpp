@@ -0,0 +1,243 @@
+/** @file test_main.cpp
+ *  This file contains tests of the ring through which the ULP hands
+ *  readings to the main CPUs, with @c ulp_ring_emulate() standing in for
+ *  the ULP program: a full ring dropping and counting readings, the wake
+ *  when the ring fills to @c ULP_WAKE_LEVEL, the threshold wake which fires
+ *  once and is armed again below both thresholds, and the indices wrapping
+ *  around the ring.
+ *
+ *  @author Corey Agena, Daniel Ceja, Parker Tenney
+ *  @date   2026-Oct-16 Original file
+ *  @copyright 2026 by the authors, released under the MIT License.
+ */
+
+#include <unity.h>
+#include "ulp_ring.h"
+
+/// The data block, as it would be in RTC memory
+static volatile uint32_t data[ULP_DATA_WORDS];
+
+/// The CPUs' side of the ring
+static UlpRing ring (data);
+
+
+void setUp (void)
+{
+    ring.reset ();
+}
+
+
+void tearDown (void)
+{
+}
+
+
+/** @brief   A reset ring is empty, armed and won't wake on readings.
+ */
+void test_reset_ring_is_empty (void)
+{
+    uint16_t fine;
+    uint16_t coarse;
+    TEST_ASSERT_EQUAL_UINT16 (0, ring.available ());
+    TEST_ASSERT_FALSE (ring.pop (fine, coarse));
+    TEST_ASSERT_EQUAL_UINT32 (1, data[ULP_ARMED]);
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 4095, 4095, true));
+    TEST_ASSERT_EQUAL_UINT16 (0, ring.new_events ());
+}
+
+
+/** @brief   The ring holds one reading fewer than its slots; after that,
+ *           readings are dropped and counted, and the ones kept aren't
+ *           touched.
+ */
+void test_full_ring_counts_drops (void)
+{
+    for (uint16_t count = 0; count < ULP_RING_SAMPLES - 1; count++)
+    {
+        ulp_ring_emulate (data, count, count + 1000, false);
+    }
+    TEST_ASSERT_EQUAL_UINT16 (ULP_RING_SAMPLES - 1, ring.available ());
+    TEST_ASSERT_EQUAL_UINT32 (0, data[ULP_DROPPED]);
+
+    for (uint16_t count = 0; count < 3; count++)
+    {
+        ulp_ring_emulate (data, 9999, 9999, false);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (3, data[ULP_DROPPED]);
+    TEST_ASSERT_EQUAL_UINT16 (3, ring.new_drops ());
+    TEST_ASSERT_EQUAL_UINT16 (0, ring.new_drops ());
+    TEST_ASSERT_EQUAL_UINT16 (ULP_RING_SAMPLES - 1, ring.available ());
+
+    // Taking one reading makes room for one more
+    uint16_t fine;
+    uint16_t coarse;
+    TEST_ASSERT_TRUE (ring.pop (fine, coarse));
+    TEST_ASSERT_EQUAL_UINT16 (0, fine);
+    TEST_ASSERT_EQUAL_UINT16 (1000, coarse);
+    ulp_ring_emulate (data, 7, 8, false);
+    ulp_ring_emulate (data, 9, 9, false);
+    TEST_ASSERT_EQUAL_UINT16 (1, ring.new_drops ());
+
+    for (uint16_t count = 1; count < ULP_RING_SAMPLES - 1; count++)
+    {
+        TEST_ASSERT_TRUE (ring.pop (fine, coarse));
+        TEST_ASSERT_EQUAL_UINT16 (count, fine);
+        TEST_ASSERT_EQUAL_UINT16 (count + 1000, coarse);
+    }
+    TEST_ASSERT_TRUE (ring.pop (fine, coarse));
+    TEST_ASSERT_EQUAL_UINT16 (7, fine);
+    TEST_ASSERT_EQUAL_UINT16 (8, coarse);
+    TEST_ASSERT_FALSE (ring.pop (fine, coarse));
+}
+
+
+/** @brief   The drop count wraps at 16 bits, as the ULP's does, and the
+ *           CPU's count of new drops follows it across the wrap.
+ */
+void test_drop_count_wraps (void)
+{
+    data[ULP_DROPPED] = 0xFFFE;
+    ring.new_drops ();
+    for (uint16_t count = 0; count < ULP_RING_SAMPLES + 3; count++)
+    {
+        ulp_ring_emulate (data, 0, 0, false);
+    }
+    TEST_ASSERT_EQUAL_UINT32 (2, data[ULP_DROPPED]);
+    TEST_ASSERT_EQUAL_UINT16 (4, ring.new_drops ());
+}
+
+
+/** @brief   The ULP wakes sleeping CPUs when @c ULP_WAKE_LEVEL readings are
+ *           waiting, and on every reading after that until they drain it.
+ */
+void test_wakes_at_wake_level (void)
+{
+    for (uint16_t count = 1; count < ULP_WAKE_LEVEL; count++)
+    {
+        TEST_ASSERT_FALSE (ulp_ring_emulate (data, 0, 0, true));
+    }
+    TEST_ASSERT_EQUAL_UINT16 (ULP_WAKE_LEVEL - 1, ring.available ());
+    TEST_ASSERT_TRUE (ulp_ring_emulate (data, 0, 0, true));
+    TEST_ASSERT_EQUAL_UINT16 (ULP_WAKE_LEVEL, ring.available ());
+    TEST_ASSERT_TRUE (ulp_ring_emulate (data, 0, 0, true));
+
+    // CPUs which are awake aren't woken
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 0, 0, false));
+
+    // Draining below the level stops the wakes
+    uint16_t fine;
+    uint16_t coarse;
+    while (ring.available () >= ULP_WAKE_LEVEL - 1)
+    {
+        ring.pop (fine, coarse);
+    }
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 0, 0, true));
+}
+
+
+/** @brief   Crossing a threshold wakes the CPUs once; the ULP is only armed
+ *           again once both readings are back below their thresholds.
+ */
+void test_threshold_fires_once_and_rearms (void)
+{
+    ring.set_thresholds (100, 200);
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 99, 199, true));
+    TEST_ASSERT_TRUE (ulp_ring_emulate (data, 100, 0, true));
+    TEST_ASSERT_EQUAL_UINT32 (0, data[ULP_ARMED]);
+
+    // Staying above, or crossing the other threshold, doesn't wake again
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 150, 0, true));
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 0, 250, true));
+
+    // One channel falling back isn't enough while the other is above
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 0, 200, true));
+    TEST_ASSERT_EQUAL_UINT32 (0, data[ULP_ARMED]);
+
+    // Below both arms it again, and the next crossing wakes
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 99, 199, true));
+    TEST_ASSERT_EQUAL_UINT32 (1, data[ULP_ARMED]);
+    TEST_ASSERT_TRUE (ulp_ring_emulate (data, 0, 200, true));
+    TEST_ASSERT_EQUAL_UINT16 (2, ring.new_events ());
+    TEST_ASSERT_EQUAL_UINT16 (0, ring.new_events ());
+}
+
+
+/** @brief   A crossing is counted as an event while the CPUs are awake,
+ *           though they aren't woken.
+ */
+void test_crossing_counted_while_awake (void)
+{
+    ring.set_thresholds (100, 100);
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 500, 0, false));
+    TEST_ASSERT_EQUAL_UINT16 (1, ring.new_events ());
+    TEST_ASSERT_FALSE (ulp_ring_emulate (data, 500, 0, true));
+    TEST_ASSERT_EQUAL_UINT16 (0, ring.new_events ());
+}
+
+
+/** @brief   Readings come out in order as the head and tail wrap around the
+ *           ring many times, and @c available() is right when the head has
+ *           wrapped and the tail hasn't.
+ */
+void test_pop_and_available_wrap (void)
+{
+    uint16_t written = 0;
+    uint16_t read = 0;
+    for (uint16_t round = 0; round < 40; round++)
+    {
+        uint16_t burst = 1 + (round * 37) % (ULP_RING_SAMPLES - 1);
+        for (uint16_t count = 0; count < burst; count++, written++)
+        {
+            ulp_ring_emulate (data, written, ~written & 0xFFFF, false);
+        }
+        TEST_ASSERT_EQUAL_UINT16 (burst, ring.available ());
+
+        uint16_t fine;
+        uint16_t coarse;
+        while (ring.pop (fine, coarse))
+        {
+            TEST_ASSERT_EQUAL_UINT16 (read, fine);
+            TEST_ASSERT_EQUAL_UINT16 (~read & 0xFFFF, coarse);
+            read++;
+        }
+        TEST_ASSERT_EQUAL_UINT16 (0, ring.available ());
+    }
+    TEST_ASSERT_EQUAL_UINT16 (written, read);
+    TEST_ASSERT_GREATER_THAN (8 * ULP_RING_SAMPLES, written);
+    TEST_ASSERT_EQUAL_UINT32 (0, data[ULP_DROPPED]);
+}
+
+
+/** @brief   Only the low half of each word counts, as the ULP writes no
+ *           more than that.
+ */
+void test_high_halves_ignored (void)
+{
+    data[ULP_HEAD] = 0xABCD0003;
+    data[ULP_TAIL] = 0x12340001;
+    data[ULP_RING + 2] = 0xFFFF0042;
+    data[ULP_RING + 3] = 0x00010043;
+    TEST_ASSERT_EQUAL_UINT16 (2, ring.available ());
+
+    uint16_t fine;
+    uint16_t coarse;
+    TEST_ASSERT_TRUE (ring.pop (fine, coarse));
+    TEST_ASSERT_EQUAL_HEX16 (0x42, fine);
+    TEST_ASSERT_EQUAL_HEX16 (0x43, coarse);
+    TEST_ASSERT_EQUAL_UINT16 (1, ring.available ());
+}
+
+
+int main (int argc, char** argv)
+{
+    UNITY_BEGIN ();
+    RUN_TEST (test_reset_ring_is_empty);
+    RUN_TEST (test_full_ring_counts_drops);
+    RUN_TEST (test_drop_count_wraps);
+    RUN_TEST (test_wakes_at_wake_level);
+    RUN_TEST (test_threshold_fires_once_and_rearms);
+    RUN_TEST (test_crossing_counted_while_awake);
+    RUN_TEST (test_pop_and_available_wrap);
+    RUN_TEST (test_high_halves_ignored);
+    return UNITY_END ();
+}
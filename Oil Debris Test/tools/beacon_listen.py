@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""@file beacon_listen.py
+Listen for the UDP telemetry beacons which oil debris testers send when
+built with USE_BEACON, and show the latest readings of each tester with how
+many of its beacons were lost. Every beacon carries its sequence number and
+the period between beacons, so a listener can tell exactly how many it
+missed. A tester which restarts begins its sequence again at 0; that is
+noticed from its uptime going backwards and counted as a restart rather
+than as loss.
+
+Usage:
+    python3 beacon_listen.py                      # broadcast, port 47210
+    python3 beacon_listen.py --group 239.255.0.1  # if sent to a group
+    python3 beacon_listen.py --seconds 600 --every 30
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+# Layout of a beacon; see beacon.h
+BEACON = struct.Struct('<2sBB6sHIIHHHHHH')
+MAGIC = b'DB'
+VERSION = 1
+
+
+class Device:
+    """What has been heard from one tester since it last started."""
+
+    def __init__(self):
+        self.received = 0
+        self.expected = 0
+        self.duplicates = 0
+        self.late = 0
+        self.restarts = 0
+        self.first_seq = None
+        self.top_seq = None
+        self.top_uptime = 0
+        self.seen = set()
+        self.events = 0
+        self.last_events = None
+        self.latest = None
+        self.heard_at = 0.0
+
+    def restart(self, seq):
+        """Begin counting again after the tester has restarted, keeping the
+        totals from before."""
+        if self.top_seq is not None:
+            self.expected += self.top_seq - self.first_seq + 1
+            self.restarts += 1
+        self.first_seq = seq
+        self.top_seq = seq
+        self.seen = set()
+        self.last_events = None
+
+    def add(self, seq, uptime, events):
+        """Count one beacon. Returns False if it was a repeat."""
+        if self.top_seq is None or (uptime + 1000 < self.top_uptime
+                                    and seq < self.top_seq):
+            self.restart(seq)
+        if seq in self.seen or seq < self.first_seq:
+            self.duplicates += 1
+            return False
+        self.seen.add(seq)
+        self.received += 1
+        if seq < self.top_seq:
+            self.late += 1
+        else:
+            self.top_seq = seq
+            self.top_uptime = uptime
+            # The beacon holds the low 16 bits of the event count
+            if self.last_events is not None:
+                self.events += (events - self.last_events) & 0xFFFF
+            self.last_events = events
+        return True
+
+    def total_expected(self):
+        span = 0 if self.top_seq is None else self.top_seq - self.first_seq + 1
+        return self.expected + span
+
+    def loss(self):
+        expected = self.total_expected()
+        return 100.0 * (expected - self.received) / expected if expected else 0
+
+
+def parse(data):
+    """Unpack a beacon into a dictionary, or return None if it isn't one."""
+    if len(data) < BEACON.size:
+        return None
+    (magic, version, size, mac, period, seq, uptime, blocks, fine_mean,
+     fine_max, coarse_mean, coarse_max, events) = BEACON.unpack_from(data)
+    if magic != MAGIC or version != VERSION or size != BEACON.size:
+        return None
+    return {'device': "debris-" + mac[3:].hex(), 'mac': mac.hex(':'),
+            'period_ms': period, 'seq': seq, 'uptime_ms': uptime,
+            'blocks': blocks, 'fine_mean': fine_mean, 'fine_max': fine_max,
+            'coarse_mean': coarse_mean, 'coarse_max': coarse_max,
+            'events': events}
+
+
+def report(devices, now):
+    print("%-14s %8s %8s %7s %5s %5s %4s %7s %7s %7s %7s %6s %6s" % (
+        "device", "received", "expected", "loss %", "dup", "late", "rst",
+        "fine", "f peak", "coarse", "c peak", "events", "silent"))
+    for name, device in sorted(devices.items()):
+        latest = device.latest
+        print("%-14s %8d %8d %7.2f %5d %5d %4d %7d %7d %7d %7d %6d %5.0fs" % (
+            name, device.received, device.total_expected(), device.loss(),
+            device.duplicates, device.late, device.restarts,
+            latest['fine_mean'], latest['fine_max'], latest['coarse_mean'],
+            latest['coarse_max'], device.events, now - device.heard_at))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Collect testers' UDP beacons and report packet loss.")
+    parser.add_argument('--port', type=int, default=47210)
+    parser.add_argument('--group', default=None,
+                        help="multicast group to join, if not broadcast")
+    parser.add_argument('--seconds', type=float, default=None,
+                        help="stop after this long (default: run until ^C)")
+    parser.add_argument('--every', type=float, default=10.0,
+                        help="seconds between reports (default 10)")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(('', args.port))
+    if args.group:
+        request = struct.pack('4s4s', socket.inet_aton(args.group),
+                              socket.inet_aton('0.0.0.0'))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, request)
+    sock.settimeout(0.5)
+
+    devices = {}
+    junk = 0
+    start = time.monotonic()
+    next_report = start + args.every
+    try:
+        while args.seconds is None or time.monotonic() - start < args.seconds:
+            try:
+                data, _ = sock.recvfrom(256)
+            except socket.timeout:
+                data = None
+            now = time.monotonic()
+            if data is not None:
+                beacon = parse(data)
+                if beacon is None:
+                    junk += 1
+                else:
+                    device = devices.setdefault(beacon['device'], Device())
+                    if device.add(beacon['seq'], beacon['uptime_ms'],
+                                  beacon['events']):
+                        device.heard_at = now
+                        if beacon['seq'] == device.top_seq:
+                            device.latest = beacon
+            if now >= next_report and devices:
+                report(devices, now)
+                next_report = now + args.every
+    except KeyboardInterrupt:
+        pass
+
+    if not devices:
+        sys.exit("no beacons were heard on port %d" % args.port)
+    report(devices, time.monotonic())
+    if junk:
+        print("%d datagrams weren't beacons" % junk, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""@file data_download.py
+Download the sample log served at /data.bin by the oil debris tester, then
+turn its packed records back into CSV. A download which is cut off is
+carried on from where it stopped the next time the script runs, or on the
+next retry, using HTTP Range requests. This is the PC-side mirror of
+the log records in src/sample_log.h and codec_decode_block() in
+src/sample_codec.cpp; tools/sync_client.py uses the same decoding.
+
+Usage:
+    python3 data_download.py http://192.168.5.1/data.bin data.bin > out.csv
+    python3 data_download.py data.bin > out.csv
+
+Each block holds the readings of one channel taken every sample period,
+which is given with --period if it isn't the tester's usual 10 ms. A
+samples record holds a block for each channel, and the channels' names
+come from the channels records the tester writes into each log file.
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import urllib.error
+import urllib.request
+
+HEADER_SIZE = 14
+MAGIC = 0xDB
+VARINT = 1
+BITPACK = 2
+RECORD_HEADER_SIZE = 8
+RECORD_MAGIC = 0xA5
+SAMPLES = 1
+EVENT = 2
+TRUTH = 3
+CHANNELS = 4
+CHUNK = 16384
+
+
+def download(url, path, retries=10, timeout=10):
+    """Fetch url into path, resuming a partial file when the tester still
+    has the same log generation. Returns the number of bytes in the file."""
+    tag_path = path + '.etag'
+    for attempt in range(retries + 1):
+        have = os.path.getsize(path) if os.path.exists(path) else 0
+        tag = None
+        if have and os.path.exists(tag_path):
+            with open(tag_path) as file:
+                tag = file.read().strip()
+
+        request = urllib.request.Request(url)
+        if have and tag:
+            request.add_header('Range', 'bytes=%d-' % have)
+            request.add_header('If-Range', tag)
+
+        try:
+            with urllib.request.urlopen(request, timeout=timeout) as reply:
+                if reply.status == 206:
+                    total = int(reply.headers['Content-Range'].split('/')[1])
+                    mode = 'ab'
+                else:
+                    # A whole new log, perhaps because it was moved aside
+                    total = int(reply.headers['Content-Length'])
+                    have = 0
+                    mode = 'wb'
+                with open(tag_path, 'w') as file:
+                    file.write(reply.headers.get('ETag', ''))
+                with open(path, mode) as file:
+                    while True:
+                        data = reply.read(CHUNK)
+                        if not data:
+                            break
+                        file.write(data)
+                        have += len(data)
+                        print("\r%d of %d bytes" % (have, total), end='',
+                              file=sys.stderr)
+                print(file=sys.stderr)
+                if have >= total:
+                    return have
+        except urllib.error.HTTPError as error:
+            if error.code == 416:
+                # We already have everything there is
+                return have
+            print("HTTP error %d" % error.code, file=sys.stderr)
+        except (OSError, ValueError) as error:
+            print("\ndownload interrupted: %s" % error, file=sys.stderr)
+
+        if attempt < retries:
+            time.sleep(min(2 ** attempt, 30))
+    sys.exit("gave up after %d retries" % retries)
+
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_block(data, offset):
+    """Decode the block at offset; return (channel, timestamp, samples,
+    size), or None if no sensible block starts there."""
+    if offset + HEADER_SIZE > len(data):
+        return None
+    (magic, mode, channel, width, count, base, stamp,
+     payload) = struct.unpack_from('<BBBBHHIH', data, offset)
+    end = offset + HEADER_SIZE + payload
+    if (magic != MAGIC or mode not in (VARINT, BITPACK) or count == 0
+            or width > 16 or end > len(data)):
+        return None
+
+    samples = [base]
+    value = base
+    pos = offset + HEADER_SIZE
+    if mode == VARINT:
+        for _ in range(count - 1):
+            zz = shift = 0
+            while True:
+                if pos >= end or shift > 14:
+                    return None
+                byte = data[pos]
+                pos += 1
+                zz |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            value = (value + zigzag_decode(zz)) & 0xFFFF
+            samples.append(value)
+    else:
+        bits = held = 0
+        mask = (1 << width) - 1
+        for _ in range(count - 1):
+            while held < width:
+                if pos >= end:
+                    return None
+                bits |= data[pos] << held
+                pos += 1
+                held += 8
+            value = (value + zigzag_decode(bits & mask)) & 0xFFFF
+            samples.append(value)
+            bits >>= width
+            held -= width
+
+    return channel, stamp, samples, end - offset
+
+
+def read_records(data):
+    """Split a run of log records into a list of (sequence, kind, payload),
+    in the order they were stored. Bytes which aren't part of a whole
+    record, as after a power failure, are skipped by looking for the next
+    place a record starts. Returns the list and the number of bytes
+    skipped."""
+    records = []
+    skipped = 0
+    offset = 0
+    while offset + RECORD_HEADER_SIZE <= len(data):
+        magic, kind, length, seq = struct.unpack_from('<BBHI', data, offset)
+        end = offset + RECORD_HEADER_SIZE + length
+        if magic != RECORD_MAGIC or end > len(data):
+            offset += 1
+            skipped += 1
+            continue
+        records.append((seq, kind, data[offset + RECORD_HEADER_SIZE:end]))
+        offset = end
+    return records, skipped + len(data) - offset
+
+
+def decode_samples(payload, period):
+    """Decode a samples record, which holds a codec block for each channel,
+    all taken at the same time. Returns a list of (time, counts), where
+    counts has an item for each channel up to the highest one in the
+    record, with None for a channel which couldn't be decoded."""
+    channels = {}
+    stamp = None
+    offset = 0
+    while offset < len(payload):
+        block = decode_block(payload, offset)
+        if block is None:
+            break
+        channel, stamp, samples, size = block
+        channels[channel] = samples
+        offset += size
+    if not channels:
+        return []
+    width = max(channels) + 1
+    rows = max(len(samples) for samples in channels.values())
+    columns = [channels.get(channel, []) for channel in range(width)]
+    return [(stamp + index * period,
+             [column[index] if index < len(column) else None
+              for column in columns])
+            for index in range(rows)]
+
+
+def decode_channels(payload):
+    """Decode a channels record into the list of the channels' names."""
+    return [name.decode('ascii', 'replace')
+            for name in payload.split(b'\0')[:-1]]
+
+
+def channel_name(names, channel):
+    """Get a channel's name, making one up if no channels record gave it;
+    the first two channels are always the fine and coarse sensors."""
+    if channel < len(names):
+        return names[channel]
+    return ("fine", "coarse")[channel] if channel < 2 else "ch%d" % channel
+
+
+def decode_event(payload):
+    """Decode an event record into (time, peak counts, samples, channel)."""
+    return struct.unpack('<IHHB', payload[:9])
+
+
+def csv_heading(names, width):
+    """Make the heading of the CSV, with a voltage for each channel."""
+    return ", ".join(["Time (ms)"] + [
+        "%s Voltage" % channel_name(names, channel).capitalize()
+        for channel in range(width)])
+
+
+def csv_row(stamp, counts, scale, width):
+    """Format one reading of each channel as a line of CSV, in volts."""
+    counts = counts + [None] * (width - len(counts))
+    return ", ".join(["%.1f" % stamp] + [
+        "" if value is None else "%.4f" % (value * scale)
+        for value in counts])
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Download /data.bin and write it out as CSV.")
+    parser.add_argument('source', help="URL of /data.bin, or a saved file")
+    parser.add_argument('path', nargs='?', default='data.bin',
+                        help="where a download is saved (default data.bin)")
+    parser.add_argument('--period', type=float, default=10.0,
+                        help="sample period in ms (default 10)")
+    parser.add_argument('--full-scale', type=float, default=5.0,
+                        help="voltage at 4095 counts (default 5.0)")
+    args = parser.parse_args()
+
+    path = args.source
+    if args.source.startswith('http'):
+        path = args.path
+        download(args.source, path)
+    with open(path, 'rb') as file:
+        data = file.read()
+
+    records, skipped = read_records(data)
+    scale = args.full_scale / 4095
+    names = []
+    rows = []
+    events = 0
+    truths = 0
+    for seq, kind, payload in records:
+        if kind == SAMPLES:
+            rows.extend(decode_samples(payload, args.period))
+        elif kind == CHANNELS:
+            names = decode_channels(payload)
+        elif kind == EVENT:
+            events += 1
+        elif kind == TRUTH:
+            truths += 1
+
+    # Every row gets a column for each channel any record named or held
+    width = max([len(names)] + [len(counts) for stamp, counts in rows])
+    print(csv_heading(names, width))
+    for stamp, counts in rows:
+        print(csv_row(stamp, counts, scale, width))
+    count = len(rows)
+
+    print("# %d rows and %d events from %d records in %d bytes, "
+          "%d bytes skipped" % (count, events, len(records), len(data),
+                                skipped), file=sys.stderr)
+    if truths:
+        print("# %d simulated particles (USE_SIMULATED)" % truths,
+              file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
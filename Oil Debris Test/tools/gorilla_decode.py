@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""@file gorilla_decode.py
+Decode the compressed voltage history served at /csv?format=gorilla by the
+oil debris tester and write it out as CSV. This is the PC-side mirror of
+GorillaDecoder in src/gorilla.cpp.
+
+Usage:
+    python3 gorilla_decode.py http://192.168.5.1/csv?format=gorilla > out.csv
+    python3 gorilla_decode.py history.bin > out.csv
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import struct
+import sys
+import urllib.request
+
+HEADER_SIZE = 12
+MAGIC = ord('G')
+
+
+class BitReader:
+    """Read bits most significant first from a bytes object."""
+
+    def __init__(self, data, start_bit, end_bit):
+        self.data = data
+        self.pos = start_bit
+        self.end = end_bit
+
+    def read(self, count):
+        if self.pos + count > self.end:
+            raise EOFError("block ended in the middle of a row")
+        value = 0
+        for _ in range(count):
+            byte = self.data[self.pos >> 3]
+            value = (value << 1) | ((byte >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return value
+
+
+def bits_to_float(bits):
+    return struct.unpack('<f', struct.pack('<I', bits))[0]
+
+
+def decode_block(data, offset):
+    """Decode one block starting at offset; return (rows, block size)."""
+    magic, columns, used, count, t0 = struct.unpack_from('<BBHII', data,
+                                                         offset)
+    if magic != MAGIC or not 1 <= columns <= 8 or used < HEADER_SIZE:
+        raise ValueError("no Gorilla block at offset %d" % offset)
+
+    if count == 0:
+        return [], used
+
+    reader = BitReader(data, (offset + HEADER_SIZE) * 8, (offset + used) * 8)
+    prev_bits = [reader.read(32) for _ in range(columns)]
+    lead = [None] * columns
+    trail = [0] * columns
+    time, delta = t0, 0
+    rows = [(time, [bits_to_float(b) for b in prev_bits])]
+
+    for _ in range(count - 1):
+        # Timestamp: a prefix of up to four ones selects the field width
+        ones = 0
+        while ones < 4 and reader.read(1):
+            ones += 1
+        dod = 0
+        if ones:
+            width = (7, 9, 12, 32)[ones - 1]
+            dod = reader.read(width)
+            if dod & (1 << (width - 1)):
+                dod -= 1 << width
+        delta += dod
+        time = (time + delta) & 0xFFFFFFFF
+
+        for col in range(columns):
+            if reader.read(1):
+                if reader.read(1):
+                    lead[col] = reader.read(5)
+                    length = reader.read(5) + 1
+                    trail[col] = 32 - lead[col] - length
+                length = 32 - lead[col] - trail[col]
+                prev_bits[col] ^= reader.read(length) << trail[col]
+        rows.append((time, [bits_to_float(b) for b in prev_bits]))
+
+    return rows, used
+
+
+def decode(data):
+    """Decode all the blocks in a buffer sent back to back."""
+    rows = []
+    offset = 0
+    while offset + HEADER_SIZE <= len(data):
+        block_rows, used = decode_block(data, offset)
+        rows.extend(block_rows)
+        offset += used
+    return rows
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    source = sys.argv[1]
+    if source.startswith('http'):
+        data = urllib.request.urlopen(source).read()
+    else:
+        with open(source, 'rb') as file:
+            data = file.read()
+
+    rows = decode(data)
+    width = max([len(values) for time, values in rows] or [2])
+    names = ["Fine", "Coarse"] + ["Ch%d" % column
+                                  for column in range(2, width)]
+    print(", ".join(["Time (ms)"] + ["%s Voltage" % name
+                                     for name in names[:width]]))
+    for time, values in rows:
+        print("%d, %s" % (time, ", ".join("%.4f" % v for v in values)))
+
+    bits = len(data) * 8
+    if rows:
+        print("# %d rows in %d bytes, %.1f bits per row"
+              % (len(rows), len(data), bits / len(rows)), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
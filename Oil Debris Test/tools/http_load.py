@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""@file http_load.py
+Load an oil debris tester's web server and report how it copes. Each path
+is asked for over and over by 1, 2, 4 and 8 clients at once for a few
+seconds; each step gives the requests per second, the spread of the time
+each request took as the clients saw it, the bytes in each response and
+the errors. Before each step the server's own times are cleared through
+/stats?reset=1, and afterwards /stats gives the time the route's handler
+took on the server, so the two can be compared: the difference is spent
+waiting to be accepted and on the network.
+
+    python3 http_load.py --host 192.168.4.1
+    python3 http_load.py --host localhost --port 8089 --json load.json
+
+The second line loads the host benchmark's server, started with
+replay_bench --serve 8089. Only the standard library is used.
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import argparse
+import http.client
+import json
+import sys
+import threading
+import time
+
+DEFAULT_PATHS = ['/api/status', '/csv', '/api/samples?max=10',
+                 '/api/samples?max=100', '/api/samples?max=1000']
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def fetch(host, port, path, timeout):
+    """Ask for one page, returning its status and body."""
+    connection = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        connection.request('GET', path)
+        response = connection.getresponse()
+        return response.status, response.read()
+    finally:
+        connection.close()
+
+
+def server_times(host, port, path, timeout):
+    """Get the server's times for the route a path belongs to."""
+    status, body = fetch(host, port, '/stats', timeout)
+    if status != 200:
+        return None
+    route = path.split('?')[0]
+    for entry in json.loads(body).get('routes', []):
+        if entry.get('route') == route:
+            return entry
+    return None
+
+
+def run_step(args, path, clients):
+    """Load one path with some clients at once and measure it."""
+    fetch(args.host, args.port, '/stats?reset=1', args.timeout)
+    latencies = []
+    sizes = []
+    errors = [0]
+    lock = threading.Lock()
+    stop = time.monotonic() + args.seconds
+
+    def client():
+        while time.monotonic() < stop:
+            start = time.monotonic()
+            try:
+                status, body = fetch(args.host, args.port, path,
+                                     args.timeout)
+            except (OSError, http.client.HTTPException):
+                status, body = None, b''
+            took = 1000 * (time.monotonic() - start)
+            with lock:
+                if status == 200:
+                    latencies.append(took)
+                    sizes.append(len(body))
+                else:
+                    errors[0] += 1
+
+    threads = [threading.Thread(target=client) for _ in range(clients)]
+    began = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - began
+
+    server = server_times(args.host, args.port, path, args.timeout) or {}
+    return {
+        'path': path,
+        'clients': clients,
+        'requests': len(latencies),
+        'errors': errors[0],
+        'req_per_s': len(latencies) / elapsed,
+        'bytes_per_response': sum(sizes) / len(sizes) if sizes else 0,
+        'client_p50_ms': percentile(latencies, 0.5),
+        'client_p99_ms': percentile(latencies, 0.99),
+        'server_count': server.get('count', 0),
+        'server_p50_us': server.get('p50_us', 0),
+        'server_p99_us': server.get('p99_us', 0),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure a tester's web server under load.")
+    parser.add_argument('--host', default='192.168.4.1')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--paths', nargs='+', default=DEFAULT_PATHS)
+    parser.add_argument('--clients', type=int, nargs='+',
+                        default=[1, 2, 4, 8])
+    parser.add_argument('--seconds', type=float, default=5.0)
+    parser.add_argument('--timeout', type=float, default=10.0)
+    parser.add_argument('--json', help="also write the results to this file")
+    args = parser.parse_args()
+
+    try:
+        fetch(args.host, args.port, '/stats', args.timeout)
+    except OSError as error:
+        sys.exit("can't reach %s:%d: %s" % (args.host, args.port, error))
+
+    results = []
+    print("path, clients, req/s, bytes/response, client p50 (ms), "
+          "client p99 (ms), server p50 (us), server p99 (us), errors")
+    for path in args.paths:
+        for clients in args.clients:
+            step = run_step(args, path, clients)
+            results.append(step)
+            print("%s, %d, %.1f, %.0f, %.2f, %.2f, %d, %d, %d" % (
+                path, clients, step['req_per_s'],
+                step['bytes_per_response'], step['client_p50_ms'],
+                step['client_p99_ms'], step['server_p50_us'],
+                step['server_p99_us'], step['errors']))
+            sys.stdout.flush()
+
+    if args.json:
+        with open(args.json, 'w') as out:
+            json.dump({'schema': 1, 'kind': 'http_load',
+                       'host': args.host, 'port': args.port,
+                       'seconds': args.seconds, 'steps': results},
+                      out, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""@file mqtt_bench.py
+Subscribe to the telemetry which oil debris testers publish to an MQTT
+broker and report its throughput and latency. For each tester it counts
+messages, records and bytes per second, shows how old the newest reading
+was when each message was sent (age_ms), and checks the record sequence
+numbers for gaps and repeats. A local mosquitto broker makes a good stand-in
+for the real one:
+
+    mosquitto -v &
+    python3 mqtt_bench.py --host localhost --seconds 120
+
+Needs the paho-mqtt package (pip install paho-mqtt).
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import argparse
+import json
+import sys
+import time
+
+import paho.mqtt.client as mqtt
+
+
+class Device:
+    """What has been received from one tester."""
+
+    def __init__(self):
+        self.messages = 0
+        self.bytes = 0
+        self.records = 0
+        self.repeats = 0
+        self.gaps = 0
+        self.lost = 0
+        self.last_seq = None
+        self.ages = []
+        self.arrivals = []
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure the telemetry testers publish over MQTT.")
+    parser.add_argument('--host', default='localhost')
+    parser.add_argument('--port', type=int, default=1883)
+    parser.add_argument('--topic', default='debris/+/telemetry')
+    parser.add_argument('--seconds', type=float, default=60.0)
+    args = parser.parse_args()
+
+    devices = {}
+
+    def on_message(client, userdata, message):
+        now = time.monotonic()
+        try:
+            body = json.loads(message.payload)
+        except ValueError:
+            print("unreadable message on %s" % message.topic,
+                  file=sys.stderr)
+            return
+        device = devices.setdefault(body.get('device', message.topic),
+                                    Device())
+        device.messages += 1
+        device.bytes += len(message.payload)
+        device.ages.append(body.get('age_ms', 0))
+        device.arrivals.append(now)
+        device.lost = body.get('lost', 0)
+
+        seqs = sorted([row[0] for row in body.get('blocks', [])]
+                      + [row[0] for row in body.get('events', [])])
+        for seq in seqs:
+            if device.last_seq is not None and seq <= device.last_seq:
+                device.repeats += 1
+                continue
+            if device.last_seq is not None and seq > device.last_seq + 1:
+                device.gaps += 1
+            device.last_seq = seq
+            device.records += 1
+
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2)
+    except AttributeError:
+        client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(args.host, args.port)
+    client.subscribe(args.topic, qos=1)
+
+    start = time.monotonic()
+    client.loop_start()
+    time.sleep(args.seconds)
+    client.loop_stop()
+    elapsed = time.monotonic() - start
+
+    if not devices:
+        sys.exit("nothing was received on %s" % args.topic)
+
+    print("device, messages/s, records/s, bytes/s, mean bytes/msg, "
+          "age_ms p50, age_ms p99, gap between msgs p99 (ms), gaps, "
+          "repeats, lost")
+    for name, device in sorted(devices.items()):
+        spacing = [1000 * (b - a) for a, b in zip(device.arrivals,
+                                                  device.arrivals[1:])]
+        print("%s, %.2f, %.1f, %.0f, %.0f, %d, %d, %.0f, %d, %d, %d" % (
+            name, device.messages / elapsed, device.records / elapsed,
+            device.bytes / elapsed, device.bytes / device.messages,
+            percentile(device.ages, 0.5), percentile(device.ages, 0.99),
+            percentile(spacing, 0.99), device.gaps, device.repeats,
+            device.lost))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""@file sync_client.py
+Collect new readings and debris events from one or more oil debris testers
+by polling their /sync endpoints. Each tester numbers its log records in
+sequence, across restarts too, so only records newer than the last one
+saved are fetched. The sequence is checked on every poll; a gap or a
+repeated record is reported, as are records the tester had to throw away
+before they could be fetched.
+
+Usage:
+    python3 sync_client.py http://192.168.5.1 [http://192.168.5.2 ...]
+    python3 sync_client.py --once --dir data http://192.168.5.1
+
+For each tester a directory holds samples.csv, events.csv and the cursor,
+the sequence number of the last record saved, in cursor.txt. The cursor is
+only moved on after the rows have been written.
+
+@author Corey Agena, Daniel Ceja, Parker Tenney
+@date   2026-Oct-16 Original file
+@copyright 2026 by the authors, released under the MIT License.
+"""
+
+import argparse
+import os
+import sys
+import time
+import urllib.parse
+import urllib.request
+
+from data_download import (CHANNELS, EVENT, SAMPLES, channel_name,
+                           csv_heading, csv_row, decode_channels,
+                           decode_event, decode_samples, read_records)
+
+
+class Tester:
+    """The saved state of one tester: where its files are and its cursor."""
+
+    def __init__(self, url, directory):
+        self.url = url.rstrip('/')
+        self.directory = directory
+        os.makedirs(directory, exist_ok=True)
+        self.cursor_path = os.path.join(directory, 'cursor.txt')
+        self.cursor = 0
+        if os.path.exists(self.cursor_path):
+            with open(self.cursor_path) as file:
+                self.cursor = int(file.read().strip() or 0)
+        self.gaps = 0
+        self.repeats = 0
+        self.lost = 0
+        self.names = []
+
+    def save_cursor(self, cursor):
+        """Replace the cursor file in one step, so a crash can't leave it
+        half-written."""
+        temporary = self.cursor_path + '.tmp'
+        with open(temporary, 'w') as file:
+            file.write("%d\n" % cursor)
+        os.replace(temporary, self.cursor_path)
+        self.cursor = cursor
+
+    def append(self, name, heading, lines):
+        path = os.path.join(self.directory, name)
+        new = not os.path.exists(path)
+        with open(path, 'a') as file:
+            if new:
+                file.write(heading + "\n")
+            for line in lines:
+                file.write(line + "\n")
+
+
+def poll(tester, batch, period, scale, timeout):
+    """Fetch and save one batch of records from a tester. Returns True if
+    the tester says more records are waiting."""
+    query = urllib.parse.urlencode({'after': tester.cursor, 'max': batch})
+    with urllib.request.urlopen("%s/sync?%s" % (tester.url, query),
+                                timeout=timeout) as reply:
+        data = reply.read()
+        length = int(reply.headers['Content-Length'])
+        oldest = int(reply.headers['X-Sync-Oldest'])
+        following = int(reply.headers['X-Sync-Next'])
+    if len(data) != length:
+        raise IOError("reply cut short at %d of %d bytes" % (len(data),
+                                                              length))
+
+    records, skipped = read_records(data)
+    if skipped:
+        raise IOError("%d bytes of the reply weren't records" % skipped)
+
+    expected = tester.cursor + 1
+    if records and oldest > expected:
+        lost = min(oldest, records[0][0]) - expected
+        print("%s: %d records were dropped by the tester before they could "
+              "be fetched" % (tester.url, lost), file=sys.stderr)
+        tester.lost += lost
+        expected = records[0][0]
+
+    samples = []
+    events = []
+    cursor = tester.cursor
+    for seq, kind, payload in records:
+        if seq < expected:
+            tester.repeats += 1
+            print("%s: record %d repeated" % (tester.url, seq),
+                  file=sys.stderr)
+            continue
+        if seq > expected:
+            tester.gaps += 1
+            print("%s: records %d to %d missing" % (tester.url, expected,
+                                                    seq - 1),
+                  file=sys.stderr)
+        expected = seq + 1
+        cursor = seq
+
+        if kind == SAMPLES:
+            for stamp, counts in decode_samples(payload, period):
+                width = max(len(counts), len(tester.names))
+                samples.append("%d, %s" % (seq, csv_row(stamp, counts, scale,
+                                                         width)))
+        elif kind == CHANNELS:
+            tester.names = decode_channels(payload)
+        elif kind == EVENT:
+            stamp, peak, duration, channel = decode_event(payload)
+            events.append("%d, %d, %s, %d, %d" % (
+                seq, stamp, channel_name(tester.names, channel), peak,
+                duration))
+
+    tester.append('samples.csv', "Record, " + csv_heading(
+                      tester.names, max(len(tester.names), 2)), samples)
+    tester.append('events.csv',
+                  "Record, Time (ms), Channel, Peak (counts), Samples",
+                  events)
+    if cursor != tester.cursor:
+        tester.save_cursor(cursor)
+
+    return following > cursor + 1 and len(records) > 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Fetch new records from testers' /sync endpoints.")
+    parser.add_argument('urls', nargs='+', help="tester base URLs")
+    parser.add_argument('--dir', default='sync',
+                        help="where each tester's files go (default sync)")
+    parser.add_argument('--batch', type=int, default=256,
+                        help="records per request (default 256)")
+    parser.add_argument('--interval', type=float, default=10.0,
+                        help="seconds between polls (default 10)")
+    parser.add_argument('--once', action='store_true',
+                        help="fetch everything new, then stop")
+    parser.add_argument('--period', type=float, default=10.0,
+                        help="sample period in ms (default 10)")
+    parser.add_argument('--full-scale', type=float, default=5.0,
+                        help="voltage at 4095 counts (default 5.0)")
+    parser.add_argument('--timeout', type=float, default=10.0)
+    args = parser.parse_args()
+
+    testers = [Tester(url, os.path.join(
+                   args.dir, urllib.parse.urlparse(url).netloc
+                   .replace(':', '_')))
+               for url in args.urls]
+    scale = args.full_scale / 4095
+
+    while True:
+        for tester in testers:
+            try:
+                while poll(tester, args.batch, args.period, scale,
+                           args.timeout):
+                    pass
+            except (OSError, ValueError, KeyError) as error:
+                print("%s: %s" % (tester.url, error), file=sys.stderr)
+        if args.once:
+            break
+        time.sleep(args.interval)
+
+    bad = False
+    for tester in testers:
+        print("%s: up to record %d, %d gaps, %d repeats, %d lost"
+              % (tester.url, tester.cursor, tester.gaps, tester.repeats,
+                 tester.lost), file=sys.stderr)
+        bad = bad or tester.gaps or tester.repeats
+    sys.exit(1 if bad else 0)
+
+
+if __name__ == '__main__':
+    main()